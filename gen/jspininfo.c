@@ -0,0 +1,15 @@
+// auto-generated pin info file
+// for board LINUX
+#include "jspininfo.h"
+
+const JshPinInfo pinInfo[JSH_PIN_COUNT] = {
+/* PD0  */ { JSH_PORTD, JSH_PIN0+0, JSH_ANALOG_NONE, {  } },
+/* PD1  */ { JSH_PORTD, JSH_PIN0+1, JSH_ANALOG_NONE, {  } },
+/* PD2  */ { JSH_PORTD, JSH_PIN0+2, JSH_ANALOG_NONE, {  } },
+/* PD3  */ { JSH_PORTD, JSH_PIN0+3, JSH_ANALOG_NONE, {  } },
+/* PD4  */ { JSH_PORTD, JSH_PIN0+4, JSH_ANALOG_NONE, {  } },
+/* PD5  */ { JSH_PORTD, JSH_PIN0+5, JSH_ANALOG_NONE, {  } },
+/* PD6  */ { JSH_PORTD, JSH_PIN0+6, JSH_ANALOG_NONE, {  } },
+/* PD7  */ { JSH_PORTD, JSH_PIN0+7, JSH_ANALOG_NONE, {  } },
+};
+
@@ -158,21 +158,8 @@ static bool allocateJsFile(JsFile* file,FileMode mode, FileType type) {
   return true;
 }
 
-/*JSON{
-  "type" : "staticmethod",
-  "class" : "E",
-  "name" : "openFile",
-  "generate" : "jswrap_E_openFile",
-  "params" : [
-    ["path","JsVar","the path to the file to open."],
-    ["mode","JsVar","The mode to use when opening the file. Valid values for mode are 'r' for read, 'w' for write new, 'w+' for write existing, and 'a' for append. If not specified, the default is 'r'."]
-  ],
-  "return" : ["JsVar","A File object"],
-  "return_object" : "File"
-}
-Open a file
-*/
-JsVar *jswrap_E_openFile(JsVar* path, JsVar* mode) {
+/// Open a file (see E.openFile), only reporting errors if reportErrors is set
+JsVar *jsfsOpenFile(JsVar* path, JsVar* mode, bool reportErrors) {
   FRESULT res = FR_INVALID_NAME;
   JsFile file;
   file.fileVar = 0;
@@ -234,11 +221,11 @@ JsVar *jswrap_E_openFile(JsVar* path, JsVar* mode) {
           file.fileVar = 0;
         }
 
-        if(res != FR_OK)
+        if(res != FR_OK && reportErrors)
           jsfsReportError("Could not open file", res);
 
       }
-    } else {
+    } else if (reportErrors) {
       jsError("Path is undefined");
     }
 
@@ -249,6 +236,24 @@ JsVar *jswrap_E_openFile(JsVar* path, JsVar* mode) {
   return file.fileVar;
 }
 
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "E",
+  "name" : "openFile",
+  "generate" : "jswrap_E_openFile",
+  "params" : [
+    ["path","JsVar","the path to the file to open."],
+    ["mode","JsVar","The mode to use when opening the file. Valid values for mode are 'r' for read, 'w' for write new, 'w+' for write existing, and 'a' for append. If not specified, the default is 'r'."]
+  ],
+  "return" : ["JsVar","A File object"],
+  "return_object" : "File"
+}
+Open a file
+*/
+JsVar *jswrap_E_openFile(JsVar* path, JsVar* mode) {
+  return jsfsOpenFile(path, mode, true);
+}
+
 /*JSON{
   "type" : "method",
   "class" : "File",
@@ -66,6 +66,7 @@ typedef struct JsFile {
 // Called when stopping, to make sure all files are closed
 void jswrap_file_kill();
 
+JsVar* jsfsOpenFile(JsVar* path, JsVar* mode, bool reportErrors);
 JsVar* jswrap_E_openFile(JsVar* path, JsVar* mode);
 void jswrap_E_unmountSD();
 
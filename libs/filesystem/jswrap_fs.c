@@ -21,11 +21,13 @@
 #include "jsparse.h"
 #include "jsinteractive.h"
 #include "jswrap_date.h"
+#include "jswrap_error.h"
 
 #ifndef LINUX
 #include "ff.h" // filesystem stuff
 #else
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/stat.h>
 #include <dirent.h> // for readdir
 #endif
@@ -35,7 +37,9 @@
   "type" : "library",
   "class" : "fs"
 }
-This library handles interfacing with a FAT32 filesystem on an SD card. The API is designed to be similar to node.js's - However Espruino does not currently support asynchronous file IO, so the functions behave like node.js's xxxxSync functions. Versions of the functions with 'Sync' after them are also provided for compatibility.
+This library handles interfacing with a FAT32 filesystem on an SD card. The API is designed to be similar to node.js's - if a callback is given to `readdir`, `readFile`, `writeFile`, `appendFile` or `unlink` it is called with `(err, result)` once the operation has completed, otherwise the functions behave like node.js's xxxxSync functions. Versions of the functions with 'Sync' after them are also provided for compatibility.
+
+On Linux the asynchronous versions do their file IO on a worker thread, so the rest of your code keeps running. Elsewhere the IO is done straight away, and the callback is queued to run afterwards.
 
 Currently this provides minimal file IO - it's great for logging and loading/saving settings, but not good for loading large amounts of data as you will soon fill your memory up.
 
@@ -65,26 +69,222 @@ To use this, you must type ```var fs = require('fs')``` to get access to the lib
 extern bool jsfsInit();
 extern void jsfsReportError(const char *msg, FRESULT res);
 
+typedef enum {
+  JSFS_READDIR,
+  JSFS_READFILE,
+  JSFS_WRITEFILE,
+  JSFS_APPENDFILE,
+  JSFS_UNLINK,
+} JsfsAsyncOp;
+
+/// The message for the Error passed to the callback when each JsfsAsyncOp fails
+static const char *jsfsAsyncErrors[] = {
+  "Unable to list files",
+  "Unable to read file",
+  "Unable to write file",
+  "Unable to write file",
+  "Unable to delete file",
+};
+
+/// Queue callback(err[, result]) for a completed JsfsAsyncOp, with result=undefined on failure. callbackId is from jsiAddAsyncCallback, or 0
+static void jsfsQueueCallback(JsfsAsyncOp op, JsVar *callback, int callbackId, bool ok, JsVar *result) {
+  JsVar *args[2];
+  args[0] = 0;
+  args[1] = result;
+  if (!ok) {
+    JsVar *msg = jsvNewFromString(jsfsAsyncErrors[op]);
+    args[0] = jswrap_error_constructor(msg);
+    jsvUnLock(msg);
+  }
+  int argCount = (op==JSFS_READDIR || op==JSFS_READFILE) ? 2 : 1;
+  if (callbackId) jsiQueueAsyncCallback(callbackId, args, argCount);
+  else jsiQueueEvents(callback, args, argCount);
+  jsvUnLock(args[0]);
+}
+
+#ifdef LINUX
+/// A file operation being done on a worker thread (so it can't use JsVars)
+typedef struct {
+  JsfsAsyncOp op;
+  int callbackId; ///< From jsiAddAsyncCallback
+  bool ok;
+  char path[JS_DIR_BUF_SIZE];
+  char *data; ///< malloc'd - data to write, the file that was read, or '\0'-terminated filenames one after the other
+  size_t dataLen;
+} JsfsAsyncJob;
+
+/// Append to job->data, growing it as needed. Returns false if out of memory
+static bool jsfsAsyncAppend(JsfsAsyncJob *job, size_t *allocated, const char *buf, size_t len) {
+  if (job->dataLen+len > *allocated) {
+    size_t newSize = (job->dataLen+len)*2;
+    char *newData = (char*)realloc(job->data, newSize);
+    if (!newData) return false;
+    job->data = newData;
+    *allocated = newSize;
+  }
+  memcpy(&job->data[job->dataLen], buf, len);
+  job->dataLen += len;
+  return true;
+}
+
+/// Called on a worker thread
+static void jsfsAsyncWork(void *data) {
+  JsfsAsyncJob *job = (JsfsAsyncJob*)data;
+  size_t allocated = 0;
+  switch (job->op) {
+  case JSFS_READDIR: {
+    DIR *dir = opendir(job->path);
+    job->ok = dir!=0;
+    if (dir) {
+      struct dirent *pDir;
+      while ((pDir = readdir(dir)) != NULL)
+        if (!jsfsAsyncAppend(job, &allocated, pDir->d_name, strlen(pDir->d_name)+1))
+          job->ok = false;
+      closedir(dir);
+    }
+  } break;
+  case JSFS_READFILE: {
+    FILE *f = fopen(job->path, "rb");
+    job->ok = f!=0;
+    if (f) {
+      char buf[256];
+      size_t n;
+      while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        if (!jsfsAsyncAppend(job, &allocated, buf, n))
+          job->ok = false;
+      fclose(f);
+    }
+  } break;
+  case JSFS_WRITEFILE:
+  case JSFS_APPENDFILE: {
+    FILE *f = fopen(job->path, job->op==JSFS_APPENDFILE ? "ab" : "wb");
+    job->ok = f!=0;
+    if (f) {
+      if (job->dataLen && fwrite(job->data, 1, job->dataLen, f)!=job->dataLen)
+        job->ok = false;
+      if (fclose(f)!=0) job->ok = false;
+    }
+  } break;
+  case JSFS_UNLINK:
+    job->ok = remove(job->path)==0;
+    break;
+  }
+}
+
+/// Called from the idle loop once jsfsAsyncWork has finished
+static void jsfsAsyncDone(void *data, bool cancelled) {
+  JsfsAsyncJob *job = (JsfsAsyncJob*)data;
+  if (!cancelled) {
+    JsVar *result = 0;
+    if (job->ok && job->op==JSFS_READFILE) {
+      result = jsvNewFromEmptyString();
+      if (result && !jsvAppendStringBuf(result, job->data, job->dataLen))
+        job->ok = false; // out of memory
+    } else if (job->ok && job->op==JSFS_READDIR) {
+      result = jsvNewWithFlags(JSV_ARRAY);
+      size_t i = 0;
+      while (result && i<job->dataLen) {
+        JsVar *fnVar = jsvNewFromString(&job->data[i]);
+        if (fnVar) { // out of memory?
+          jsvArrayPush(result, fnVar);
+          jsvUnLock(fnVar);
+        }
+        i += strlen(&job->data[i])+1;
+      }
+    }
+    if (job->ok && !result && (job->op==JSFS_READDIR || job->op==JSFS_READFILE))
+      job->ok = false; // out of memory
+    jsfsQueueCallback(job->op, 0, job->callbackId, job->ok, job->ok ? result : 0);
+    jsvUnLock(result);
+  }
+  free(job->data);
+  free(job);
+}
+#endif
+
+/** Perform the given operation and call callback(err[, result]) from the idle loop. On Linux
+ * the IO itself is done on a worker thread, otherwise it's done right now */
+static void jsfsQueueAsync(JsfsAsyncOp op, JsVar *path, JsVar *data, JsVar *callback) {
+#ifdef LINUX
+  JsfsAsyncJob *job = (JsfsAsyncJob*)malloc(sizeof(JsfsAsyncJob));
+  if (!job) {
+    jsError("Out of memory");
+    return;
+  }
+  job->op = op;
+  job->ok = false;
+  job->data = 0;
+  job->dataLen = 0;
+  job->path[0] = 0;
+  if (!jsvIsUndefined(path))
+    jsvGetString(path, job->path, JS_DIR_BUF_SIZE);
+  if (op==JSFS_READDIR && !job->path[0]) strcpy(job->path, "."); // deal with empty readdir
+  if (op==JSFS_WRITEFILE || op==JSFS_APPENDFILE) {
+    // copy the data out now - it's not safe to touch JsVars from the worker
+    JsvIterator it;
+    jsvIteratorNew(&it, data);
+    while (jsvIteratorHasElement(&it)) {
+      job->dataLen++;
+      jsvIteratorNext(&it);
+    }
+    jsvIteratorFree(&it);
+    job->data = (char*)malloc(job->dataLen ? job->dataLen : 1);
+    if (!job->data) {
+      free(job);
+      jsError("Out of memory");
+      return;
+    }
+    size_t i = 0;
+    jsvIteratorNew(&it, data);
+    while (jsvIteratorHasElement(&it) && i<job->dataLen) {
+      job->data[i++] = (char)jsvIteratorGetIntegerValue(&it);
+      jsvIteratorNext(&it);
+    }
+    jsvIteratorFree(&it);
+  }
+  job->callbackId = jsiAddAsyncCallback(callback);
+  if (!job->callbackId) {
+    free(job->data);
+    free(job);
+    return; // out of memory
+  }
+  jshWorkerQueue(jsfsAsyncWork, jsfsAsyncDone, job);
+#else
+  JsVar *result = 0;
+  bool ok = false;
+  switch (op) {
+  case JSFS_READDIR: result = jswrap_fs_readdir(path, 0); ok = result!=0; break;
+  case JSFS_READFILE: result = jswrap_fs_readFile(path, 0); ok = result!=0; break;
+  case JSFS_WRITEFILE: ok = jswrap_fs_writeOrAppendFile(path, data, false, 0); break;
+  case JSFS_APPENDFILE: ok = jswrap_fs_writeOrAppendFile(path, data, true, 0); break;
+  case JSFS_UNLINK: ok = jswrap_fs_unlink(path, 0); break;
+  }
+  jsfsQueueCallback(op, callback, 0, ok, result);
+  jsvUnLock(result);
+#endif
+}
+
 /*JSON{
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "readdir",
   "generate" : "jswrap_fs_readdir",
   "params" : [
-    ["path","JsVar","The path of the directory to list. If it is not supplied, '' is assumed, which will list the root directory"]
+    ["path","JsVar","The path of the directory to list. If it is not supplied, '' is assumed, which will list the root directory"],
+    ["callback","JsVar","[optional] A function to call with `(err, files)` when done. If supplied, nothing is returned"]
   ],
   "return" : ["JsVar","An array of filename strings (or undefined if the directory couldn't be listed)"]
 }
 List all files in the supplied directory, returning them as an array of strings.
 
-NOTE: Espruino does not yet support Async file IO, so this function behaves like the 'Sync' version.
+If no callback is given, this function behaves like the 'Sync' version.
 */
 /*JSON{
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "readdirSync",
   "ifndef" : "SAVE_ON_FLASH",
-  "generate" : "jswrap_fs_readdir",
+  "generate_full" : "jswrap_fs_readdir(path, 0)",
   "params" : [
     ["path","JsVar","The path of the directory to list. If it is not supplied, '' is assumed, which will list the root directory"]
   ],
@@ -93,7 +293,11 @@ NOTE: Espruino does not yet support Async file IO, so this function behaves like
 List all files in the supplied directory, returning them as an array of strings.
 */
 
-JsVar *jswrap_fs_readdir(JsVar *path) {
+JsVar *jswrap_fs_readdir(JsVar *path, JsVar *callback) {
+  if (jsvIsFunction(callback)) {
+    jsfsQueueAsync(JSFS_READDIR, path, 0, callback);
+    return 0;
+  }
   JsVar *arr = 0; // undefined unless we can open card
 
   char pathStr[JS_DIR_BUF_SIZE] = "";
@@ -148,23 +352,24 @@ JsVar *jswrap_fs_readdir(JsVar *path) {
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "writeFile",
-  "generate_full" : " jswrap_fs_writeOrAppendFile(path, data, false)",
+  "generate_full" : " jswrap_fs_writeOrAppendFile(path, data, false, callback)",
   "params" : [
     ["path","JsVar","The path of the file to write"],
-    ["data","JsVar","The data to write to the file"]
+    ["data","JsVar","The data to write to the file"],
+    ["callback","JsVar","[optional] A function to call with `(err)` when done"]
   ],
-  "return" : ["bool","True on success, false on failure"]
+  "return" : ["bool","True on success, false on failure (always true if a callback was given)"]
 }
 Write the data to the given file
 
-NOTE: Espruino does not yet support Async file IO, so this function behaves like the 'Sync' version.
+If no callback is given, this function behaves like the 'Sync' version.
 */
 /*JSON{
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "writeFileSync",
   "ifndef" : "SAVE_ON_FLASH",
-  "generate_full" : " jswrap_fs_writeOrAppendFile(path, data, false)",
+  "generate_full" : " jswrap_fs_writeOrAppendFile(path, data, false, 0)",
   "params" : [
     ["path","JsVar","The path of the file to write"],
     ["data","JsVar","The data to write to the file"]
@@ -177,23 +382,24 @@ Write the data to the given file
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "appendFile",
-  "generate_full" : " jswrap_fs_writeOrAppendFile(path, data, true)",
+  "generate_full" : " jswrap_fs_writeOrAppendFile(path, data, true, callback)",
   "params" : [
     ["path","JsVar","The path of the file to write"],
-    ["data","JsVar","The data to write to the file"]
+    ["data","JsVar","The data to write to the file"],
+    ["callback","JsVar","[optional] A function to call with `(err)` when done"]
   ],
-  "return" : ["bool","True on success, false on failure"]
+  "return" : ["bool","True on success, false on failure (always true if a callback was given)"]
 }
 Append the data to the given file, created a new file if it doesn't exist
 
-NOTE: Espruino does not yet support Async file IO, so this function behaves like the 'Sync' version.
+If no callback is given, this function behaves like the 'Sync' version.
 */
 /*JSON{
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "appendFileSync",
   "ifndef" : "SAVE_ON_FLASH",
-  "generate_full" : "jswrap_fs_writeOrAppendFile(path, data, true)",
+  "generate_full" : "jswrap_fs_writeOrAppendFile(path, data, true, 0)",
   "params" : [
     ["path","JsVar","The path of the file to write"],
     ["data","JsVar","The data to write to the file"]
@@ -202,7 +408,11 @@ NOTE: Espruino does not yet support Async file IO, so this function behaves like
 }
 Append the data to the given file, created a new file if it doesn't exist
 */
-bool jswrap_fs_writeOrAppendFile(JsVar *path, JsVar *data, bool append) {
+bool jswrap_fs_writeOrAppendFile(JsVar *path, JsVar *data, bool append, JsVar *callback) {
+  if (jsvIsFunction(callback)) {
+    jsfsQueueAsync(append ? JSFS_APPENDFILE : JSFS_WRITEFILE, path, data, callback);
+    return true;
+  }
   JsVar *fMode = jsvNewFromString(append ? "a" : "w");
   JsVar *f = jswrap_E_openFile(path, fMode);
   jsvUnLock(fMode);
@@ -213,26 +423,43 @@ bool jswrap_fs_writeOrAppendFile(JsVar *path, JsVar *data, bool append) {
   return amt>0;
 }
 
+/** Write the data to the given file, but don't report an error if the file
+ * can't be opened. If not everything could be written the file is removed,
+ * so a half-written file is never left behind. */
+bool jsfsWriteFileQuietly(JsVar *path, JsVar *data) {
+  JsVar *fMode = jsvNewFromString("w");
+  JsVar *f = jsfsOpenFile(path, fMode, false);
+  jsvUnLock(fMode);
+  if (!f) return false;
+  size_t amt = jswrap_file_write(f, data);
+  jswrap_file_close(f);
+  jsvUnLock(f);
+  if (amt == jsvGetStringLength(data)) return true;
+  jswrap_fs_unlink(path, 0);
+  return false;
+}
+
 /*JSON{
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "readFile",
   "generate" : "jswrap_fs_readFile",
   "params" : [
-    ["path","JsVar","The path of the file to read"]
+    ["path","JsVar","The path of the file to read"],
+    ["callback","JsVar","[optional] A function to call with `(err, data)` when done. If supplied, nothing is returned"]
   ],
   "return" : ["JsVar","A string containing the contents of the file (or undefined if the file doesn't exist)"]
 }
 Read all data from a file and return as a string
 
-NOTE: Espruino does not yet support Async file IO, so this function behaves like the 'Sync' version.
+If no callback is given, this function behaves like the 'Sync' version.
 */
 /*JSON{
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "readFileSync",
   "ifndef" : "SAVE_ON_FLASH",
-  "generate" : "jswrap_fs_readFile",
+  "generate_full" : "jswrap_fs_readFile(path, 0)",
   "params" : [
     ["path","JsVar","The path of the file to read"]
   ],
@@ -242,7 +469,11 @@ Read all data from a file and return as a string.
 
 **Note:** The size of files you can load using this method is limited by the amount of available RAM. To read files a bit at a time, see the `File` class.
 */
-JsVar *jswrap_fs_readFile(JsVar *path) {
+JsVar *jswrap_fs_readFile(JsVar *path, JsVar *callback) {
+  if (jsvIsFunction(callback)) {
+    jsfsQueueAsync(JSFS_READFILE, path, 0, callback);
+    return 0;
+  }
   JsVar *fMode = jsvNewFromString("r");
   JsVar *f = jswrap_E_openFile(path, fMode);
   jsvUnLock(fMode);
@@ -260,20 +491,21 @@ JsVar *jswrap_fs_readFile(JsVar *path) {
   "ifndef" : "SAVE_ON_FLASH",
   "generate" : "jswrap_fs_unlink",
   "params" : [
-    ["path","JsVar","The path of the file to delete"]
+    ["path","JsVar","The path of the file to delete"],
+    ["callback","JsVar","[optional] A function to call with `(err)` when done"]
   ],
-  "return" : ["bool","True on success, or false on failure"]
+  "return" : ["bool","True on success, or false on failure (always true if a callback was given)"]
 }
 Delete the given file
 
-NOTE: Espruino does not yet support Async file IO, so this function behaves like the 'Sync' version.
+If no callback is given, this function behaves like the 'Sync' version.
 */
 /*JSON{
   "type" : "staticmethod",
   "class" : "fs",
   "name" : "unlinkSync",
   "ifndef" : "SAVE_ON_FLASH",
-  "generate" : "jswrap_fs_unlink",
+  "generate_full" : "jswrap_fs_unlink(path, 0)",
   "params" : [
     ["path","JsVar","The path of the file to delete"]
   ],
@@ -281,7 +513,11 @@ NOTE: Espruino does not yet support Async file IO, so this function behaves like
 }
 Delete the given file
 */
-bool jswrap_fs_unlink(JsVar *path) {
+bool jswrap_fs_unlink(JsVar *path, JsVar *callback) {
+  if (jsvIsFunction(callback)) {
+    jsfsQueueAsync(JSFS_UNLINK, path, 0, callback);
+    return true;
+  }
   char pathStr[JS_DIR_BUF_SIZE] = "";
   if (!jsvIsUndefined(path))
     jsvGetString(path, pathStr, JS_DIR_BUF_SIZE);
@@ -13,8 +13,9 @@
  */
 #include "jsvar.h"
 
-JsVar *jswrap_fs_readdir(JsVar *path);
-bool jswrap_fs_writeOrAppendFile(JsVar *path, JsVar *data, bool append);
-JsVar *jswrap_fs_readFile(JsVar *path);
-bool jswrap_fs_unlink(JsVar *path);
+JsVar *jswrap_fs_readdir(JsVar *path, JsVar *callback);
+bool jswrap_fs_writeOrAppendFile(JsVar *path, JsVar *data, bool append, JsVar *callback);
+bool jsfsWriteFileQuietly(JsVar *path, JsVar *data);
+JsVar *jswrap_fs_readFile(JsVar *path, JsVar *callback);
+bool jswrap_fs_unlink(JsVar *path, JsVar *callback);
 JsVar *jswrap_fs_stat(JsVar *path);
@@ -48,8 +48,7 @@ void esp8266_got_data(JsVar *data) {
 
 bool esp8266_idle(JsVar *usartClass) {
   bool found = false;
-  bool hasChanged = false;
-  JsVar *buf = jsvObjectGetChild(usartClass, STREAM_BUFFER_NAME, 0);
+  JsVar *buf = jswrap_stream_available(usartClass) ? jswrap_stream_read(usartClass, 0) : 0;
   if (jsvIsString(buf)) {
     if (esp8266_ipd_buffer_size) {
       size_t nChars = jsvGetStringLength(buf);
@@ -60,7 +59,6 @@ bool esp8266_idle(JsVar *usartClass) {
       JsVar *newBuf = jsvNewFromStringVar(buf, (size_t)(nChars+1), JSVAPPENDSTRINGVAR_MAXLENGTH);
       jsvUnLock(buf);
       buf = newBuf;
-      hasChanged = true;
       esp8266_got_data(data);
     } else {
       char chars[10];
@@ -81,7 +79,6 @@ bool esp8266_idle(JsVar *usartClass) {
             JsVar *newBuf = jsvNewFromStringVar(buf, (size_t)(i+nChars+1), JSVAPPENDSTRINGVAR_MAXLENGTH);
             jsvUnLock(buf);
             buf = newBuf;
-            hasChanged = true;
             esp8266_got_data(data);
             jsvUnLock(data);
           } else {
@@ -92,12 +89,10 @@ bool esp8266_idle(JsVar *usartClass) {
           jsWarn("ESP8266 expecting +IPD string, got %q", buf);
           jsvUnLock(buf);
           buf = 0;
-          hasChanged = true;
         }
       } else { // string doesn't start with '+IPD'
         int idx = jsvGetStringIndexOf(buf, '\n');
         while (!found && idx>0/* because we want a \r before it */) {
-          hasChanged = true;
           JsVar *line = jsvNewFromStringVar(buf,0,(size_t)(idx-1)); // \r\n - so idx is of '\n' and we want to remove '\r' too
           jsiConsoleRemoveInputLine();
           jsiConsolePrintf("ESP8266> %q\n", line);
@@ -112,8 +107,8 @@ bool esp8266_idle(JsVar *usartClass) {
       }
     }
   }
-  if (hasChanged)
-    jsvObjectSetChild(usartClass, STREAM_BUFFER_NAME, buf);
+  // put back whatever we didn't use
+  jswrap_stream_setBuffer(usartClass, buf);
   jsvUnLock(buf);
   return found;
 }
@@ -16,6 +16,9 @@
 #include "jsinteractive.h"
 #include "jshardware.h"
 #include "jswrap_stream.h"
+#ifdef LINUX
+#include "network_linux.h"
+#endif
 
 #define HTTP_NAME_PORT "port"
 #define HTTP_NAME_SOCKET "sckt"
@@ -29,6 +32,7 @@
 #define HTTP_NAME_HEADERS "hdr"
 #define HTTP_NAME_CLOSENOW "closeNow"
 #define HTTP_NAME_CLOSE "close"
+#define HTTP_NAME_RESOLVING "rslv" ///< id from net_linux_gethostbyname_async while the host name is being looked up
 #define HTTP_NAME_ON_CONNECT "#onconnect"
 #define HTTP_NAME_ON_CLOSE "#onclose"
 
@@ -368,7 +372,8 @@ bool httpClientConnectionsIdle(JsNetwork *net) {
     JsVar *connection = jsvObjectIteratorGetValue(&it);
     bool closeConnectionNow = jsvGetBoolAndUnLock(jsvObjectGetChild(connection, HTTP_NAME_CLOSENOW, false));
     int sckt = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_SOCKET,0))-1; // so -1 if undefined
-    if (sckt<0) closeConnectionNow = true;
+    bool resolving = jsvGetBoolAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_RESOLVING,0)); // no socket yet, but we'll get one
+    if (sckt<0 && !resolving) closeConnectionNow = true;
     bool hadHeaders = jsvGetBoolAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_HAD_HEADERS,0));
     JsVar *receiveData = jsvObjectGetChild(connection,HTTP_NAME_RECEIVE_DATA,0);
 
@@ -384,7 +389,7 @@ bool httpClientConnectionsIdle(JsNetwork *net) {
       receiveData = 0;
     }
 
-    if (!closeConnectionNow) {
+    if (!closeConnectionNow && !resolving) {
       JsVar *sendData = jsvObjectGetChild(connection,HTTP_NAME_SEND_DATA,0);
       // send data if possible
       if (sendData) {
@@ -611,29 +616,20 @@ void httpClientRequestWrite(JsVar *httpClientReqVar, JsVar *data) {
   jsvUnLock(sendData);
 }
 
-void httpClientRequestEnd(JsNetwork *net, JsVar *httpClientReqVar) {
-  httpClientRequestWrite(httpClientReqVar, 0); // force sendData to be made
-
-  JsVar *options = jsvObjectGetChild(httpClientReqVar, HTTP_NAME_OPTIONS_VAR, false);
-  unsigned short port = (unsigned short)jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "port", 0));
-  if (port==0) port=80;
-
-  char hostName[128];
-  JsVar *hostNameVar = jsvObjectGetChild(options, "host", 0);
-  jsvGetString(hostNameVar, hostName, sizeof(hostName));
-  jsvUnLock(hostNameVar);
-
-  unsigned long host_addr = 0;
-  networkGetHostByName(net, hostName, &host_addr);
-
+/// Create the socket for a client request once we know the address of the host
+static void httpClientRequestConnect(JsNetwork *net, JsVar *httpClientReqVar, unsigned long host_addr) {
   if(!host_addr) {
     jsError("Unable to locate host");
     jsvUnLock(jsvObjectSetChild(httpClientReqVar, HTTP_NAME_CLOSENOW, jsvNewFromBool(true)));
-    jsvUnLock(options);
     net->checkError(net);
     return;
   }
 
+  JsVar *options = jsvObjectGetChild(httpClientReqVar, HTTP_NAME_OPTIONS_VAR, false);
+  unsigned short port = (unsigned short)jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "port", 0));
+  if (port==0) port=80;
+  jsvUnLock(options);
+
   int sckt =  net->createsocket(net, host_addr, port);
   if (sckt<0) {
     jsError("Unable to create socket\n");
@@ -642,9 +638,61 @@ void httpClientRequestEnd(JsNetwork *net, JsVar *httpClientReqVar) {
     jsvUnLock(jsvObjectSetChild(httpClientReqVar, HTTP_NAME_SOCKET, jsvNewFromInteger(sckt+1)));
   }
 
+  net->checkError(net);
+}
+
+#ifdef LINUX
+/// Called from the idle loop when a lookup from net_linux_gethostbyname_async has finished
+static void httpClientHostResolved(int id, unsigned long host_addr) {
+  JsNetwork net;
+  if (!networkGetFromVar(&net)) return;
+  JsVar *arr = httpGetArray(HTTP_ARRAY_HTTP_CLIENT_CONNECTIONS,false);
+  if (arr) {
+    JsvObjectIterator it;
+    jsvObjectIteratorNew(&it, arr);
+    while (jsvObjectIteratorHasValue(&it)) {
+      JsVar *connection = jsvObjectIteratorGetValue(&it);
+      if (jsvGetIntegerAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_RESOLVING,0)) == id) {
+        jsvRemoveNamedChild(connection, HTTP_NAME_RESOLVING);
+        httpClientRequestConnect(&net, connection, host_addr);
+        jsvUnLock(connection);
+        break;
+      }
+      jsvUnLock(connection);
+      jsvObjectIteratorNext(&it);
+    }
+    jsvObjectIteratorFree(&it);
+    jsvUnLock(arr);
+  }
+  // if the request wasn't found it was closed (or the interpreter was reset) while we waited
+  networkFree(&net);
+}
+#endif
+
+void httpClientRequestEnd(JsNetwork *net, JsVar *httpClientReqVar) {
+  httpClientRequestWrite(httpClientReqVar, 0); // force sendData to be made
+
+  JsVar *options = jsvObjectGetChild(httpClientReqVar, HTTP_NAME_OPTIONS_VAR, false);
+  char hostName[128];
+  JsVar *hostNameVar = jsvObjectGetChild(options, "host", 0);
+  jsvGetString(hostNameVar, hostName, sizeof(hostName));
+  jsvUnLock(hostNameVar);
   jsvUnLock(options);
 
-  net->checkError(net);
+#ifdef LINUX
+  if (net->data.type==JSNETWORKTYPE_SOCKET && !networkParseIPAddress(hostName)) {
+    // Don't block while looking up the name - httpClientHostResolved will connect when it's done
+    int id = net_linux_gethostbyname_async(hostName, httpClientHostResolved);
+    if (id) {
+      jsvUnLock(jsvObjectSetChild(httpClientReqVar, HTTP_NAME_RESOLVING, jsvNewFromInteger(id)));
+      return;
+    }
+  }
+#endif
+
+  unsigned long host_addr = 0;
+  networkGetHostByName(net, hostName, &host_addr);
+  httpClientRequestConnect(net, httpClientReqVar, host_addr);
 }
 
 
@@ -15,6 +15,7 @@
 #include "network_linux.h"
 
 #include <string.h> // for memset
+#include <stdlib.h> // for malloc
 
 #define INVALID_SOCKET ((SOCKET)(-1))
 #define SOCKET_ERROR (-1)
@@ -47,6 +48,52 @@ void net_linux_gethostbyname(JsNetwork *net, char * hostName, unsigned long* out
     *out_ip_addr = *(unsigned long*)*host_addr_p->h_addr_list;
 }
 
+/// A name lookup being done on a worker thread - see net_linux_gethostbyname_async
+typedef struct {
+  char hostName[128];
+  unsigned long ip;
+  int id;
+  void (*callback)(int id, unsigned long ip);
+} NetLinuxHostLookup;
+
+static THREAD_LOCAL int netLinuxLastLookupId = 0;
+
+static void net_linux_gethostbyname_work(void *data) {
+  NetLinuxHostLookup *lookup = (NetLinuxHostLookup*)data;
+#ifdef WIN32
+  net_linux_gethostbyname(0, lookup->hostName, &lookup->ip); // winsock's gethostbyname is per-thread anyway
+#else
+  // gethostbyname isn't thread safe - getaddrinfo is
+  struct addrinfo hints, *res = 0;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(lookup->hostName, 0, &hints, &res)==0 && res)
+    lookup->ip = (unsigned long)((struct sockaddr_in*)res->ai_addr)->sin_addr.s_addr;
+  if (res) freeaddrinfo(res);
+#endif
+}
+
+static void net_linux_gethostbyname_done(void *data, bool cancelled) {
+  NetLinuxHostLookup *lookup = (NetLinuxHostLookup*)data;
+  if (!cancelled) lookup->callback(lookup->id, lookup->ip);
+  free(lookup);
+}
+
+int net_linux_gethostbyname_async(const char *hostName, void (*callback)(int id, unsigned long ip)) {
+  NetLinuxHostLookup *lookup = (NetLinuxHostLookup*)malloc(sizeof(NetLinuxHostLookup));
+  if (!lookup) return 0;
+  if (++netLinuxLastLookupId <= 0) netLinuxLastLookupId = 1;
+  int id = netLinuxLastLookupId;
+  strncpy(lookup->hostName, hostName, sizeof(lookup->hostName));
+  lookup->hostName[sizeof(lookup->hostName)-1] = 0;
+  lookup->ip = 0;
+  lookup->id = id;
+  lookup->callback = callback;
+  jshWorkerQueue(net_linux_gethostbyname_work, net_linux_gethostbyname_done, lookup);
+  return id;
+}
+
 /// Called on idle. Do any checks required for this device
 void net_linux_idle(JsNetwork *net) {
   NOT_USED(net);
@@ -71,10 +118,12 @@ int net_linux_createsocket(JsNetwork *net, unsigned long host, unsigned short po
     sckt = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (sckt<0) return sckt; // error
 
-    // turn on non-blocking mode
+    // turn on non-blocking mode - so we don't wait here for the connection. recv/send use select, so just return 0 until it's made
     #ifdef WIN_OS
     u_long n = 1;
     ioctlsocket(sckt,FIONBIO,&n);
+    #else
+    fcntl(sckt, F_SETFL, fcntl(sckt, F_GETFL, 0) | O_NONBLOCK);
     #endif
 
     sin.sin_addr.s_addr = (in_addr_t)host;
@@ -14,3 +14,7 @@
 #include "network.h"
 
 void netSetCallbacks_linux(JsNetwork *net);
+
+/** Look up an IP address from a name on a worker thread, then call callback(id, ip) from the idle loop
+ * (with ip=0 on failure). Returns the id that will be passed to callback, or 0 if the lookup couldn't be started */
+int net_linux_gethostbyname_async(const char *hostName, void (*callback)(int id, unsigned long ip));
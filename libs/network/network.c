@@ -27,7 +27,7 @@
   #include "network_linux.h"
 #endif
 
-JsNetworkState networkState =
+THREAD_LOCAL JsNetworkState networkState =
 #ifdef LINUX
     NETWORKSTATE_ONLINE
 #else
@@ -35,7 +35,7 @@ JsNetworkState networkState =
 #endif
     ;
 
-JsNetwork *networkCurrentStruct = 0;
+THREAD_LOCAL JsNetwork *networkCurrentStruct = 0;
 
 unsigned long networkParseIPAddress(const char *ip) {
   int n = 0;
@@ -28,7 +28,7 @@ typedef enum {
   NETWORKSTATE_INVOLUNTARY_DISCONNECT, // just randomly disconnected - maybe try and reconnect
 } PACKED_FLAGS JsNetworkState;
 
-extern JsNetworkState networkState; // FIXME put this in JsNetwork
+extern THREAD_LOCAL JsNetworkState networkState; // FIXME put this in JsNetwork
 
 // This is all code for handling multiple types of network access with one binary
 typedef enum {
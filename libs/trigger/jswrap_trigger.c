@@ -22,6 +22,8 @@
 }
 This class exists in order to interface Espruino with fast-moving trigger wheels. Trigger wheels are physical discs with evenly spaced teeth cut into them, and often with one or two teeth next to each other missing. A sensor sends a signal whenever a tooth passed by, and this allows a device to measure not only RPM, but absolute position.
 
+Up to 4 independent trigger wheels (for instance a crank and a cam) can be used at once - each function takes an optional `wheel` argument saying which one to use.
+
 This class is currently in testing - it is NOT AVAILABLE on normal boards.
 */
 
@@ -31,15 +33,17 @@ This class is currently in testing - it is NOT AVAILABLE on normal boards.
   "name" : "getPosAtTime",
   "generate" : "jswrap_trig_getPosAtTime",
   "params" : [
-    ["time","float","The time at which to find the position"]
+    ["time","float","The time at which to find the position"],
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
   ],
   "return" : ["float","The position of the trigger wheel in degrees - as a floating point number"]
 }
 Get the position of the trigger wheel at the given time (from getTime)
 */
-JsVarFloat jswrap_trig_getPosAtTime(JsVarFloat time) {
+JsVarFloat jswrap_trig_getPosAtTime(JsVarFloat time, JsVarInt wheel) {
   JsSysTime sTime = (JsSysTime)(time * (JsVarFloat)jshGetTimeFromMilliseconds(1000));
-  TriggerStruct *trig = &mainTrigger;
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return 0;
   JsVarFloat position = trigGetToothAtTime(trig, sTime);
   return wrapAround((position * 360 / trig->teethTotal) + trig->keyPosition, 360);
 }
@@ -51,18 +55,20 @@ JsVarFloat jswrap_trig_getPosAtTime(JsVarFloat time) {
   "generate" : "jswrap_trig_setup",
   "params" : [
     ["pin","pin","The pin to use for triggering"],
-    ["options","JsVar","Additional options as an object. defaults are: ```{teethTotal:60,teethMissing:2,minRPM:30,keyPosition:0}```"]
+    ["options","JsVar","Additional options as an object. defaults are: ```{teethTotal:60,teethMissing:2,minRPM:30,keyPosition:0}```"],
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
   ]
 }
 Initialise the trigger class
 */
-void jswrap_trig_setup(Pin pin, JsVar *options) {
+void jswrap_trig_setup(Pin pin, JsVar *options, JsVarInt wheel) {
   if (!jshIsPinValid(pin)) {
     jsError("Invalid pin supplied as an argument to Trig.setup");
     return;
   }
 
-  TriggerStruct *trig = &mainTrigger;
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return;
   // static info
   trig->teethMissing = 2;
   trig->teethTotal = 60;
@@ -83,6 +89,11 @@ void jswrap_trig_setup(Pin pin, JsVar *options) {
     if (!jsvIsUndefined(v)) trig->keyPosition = jsvGetFloat(v);
     jsvUnLock(v);
   }
+  if (trig->teethTotal==0 || trig->teethMissing>=trig->teethTotal) {
+    jsExceptionHere(JSET_ERROR, "teethTotal must be greater than teethMissing");
+    trigSetPin(trig, PIN_UNDEFINED);
+    return;
+  }
   trig->maxTooth = (unsigned int)jshGetTimeFromMilliseconds(60000 / (JsVarFloat)(trig->teethTotal * minRPM));
 
   // semi-static info
@@ -91,6 +102,7 @@ void jswrap_trig_setup(Pin pin, JsVar *options) {
     trig->triggers[i].tooth = TRIGGERPOINT_TOOTH_DISABLE;
     trig->triggers[i].newTooth = TRIGGERPOINT_TOOTH_DISABLE;
   }
+  memset(trig->toothTriggers, 0, sizeof(trig->toothTriggers));
   // dynamic info
   trig->lastTime = jshGetSystemTime();
   trig->avrTrigger = (unsigned int)jshGetTimeFromMilliseconds(10); // average time for a trigger pulse
@@ -98,11 +110,10 @@ void jswrap_trig_setup(Pin pin, JsVar *options) {
   trig->currTooth = 0;
   trig->teethSinceStart = 0;
   trig->wrongTriggerTeeth = 0;
+  trig->errors = 0;
+  memset(trig->errorCounts, 0, sizeof(trig->errorCounts));
   // finally set up the watch!
-  if (jshIsPinValid(trig->sensorPin))
-    jshPinWatch(trig->sensorPin, false);
-  trig->sensorPin = pin;
-  jshPinWatch(trig->sensorPin, true);
+  trigSetPin(trig, pin);
 }
 
 /*JSON{
@@ -114,13 +125,15 @@ void jswrap_trig_setup(Pin pin, JsVar *options) {
     ["num","int","The trigger number (0..7)"],
     ["pos","float","The position (in degrees) to fire the trigger at"],
     ["pins","JsVar","An array of pins to pulse (max 4)"],
-    ["pulseLength","float","The time (in msec) to pulse for"]
+    ["pulseLength","float","The time (in msec) to pulse for"],
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
   ]
 }
 Set a trigger for a certain point in the cycle
 */
-void jswrap_trig_setTrigger(JsVarInt num, JsVarFloat position, JsVar *pins, JsVarFloat pulseLength) {
-  TriggerStruct *trig = &mainTrigger;
+void jswrap_trig_setTrigger(JsVarInt num, JsVarFloat position, JsVar *pins, JsVarFloat pulseLength, JsVarInt wheel) {
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return;
   if (num<0 || num>=TRIGGER_TRIGGERS_COUNT) {
      jsWarn("Invalid trigger number\n");
      return;
@@ -139,17 +152,15 @@ void jswrap_trig_setTrigger(JsVarInt num, JsVarFloat position, JsVar *pins, JsVa
 
   TriggerPointStruct *tp = &trig->triggers[num];
   tp->newTooth = (unsigned char)position;
-  tp->newToothFraction = (unsigned char)((position - tp->tooth)*256);
+  tp->newToothFraction = (unsigned char)((position - tp->newTooth)*256);
   tp->pulseLength = jshGetTimeFromMilliseconds(pulseLength);
   int i, l=(int)jsvGetArrayLength(pins);
   for (i=0;i<TRIGGERPOINT_TRIGGERS_COUNT;i++) {
     tp->pins[i] = (Pin)((i<l) ? jshGetPinFromVarAndUnLock(jsvGetArrayItem(pins, i)) : PIN_UNDEFINED);
   }
   // now copy over data if we need to do it immediately
-  if (tp->tooth==TRIGGERPOINT_TOOTH_DISABLE || tp->newTooth==TRIGGERPOINT_TOOTH_DISABLE) {
-    tp->tooth = tp->newTooth;
-    tp->toothFraction = tp->newToothFraction;
-  }
+  if (tp->tooth==TRIGGERPOINT_TOOTH_DISABLE || tp->newTooth==TRIGGERPOINT_TOOTH_DISABLE)
+    trigSetTriggerTooth(trig, (int)num, tp->newTooth, tp->newToothFraction);
   // all done!
 }
 
@@ -159,21 +170,22 @@ void jswrap_trig_setTrigger(JsVarInt num, JsVarFloat position, JsVar *pins, JsVa
   "name" : "killTrigger",
   "generate" : "jswrap_trig_killTrigger",
   "params" : [
-    ["num","int","The trigger number (0..7)"]
+    ["num","int","The trigger number (0..7)"],
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
   ]
 }
 Disable a trigger
 */
-void jswrap_trig_killTrigger(JsVarInt num) {
-  TriggerStruct *trig = &mainTrigger;
+void jswrap_trig_killTrigger(JsVarInt num, JsVarInt wheel) {
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return;
   if (num<0 || num>=TRIGGER_TRIGGERS_COUNT) {
      jsWarn("Invalid trigger number\n");
      return;
    }
 
-  TriggerPointStruct *tp = &trig->triggers[num];
-  tp->tooth = TRIGGERPOINT_TOOTH_DISABLE;
-  tp->newTooth = TRIGGERPOINT_TOOTH_DISABLE;
+  trig->triggers[num].newTooth = TRIGGERPOINT_TOOTH_DISABLE;
+  trigSetTriggerTooth(trig, (int)num, TRIGGERPOINT_TOOTH_DISABLE, 0);
 }
 
 /*JSON{
@@ -182,14 +194,16 @@ void jswrap_trig_killTrigger(JsVarInt num) {
   "name" : "getTrigger",
   "generate" : "jswrap_trig_getTrigger",
   "params" : [
-    ["num","int","The trigger number (0..7)"]
+    ["num","int","The trigger number (0..7)"],
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
   ],
   "return" : ["JsVar","A structure containing all information about the trigger"]
 }
 Get the current state of a trigger
 */
-JsVar *jswrap_trig_getTrigger(JsVarInt num) {
-  TriggerStruct *trig = &mainTrigger;
+JsVar *jswrap_trig_getTrigger(JsVarInt num, JsVarInt wheel) {
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return 0;
   if (num<0 || num>=TRIGGER_TRIGGERS_COUNT) {
      jsWarn("Invalid trigger number\n");
      return 0;
@@ -229,12 +243,16 @@ JsVar *jswrap_trig_getTrigger(JsVarInt num) {
   "class" : "Trig",
   "name" : "getRPM",
   "generate" : "jswrap_trig_getRPM",
+  "params" : [
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
+  ],
   "return" : ["float","The current RPM of the trigger wheel"]
 }
 Get the RPM of the trigger wheel
 */
-JsVarFloat jswrap_trig_getRPM() {
-  TriggerStruct *trig = &mainTrigger;
+JsVarFloat jswrap_trig_getRPM(JsVarInt wheel) {
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return 0;
 
   if (jshGetSystemTime() > (trig->lastTime + trig->maxTooth)) return 0;
   return jshGetTimeFromMilliseconds(60000) / (JsVarFloat)(trig->avrTooth * trig->teethTotal);
@@ -245,12 +263,16 @@ JsVarFloat jswrap_trig_getRPM() {
   "class" : "Trig",
   "name" : "getErrors",
   "generate" : "jswrap_trig_getErrors",
+  "params" : [
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
+  ],
   "return" : ["int","The error flags"]
 }
 Get the current error flags from the trigger wheel - and zero them
 */
-JsVarInt jswrap_trig_getErrors() {
-  TriggerStruct *trig = &mainTrigger;
+JsVarInt jswrap_trig_getErrors(JsVarInt wheel) {
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return 0;
   TriggerError errors = trig->errors;
   trig->errors = 0;
   return (JsVarInt)errors;
@@ -261,12 +283,16 @@ JsVarInt jswrap_trig_getErrors() {
   "class" : "Trig",
   "name" : "getErrorArray",
   "generate" : "jswrap_trig_getErrorArray",
+  "params" : [
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
+  ],
   "return" : ["JsVar","An array of error strings"]
 }
 Get the current error flags from the trigger wheel - and zero them
 */
-JsVar* jswrap_trig_getErrorArray() {
-  TriggerStruct *trig = &mainTrigger;
+JsVar* jswrap_trig_getErrorArray(JsVarInt wheel) {
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return 0;
   TriggerError errors = trig->errors;
   trig->errors = 0;
 
@@ -284,3 +310,33 @@ JsVar* jswrap_trig_getErrorArray() {
   }
   return arr;
 }
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "Trig",
+  "name" : "getErrorCounts",
+  "generate" : "jswrap_trig_getErrorCounts",
+  "params" : [
+    ["wheel","int","The trigger wheel to use (0..3, default 0)"]
+  ],
+  "return" : ["JsVar","An object mapping error names to the number of times they have happened"]
+}
+Get the number of times each error has happened on the trigger wheel since `Trig.setup` was called. Unlike `Trig.getErrors` this doesn't zero anything.
+*/
+JsVar* jswrap_trig_getErrorCounts(JsVarInt wheel) {
+  TriggerStruct *trig = trigGetInstance((int)wheel);
+  if (!trig) return 0;
+
+  JsVar *obj = jsvNewWithFlags(JSV_OBJECT);
+  if (obj) {
+    int i;
+    for (i=0;i<TRIGERR_COUNT;i++) {
+      if (trig->errorCounts[i]) {
+        JsVar *v = jsvNewFromInteger(trig->errorCounts[i]);
+        jsvUnLock(jsvAddNamedChild(obj, v, trigGetErrorString(1<<i)));
+        jsvUnLock(v);
+      }
+    }
+  }
+  return obj;
+}
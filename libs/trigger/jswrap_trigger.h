@@ -12,11 +12,12 @@
  * ----------------------------------------------------------------------------
  */
 
-JsVarFloat jswrap_trig_getPosAtTime(JsVarFloat time);
-void jswrap_trig_setup(Pin pin, JsVar *options);
-void jswrap_trig_setTrigger(JsVarInt num, JsVarFloat position, JsVar *pins, JsVarFloat pulseLength);
-void jswrap_trig_killTrigger(JsVarInt num);
-JsVar *jswrap_trig_getTrigger(JsVarInt num);
-JsVarFloat jswrap_trig_getRPM();
-JsVarInt jswrap_trig_getErrors();
-JsVar* jswrap_trig_getErrorArray();
+JsVarFloat jswrap_trig_getPosAtTime(JsVarFloat time, JsVarInt wheel);
+void jswrap_trig_setup(Pin pin, JsVar *options, JsVarInt wheel);
+void jswrap_trig_setTrigger(JsVarInt num, JsVarFloat position, JsVar *pins, JsVarFloat pulseLength, JsVarInt wheel);
+void jswrap_trig_killTrigger(JsVarInt num, JsVarInt wheel);
+JsVar *jswrap_trig_getTrigger(JsVarInt num, JsVarInt wheel);
+JsVarFloat jswrap_trig_getRPM(JsVarInt wheel);
+JsVarInt jswrap_trig_getErrors(JsVarInt wheel);
+JsVar* jswrap_trig_getErrorArray(JsVarInt wheel);
+JsVar* jswrap_trig_getErrorCounts(JsVarInt wheel);
@@ -54,13 +54,87 @@ Issue using with save()
 Needs to have a minRPM to detect when wheel is stationary
 */
 
-TriggerStruct mainTrigger = { (Pin)-1/*pin*/};
+TriggerStruct triggers[TRIGGER_INSTANCES] = {
+  { (Pin)-1/*pin*/},
+  { (Pin)-1/*pin*/},
+  { (Pin)-1/*pin*/},
+  { (Pin)-1/*pin*/},
+};
+
+TriggerStruct *trigGetInstance(int wheel) {
+  if (wheel<0 || wheel>=TRIGGER_INSTANCES) {
+    jsExceptionHere(JSET_ERROR, "Invalid trigger wheel number %d (must be 0..%d)", wheel, TRIGGER_INSTANCES-1);
+    return 0;
+  }
+  return &triggers[wheel];
+}
+
+int trigGetErrorIndex(TriggerError flag) {
+  int i = 0;
+  while (i<TRIGERR_COUNT && !(flag & (1<<i))) i++;
+  return i;
+}
+
+void trigSetError(TriggerStruct *data, TriggerError flag) {
+  data->errors |= flag;
+  int i = trigGetErrorIndex(flag);
+  if (i<TRIGERR_COUNT && data->errorCounts[i]<0xFFFF)
+    data->errorCounts[i]++;
+}
+
+void trigSetPin(TriggerStruct *data, Pin pin) {
+  Pin oldPin = data->sensorPin;
+  data->sensorPin = pin;
+  // only stop watching the old pin if no other wheel is using it
+  int i;
+  if (jshIsPinValid(oldPin)) {
+    bool used = false;
+    for (i=0;i<TRIGGER_INSTANCES;i++)
+      if (triggers[i].sensorPin == oldPin) used = true;
+    if (!used) jshPinWatch(oldPin, false);
+  }
+  if (jshIsPinValid(pin))
+    jshPinWatch(pin, true);
+}
+
+void trigSetTriggerTooth(TriggerStruct *data, int num, unsigned char tooth, unsigned char toothFraction) {
+  TriggerPointStruct *trig = &data->triggers[num];
+  unsigned char mask = (unsigned char)(1<<num);
+  if (trig->tooth != TRIGGERPOINT_TOOTH_DISABLE)
+    data->toothTriggers[trig->tooth] &= (unsigned char)~mask;
+  trig->tooth = tooth;
+  trig->toothFraction = toothFraction;
+  if (tooth != TRIGGERPOINT_TOOTH_DISABLE)
+    data->toothTriggers[tooth] |= mask;
+}
+
+/// Fire trigger point 'num', which is 'toothOffset' teeth (in 1/256ths) after the tooth at 'pulseTime'
+static void trigFire(TriggerStruct *data, int num, JsSysTime pulseTime, JsSysTime currentTime, int toothOffset) {
+  TriggerPointStruct *trig = &data->triggers[num];
+  JsSysTime trigTime = pulseTime + (((JsSysTime)toothOffset * (JsSysTime)data->avrTooth) >> 8);
+  if (trigTime > pulseTime + jshGetTimeFromMilliseconds(500)) {
+    trigTime = pulseTime + jshGetTimeFromMilliseconds(500);
+    trigSetError(data, TRIGERR_TRIG_IN_FUTURE);
+  }
+  if (trigTime < currentTime)
+    trigSetError(data, TRIGERR_TRIG_IN_PAST);
+
+  if (!jstPinOutputAtTime(trigTime, trig->pins, TRIGGERPOINT_TRIGGERS_COUNT, 0xFF))
+    trigSetError(data, TRIGERR_TIMER_FULL);
+  if (trig->pulseLength>0) {
+    if (!jstPinOutputAtTime(trigTime+trig->pulseLength, trig->pins, TRIGGERPOINT_TRIGGERS_COUNT, 0))
+      trigSetError(data, TRIGERR_TIMER_FULL);
+  }
+  // trigger fired, so update it
+  if (trig->newTooth!=trig->tooth || trig->newToothFraction!=trig->toothFraction)
+    trigSetTriggerTooth(data, num, trig->newTooth, trig->newToothFraction);
+}
 
 void trigOnTimingPulse(TriggerStruct *data, JsSysTime pulseTime) {
   JsSysTime currentTime = jshGetSystemTime();
   int timeDiff = (int)(pulseTime - data->lastTime);
   if (timeDiff < 0) {
-    data->errors |= TRIGERR_WRONG_TIME;
+    trigSetError(data, TRIGERR_WRONG_TIME);
     timeDiff = 0;
 //    jsiConsolePrintf("0x%Lx 0x%Lx 0x%Lx\n",data->lastTime2, data->lastTime, pulseTime);
     pulseTime = data->lastTime + data->avrTrigger; // just make it up and hope!
@@ -85,7 +159,7 @@ void trigOnTimingPulse(TriggerStruct *data, JsSysTime pulseTime) {
     // Otherwise figure out how many teeth
     teeth = (unsigned char)(((((unsigned int)timeDiff<<1) / data->avrTrigger) + 1) >> 1); // round to find out # of teeth
     if (teeth<1) {
-      data->errors |= TRIGERR_SHORT_TOOTH;
+      trigSetError(data, TRIGERR_SHORT_TOOTH);
       teeth=1;
     }
     // and do slow averages
@@ -99,7 +173,7 @@ void trigOnTimingPulse(TriggerStruct *data, JsSysTime pulseTime) {
   data->currTooth = (unsigned char)(data->currTooth + teeth);
   // handle trigger tooth
   if (teeth > data->teethMissing) {
-    if (teeth != data->teethMissing+1) data->errors |= TRIGERR_MISSED_TRIG_TOOTH;
+    if (teeth != data->teethMissing+1) trigSetError(data, TRIGERR_MISSED_TRIG_TOOTH);
 
     if (data->currTooth == data->teethTotal) {
       /* just what we expect - set back to 0.
@@ -109,9 +183,9 @@ void trigOnTimingPulse(TriggerStruct *data, JsSysTime pulseTime) {
     } else {
       // Something has gone wrong - we got a trigger tooth when we didn't expect one
       if (data->currTooth < data->teethTotal) {
-        data->errors |= TRIGERR_WHEEL_MISSED_TOOTH;
+        trigSetError(data, TRIGERR_WHEEL_MISSED_TOOTH);
       } else { // data->currTooth > expectedTooth
-        data->errors |= TRIGERR_WHEEL_GAINED_TOOTH;
+        trigSetError(data, TRIGERR_WHEEL_GAINED_TOOTH);
       }
       // increment counter
       data->wrongTriggerTeeth++;
@@ -120,18 +194,18 @@ void trigOnTimingPulse(TriggerStruct *data, JsSysTime pulseTime) {
       if (data->wrongTriggerTeeth > 1) {
         data->wrongTriggerTeeth = 0;
         data->currTooth = 0;
-        data->errors |= TRIGERR_TRIG_TOOTH_CHANGED;
+        trigSetError(data, TRIGERR_TRIG_TOOTH_CHANGED);
       }
     }
   } else {
     // just a normal tooth event
-    if (teeth!=1) data->errors |= TRIGERR_MISSED_TOOTH;
+    if (teeth!=1) trigSetError(data, TRIGERR_MISSED_TOOTH);
   }
   // handle roll-over
   if (data->teethTotal>0) { // sanity check to stop endless loop if misconfigured
     while (data->currTooth >= data->teethTotal) {
-      data->errors |= TRIGERR_WHEEL_MISSED_TRIG_TOOTH;
-      data->currTooth = (unsigned char)(data->currTooth + data->teethTotal);
+      trigSetError(data, TRIGERR_WHEEL_MISSED_TRIG_TOOTH);
+      data->currTooth = (unsigned char)(data->currTooth - data->teethTotal);
     }
   }
 
@@ -141,41 +215,24 @@ void trigOnTimingPulse(TriggerStruct *data, JsSysTime pulseTime) {
     // TODO: teethSinceStart>10 && hadTrigger?
     // don't start firing events until we actually know where we are!!
 
-    unsigned char currTooth = data->currTooth;
-    if (currTooth < lastTooth) currTooth = (unsigned char)(data->currTooth + data->teethTotal);
+    int currTooth = data->currTooth;
+    if (currTooth < lastTooth) currTooth += data->teethTotal;
     int tooth;
 
+    /* Look at the firing table for the teeth that have just come within
+     * TRIGGER_LOOKAHEAD teeth of us (to give us time to schedule them).
+     * This is normally one tooth, or teethMissing+1 after the gap. */
     for (tooth=lastTooth+TRIGGER_LOOKAHEAD;tooth<currTooth+TRIGGER_LOOKAHEAD;tooth++) {
-      // actually we want to check a few teeth into the future to give us time
-      int i;
-      for (i=0;i<TRIGGER_TRIGGERS_COUNT;i++) {
-        TriggerPointStruct *trig = &data->triggers[i];
-        if (trig->tooth != TRIGGERPOINT_TOOTH_DISABLE) {
-          if ((trig->tooth == tooth) || ((trig->tooth+data->teethTotal) == tooth)) { // because we wrap
-           // doAtTime(data->triggers[i].toothFraction * data->avrTooth >> 8);
-            JsSysTime trigTime = pulseTime +
-                                 ((trig->toothFraction * data->avrTooth) >> 8) +
-                                 (((int)tooth-(int)currTooth) * (int)data->avrTooth);
-            if (trigTime > pulseTime + jshGetTimeFromMilliseconds(500)) {
-              trigTime = jshGetTimeFromMilliseconds(500);
-              data->errors |= TRIGERR_TRIG_IN_FUTURE;
-            }
-            if (trigTime < currentTime) {
-              data->errors |= TRIGERR_TRIG_IN_PAST;
-              //jsiConsolePrint("Trigger already passed\n");
-            }
-
-            if (!jstPinOutputAtTime(trigTime, trig->pins, TRIGGERPOINT_TRIGGERS_COUNT, 0xFF))
-              data->errors |= TRIGERR_TIMER_FULL;
-            if (trig->pulseLength>0) {
-              if (!jstPinOutputAtTime(trigTime+trig->pulseLength, trig->pins, TRIGGERPOINT_TRIGGERS_COUNT, 0))
-                data->errors |= TRIGERR_TIMER_FULL;
-            }
-            // trigger fired, so update it
-            trig->tooth  = trig->newTooth;
-            trig->toothFraction = trig->newToothFraction;
-          }
-        }
+      int wheelTooth = tooth;
+      while (wheelTooth >= data->teethTotal) wheelTooth -= data->teethTotal; // because we wrap
+      unsigned char fire = data->toothTriggers[wheelTooth];
+      int num = 0;
+      while (fire) {
+        if (fire & 1)
+          trigFire(data, num, pulseTime, currentTime,
+                   ((tooth-currTooth) << 8) + data->triggers[num].toothFraction);
+        fire >>= 1;
+        num++;
       }
     }
   }
@@ -186,14 +243,17 @@ bool trigHandleEXTI(IOEventFlags channel, JsSysTime time) {
   IOEvent event;
   event.flags = channel;
 
-  if (mainTrigger.sensorPin!=PIN_UNDEFINED && jshIsEventForPin(&event, mainTrigger.sensorPin)) {
-  //  jshPinOutput(JSH_PORTB_OFFSET + 4, event.flags & EV_EXTI_IS_HIGH);
-
-    if (!(event.flags & EV_EXTI_IS_HIGH)) // we only care about falling edges
-      trigOnTimingPulse(&mainTrigger, time);
-    return true; // return true anyway, so stop this being added to our event queue
+  bool handled = false;
+  int i;
+  for (i=0;i<TRIGGER_INSTANCES;i++) {
+    TriggerStruct *data = &triggers[i];
+    if (data->sensorPin!=PIN_UNDEFINED && jshIsEventForPin(&event, data->sensorPin)) {
+      if (!(event.flags & EV_EXTI_IS_HIGH)) // we only care about falling edges
+        trigOnTimingPulse(data, time);
+      handled = true; // return true anyway, so stop this being added to our event queue
+    }
   }
-  return false;
+  return handled;
 }
 
 /** At a certain time, get which tooth number we're on */
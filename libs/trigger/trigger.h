@@ -29,6 +29,7 @@ typedef enum {
   TRIGERR_WRONG_TIME               = 1<<10, //< Time is in the past
   TRIGERR_TIMER_FULL               = 1<<11, //< The timer queue is full
 } TriggerError;
+#define TRIGERR_COUNT 12 //< How many different TriggerError flags there are
 
 /** Given a single flag, return a string for it */
 const char *trigGetErrorString(TriggerError flag);
@@ -45,7 +46,9 @@ typedef struct TriggerPointStruct {
   JsSysTime pulseLength; 
 } PACKED_FLAGS TriggerPointStruct;
 
-#define TRIGGER_TRIGGERS_COUNT (8)
+#define TRIGGER_TRIGGERS_COUNT (8) //< Must be <=8, as each tooth in TriggerStruct.toothTriggers is a bitmask of triggers
+#define TRIGGER_MAX_TEETH (256) //< teethTotal is an unsigned char
+#define TRIGGER_INSTANCES (4) //< How many independent trigger wheels we can handle at once
 typedef struct TriggerStruct {
   Pin sensorPin;
   // static info
@@ -55,6 +58,7 @@ typedef struct TriggerStruct {
   JsVarFloat keyPosition; // actual position (in degrees) of the first tooth after the missing teeth
   // semi-static info
   TriggerPointStruct triggers[TRIGGER_TRIGGERS_COUNT];
+  unsigned char toothTriggers[TRIGGER_MAX_TEETH]; //< Firing table - for each tooth, a bitmask of the triggers that fire on it
   // dynamic info
   JsSysTime lastTime, lastTime2;
   unsigned int avrTrigger; // average time for a trigger pulse
@@ -63,11 +67,19 @@ typedef struct TriggerStruct {
   unsigned int teethSinceStart;
   unsigned char wrongTriggerTeeth;
   TriggerError errors;
+  unsigned short errorCounts[TRIGERR_COUNT]; //< How many times each error has happened (saturating)
 } PACKED_FLAGS TriggerStruct;
 
-/** This is a bit hacky - ideally we'd link to this via each object, so we can have >1 trigger */
-extern TriggerStruct mainTrigger;
-
+/** Get the given trigger wheel, or 0 (with an exception) if the number is invalid */
+TriggerStruct *trigGetInstance(int wheel);
+/** Set up the given trigger wheel to use the given pin (PIN_UNDEFINED disables it) */
+void trigSetPin(TriggerStruct *data, Pin pin);
+/** Set the tooth a trigger point fires on, keeping the firing table up to date */
+void trigSetTriggerTooth(TriggerStruct *data, int num, unsigned char tooth, unsigned char toothFraction);
+/** Set an error flag, and count it */
+void trigSetError(TriggerStruct *data, TriggerError flag);
+/** Convert a single error flag into an index in errorCounts */
+int trigGetErrorIndex(TriggerError flag);
 
 /** Actually handle a trigger event, and do stuff if it is for us */
 bool trigHandleEXTI(IOEventFlags channel, JsSysTime time);
@@ -124,6 +124,74 @@ def getCDeclaration(jsondata, name):
     s.append(toCType(param[1]));
   return toCType(result[0])+" "+name+"("+",".join(s)+")";
 
+def toArgumentCType(argType):
+  # C type used when calling a function with the given JSWAT_ type
+  if argType=="JSWAT_VOID": return "void";
+  if argType=="JSWAT_JSVAR": return "JsVar*";
+  if argType=="JSWAT_ARGUMENT_ARRAY": return "JsVar*";
+  if argType=="JSWAT_BOOL": return "bool";
+  if argType=="JSWAT_PIN": return "Pin";
+  if argType=="JSWAT_INT32": return "JsVarInt";
+  if argType=="JSWAT_JSVARFLOAT": return "JsVarFloat";
+  sys.stderr.write("ERROR: toArgumentCType: Unknown argument type "+argType+"\n")
+  exit(1)
+
+def addCallStub(jsondata):
+  # Remember each distinct argument specifier, so we can output a typed call stub for it
+  spec = getArgumentSpecifier(jsondata)
+  if spec in callStubs: return
+  if jsondata["type"]=="object":
+    callStubs[spec] = { "result" : "JSWAT_JSVAR", "this" : False, "params" : [] }
+  else:
+    callStubs[spec] = {
+      "result" : toArgumentType(getResult(jsondata)[0]),
+      "this" : hasThis(jsondata),
+      "params" : [toArgumentType(param[1]) for param in getParams(jsondata)] }
+
+def codeOutCallStub(spec, stub):
+  params = []
+  args = []
+  if stub["this"]:
+    params.append("JsVar*")
+    args.append("thisParam")
+  codeOut("    case "+spec+": {")
+  n = 0
+  for argType in stub["params"]:
+    param = "JSW_PARAM("+str(n)+")"
+    if argType=="JSWAT_JSVAR": value = param
+    elif argType=="JSWAT_ARGUMENT_ARRAY": value = "jsnNewArgumentArray(paramData, paramCount, "+str(n)+")"
+    elif argType=="JSWAT_BOOL": value = "jsvGetBool("+param+")"
+    elif argType=="JSWAT_PIN": value = "jshGetPinFromVar("+param+")"
+    elif argType=="JSWAT_INT32": value = "(JsVarInt)jsvGetInteger("+param+")"
+    elif argType=="JSWAT_JSVARFLOAT": value = "jsvGetFloat("+param+")"
+    codeOut("      "+toArgumentCType(argType)+" a"+str(n)+" = "+value+";")
+    params.append(toArgumentCType(argType))
+    args.append("a"+str(n))
+    n = n+1
+  resultType = stub["result"]
+  call = "(("+toArgumentCType(resultType)+" (*)("+",".join(params)+"))function)("+", ".join(args)+")"
+  if resultType=="JSWAT_BOOL": call = "jsvNewFromBool("+call+")"
+  elif resultType=="JSWAT_PIN": call = "jsvNewFromPin("+call+")"
+  elif resultType=="JSWAT_INT32": call = "jsvNewFromInteger("+call+")"
+  elif resultType=="JSWAT_JSVARFLOAT": call = "jsvNewFromFloat("+call+")"
+  if "JSWAT_ARGUMENT_ARRAY" in stub["params"]:
+    # the argument array must be unlocked after the call
+    argsArray = "a"+str(stub["params"].index("JSWAT_ARGUMENT_ARRAY"))
+    if resultType=="JSWAT_VOID":
+      codeOut("      "+call+";")
+      codeOut("      jsvUnLock("+argsArray+");")
+      codeOut("      return 0;")
+    else:
+      codeOut("      JsVar *r = "+call+";")
+      codeOut("      jsvUnLock("+argsArray+");")
+      codeOut("      return r;")
+  elif resultType=="JSWAT_VOID":
+    codeOut("      "+call+";")
+    codeOut("      return 0;")
+  else:
+    codeOut("      return "+call+";")
+  codeOut("    }")
+
 def codeOutSymbolTable(builtin):
   codeName = builtin["name"]
   # sort by name
@@ -136,6 +204,7 @@ def codeOutSymbolTable(builtin):
     symName = sym["name"];
     if "generate" in sym:
       listSymbols.append("{"+", ".join([str(strLen), "(void (*)(void))"+sym["generate"], getArgumentSpecifier(sym)])+"}")
+      addCallStub(sym)
       listChars = listChars + symName + "\\0";
       strLen = strLen + len(symName) + 1
     else: 
@@ -189,6 +258,7 @@ codeOut('// Generated by scripts/build_jswrapper.py');
 codeOut('');
 codeOut('#include "jswrapper.h"');
 codeOut('#include "jsnative.h"');
+codeOut('#include "jsparse.h"');
 for include in includes:
   codeOut('#include "'+include+'"');
 codeOut('');
@@ -233,6 +303,8 @@ codeOut('// --------------------------------------------------------------------
 codeOut('');
 
 codeOut("""
+extern const JswSymList jswSymbolTables[];
+
 JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *name) {
   int searchMin = 0;
   int searchMax = symbolsPtr->symbolCount-1;
@@ -242,7 +314,9 @@ JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *
     int cmp = strcmp(name, &symbolsPtr->symbolChars[sym->strOffset]);
     if (cmp==0) {
       if ((sym->functionSpec & JSWAT_EXECUTE_IMMEDIATELY_MASK) == JSWAT_EXECUTE_IMMEDIATELY)
-        return jsnCallFunction(sym->functionPtr, sym->functionSpec, parent, 0, 0);
+        return jswCallFunction(sym->functionPtr, sym->functionSpec, parent, 0, 0);
+      if (sym->functionSpec & JSWAT_THIS_ARG) // methods get cached, so 'arr.push' doesn't allocate each time
+        return jspGetBuiltInMethod((int)(symbolsPtr-jswSymbolTables), idx, sym->functionPtr, sym->functionSpec);
       return jsvNewNativeFunction(sym->functionPtr, sym->functionSpec);
     } else {
       if (cmp<0) {
@@ -290,6 +364,7 @@ for jsondata in jsondatas:
 
 
 print "Outputting Symbol Tables"
+callStubs = {}
 idx = 0
 for b in builtins:
   builtin = builtins[b]
@@ -300,6 +375,24 @@ for b in builtins:
 codeOut('');
 codeOut('');
 
+codeOut('/** Call a native function. Rather than decoding the argument specifier at runtime with')
+codeOut(' * jsnCallFunction, we have a stub for each one used by built-in functions that converts')
+codeOut(' * the arguments and calls the function directly. */')
+codeOut('JsVar *jswCallFunction(void *function, JsnArgumentType argumentSpecifier, JsVar *thisParam, JsVar **paramData, int paramCount) {')
+codeOut('#ifndef SAVE_ON_FLASH')
+codeOut('#define JSW_PARAM(N) (((N)<paramCount) ? paramData[N] : (JsVar*)0)')
+codeOut('  switch ((int)argumentSpecifier) {')
+for spec in sorted(callStubs.keys()):
+  codeOutCallStub(spec, callStubs[spec])
+codeOut('    default: break;')
+codeOut('  }')
+codeOut('#undef JSW_PARAM')
+codeOut('#endif')
+codeOut('  return jsnCallFunction(function, argumentSpecifier, thisParam, paramData, paramCount);')
+codeOut('}')
+codeOut('')
+codeOut('')
+
 codeOut('const JswSymList jswSymbolTables[] = {');
 for b in builtins:
   builtin = builtins[b]
@@ -237,6 +237,10 @@ codeOut("#define FLASH_TOTAL ("+str(board.chip['flash'])+"*1024)")
 codeOut("");
 if LINUX:
   codeOut('#define RESIZABLE_JSVARS // Allocate variables in blocks using malloc')
+  codeOut("#define FLASH_PAGE_SIZE                 4096 // 'flash' is the espruino.state file")
+  codeOut("#define FLASH_SAVED_CODE_PAGES          4096")
+  codeOut("#define FLASH_SAVED_CODE_LENGTH (FLASH_PAGE_SIZE*FLASH_SAVED_CODE_PAGES)")
+  codeOut("#define FLASH_SAVED_CODE_START 0")
 else:
   codeOut("#define JSVAR_CACHE_SIZE                "+str(variables)+" // Number of JavaScript variables in RAM")
   codeOut("#define FLASH_AVAILABLE_FOR_CODE        "+str(flash_available_for_code))
@@ -270,18 +274,18 @@ codeOut("");
 if LINUX:
   bufferSizeIO = 256
   bufferSizeTX = 256
-  bufferSizeTimer = 16
+  bufferSizeTimer = 64
 else:
   bufferSizeIO = 64 if board.chip["ram"]<20 else 128
   bufferSizeTX = 32 if board.chip["ram"]<20 else 128
-  bufferSizeTimer = 4 if board.chip["ram"]<20 else 16
+  bufferSizeTimer = 4 if board.chip["ram"]<20 else (16 if board.chip["ram"]<64 else 32)
 
 if 'util_timer_tasks' in board.info:
   bufferSizeTimer = board.info['util_timer_tasks']
 
 codeOut("#define IOBUFFERMASK "+str(bufferSizeIO-1)+" // (max 255) amount of items in event buffer - events take ~9 bytes each")
 codeOut("#define TXBUFFERMASK "+str(bufferSizeTX-1)+" // (max 255)")
-codeOut("#define UTILTIMERTASK_TASKS ("+str(bufferSizeTimer)+") // Must be power of 2 - and max 256")
+codeOut("#define UTILTIMERTASK_TASKS ("+str(bufferSizeTimer)+") // Size of the utility timer's task queue (set with util_timer_tasks in the board file)")
 
 codeOut("");
 
@@ -32,8 +32,8 @@ typedef struct {
   unsigned char data;         // data to transmit
 } PACKED_FLAGS TxBufferItem;
 
-TxBufferItem txBuffer[TXBUFFERMASK+1];
-volatile unsigned char txHead=0, txTail=0;
+THREAD_LOCAL TxBufferItem txBuffer[TXBUFFERMASK+1];
+THREAD_LOCAL volatile unsigned char txHead=0, txTail=0;
 
 typedef enum {
   SDS_NONE,
@@ -42,7 +42,7 @@ typedef enum {
   SDS_XOFF_SENT = 4, // sending XON clears this
   SDS_FLOW_CONTROL_XON_XOFF = 8, // flow control enabled
 } PACKED_FLAGS JshSerialDeviceState;
-JshSerialDeviceState jshSerialDeviceStates[USARTS+1];
+THREAD_LOCAL JshSerialDeviceState jshSerialDeviceStates[USARTS+1];
 
 // ----------------------------------------------------------------------------
 
@@ -152,8 +152,8 @@ bool jshHasTransmitData() {
 
 // ----------------------------------------------------------------------------
 //                                                              IO EVENT BUFFER
-IOEvent ioBuffer[IOBUFFERMASK+1];
-volatile unsigned char ioHead=0, ioTail=0;
+THREAD_LOCAL IOEvent ioBuffer[IOBUFFERMASK+1];
+THREAD_LOCAL volatile unsigned char ioHead=0, ioTail=0;
 // ----------------------------------------------------------------------------
 
 
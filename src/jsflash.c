@@ -0,0 +1,423 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Saving and loading compressed snapshots of the JsVars to and from Flash
+ *
+ * The saved state is a JsfHeader followed by pages of compressed JsVars.
+ * Each page holds a range of JsVars, with a JsfPageTrailer at the end of
+ * the page describing it. Unused JsVars are skipped entirely, and each used
+ * JsVar is compressed with literals, runs, and copies from the same bytes
+ * of the previous used JsVar in the page (vars of the same type tend to
+ * look very similar).
+ *
+ * When saving, each page tries to end at the same JsVar as it did last time.
+ * That way a change only alters the pages containing the changed JsVars,
+ * and only those pages get erased and rewritten.
+ * ----------------------------------------------------------------------------
+ */
+#include "jsflash.h"
+#include "jshardware.h"
+#include "jsvar.h"
+#include "jsinteractive.h"
+
+#define JSF_MAGIC 0x4A53464C // 'LFSJ'
+#define JSF_VERSION 1
+
+typedef struct {
+  uint32_t magic;     ///< JSF_MAGIC
+  uint16_t version;   ///< JSF_VERSION
+  uint16_t varSize;   ///< sizeof(JsVar) - we can't load state saved by a build with different JsVars
+  uint32_t varCount;  ///< jsvGetMemoryTotal() when saved
+  uint32_t pageCount; ///< How many pages of JsVars follow
+} JsfHeader;
+
+typedef struct {
+  uint32_t firstVar; ///< The first JsVar in this page
+  uint32_t endVar;   ///< The JsVar after the last one in this page (the first JsVar in the next page)
+  uint32_t length;   ///< Bytes of compressed data at the start of the page (after the JsfHeader in the first page)
+  uint32_t checksum; ///< Checksum of the compressed data
+} JsfPageTrailer;
+
+// Compressed data tokens
+#define JSF_LITERAL     0x00 ///< 0x00-0x7F: n+1 bytes follow
+#define JSF_RUN         0x80 ///< 0x80-0xBF: the next byte is repeated n+JSF_MIN_MATCH times
+#define JSF_COPY        0xC0 ///< 0xC0-0xEF: copy n+JSF_MIN_MATCH bytes from the same place in the previous used JsVar
+#define JSF_SKIP        0xF0 ///< Followed by a varint - the number of unused JsVars
+
+#define JSF_MIN_MATCH   3
+#define JSF_MAX_LITERAL (JSF_RUN-JSF_LITERAL)
+#define JSF_MAX_RUN     (JSF_COPY-JSF_RUN+JSF_MIN_MATCH-1)
+#define JSF_MAX_COPY    (JSF_SKIP-JSF_COPY+JSF_MIN_MATCH-1)
+
+#define JSF_PAGE_SLACK  8  ///< New pages are left 1/JSF_PAGE_SLACK empty
+#define JSF_BUFFER_SIZE 32 ///< Bytes read from/written to flash at once. Must be a power of 2, and divide FLASH_PAGE_SIZE
+
+/// Addresses of the start of a page, its compressed data, and its trailer
+#define JSF_PAGE_ADDR(page) (FLASH_SAVED_CODE_START + (uint32_t)(page)*FLASH_PAGE_SIZE)
+#define JSF_PAGE_DATA(page) (JSF_PAGE_ADDR(page) + (uint32_t)((page)?0:sizeof(JsfHeader)))
+#define JSF_PAGE_TRAILER(page) (JSF_PAGE_ADDR((page)+1) - (uint32_t)sizeof(JsfPageTrailer))
+
+typedef struct {
+  bool write; ///< false = compare with what's in flash and note changed pages, true = write the changed pages
+  uint32_t addr; ///< Address of buf[0]
+  unsigned int bufLen;
+  uint32_t buf[JSF_BUFFER_SIZE/4]; ///< uint32_t so we can program flash from it a word at a time
+  unsigned int page; ///< The page we're writing
+  uint32_t length, checksum; ///< For the current page
+  uint32_t totalLength;
+  uint32_t changedPages[(FLASH_SAVED_CODE_PAGES+31)/32];
+  bool failed; ///< Set if writing to flash failed
+} JsfWriter;
+
+typedef struct {
+  uint32_t addr, end;
+  unsigned int bufIdx, bufLen;
+  unsigned char buf[JSF_BUFFER_SIZE];
+} JsfReader;
+
+static uint32_t jsfChecksum(uint32_t checksum, unsigned char ch) {
+  return ((checksum << 5) + checksum) ^ ch;
+}
+
+static bool jsfIsPageChanged(JsfWriter *w, unsigned int page) {
+  return (w->changedPages[page>>5] & (1U<<(page&31))) != 0;
+}
+
+static void jsfSetPageChanged(JsfWriter *w, unsigned int page) {
+  w->changedPages[page>>5] |= 1U<<(page&31);
+}
+
+static void jsfWriterFlush(JsfWriter *w) {
+  if (!w->bufLen) return;
+  unsigned char *buf = (unsigned char*)w->buf;
+  if (w->write) {
+    if (jsfIsPageChanged(w, w->page)) {
+      unsigned int len = (w->bufLen+3) & ~3U;
+      while (w->bufLen < len) buf[w->bufLen++] = 0xFF; // pad to a word with 'erased' bytes
+      if (!jshFlashWrite(buf, w->addr, len)) w->failed = true;
+    }
+  } else {
+    unsigned char old[JSF_BUFFER_SIZE];
+    jshFlashRead(old, w->addr, w->bufLen);
+    if (memcmp(old, buf, w->bufLen))
+      jsfSetPageChanged(w, w->page);
+  }
+  w->addr += w->bufLen;
+  w->bufLen = 0;
+}
+
+/// Output a byte (or if w==0, just count it)
+static size_t jsfPutByte(JsfWriter *w, unsigned char ch) {
+  if (!w) return 1;
+  ((unsigned char*)w->buf)[w->bufLen++] = ch;
+  w->length++;
+  w->checksum = jsfChecksum(w->checksum, ch);
+  // flush on JSF_BUFFER_SIZE boundaries, so we never cross a page
+  if (((w->addr + w->bufLen) & (JSF_BUFFER_SIZE-1)) == 0)
+    jsfWriterFlush(w);
+  return 1;
+}
+
+static size_t jsfPutLiteral(JsfWriter *w, const unsigned char *data, size_t start, size_t end) {
+  size_t len = 0;
+  while (start < end) {
+    size_t n = end-start;
+    if (n > JSF_MAX_LITERAL) n = JSF_MAX_LITERAL;
+    len += jsfPutByte(w, (unsigned char)(JSF_LITERAL + n - 1));
+    while (n--) len += jsfPutByte(w, data[start++]);
+  }
+  return len;
+}
+
+/** Compress a JsVar, using the previous used JsVar (if there was one) as a dictionary.
+ * Returns the compressed size - if w==0, nothing is output */
+static size_t jsfPutVar(JsfWriter *w, const unsigned char *v, const unsigned char *prev) {
+  size_t i = 0, literalStart = 0, len = 0;
+  while (i < sizeof(JsVar)) {
+    size_t copy = 0, run = 1;
+    if (prev)
+      while (i+copy < sizeof(JsVar) && copy < JSF_MAX_COPY && v[i+copy]==prev[i+copy]) copy++;
+    while (i+run < sizeof(JsVar) && run < JSF_MAX_RUN && v[i+run]==v[i]) run++;
+    if (copy >= JSF_MIN_MATCH || run >= JSF_MIN_MATCH) {
+      len += jsfPutLiteral(w, v, literalStart, i);
+      if (copy >= run) {
+        len += jsfPutByte(w, (unsigned char)(JSF_COPY + copy - JSF_MIN_MATCH));
+        i += copy;
+      } else {
+        len += jsfPutByte(w, (unsigned char)(JSF_RUN + run - JSF_MIN_MATCH));
+        len += jsfPutByte(w, v[i]);
+        i += run;
+      }
+      literalStart = i;
+    } else
+      i++;
+  }
+  return len + jsfPutLiteral(w, v, literalStart, i);
+}
+
+static size_t jsfPutSkip(JsfWriter *w, unsigned int count) {
+  size_t len = jsfPutByte(w, JSF_SKIP);
+  while (count >= 0x80) {
+    len += jsfPutByte(w, (unsigned char)(0x80 | (count&0x7F)));
+    count >>= 7;
+  }
+  return len + jsfPutByte(w, (unsigned char)count);
+}
+
+static bool jsfGetHeader(JsfHeader *header) {
+  jshFlashRead(header, FLASH_SAVED_CODE_START, sizeof(JsfHeader));
+  return header->magic == JSF_MAGIC &&
+         header->version == JSF_VERSION &&
+         header->varSize == sizeof(JsVar) &&
+         header->pageCount <= FLASH_SAVED_CODE_PAGES;
+}
+
+/** Compress all JsVars, page by page. 'oldHeader' is the header of what
+ * is already in flash (or 0). Returns the number of pages used, or 0 if
+ * there wasn't enough space */
+static unsigned int jsfPutState(JsfWriter *w, JsfHeader *oldHeader, JsfHeader *header) {
+  w->totalLength = 0;
+  unsigned int total = jsvGetMemoryTotal();
+  // trailing unused JsVars aren't saved - everything after the last page is cleared on load
+  unsigned int end = total;
+  while (end>0 && (_jsvGetAddressOf((JsVarRef)end)->flags&JSV_VARTYPEMASK) == JSV_UNUSED) end--;
+  end++;
+  unsigned int ref = 1, page = 0;
+  do {
+    if (page >= FLASH_SAVED_CODE_PAGES) return 0; // not enough space
+    // Try and end the page where it ended last time, so following pages don't change
+    JsfPageTrailer trailer, oldTrailer;
+    jshFlashRead(&oldTrailer, JSF_PAGE_TRAILER(page), sizeof(JsfPageTrailer));
+    unsigned int target = end;
+    if (oldHeader && page+1<oldHeader->pageCount && oldTrailer.endVar>ref && oldTrailer.endVar<end)
+      target = oldTrailer.endVar;
+    if (w->write && jsfIsPageChanged(w, page)) {
+      jshFlashErasePage(JSF_PAGE_ADDR(page));
+      if (page==0 && !jshFlashWrite(header, FLASH_SAVED_CODE_START, sizeof(JsfHeader)))
+        w->failed = true;
+    }
+
+    w->page = page;
+    w->addr = JSF_PAGE_DATA(page);
+    w->bufLen = 0;
+    w->length = 0;
+    w->checksum = 0;
+    size_t capacity = JSF_PAGE_TRAILER(page) - JSF_PAGE_DATA(page);
+    // if we're not reusing the old layout, leave some space so the page can grow next time
+    if (target==end) capacity -= capacity / JSF_PAGE_SLACK;
+    trailer.firstVar = ref;
+    unsigned int skip = 0;
+    const unsigned char *prev = 0;
+    while (ref < target) {
+      const unsigned char *v = (const unsigned char*)_jsvGetAddressOf((JsVarRef)ref);
+      if ((((JsVar*)v)->flags&JSV_VARTYPEMASK) == JSV_UNUSED) {
+        skip++;
+        ref++;
+        continue;
+      }
+      if (w->length + (skip?jsfPutSkip(0, skip):0) + jsfPutVar(0, v, prev) > capacity)
+        break; // won't fit - start a new page
+      if (skip) jsfPutSkip(w, skip);
+      skip = 0;
+      jsfPutVar(w, v, prev);
+      prev = v;
+      ref++;
+    }
+    jsfWriterFlush(w);
+    trailer.endVar = ref;
+    trailer.length = w->length;
+    trailer.checksum = w->checksum;
+    w->totalLength += w->length;
+    if (w->write) {
+      if (jsfIsPageChanged(w, page) && !jshFlashWrite(&trailer, JSF_PAGE_TRAILER(page), sizeof(JsfPageTrailer)))
+        w->failed = true;
+    } else if (memcmp(&trailer, &oldTrailer, sizeof(JsfPageTrailer)))
+      jsfSetPageChanged(w, page);
+    page++;
+  } while (ref < end);
+  return page;
+}
+
+static void jsfReaderInit(JsfReader *r, unsigned int page, const JsfPageTrailer *trailer) {
+  r->addr = JSF_PAGE_DATA(page);
+  r->end = r->addr + trailer->length;
+  r->bufIdx = 0;
+  r->bufLen = 0;
+}
+
+/// Get the next byte of compressed data, or -1 if there is no more
+static int jsfGetByte(JsfReader *r) {
+  if (r->bufIdx >= r->bufLen) {
+    if (r->addr >= r->end) return -1;
+    r->bufLen = JSF_BUFFER_SIZE - (r->addr & (JSF_BUFFER_SIZE-1));
+    if (r->bufLen > r->end - r->addr) r->bufLen = (unsigned int)(r->end - r->addr);
+    jshFlashRead(r->buf, r->addr, r->bufLen);
+    r->addr += r->bufLen;
+    r->bufIdx = 0;
+  }
+  return r->buf[r->bufIdx++];
+}
+
+/// Check every page's trailer and checksum
+static bool jsfIsDataValid(const JsfHeader *header) {
+  unsigned int page, ref = 1;
+  for (page=0;page<header->pageCount;page++) {
+    JsfPageTrailer trailer;
+    jshFlashRead(&trailer, JSF_PAGE_TRAILER(page), sizeof(JsfPageTrailer));
+    if (trailer.firstVar!=ref || trailer.endVar<ref || trailer.endVar>header->varCount+1 ||
+        trailer.length > JSF_PAGE_TRAILER(page) - JSF_PAGE_DATA(page))
+      return false;
+    ref = trailer.endVar;
+    JsfReader r;
+    jsfReaderInit(&r, page, &trailer);
+    uint32_t checksum = 0;
+    int ch;
+    while ((ch = jsfGetByte(&r)) >= 0)
+      checksum = jsfChecksum(checksum, (unsigned char)ch);
+    if (checksum != trailer.checksum) return false;
+  }
+  return true;
+}
+
+void jsfSaveToFlash() {
+  JsfWriter w;
+  memset(w.changedPages, 0, sizeof(w.changedPages));
+  w.failed = false;
+  JsfHeader header, oldHeader;
+  bool hasOldHeader = jsfGetHeader(&oldHeader);
+  // First pass - find out how big the data is, and which pages have changed
+  w.write = false;
+  unsigned int pages = jsfPutState(&w, hasOldHeader ? &oldHeader : 0, 0);
+  unsigned int total = jsvGetMemoryTotal();
+  if (!pages) {
+    jsiConsolePrintf("\nNot enough space in flash (%d bytes). Nothing saved.\n", (int)FLASH_SAVED_CODE_LENGTH);
+    return;
+  }
+  jsiConsolePrintf("\nCompressed %d bytes to %d", (int)(total*sizeof(JsVar)), (int)w.totalLength);
+
+  memset(&header, 0, sizeof(header));
+  header.magic = JSF_MAGIC;
+  header.version = JSF_VERSION;
+  header.varSize = (uint16_t)sizeof(JsVar);
+  header.varCount = total;
+  header.pageCount = pages;
+  if (memcmp(&header, &oldHeader, sizeof(JsfHeader)))
+    jsfSetPageChanged(&w, 0);
+
+  unsigned int page, changed = 0;
+  for (page=0;page<pages;page++)
+    if (jsfIsPageChanged(&w, page)) changed++;
+  if (!changed) {
+    jsiConsolePrint("\nNo changes since last save\n");
+    return;
+  }
+  jsiConsolePrintf("\nWriting %d of %d pages...", changed, pages);
+  // Second pass - erase and rewrite only the pages that changed
+  w.write = true;
+  jsfPutState(&w, hasOldHeader ? &oldHeader : 0, &header);
+  if (w.failed) {
+    jsiConsolePrint("\nWriting to flash failed!\n");
+    return;
+  }
+
+  jsiConsolePrint("\nChecking...");
+  if (jsfGetHeader(&oldHeader) && !memcmp(&header, &oldHeader, sizeof(JsfHeader)) && jsfIsDataValid(&header))
+    jsiConsolePrint("\nDone!\n");
+  else
+    jsiConsolePrint("\nSaved data is corrupt!\n");
+}
+
+/// Set JsVars from 'ref' up to (but not including) 'end' as unused
+static void jsfClearVars(unsigned int ref, unsigned int end) {
+  for (;ref<end;ref++) {
+    JsVar *v = _jsvGetAddressOf((JsVarRef)ref);
+    memset(v, 0, sizeof(JsVar));
+    v->flags = JSV_UNUSED;
+  }
+}
+
+/// Decompress one page of JsVars
+static void jsfGetPage(unsigned int page, const JsfPageTrailer *trailer) {
+  JsfReader r;
+  jsfReaderInit(&r, page, trailer);
+  unsigned int ref = trailer->firstVar;
+  size_t idx = 0;
+  unsigned char *v = ref<trailer->endVar ? (unsigned char*)_jsvGetAddressOf((JsVarRef)ref) : 0;
+  const unsigned char *prev = 0;
+  int token;
+  while (v && (token = jsfGetByte(&r)) >= 0) {
+    if (token == JSF_SKIP) {
+      unsigned int count = 0, shift = 0;
+      int ch;
+      do {
+        ch = jsfGetByte(&r);
+        count |= (unsigned int)(ch&0x7F) << shift;
+        shift += 7;
+      } while (ch >= 0x80);
+      if (count > trailer->endVar-ref) count = trailer->endVar-ref;
+      jsfClearVars(ref, ref+count);
+      ref += count;
+      v = ref<trailer->endVar ? (unsigned char*)_jsvGetAddressOf((JsVarRef)ref) : 0;
+      continue;
+    }
+    int n, ch = 0;
+    if (token < JSF_RUN) n = token - JSF_LITERAL + 1;
+    else if (token < JSF_COPY) { n = token - JSF_RUN + JSF_MIN_MATCH; ch = jsfGetByte(&r); }
+    else n = token - JSF_COPY + JSF_MIN_MATCH;
+    while (n-- && v) {
+      if (token < JSF_RUN) ch = jsfGetByte(&r);
+      else if (token >= JSF_COPY) ch = prev ? prev[idx] : 0;
+      v[idx++] = (unsigned char)ch;
+      if (idx >= sizeof(JsVar)) {
+        prev = v;
+        idx = 0;
+        ref++;
+        v = ref<trailer->endVar ? (unsigned char*)_jsvGetAddressOf((JsVarRef)ref) : 0;
+      }
+    }
+  }
+  // anything not in the data was unused
+  jsfClearVars(ref, trailer->endVar);
+}
+
+bool jsfLoadFromFlash() {
+  JsfHeader header;
+  // check everything before we overwrite any variables
+  if (!jsfGetHeader(&header) || !jsfIsDataValid(&header)) {
+    jsiConsolePrint("\nSaved state is corrupt - not loading\n");
+    jsfClearVars(1, jsvGetMemoryTotal()+1);
+    return false;
+  }
+  if (header.varCount > jsvGetMemoryTotal()) {
+#ifdef RESIZABLE_JSVARS
+    jsvSetMemoryTotal(header.varCount);
+#else
+    jsiConsolePrint("\nSaved state has too many variables - not loading\n");
+    jsfClearVars(1, jsvGetMemoryTotal()+1);
+    return false;
+#endif
+  }
+  jsiConsolePrintf("\nLoading %d pages...\n", header.pageCount);
+
+  unsigned int page, ref = 1;
+  for (page=0;page<header.pageCount;page++) {
+    JsfPageTrailer trailer;
+    jshFlashRead(&trailer, JSF_PAGE_TRAILER(page), sizeof(JsfPageTrailer));
+    jsfGetPage(page, &trailer);
+    ref = trailer.endVar;
+  }
+  jsfClearVars(ref, jsvGetMemoryTotal()+1);
+  return true;
+}
+
+bool jsfFlashContainsCode() {
+  JsfHeader header;
+  return jsfGetHeader(&header);
+}
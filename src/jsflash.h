@@ -0,0 +1,26 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Saving and loading compressed snapshots of the JsVars to and from Flash
+ * ----------------------------------------------------------------------------
+ */
+#ifndef JSFLASH_H_
+#define JSFLASH_H_
+
+#include "jsutils.h"
+
+/// Save contents of JsVars into Flash - only the pages that have changed are rewritten
+void jsfSaveToFlash();
+/// Load contents of JsVars from Flash. Returns false (leaving all JsVars unused) if the saved state was invalid
+bool jsfLoadFromFlash();
+/// Returns true if flash contains something useful
+bool jsfFlashContainsCode();
+
+#endif /* JSFLASH_H_ */
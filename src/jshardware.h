@@ -25,6 +25,20 @@
 
 #ifdef LINUX
 #include <inttypes.h>
+/// Write everything sent to the virtual DAC into the given WAV file (closing any open file)
+bool jshWaveformFileOpen(const char *filename, int sampleRate);
+/// Finish writing the WAV file (if one was open)
+void jshWaveformFileClose();
+
+typedef void (*JshWorkerFn)(void *data);
+typedef void (*JshWorkerDoneFn)(void *data, bool cancelled);
+/** Call work(data) on a background thread (for blocking I/O), then done(data, false) from
+ * jshIdle on the thread that queued it. 'work' must not touch any JsVars */
+void jshWorkerQueue(JshWorkerFn work, JshWorkerDoneFn done, void *data);
+/// Are jobs queued from this thread still waiting for their 'done' call?
+bool jshWorkerIsBusy();
+/// Wait for this thread's jobs to finish and call done(data, true) on them - so they only free their data
+void jshWorkerKill();
 #endif
 
 void jshInit();
@@ -224,12 +238,12 @@ void jshI2CWrite(IOEventFlags device, unsigned char address, int nBytes, const u
 void jshI2CRead(IOEventFlags device, unsigned char address, int nBytes, unsigned char *data, bool sendStop);
 
 
-/// Save contents of JsVars into Flash
-void jshSaveToFlash();
-/// Load contents of JsVars from Flash
-void jshLoadFromFlash();
-/// Returns true if flash contains something useful
-bool jshFlashContainsCode();
+/// Erase the flash page containing the address (see FLASH_PAGE_SIZE and FLASH_SAVED_CODE_START)
+void jshFlashErasePage(uint32_t addr);
+/// Read data from flash memory into the buffer
+void jshFlashRead(void *buf, uint32_t addr, uint32_t len);
+/// Write data to flash memory from the buffer. addr and len must be word aligned, and the page must have been erased. Returns false if the write failed
+bool jshFlashWrite(void *buf, uint32_t addr, uint32_t len);
 
 /// Enter simple sleep mode (can be woken up by interrupts). Returns true on success
 bool jshSleep(JsSysTime timeUntilWake);
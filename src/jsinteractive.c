@@ -15,6 +15,7 @@
 #include "jsinteractive.h"
 #include "jshardware.h"
 #include "jstimer.h"
+#include "jsflash.h"
 #include "jswrapper.h"
 #include "jswrap_json.h"
 #include "jswrap_io.h"
@@ -41,26 +42,71 @@ typedef enum {
  IS_HAD_27_91_54,
 } PACKED_FLAGS InputState;
 
-TODOFlags todo = TODO_NOTHING;
-JsVar *events = 0; // Array of events to execute
-JsVarRef timerArray = 0; // Linked List of timers to check and run
-JsVarRef watchArray = 0; // Linked List of input watches to check and run
+/// An event waiting to be executed (see jsiQueueEventInternal)
+typedef struct {
+  JsVarRef func; ///< The function (or string of code) to execute - referenced
+  JsVarRef args[JSI_EVENT_MAX_ARGS]; ///< The arguments to call it with - referenced (0 for undefined)
+  unsigned char argCount;
+} JsiEvent;
+
+THREAD_LOCAL TODOFlags todo = TODO_NOTHING;
+#ifdef RESIZABLE_JSVARS
+THREAD_LOCAL JsiEvent *events = 0; ///< Ring buffer of events to execute (allocated in jsiSoftInit, grows as needed)
+THREAD_LOCAL unsigned int eventsSize = 0; ///< The number of events that will fit in 'events'
+#else
+THREAD_LOCAL JsiEvent events[JSI_EVENT_QUEUE_SIZE]; ///< Ring buffer of events to execute
+#define eventsSize JSI_EVENT_QUEUE_SIZE
+#endif
+THREAD_LOCAL unsigned int eventsFirst = 0; ///< Index in 'events' of the next event to execute
+THREAD_LOCAL unsigned int eventsCount = 0; ///< Number of events waiting to execute
+THREAD_LOCAL JsVarRef timerArray = 0; // Linked List of timers to check and run
+THREAD_LOCAL JsVarRef watchArray = 0; // Linked List of input watches to check and run
+
+/** Native copy of a watch in watchArray, so that pin events can be handled
+ * without looking up every setting by name. The watch object stays the
+ * 'real' copy (it is what gets saved and dumped) - see jsiAddWatch */
+typedef struct {
+  JsVarRef watch; ///< The watch object in watchArray (not referenced - watchArray owns it)
+  JsVarRef capture; ///< ArrayBufferView that edge times are captured into, or 0 (owned by the watch)
+  JsSysTime lastTime; ///< Time of the last edge that was handled
+  JsSysTime captureStart; ///< Time of the first edge in the capture buffer
+  JsVarInt debounce; ///< Debounce time in JsSysTime units, or 0
+  unsigned int captureCount; ///< How many edges are in the capture buffer so far
+  unsigned int captureSize; ///< How many edges fit in the capture buffer
+  Pin pin;
+  unsigned char line; ///< Index of the EXTI line events for this pin arrive on, or JSI_WATCH_NO_LINE
+  signed char edge; ///< 1 = rising, -1 = falling, 0 = both
+  bool recur;
+  bool state; ///< The last state of the pin (for debouncing)
+  bool hasLastTime;
+  bool captureState; ///< The state of the pin at the first captured edge
+} JsiWatch;
+
+#define JSI_WATCH_LINES (EV_EXTI_MAX+1-EV_EXTI0)
+#define JSI_WATCH_NO_LINE JSI_WATCH_LINES
+THREAD_LOCAL JsiWatch watches[JSI_MAX_WATCHES]; ///< Watches, sorted by EXTI line
+THREAD_LOCAL unsigned int watchesCount = 0; ///< Number of watches in 'watches'
+THREAD_LOCAL unsigned int watchesOverflow = 0; ///< Number of watches in watchArray that didn't fit in 'watches' (these are handled from their watch objects instead)
+/// Index of the first watch for each EXTI line - watches for line N are from watchLineStart[N] to watchLineStart[N+1]
+THREAD_LOCAL unsigned int watchLineStart[JSI_WATCH_LINES+2];
+THREAD_LOCAL unsigned char watchesChanged = 0; ///< Incremented whenever 'watches' is modified
 // ----------------------------------------------------------------------------
-IOEventFlags consoleDevice = DEFAULT_CONSOLE_DEVICE; ///< The console device for user interaction
-Pin pinBusyIndicator = DEFAULT_BUSY_PIN_INDICATOR;
-Pin pinSleepIndicator = DEFAULT_SLEEP_PIN_INDICATOR;
-JsiStatus jsiStatus;
-JsSysTime jsiLastIdleTime;  ///< The last time we went around the idle loop - use this for timers
+THREAD_LOCAL IOEventFlags consoleDevice = DEFAULT_CONSOLE_DEVICE; ///< The console device for user interaction
+THREAD_LOCAL Pin pinBusyIndicator = DEFAULT_BUSY_PIN_INDICATOR;
+THREAD_LOCAL Pin pinSleepIndicator = DEFAULT_SLEEP_PIN_INDICATOR;
+THREAD_LOCAL JsiStatus jsiStatus;
+THREAD_LOCAL JsSysTime jsiLastIdleTime;  ///< The last time we went around the idle loop - use this for timers
 // ----------------------------------------------------------------------------
-JsVar *inputLine = 0; ///< The current input line
-JsvStringIterator inputLineIterator; ///< Iterator that points to the end of the input line
-int inputLineLength = -1;
-bool inputLineRemoved = false;
-size_t inputCursorPos = 0; ///< The position of the cursor in the input line
-InputState inputState = 0; ///< state for dealing with cursor keys
-bool hasUsedHistory = false; ///< Used to speed up - if we were cycling through history and then edit, we need to copy the string
-unsigned char loopsIdling; ///< How many times around the loop have we been entirely idle?
-bool interruptedDuringEvent; ///< Were we interrupted while executing an event? If so may want to clear timers
+THREAD_LOCAL JsVar *inputLine = 0; ///< The current input line
+THREAD_LOCAL JsvStringIterator inputLineIterator; ///< Iterator that points to the end of the input line
+THREAD_LOCAL int inputLineLength = -1;
+THREAD_LOCAL bool inputLineRemoved = false;
+THREAD_LOCAL size_t inputCursorPos = 0; ///< The position of the cursor in the input line
+THREAD_LOCAL InputState inputState = 0; ///< state for dealing with cursor keys
+THREAD_LOCAL bool hasUsedHistory = false; ///< Used to speed up - if we were cycling through history and then edit, we need to copy the string
+THREAD_LOCAL unsigned char loopsIdling; ///< How many times around the loop have we been entirely idle?
+THREAD_LOCAL bool interruptedDuringEvent; ///< Were we interrupted while executing an event? If so may want to clear timers
+THREAD_LOCAL int asyncCallbackId = 0; ///< The last id from jsiAddAsyncCallback - never reset, so a stale completion can't call a new callback
 // ----------------------------------------------------------------------------
 
 IOEventFlags jsiGetDeviceFromClass(JsVar *class) {
@@ -341,7 +387,7 @@ void jsiClearInputLine() {
 }
 
 void jsiSetBusy(JsiBusyDevice device, bool isBusy) {
-  static JsiBusyDevice business = 0;
+  static THREAD_LOCAL JsiBusyDevice business = 0;
 
   if (isBusy)
     business |= device;
@@ -357,6 +403,92 @@ void jsiSetSleep(JsiSleepType isSleep) {
     jshPinOutput(pinSleepIndicator, isSleep == JSI_SLEEP_AWAKE);
 }
 
+/// Remove all events from the queue without executing them
+static void jsiClearEvents() {
+  while (eventsCount) {
+    JsiEvent *event = &events[eventsFirst];
+    jsvUnRefRef(event->func);
+    int i;
+    for (i=0;i<event->argCount;i++)
+      if (event->args[i]) jsvUnRefRef(event->args[i]);
+    eventsFirst = (eventsFirst+1) % eventsSize;
+    eventsCount--;
+  }
+  eventsFirst = 0;
+}
+
+/// Called from jsvGarbageCollect - mark everything in the event queue as used
+void jsiGarbageCollectMarkUsed() {
+  unsigned int n;
+  for (n=0;n<eventsCount;n++) {
+    JsiEvent *event = &events[(eventsFirst+n) % eventsSize];
+    jsvGarbageCollectMarkUsedRef(event->func);
+    int i;
+    for (i=0;i<event->argCount;i++)
+      if (event->args[i]) jsvGarbageCollectMarkUsedRef(event->args[i]);
+  }
+}
+
+/// Called from jsvDefragment - update the references to JsVars that we store
+void jsiDefragmentRemapRefs() {
+  unsigned int n;
+  for (n=0;n<eventsCount;n++) {
+    JsiEvent *event = &events[(eventsFirst+n) % eventsSize];
+    event->func = jsvDefragmentRemapRef(event->func);
+    int i;
+    for (i=0;i<event->argCount;i++)
+      event->args[i] = jsvDefragmentRemapRef(event->args[i]);
+  }
+  timerArray = jsvDefragmentRemapRef(timerArray);
+  watchArray = jsvDefragmentRemapRef(watchArray);
+  for (n=0;n<watchesCount;n++) {
+    watches[n].watch = jsvDefragmentRemapRef(watches[n].watch);
+    watches[n].capture = jsvDefragmentRemapRef(watches[n].capture);
+  }
+  jspDefragmentRemapRefs();
+}
+
+/// Defragment JsVars (if it is safe to) - returns false if we couldn't
+static bool jsiDefragment() {
+#ifndef SAVE_ON_FLASH
+  // Waveforms read JsVars directly from the timer IRQ, so they can't be moved
+  if (jstHasBufferChannels()) return false;
+#endif
+  jsvDefragment();
+  return true;
+}
+
+/// Work out which EXTI line events for the given pin will arrive on
+static unsigned char jsiGetWatchLine(Pin pin) {
+  IOEvent event;
+  event.data.time = 0;
+  unsigned char line;
+  for (line=0;line<JSI_WATCH_LINES;line++) {
+    event.flags = (IOEventFlags)(EV_EXTI0+line);
+    if (jshIsEventForPin(&event, pin)) return line;
+  }
+  return JSI_WATCH_NO_LINE;
+}
+
+/// Sort 'watches' by EXTI line (keeping watches on the same line in order) and update watchLineStart
+static void jsiSortWatches() {
+  unsigned int i, j;
+  for (i=0;i<watchesCount;i++)
+    watches[i].line = jsiGetWatchLine(watches[i].pin);
+  // insertion sort - there are few watches, and they're almost always sorted already
+  for (i=1;i<watchesCount;i++) {
+    JsiWatch watch = watches[i];
+    for (j=i; j>0 && watches[j-1].line>watch.line; j--)
+      watches[j] = watches[j-1];
+    watches[j] = watch;
+  }
+  unsigned int line = 0;
+  for (i=0;i<watchesCount;i++)
+    while (line <= watches[i].line) watchLineStart[line++] = i;
+  while (line < JSI_WATCH_LINES+2) watchLineStart[line++] = watchesCount;
+  watchesChanged++;
+}
+
 static JsVarRef _jsiInitNamedArray(const char *name) {
   JsVar *array = jsvObjectGetChild(execInfo.hiddenRoot, name, JSV_ARRAY);
   JsVarRef arrayRef = 0;
@@ -371,7 +503,14 @@ void jsiSoftInit() {
   jswInit();
 
   jsErrorFlags = 0;
-  events = jsvNewWithFlags(JSV_ARRAY);
+#ifdef RESIZABLE_JSVARS
+  if (!events) {
+    eventsSize = JSI_EVENT_QUEUE_SIZE;
+    events = (JsiEvent*)malloc(sizeof(JsiEvent)*eventsSize);
+  }
+#endif
+  eventsFirst = 0;
+  eventsCount = 0;
   inputLine = jsvNewFromEmptyString();
   inputCursorPos = 0;
   jsiInputLineCursorMoved();
@@ -392,6 +531,9 @@ void jsiSoftInit() {
   }
 
   // Check any existing watches and set up interrupts for them
+  watchesCount = 0;
+  watchesOverflow = 0;
+  jsiSortWatches();
   if (watchArray) {
     JsVar *watchArrayPtr = jsvLock(watchArray);
     JsvObjectIterator it;
@@ -400,6 +542,7 @@ void jsiSoftInit() {
       JsVar *watch = jsvObjectIteratorGetValue(&it);
       JsVar *watchPin = jsvObjectGetChild(watch, "pin", 0);
       jshPinWatch(jshGetPinFromVar(watchPin), true);
+      jsiAddWatch(watch);
       jsvUnLock(watchPin);
       jsvUnLock(watch);
       jsvObjectIteratorNext(&it);
@@ -531,30 +674,33 @@ void jsiSoftKill() {
   // Stop all active timer tasks
   jstReset();
   // Unref Watches/etc
-  if (events) {
-    jsvUnLock(events);
-    events=0;
-  }
+  jsiClearEvents();
   if (timerArray) {
     jsvUnRefRef(timerArray);
     timerArray=0;
   }
-  if (watchArray) {
-    // Check any existing watches and disable interrupts for them
+  // Check any existing watches and disable interrupts for them
+  unsigned int i;
+  for (i=0;i<watchesCount;i++)
+    jshPinWatch(watches[i].pin, false);
+  if (watchesOverflow) { // some watches are only in watchArray
     JsVar *watchArrayPtr = jsvLock(watchArray);
     JsvObjectIterator it;
     jsvObjectIteratorNew(&it, watchArrayPtr);
     while (jsvObjectIteratorHasValue(&it)) {
       JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
-      JsVar *watchPin = jsvObjectGetChild(watchPtr, "pin", 0);
-      jshPinWatch(jshGetPinFromVar(watchPin), false);
-      jsvUnLock(watchPin);
+      jshPinWatch(jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0)), false);
       jsvUnLock(watchPtr);
       jsvObjectIteratorNext(&it);
     }
     jsvObjectIteratorFree(&it);
-    jsvUnRef(watchArrayPtr);
     jsvUnLock(watchArrayPtr);
+  }
+  watchesCount = 0;
+  watchesOverflow = 0;
+  jsiSortWatches();
+  if (watchArray) {
+    jsvUnRefRef(watchArray);
     watchArray=0;
   }
   // Save initialisation information
@@ -585,13 +731,14 @@ void jsiInit(bool autoLoad) {
 
   /* If flash contains any code, then we should
      Try and load from it... */
-  bool loadFlash = autoLoad && jshFlashContainsCode();
+  bool loadFlash = autoLoad && jsfFlashContainsCode();
   if (loadFlash) {
     jspSoftKill();
     jsvSoftKill();
-    jshLoadFromFlash();
+    jsfLoadFromFlash();
     jsvSoftInit();
     jspSoftInit();
+    jsvRemoveNamedChild(execInfo.hiddenRoot, JSI_ASYNC_NAME); // nothing is running that could complete these
   }
 
   // Softinit may run initialisation code that will overwrite defaults
@@ -622,6 +769,11 @@ void jsiInit(bool autoLoad) {
 
 void jsiKill() {
   jsiSoftKill();
+#ifdef RESIZABLE_JSVARS
+  free(events);
+  events = 0;
+  eventsSize = 0;
+#endif
 
   jspKill();
 }
@@ -1076,22 +1228,39 @@ void jsiHandleChar(char ch) {
 }
 
 void jsiQueueEventInternal(JsVar *callbackFunc, JsVar **args, int argCount) {
-  assert(argCount<10);
   assert(jsvIsFunction(callbackFunc) || jsvIsString(callbackFunc));
-
-  JsVar *event = jsvNewWithFlags(JSV_OBJECT);
-  if (event) { // Could be out of memory error!
-    jsvUnLock(jsvAddNamedChild(event, callbackFunc, "func"));
-
-    int i;
-    for (i=0;i<argCount;i++) {
-      char argName[5] = "arg#";
-      argName[3] = (char)('0'+i);
-      jsvUnLock(jsvAddNamedChild(event, args[i], argName));
+  if (argCount > JSI_EVENT_MAX_ARGS) {
+    jsWarn("Too many arguments for event - only using %d", JSI_EVENT_MAX_ARGS);
+    argCount = JSI_EVENT_MAX_ARGS;
+  }
+
+  if (eventsCount >= eventsSize) {
+#ifdef RESIZABLE_JSVARS
+    // Double the size of the queue, unwrapping it as we go
+    JsiEvent *newEvents = (JsiEvent*)malloc(sizeof(JsiEvent)*eventsSize*2);
+    if (newEvents) {
+      unsigned int n;
+      for (n=0;n<eventsCount;n++)
+        newEvents[n] = events[(eventsFirst+n) % eventsSize];
+      free(events);
+      events = newEvents;
+      eventsSize *= 2;
+      eventsFirst = 0;
+    }
+#endif
+    if (eventsCount >= eventsSize) {
+      jsErrorFlags |= JSERR_EVENT_QUEUE_FULL;
+      return;
     }
-
-    jsvArrayPushAndUnLock(events, event);
   }
+
+  JsiEvent *event = &events[(eventsFirst+eventsCount) % eventsSize];
+  event->func = jsvGetRef(jsvRef(callbackFunc));
+  event->argCount = (unsigned char)argCount;
+  int i;
+  for (i=0;i<argCount;i++)
+    event->args[i] = args[i] ? jsvGetRef(jsvRef(args[i])) : 0;
+  eventsCount++;
 }
 
 /// Queue a function, string, or array (of funcs/strings) to be executed next time around the idle loop
@@ -1115,6 +1284,37 @@ void jsiQueueEvents(JsVar *callback, JsVar **args, int argCount) { // an array o
   }
 }
 
+int jsiAddAsyncCallback(JsVar *callback) {
+  JsVar *async = jsvObjectGetChild(execInfo.hiddenRoot, JSI_ASYNC_NAME, JSV_ARRAY);
+  if (!async) return 0; // out of memory
+  if (++asyncCallbackId <= 0) asyncCallbackId = 1;
+  int id = asyncCallbackId;
+  JsVar *idVar = jsvNewFromInteger(id);
+  JsVar *name = idVar ? jsvFindChildFromVar(async, idVar, true) : 0;
+  if (name) jsvSetValueOfName(name, callback);
+  else id = 0;
+  jsvUnLock(name);
+  jsvUnLock(idVar);
+  jsvUnLock(async);
+  return id;
+}
+
+void jsiQueueAsyncCallback(int id, JsVar **args, int argCount) {
+  JsVar *async = jsvObjectGetChild(execInfo.hiddenRoot, JSI_ASYNC_NAME, 0);
+  if (!async) return;
+  JsVar *idVar = jsvNewFromInteger(id);
+  JsVar *name = idVar ? jsvFindChildFromVar(async, idVar, false) : 0;
+  if (name) {
+    JsVar *callback = jsvSkipName(name);
+    jsiQueueEvents(callback, args, argCount);
+    jsvUnLock(callback);
+    jsvRemoveChild(async, name);
+    jsvUnLock(name);
+  }
+  jsvUnLock(idVar);
+  jsvUnLock(async);
+}
+
 bool jsiObjectHasCallbacks(JsVar *object, const char *callbackName) {
   JsVar *callback = jsvObjectGetChild(object, callbackName, 0);
   bool hasCallbacks = !jsvIsUndefined(callback);
@@ -1130,34 +1330,34 @@ void jsiQueueObjectCallbacks(JsVar *object, const char *callbackName, JsVar **ar
 }
 
 void jsiExecuteEvents() {
-  bool hasEvents = !jsvArrayIsEmpty(events);
+  bool hasEvents = eventsCount!=0;
   bool wasInterrupted = jspIsInterrupted();
   if (hasEvents) jsiSetBusy(BUSY_INTERACTIVE, true);
-  while (!jsvArrayIsEmpty(events)) {
-    JsVar *event = jsvSkipNameAndUnLock(jsvArrayPopFirst(events));
-    // Get function to execute
-    JsVar *func = jsvObjectGetChild(event, "func", 0);
-    JsVar *args[2];
-    // TODO: make this faster by iterating over the children (and support varying numbers of args)
-    args[0] = jsvObjectGetChild(event, "arg0", 0);
-    args[1] = jsvObjectGetChild(event, "arg1", 0);
-    // free
-    jsvUnLock(event);
-
+  while (eventsCount) {
+    // Take the event off the queue first, as executing it may queue more
+    JsiEvent *event = &events[eventsFirst];
+    JsVar *func = jsvLock(event->func);
+    jsvUnRef(func);
+    JsVar *args[JSI_EVENT_MAX_ARGS];
+    int i, argCount = event->argCount;
+    for (i=0;i<argCount;i++) {
+      args[i] = event->args[i] ? jsvLock(event->args[i]) : 0;
+      if (args[i]) jsvUnRef(args[i]);
+    }
+    eventsFirst = (eventsFirst+1) % eventsSize;
+    eventsCount--;
 
     // now run..
-    if (func) {
-      if (jsvIsFunction(func))
-        jsvUnLock(jspExecuteFunction(func, 0, 2, args));
-      else if (jsvIsString(func))
-        jsvUnLock(jspEvaluateVar(func, 0, false));
-      else 
-        jsError("Unknown type of callback in Event Queue");
-    }
+    if (jsvIsFunction(func))
+      jsvUnLock(jspExecuteFunction(func, 0, argCount, args));
+    else if (jsvIsString(func))
+      jsvUnLock(jspEvaluateVar(func, 0, false));
+    else
+      jsError("Unknown type of callback in Event Queue");
     //jsPrint("Event Done\n");
     jsvUnLock(func);
-    jsvUnLock(args[0]);
-    jsvUnLock(args[1]);
+    for (i=0;i<argCount;i++)
+      jsvUnLock(args[i]);
   }
   if (hasEvents) {
     jsiSetBusy(BUSY_INTERACTIVE, false);
@@ -1203,34 +1403,315 @@ bool jsiHasTimers() {
   JsVar *timerArrayPtr = jsvLock(timerArray);
   bool hasTimers = !jsvArrayIsEmpty(timerArrayPtr);
   jsvUnLock(timerArrayPtr);
+  if (!hasTimers) {
+    JsVar *async = jsvObjectGetChild(execInfo.hiddenRoot, JSI_ASYNC_NAME, 0);
+    hasTimers = async && !jsvArrayIsEmpty(async);
+    jsvUnLock(async);
+  }
   return hasTimers;
 }
 
-/// Is the given watch object meant to be executed when the current value of the pin is pinIsHigh
-bool jsiShouldExecuteWatch(JsVar *watchPtr, bool pinIsHigh) {
-  int watchEdge = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "edge", 0));
-  return watchEdge==0 || // any edge
-         (pinIsHigh && watchEdge>0) || // rising edge
-         (!pinIsHigh && watchEdge<0); // falling edge
-}
-
-bool jsiIsWatchingPin(Pin pin) {
-  bool isWatched = false;
+/// Is the given watch meant to be executed when the current value of the pin is pinIsHigh
+static bool jsiShouldExecuteWatch(JsiWatch *watch, bool pinIsHigh) {
+  return watch->edge==0 || // any edge
+         (pinIsHigh && watch->edge>0) || // rising edge
+         (!pinIsHigh && watch->edge<0); // falling edge
+}
+
+/// Return the index in 'watches' of the given watch object's ref, or -1
+static int jsiFindWatchIndex(JsVarRef watchRef) {
+  unsigned int i;
+  for (i=0;i<watchesCount;i++)
+    if (watches[i].watch == watchRef) return (int)i;
+  return -1;
+}
+
+/// Return the native watch for the given watch object, or 0 if it has been removed
+static JsiWatch *jsiGetWatch(JsVar *watchPtr) {
+  int idx = jsiFindWatchIndex(jsvGetRef(watchPtr));
+  return (idx>=0) ? &watches[idx] : 0;
+}
+
+/** Fill in a native watch from a watch object. Watches that didn't fit in
+ * 'watches' keep their state in the watch object (see jsiSaveWatchState), so
+ * that is loaded too. */
+static void jsiLoadWatch(JsiWatch *watch, JsVar *watchPtr) {
+  watch->watch = jsvGetRef(watchPtr);
+  watch->pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
+  watch->line = jsiGetWatchLine(watch->pin);
+  watch->edge = (signed char)jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "edge", 0));
+  watch->recur = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr, "recur", 0));
+  watch->debounce = jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "debounce", 0));
+  watch->state = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr, "state", 0));
+  JsVar *lastTime = jsvObjectGetChild(watchPtr, "lastTime", 0);
+  watch->hasLastTime = lastTime!=0;
+  watch->lastTime = lastTime ? jshGetTimeFromMilliseconds(jsvGetFloat(lastTime)*1000) : 0;
+  jsvUnLock(lastTime);
+  JsVar *capture = jsvObjectGetChild(watchPtr, "capture", 0);
+  watch->capture = jsvIsArrayBuffer(capture) ? jsvGetRef(capture) : 0;
+  watch->captureSize = watch->capture ? (unsigned int)jsvGetArrayBufferLength(capture) : 0;
+  watch->captureCount = (unsigned int)jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "captureCount", 0));
+  watch->captureStart = (JsSysTime)jsvGetLongIntegerAndUnLock(jsvObjectGetChild(watchPtr, "captureStart", 0));
+  watch->captureState = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr, "captureState", 0));
+  jsvUnLock(capture);
+}
+
+/// Save the state of a watch that isn't in 'watches' back into its watch object
+static void jsiSaveWatchState(JsiWatch *watch, JsVar *watchPtr) {
+  jsvUnLock(jsvObjectSetChild(watchPtr, "state", jsvNewFromBool(watch->state)));
+  if (watch->hasLastTime)
+    jsvUnLock(jsvObjectSetChild(watchPtr, "lastTime", jsvNewFromFloat(jshGetMillisecondsFromTime(watch->lastTime)/1000)));
+  if (watch->capture) {
+    jsvUnLock(jsvObjectSetChild(watchPtr, "captureCount", jsvNewFromInteger((JsVarInt)watch->captureCount)));
+    jsvUnLock(jsvObjectSetChild(watchPtr, "captureStart", jsvNewFromLongInteger(watch->captureStart)));
+    jsvUnLock(jsvObjectSetChild(watchPtr, "captureState", jsvNewFromBool(watch->captureState)));
+  }
+}
+
+/** Return an array of the watch objects that didn't fit in 'watches' which
+ * are for the given pin (or for any pin if pin==PIN_UNDEFINED) */
+static JsVar *jsiGetOverflowWatches(Pin pin) {
+  JsVar *list = jsvNewWithFlags(JSV_ARRAY);
+  if (!list) return 0;
   JsVar *watchArrayPtr = jsvLock(watchArray);
   JsvObjectIterator it;
   jsvObjectIteratorNew(&it, watchArrayPtr);
   while (jsvObjectIteratorHasValue(&it)) {
     JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
-    JsVar *pinVar = jsvObjectGetChild(watchPtr, "pin", 0);
-    if (jshGetPinFromVar(pinVar) == pin)
-      isWatched = true;
-    jsvUnLock(pinVar);
+    if (jsiFindWatchIndex(jsvGetRef(watchPtr))<0 &&
+        (pin==PIN_UNDEFINED || jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0))==pin))
+      jsvArrayPush(list, watchPtr);
     jsvUnLock(watchPtr);
     jsvObjectIteratorNext(&it);
   }
   jsvObjectIteratorFree(&it);
   jsvUnLock(watchArrayPtr);
-  return isWatched;
+  return list;
+}
+
+/// Is the given watch object still in watchArray?
+static bool jsiIsWatchInArray(JsVar *watchPtr) {
+  JsVar *watchArrayPtr = jsvLock(watchArray);
+  JsVar *watchNamePtr = jsvGetArrayIndexOf(watchArrayPtr, watchPtr, true);
+  jsvUnLock(watchArrayPtr);
+  jsvUnLock(watchNamePtr);
+  return watchNamePtr!=0;
+}
+
+/** Return the native watch for the given watch object. If it didn't fit in
+ * 'watches' it's loaded into 'overflowWatch' (and that is returned). Returns 0
+ * if the watch has been removed. */
+static JsiWatch *jsiGetWatchOrLoad(JsVar *watchPtr, JsiWatch *overflowWatch) {
+  JsiWatch *watch = jsiGetWatch(watchPtr);
+  if (!watch && watchesOverflow && jsiIsWatchInArray(watchPtr)) {
+    jsiLoadWatch(overflowWatch, watchPtr);
+    watch = overflowWatch;
+  }
+  return watch;
+}
+
+bool jsiAddWatch(JsVar *watchPtr) {
+  if (watchesCount >= JSI_MAX_WATCHES) {
+    // Full - so this will be handled (more slowly) from watchArray
+    watchesOverflow++;
+    return false;
+  }
+  jsiLoadWatch(&watches[watchesCount++], watchPtr);
+  jsiSortWatches();
+  return true;
+}
+
+void jsiRemoveWatch(JsVar *watchPtr) {
+  Pin pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
+  int idx = jsiFindWatchIndex(jsvGetRef(watchPtr));
+  if (idx>=0) {
+    watchesCount--;
+    memmove(&watches[idx], &watches[idx+1], sizeof(JsiWatch)*(watchesCount-(unsigned int)idx));
+    jsiSortWatches();
+  }
+  JsVar *watchArrayPtr = jsvLock(watchArray);
+  JsVar *watchNamePtr = jsvGetArrayIndexOf(watchArrayPtr, watchPtr, true);
+  if (watchNamePtr) {
+    if (idx<0 && watchesOverflow) watchesOverflow--;
+    jsvRemoveChild(watchArrayPtr, watchNamePtr);
+    jsvUnLock(watchNamePtr);
+  }
+  jsvUnLock(watchArrayPtr);
+  // Now check if this pin is still being watched
+  if (!jsiIsWatchingPin(pin))
+    jshPinWatch(pin, false); // 'unwatch' pin
+}
+
+void jsiRemoveAllWatches() {
+  unsigned int i;
+  for (i=0;i<watchesCount;i++)
+    jshPinWatch(watches[i].pin, false);
+  JsVar *list = watchesOverflow ? jsiGetOverflowWatches(PIN_UNDEFINED) : 0;
+  if (list) {
+    JsvObjectIterator it;
+    jsvObjectIteratorNew(&it, list);
+    while (jsvObjectIteratorHasValue(&it)) {
+      JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
+      jshPinWatch(jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0)), false);
+      jsvUnLock(watchPtr);
+      jsvObjectIteratorNext(&it);
+    }
+    jsvObjectIteratorFree(&it);
+    jsvUnLock(list);
+  }
+  watchesCount = 0;
+  watchesOverflow = 0;
+  jsiSortWatches();
+  JsVar *watchArrayPtr = jsvLock(watchArray);
+  jsvRemoveAllChildren(watchArrayPtr);
+  jsvUnLock(watchArrayPtr);
+}
+
+bool jsiIsWatchingPin(Pin pin) {
+  unsigned int i;
+  for (i=0;i<watchesCount;i++)
+    if (watches[i].pin == pin)
+      return true;
+  if (watchesOverflow) {
+    JsVar *list = jsiGetOverflowWatches(pin);
+    bool isWatched = list && !jsvArrayIsEmpty(list);
+    jsvUnLock(list);
+    return isWatched;
+  }
+  return false;
+}
+
+/** Execute a watch's callback with the given data, then remove the watch if it
+ * doesn't repeat (or if it failed). This executes JS, so 'watches' may have
+ * changed afterwards. */
+static void jsiExecuteWatchCallback(JsiWatch *watch, JsVar *data) {
+  JsVar *watchPtr = jsvLock(watch->watch);
+  JsVar *watchCallback = jsvObjectGetChild(watchPtr, "callback", 0);
+  bool watchRecurring = watch->recur;
+  if (!jsiExecuteEventCallback(watchCallback, data, 0) && watchRecurring) {
+    jsError("Error processing Watch - removing it.");
+    jsErrorFlags |= JSERR_CALLBACK;
+    watchRecurring = false;
+  }
+  if (!watchRecurring)
+    jsiRemoveWatch(watchPtr);
+  jsvUnLock(watchCallback);
+  jsvUnLock(watchPtr);
+}
+
+/// Add an edge to a watch's capture buffer, and call the watch's callback if the buffer is full
+static void jsiCaptureWatchEdge(JsiWatch *watch, JsSysTime eventTime, bool pinIsHigh) {
+  if (!watch->captureCount) {
+    watch->captureStart = eventTime;
+    watch->captureState = pinIsHigh;
+  }
+  JsVar *capture = jsvLock(watch->capture);
+  JsvArrayBufferIterator it;
+  jsvArrayBufferIteratorNew(&it, capture, watch->captureCount);
+  // time since the first edge, in microseconds
+  jsvArrayBufferIteratorSetIntegerValue(&it, (JsVarInt)(jshGetMillisecondsFromTime(eventTime - watch->captureStart)*1000));
+  jsvArrayBufferIteratorFree(&it);
+  if (++watch->captureCount >= watch->captureSize) {
+    watch->captureCount = 0;
+    JsVar *data = jsvNewWithFlags(JSV_OBJECT);
+    if (data) {
+      jsvUnLock(jsvObjectSetChild(data, "time", jsvNewFromFloat(jshGetMillisecondsFromTime(watch->captureStart)/1000)));
+      jsvUnLock(jsvObjectSetChild(data, "pin", jsvNewFromPin(watch->pin)));
+      jsvUnLock(jsvObjectSetChild(data, "state", jsvNewFromBool(watch->captureState)));
+      jsvObjectSetChild(data, "data", capture); // no unlock
+    }
+    jsiExecuteWatchCallback(watch, data);
+    jsvUnLock(data);
+  }
+  jsvUnLock(capture);
+}
+
+/// Handle an edge on a watch's pin. This may execute JS, so 'watches' may have changed afterwards.
+static void jsiHandleWatchEvent(JsiWatch *watch, JsSysTime eventTime, bool pinIsHigh) {
+  if (watch->capture) {
+    if (jsiShouldExecuteWatch(watch, pinIsHigh))
+      jsiCaptureWatchEdge(watch, eventTime, pinIsHigh);
+    return;
+  }
+
+  bool executeNow = false;
+  if (watch->debounce<=0) {
+    executeNow = true;
+  } else { // Debouncing - use timeouts to ensure we only fire at the right time
+    // store the current state of the pin
+    bool oldWatchState = watch->state;
+    watch->state = pinIsHigh;
+
+    JsVar *watchPtr = jsvLock(watch->watch);
+    JsVar *timeout = jsvObjectGetChild(watchPtr, "timeout", 0);
+    if (timeout) { // if we had a timeout, update the callback time
+      JsSysTime timeoutTime = jsiLastIdleTime + (JsSysTime)jsvGetIntegerAndUnLock(jsvObjectGetChild(timeout, "time", 0));
+      jsvUnLock(jsvObjectSetChild(timeout, "time", jsvNewFromInteger((JsVarInt)(eventTime - jsiLastIdleTime) + watch->debounce)));
+      if (eventTime > timeoutTime) {
+        // timeout should have fired, but we didn't get around to executing it!
+        // Do it now (with the old timeout time)
+        executeNow = true;
+        eventTime = timeoutTime - watch->debounce;
+        pinIsHigh = oldWatchState;
+      }
+    } else { // else create a new timeout
+      timeout = jsvNewWithFlags(JSV_OBJECT);
+      if (timeout) {
+        jsvObjectSetChild(timeout, "watch", watchPtr); // no unlock
+        jsvUnLock(jsvObjectSetChild(timeout, "time", jsvNewFromInteger((JsVarInt)(eventTime - jsiLastIdleTime) + watch->debounce)));
+        jsvUnLock(jsvObjectSetChild(timeout, "callback", jsvObjectGetChild(watchPtr, "callback", 0)));
+        jsvUnLock(jsvObjectSetChild(timeout, "pin", jsvNewFromPin(watch->pin)));
+        // Add to timer array
+        jsiTimerAdd(timeout);
+        // Add to our watch
+        jsvObjectSetChild(watchPtr, "timeout", timeout); // no unlock
+      }
+    }
+    jsvUnLock(timeout);
+    jsvUnLock(watchPtr);
+  }
+
+  // If we want to execute this watch right now...
+  if (executeNow) {
+    bool hadLastTime = watch->hasLastTime;
+    JsSysTime lastTime = watch->lastTime;
+    watch->lastTime = eventTime;
+    watch->hasLastTime = true;
+    if (jsiShouldExecuteWatch(watch, pinIsHigh)) { // edge triggering
+      JsVar *data = jsvNewWithFlags(JSV_OBJECT);
+      if (data) {
+        if (hadLastTime)
+          jsvUnLock(jsvObjectSetChild(data, "lastTime", jsvNewFromFloat(jshGetMillisecondsFromTime(lastTime)/1000)));
+        jsvUnLock(jsvObjectSetChild(data, "time", jsvNewFromFloat(jshGetMillisecondsFromTime(eventTime)/1000)));
+        jsvUnLock(jsvObjectSetChild(data, "pin", jsvNewFromPin(watch->pin)));
+        jsvUnLock(jsvObjectSetChild(data, "state", jsvNewFromBool(pinIsHigh)));
+      }
+      jsiExecuteWatchCallback(watch, data);
+      jsvUnLock(data);
+    }
+  }
+}
+
+/// Handle a pin event for the watches that didn't fit in 'watches' (slower, as they're read from their watch objects)
+static void jsiHandleOverflowWatchEvents(IOEvent *event, JsSysTime eventTime, bool pinIsHigh) {
+  // Copy the list first, as callbacks may add or remove watches
+  JsVar *list = jsiGetOverflowWatches(PIN_UNDEFINED);
+  if (!list) return;
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, list);
+  while (jsvObjectIteratorHasValue(&it)) {
+    JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
+    JsiWatch watch;
+    jsiLoadWatch(&watch, watchPtr);
+    if (jshIsEventForPin(event, watch.pin) && jsiIsWatchInArray(watchPtr)) {
+      jsiHandleWatchEvent(&watch, eventTime, pinIsHigh);
+      jsiSaveWatchState(&watch, watchPtr);
+    }
+    jsvUnLock(watchPtr);
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+  jsvUnLock(list);
 }
 
 void jsiHandleIOEventForUSART(JsVar *usartClass, IOEvent *event) {
@@ -1301,110 +1782,40 @@ void jsiIdle() {
       }
       jsvUnLock(usartClass);
     } else if (DEVICE_IS_EXTI(eventType)) { // ---------------------------------------------------------------- PIN WATCH
-      // we have an event... find out what it was for...
-      // Check everything in our Watch array
-      JsVar *watchArrayPtr = jsvLock(watchArray);
-      JsvObjectIterator it;
-      jsvObjectIteratorNew(&it, watchArrayPtr);
-      while (jsvObjectIteratorHasValue(&it)) {
-        bool hasDeletedWatch = false;
-        JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
-        Pin pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
-
-        if (jshIsEventForPin(&event, pin)) {
-          /** Work out event time. Events time is only stored in 32 bits, so we need to
-           * use the correct 'high' 32 bits from the current time.
-           *
-           * We know that the current time is always newer than the event time, so
-           * if the bottom 32 bits of the current time is less than the bottom
-           * 32 bits of the event time, we need to subtract a full 32 bits worth
-           * from the current time.
-           */
-          JsSysTime time = jshGetSystemTime();
-          if (((unsigned int)time) < (unsigned int)event.data.time)
-            time = time - 0x100000000LL;
-          // finally, mask in the event's time
-          JsSysTime eventTime = (time & ~0xFFFFFFFFLL) | (JsSysTime)event.data.time;
-
-          // Now actually process the event
-          bool pinIsHigh = (event.flags&EV_EXTI_IS_HIGH)!=0;
-
-          bool executeNow = false;
-          JsVarInt debounce = jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "debounce", 0));
-          if (debounce<=0) {
-            executeNow = true;
-          } else { // Debouncing - use timeouts to ensure we only fire at the right time
-            // store the current state of the pin
-            bool oldWatchState = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr, "state",0));
-            jsvUnLock(jsvObjectSetChild(watchPtr, "state", jsvNewFromBool(pinIsHigh)));
-
-            JsVar *timeout = jsvObjectGetChild(watchPtr, "timeout", 0);
-            if (timeout) { // if we had a timeout, update the callback time
-              JsSysTime timeoutTime = jsiLastIdleTime + (JsSysTime)jsvGetIntegerAndUnLock(jsvObjectGetChild(timeout, "time", 0));
-              jsvUnLock(jsvObjectSetChild(timeout, "time", jsvNewFromInteger((JsVarInt)(eventTime - jsiLastIdleTime) + debounce)));
-              if (eventTime > timeoutTime) {
-                // timeout should have fired, but we didn't get around to executing it!
-                // Do it now (with the old timeout time)
-                executeNow = true;
-                eventTime = timeoutTime - debounce;
-                pinIsHigh = oldWatchState;
-              }
-            } else { // else create a new timeout
-              timeout = jsvNewWithFlags(JSV_OBJECT);
-              if (timeout) {
-                jsvObjectSetChild(timeout, "watch", watchPtr); // no unlock
-                jsvUnLock(jsvObjectSetChild(timeout, "time", jsvNewFromInteger((JsVarInt)(eventTime - jsiLastIdleTime) + debounce)));
-                jsvUnLock(jsvObjectSetChild(timeout, "callback", jsvObjectGetChild(watchPtr, "callback", 0)));
-                jsvUnLock(jsvObjectSetChild(timeout, "lastTime", jsvObjectGetChild(watchPtr, "lastTime", 0)));
-                jsvUnLock(jsvObjectSetChild(timeout, "pin", jsvNewFromPin(pin)));
-                // Add to timer array
-                jsiTimerAdd(timeout);
-                // Add to our watch
-                jsvObjectSetChild(watchPtr, "timeout", timeout); // no unlock
-              }
-            }
-            jsvUnLock(timeout);
-          }
-
-          // If we want to execute this watch right now...
-          if (executeNow) {
-            JsVar *timePtr = jsvNewFromFloat(jshGetMillisecondsFromTime(eventTime)/1000);
-            if (jsiShouldExecuteWatch(watchPtr, pinIsHigh)) { // edge triggering
-              JsVar *watchCallback = jsvObjectGetChild(watchPtr, "callback", 0);
-              bool watchRecurring = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr,  "recur", 0));
-              JsVar *data = jsvNewWithFlags(JSV_OBJECT);
-              if (data) {
-                jsvUnLock(jsvObjectSetChild(data, "lastTime", jsvObjectGetChild(watchPtr, "lastTime", 0)));
-                // set both data.time, and watch.lastTime in one go
-                jsvObjectSetChild(data, "time", timePtr); // no unlock
-                jsvUnLock(jsvObjectSetChild(data, "pin", jsvNewFromPin(pin)));
-                jsvUnLock(jsvObjectSetChild(data, "state", jsvNewFromBool(pinIsHigh)));
-              }
-              if (!jsiExecuteEventCallback(watchCallback, data, 0) && watchRecurring) {
-                jsError("Error processing Watch - removing it.");
-                jsErrorFlags |= JSERR_CALLBACK;
-                watchRecurring = false;
-              }
-              jsvUnLock(data);
-              if (!watchRecurring) {
-                // free all
-                jsvObjectIteratorRemoveAndGotoNext(&it, watchArrayPtr);
-                hasDeletedWatch = true;
-                if (!jsiIsWatchingPin(pin))
-                  jshPinWatch(pin, false);
-              }
-              jsvUnLock(watchCallback);
-            }
-            jsvUnLock(jsvObjectSetChild(watchPtr, "lastTime", timePtr));
-          }
+      /** Work out event time. Events time is only stored in 32 bits, so we need to
+       * use the correct 'high' 32 bits from the current time.
+       *
+       * We know that the current time is always newer than the event time, so
+       * if the bottom 32 bits of the current time is less than the bottom
+       * 32 bits of the event time, we need to subtract a full 32 bits worth
+       * from the current time.
+       */
+      JsSysTime time = jshGetSystemTime();
+      if (((unsigned int)time) < (unsigned int)event.data.time)
+        time = time - 0x100000000LL;
+      // finally, mask in the event's time
+      JsSysTime eventTime = (time & ~0xFFFFFFFFLL) | (JsSysTime)event.data.time;
+      bool pinIsHigh = (event.flags&EV_EXTI_IS_HIGH)!=0;
+
+      // Now check every watch for this EXTI line
+      unsigned int line = (unsigned int)(eventType - EV_EXTI0);
+      unsigned int i = watchLineStart[line];
+      while (i < watchLineStart[line+1]) {
+        JsiWatch *watch = &watches[i++];
+        if (!jshIsEventForPin(&event, watch->pin)) continue;
+        // remember where we were, in case the callback adds or removes watches
+        unsigned char changed = watchesChanged;
+        JsVarRef nextWatch = (i < watchLineStart[line+1]) ? watches[i].watch : 0;
+        jsiHandleWatchEvent(watch, eventTime, pinIsHigh);
+        if (watchesChanged != changed) {
+          int idx = nextWatch ? jsiFindWatchIndex(nextWatch) : -1;
+          if (idx<0) break;
+          i = (unsigned int)idx;
         }
-
-        jsvUnLock(watchPtr);
-        if (!hasDeletedWatch)
-          jsvObjectIteratorNext(&it);
       }
-      jsvObjectIteratorFree(&it);
-      jsvUnLock(watchArrayPtr);
+      // Watches that didn't fit in 'watches' are handled from their watch objects
+      if (watchesOverflow)
+        jsiHandleOverflowWatchEvents(&event, eventTime, pinIsHigh);
     }
   }
 
@@ -1443,21 +1854,27 @@ void jsiIdle() {
       JsVar *data = jsvNewWithFlags(JSV_OBJECT);
       if (data) {
         // if we were from a watch then we were delayed by the debounce time...
+        JsiWatch overflowWatch;
+        JsiWatch *watch = watchPtr ? jsiGetWatchOrLoad(watchPtr, &overflowWatch) : 0;
         JsVarInt delay = 0;
-        if (watchPtr)
-          delay = jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "debounce", 0));
-        // Create the 'time' variable that will be passed to the user
-        JsVar *timePtr = jsvNewFromFloat(jshGetMillisecondsFromTime(jsiLastIdleTime+timeUntilNext-delay)/1000);
+        if (watch)
+          delay = watch->debounce;
+        JsSysTime eventTime = jsiLastIdleTime+timeUntilNext-delay;
         // if it was a watch, set the last state up
-        if (watchPtr) {
-          bool state = jsvGetBoolAndUnLock(jsvObjectSetChild(data, "state", jsvObjectGetChild(watchPtr, "state", 0)));
-          exec = jsiShouldExecuteWatch(watchPtr, state);
+        if (watch) {
+          jsvUnLock(jsvObjectSetChild(data, "state", jsvNewFromBool(watch->state)));
+          exec = jsiShouldExecuteWatch(watch, watch->state);
           // set up the lastTime variable of data to what was in the watch
-          jsvUnLock(jsvObjectSetChild(data, "lastTime", jsvObjectGetChild(watchPtr, "lastTime", 0)));
+          if (watch->hasLastTime)
+            jsvUnLock(jsvObjectSetChild(data, "lastTime", jsvNewFromFloat(jshGetMillisecondsFromTime(watch->lastTime)/1000)));
           // set up the watches lastTime to this one
-          jsvObjectSetChild(watchPtr, "lastTime", timePtr); // don't unlock
+          watch->lastTime = eventTime;
+          watch->hasLastTime = true;
+          if (watch == &overflowWatch)
+            jsiSaveWatchState(watch, watchPtr);
         }
-        jsvUnLock(jsvObjectSetChild(data, "time", timePtr));
+        // Create the 'time' variable that will be passed to the user
+        jsvUnLock(jsvObjectSetChild(data, "time", jsvNewFromFloat(jshGetMillisecondsFromTime(eventTime)/1000)));
       }
       JsVar *interval = jsvObjectGetChild(timerPtr, "interval", 0);
       if (exec) {
@@ -1471,19 +1888,10 @@ void jsiIdle() {
         jsvObjectSetChild(watchPtr, "timeout", 0);
         // Deal with non-recurring watches
         if (exec) {
-          bool watchRecurring = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr,  "recur", 0));
-          if (!watchRecurring) {
-            JsVar *watchArrayPtr = jsvLock(watchArray);
-            JsVar *watchNamePtr = jsvGetArrayIndexOf(watchArrayPtr, watchPtr, true);
-            if (watchNamePtr) {
-              jsvRemoveChild(watchArrayPtr, watchNamePtr);
-              jsvUnLock(watchNamePtr);
-            }
-            jsvUnLock(watchArrayPtr);
-            Pin pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
-            if (!jsiIsWatchingPin(pin))
-              jshPinWatch(pin, false);
-          }
+          JsiWatch overflowWatch;
+          JsiWatch *watch = jsiGetWatchOrLoad(watchPtr, &overflowWatch);
+          if (watch && !watch->recur)
+            jsiRemoveWatch(watchPtr);
         }
         jsvUnLock(watchPtr);
       }
@@ -1515,7 +1923,7 @@ void jsiIdle() {
   if (jswIdle()) wasBusy = true;
 
   // Just in case we got any events to do and didn't clear loopsIdling before
-  if (wasBusy || !jsvArrayIsEmpty(events) )
+  if (wasBusy || eventsCount)
     loopsIdling = 0;
 
   if (wasBusy)
@@ -1548,10 +1956,11 @@ void jsiIdle() {
       todo &= (TODOFlags)~TODO_FLASH_SAVE;
 
       jsvGarbageCollect(); // nice to have everything all tidy!
+      jsiDefragment(); // ...and together, so the saved state compresses better
       jsiSoftKill();
       jspSoftKill();
       jsvSoftKill();
-      jshSaveToFlash();
+      jsfSaveToFlash();
       jshReset();
       jsvSoftInit();
       jspSoftInit();
@@ -1564,21 +1973,30 @@ void jsiIdle() {
       jspSoftKill();
       jsvSoftKill();
       jshReset();
-      jshLoadFromFlash();
+      jsfLoadFromFlash();
       jsvSoftInit();
       jspSoftInit();
+      jsvRemoveNamedChild(execInfo.hiddenRoot, JSI_ASYNC_NAME); // nothing is running that could complete these
       jsiSoftInit();
     }
+    if (todo & TODO_DEFRAG) {
+      todo &= (TODOFlags)~TODO_DEFRAG;
+      jsvGarbageCollect();
+      if (!jsiDefragment())
+        jsWarn("Can't defragment memory while Waveforms are running");
+    }
     jsiSetBusy(BUSY_INTERACTIVE, false);
   }
 
   /* if we've been around this loop, there is nothing to do, and
    * we have a spare 10ms then let's do some Garbage Collection
-   * just in case. */
+   * just in case - and if memory has got fragmented, tidy it up. */
   if (loopsIdling==1 &&
       minTimeUntilNext > jshGetTimeFromMilliseconds(10)) {
     jsiSetBusy(BUSY_INTERACTIVE, true);
     jsvGarbageCollect();
+    if (jsvIsFragmented())
+      jsiDefragment();
     jsiSetBusy(BUSY_INTERACTIVE, false);
   }
   // Go to sleep!
@@ -1767,6 +2185,12 @@ void jsiDumpState() {
                      (watchEdge<0)?"falling":((watchEdge>0)?"rising":"both"));
     if (watchDebounce>0)
       jsiConsolePrintf(", debounce : %f", jshGetMillisecondsFromTime(watchDebounce));
+    JsVar *watchCapture = jsvObjectGetChild(watch, "capture", 0);
+    if (watchCapture) {
+      jsiConsolePrint(", capture : ");
+      jsiDumpJSON(watchCapture, 0);
+      jsvUnLock(watchCapture);
+    }
     jsiConsolePrint(" });\n");
     jsvUnLock(watchPin);
     jsvUnLock(watchCallback);
@@ -22,6 +22,23 @@
 #define JSI_HISTORY_NAME "history"
 #define JSI_INIT_CODE_NAME "init"
 #define JSI_ONINIT_NAME "onInit"
+#define JSI_ASYNC_NAME "async" ///< Callbacks waiting for asynchronous operations to complete
+
+#ifndef JSI_EVENT_QUEUE_SIZE
+#ifdef SAVE_ON_FLASH
+#define JSI_EVENT_QUEUE_SIZE 16 ///< Number of events that can be waiting to execute (the initial size if RESIZABLE_JSVARS)
+#else
+#define JSI_EVENT_QUEUE_SIZE 64 ///< Number of events that can be waiting to execute (the initial size if RESIZABLE_JSVARS)
+#endif
+#endif
+#define JSI_EVENT_MAX_ARGS 4 ///< Maximum number of arguments that can be passed to a queued event
+#ifndef JSI_MAX_WATCHES
+#ifdef SAVE_ON_FLASH
+#define JSI_MAX_WATCHES 8 ///< Number of setWatch watches handled natively - any more are handled (more slowly) from their watch objects
+#else
+#define JSI_MAX_WATCHES 16 ///< Number of setWatch watches handled natively - any more are handled (more slowly) from their watch objects
+#endif
+#endif
 
 /// autoLoad = do we load the current state if it exists?
 void jsiInit(bool autoLoad);
@@ -32,8 +49,12 @@ bool jsiLoop();
 
 /// Tries to get rid of some memory (by clearing command history). Returns true if it got rid of something, false if it didn't.
 bool jsiFreeMoreMemory();
+/// Called from jsvGarbageCollect - mark variables that are only referenced from C code as used
+void jsiGarbageCollectMarkUsed();
+/// Called from jsvDefragment - update JsVarRefs that are stored in C code using jsvDefragmentRemapRef
+void jsiDefragmentRemapRefs();
 
-bool jsiHasTimers(); // are there timers still left to run?
+bool jsiHasTimers(); // are there timers (or asynchronous callbacks) still left to run?
 bool jsiIsWatchingPin(Pin pin); // are there any watches for the given pin?
 
 
@@ -41,6 +62,10 @@ void jsiHandleIOEventForUSART(JsVar *usartClass, IOEvent *event); ///< Called fr
 
 /// Queue a function, string, or array (of funcs/strings) to be executed next time around the idle loop
 void jsiQueueEvents(JsVar *callback, JsVar **args, int argCount);
+/// Remember a callback until an asynchronous operation completes. Returns an id for jsiQueueAsyncCallback (or 0 if out of memory)
+int jsiAddAsyncCallback(JsVar *callback);
+/// Queue the callback remembered with the given id (if it still exists - it won't after a reset) and forget it
+void jsiQueueAsyncCallback(int id, JsVar **args, int argCount);
 /// Return true if the object has callbacks...
 bool jsiObjectHasCallbacks(JsVar *object, const char *callbackName);
 /// Queue up callbacks for other things (touchscreen? network?)
@@ -103,6 +128,7 @@ typedef enum {
  TODO_FLASH_SAVE = 1,
  TODO_FLASH_LOAD = 2,
  TODO_RESET = 4,
+ TODO_DEFRAG = 8,
 } TODOFlags;
 #define USART_CALLBACK_NAME "#ondata"
 #define USART_BAUDRATE_NAME "_baudrate"
@@ -117,20 +143,23 @@ typedef enum {
   JSIS_ECHO_OFF_MASK = JSIS_ECHO_OFF|JSIS_ECHO_OFF_FOR_LINE
 } PACKED_FLAGS JsiStatus;
 
-extern JsiStatus jsiStatus;
+extern THREAD_LOCAL JsiStatus jsiStatus;
 bool jsiEcho();
 
-extern Pin pinBusyIndicator;
-extern Pin pinSleepIndicator;
-extern JsSysTime jsiLastIdleTime; ///< The last time we went around the idle loop - use this for timers
+extern THREAD_LOCAL Pin pinBusyIndicator;
+extern THREAD_LOCAL Pin pinSleepIndicator;
+extern THREAD_LOCAL JsSysTime jsiLastIdleTime; ///< The last time we went around the idle loop - use this for timers
 
 void jsiDumpState();
 void jsiSetTodo(TODOFlags newTodo);
 #define TIMER_MIN_INTERVAL 0.1 // in milliseconds
-extern JsVarRef timerArray; // Linked List of timers to check and run
-extern JsVarRef watchArray; // Linked List of input watches to check and run
+extern THREAD_LOCAL JsVarRef timerArray; // Linked List of timers to check and run
+extern THREAD_LOCAL JsVarRef watchArray; // Linked List of input watches to check and run
 
 extern JsVarInt jsiTimerAdd(JsVar *timerPtr);
+extern bool jsiAddWatch(JsVar *watchPtr); ///< Add a watch object (already in watchArray) to the native watch table. If it's full, returns false and the watch is handled from watchArray instead
+extern void jsiRemoveWatch(JsVar *watchPtr); ///< Remove a watch from watchArray and stop watching its pin if it's unused
+extern void jsiRemoveAllWatches(); ///< Remove all watches and stop watching their pins
 // end for jswrap_interactive/io.c ------------------------------------------------
 
 
@@ -60,16 +60,6 @@ static inline void jslTokenAppendChar(JsLex *lex, char ch) {
   }
 }
 
-static bool jslIsToken(JsLex *lex, const char *token, int startOffset) {
-  int i;
-  for (i=startOffset;i<lex->tokenl;i++) {
-    if (lex->token[i]!=token[i]) return false;
-    // if token is smaller than lex->token, there will be a null char
-    // which will be different from the token
-  }
-  return token[lex->tokenl] == 0; // only match if token ends now
-}
-
 typedef enum {
   JSLJT_ID,
   JSLJT_NUMBER,
@@ -88,134 +78,203 @@ typedef enum {
   JSLJT_LESSTHAN,
   JSLJT_EQUAL,
   JSLJT_GREATERTHAN,
+  JSLJT_TOKENISED, ///< 128 and above - maybe a reserved word/operator from jslNewTokenisedStringFromLexer
 } PACKED_FLAGS jslJumpTableEnum;
 
-#define jslJumpTableStart 33 // '!' - the first handled character
-#define jslJumpTableEnd 124 // '|' - the last handled character
-const jslJumpTableEnum jslJumpTable[jslJumpTableEnd+1-jslJumpTableStart] = {
-    // 33
-    JSLJT_EXCLAMATION, // !
-    JSLJT_STRING, // "
-    JSLJT_SINGLECHAR, // #
-    JSLJT_ID, // $
-    JSLJT_PERCENT, // %
-    JSLJT_AND, // &
-    JSLJT_STRING, // '
-    JSLJT_SINGLECHAR, // (
-    JSLJT_SINGLECHAR, // )
-    JSLJT_STAR, // *
-    JSLJT_PLUS, // +
-    JSLJT_SINGLECHAR, // ,
-    JSLJT_MINUS, // -
-    JSLJT_NUMBER, // . - special :/
-    JSLJT_FORWARDSLASH, // /
-    // 48
-    JSLJT_NUMBER, // 0
-    JSLJT_NUMBER, // 1
-    JSLJT_NUMBER, // 2
-    JSLJT_NUMBER, // 3
-    JSLJT_NUMBER, // 4
-    JSLJT_NUMBER, // 5
-    JSLJT_NUMBER, // 6
-    JSLJT_NUMBER, // 7
-    JSLJT_NUMBER, // 8
-    JSLJT_NUMBER, // 9
-    JSLJT_SINGLECHAR, // :
-    JSLJT_SINGLECHAR, // ;
-    JSLJT_LESSTHAN, // <
-    JSLJT_EQUAL, // =
-    JSLJT_GREATERTHAN, // >
-    JSLJT_SINGLECHAR, // ?
-    // 64
-    JSLJT_SINGLECHAR, // @
-    JSLJT_ID, // A
-    JSLJT_ID, // B
-    JSLJT_ID, // C
-    JSLJT_ID, // D
-    JSLJT_ID, // E
-    JSLJT_ID, // F
-    JSLJT_ID, // G
-    JSLJT_ID, // H
-    JSLJT_ID, // I
-    JSLJT_ID, // J
-    JSLJT_ID, // K
-    JSLJT_ID, // L
-    JSLJT_ID, // M
-    JSLJT_ID, // N
-    JSLJT_ID, // O
-    JSLJT_ID, // P
-    JSLJT_ID, // Q
-    JSLJT_ID, // R
-    JSLJT_ID, // S
-    JSLJT_ID, // T
-    JSLJT_ID, // U
-    JSLJT_ID, // V
-    JSLJT_ID, // W
-    JSLJT_ID, // X
-    JSLJT_ID, // Y
-    JSLJT_ID, // Z
-    JSLJT_SINGLECHAR, // [
-    JSLJT_SINGLECHAR, // \ char
-    JSLJT_SINGLECHAR, // ]
-    JSLJT_TOPHAT, // ^
-    JSLJT_ID, // _
-    // 96
-    JSLJT_SINGLECHAR, // `
-    JSLJT_ID, // A lowercase
-    JSLJT_ID, // B lowercase
-    JSLJT_ID, // C lowercase
-    JSLJT_ID, // D lowercase
-    JSLJT_ID, // E lowercase
-    JSLJT_ID, // F lowercase
-    JSLJT_ID, // G lowercase
-    JSLJT_ID, // H lowercase
-    JSLJT_ID, // I lowercase
-    JSLJT_ID, // J lowercase
-    JSLJT_ID, // K lowercase
-    JSLJT_ID, // L lowercase
-    JSLJT_ID, // M lowercase
-    JSLJT_ID, // N lowercase
-    JSLJT_ID, // O lowercase
-    JSLJT_ID, // P lowercase
-    JSLJT_ID, // Q lowercase
-    JSLJT_ID, // R lowercase
-    JSLJT_ID, // S lowercase
-    JSLJT_ID, // T lowercase
-    JSLJT_ID, // U lowercase
-    JSLJT_ID, // V lowercase
-    JSLJT_ID, // W lowercase
-    JSLJT_ID, // X lowercase
-    JSLJT_ID, // Y lowercase
-    JSLJT_ID, // Z lowercase
-    JSLJT_SINGLECHAR, // {
-    JSLJT_OR, // |
-    // everything past here is handled as a single char
-//  JSLJT_SINGLECHAR, // }
-//  JSLJT_SINGLECHAR, // ~
+/* Each character's entry in jslCharTable is the jslJumpTableEnum for a token
+ * starting with it, along with these flags */
+#define JSLCT_TYPE_MASK 0x1F
+#define JSLCT_WHITESPACE 0x20 ///< skipped between tokens
+#define JSLCT_ID 0x40 ///< can be part of an identifier
+#define JSLCT_PLAIN 0x80 ///< can't end a string or a comment (not 0, newline, backslash, quotes or '*')
+
+#define END JSLJT_SINGLECHAR
+#define CH (JSLJT_SINGLECHAR|JSLCT_PLAIN)
+#define WS (JSLJT_SINGLECHAR|JSLCT_WHITESPACE|JSLCT_PLAIN)
+#define NL (JSLJT_SINGLECHAR|JSLCT_WHITESPACE)
+#define ID (JSLJT_ID|JSLCT_ID|JSLCT_PLAIN)
+#define NUM (JSLJT_NUMBER|JSLCT_ID|JSLCT_PLAIN)
+#define DOT (JSLJT_NUMBER|JSLCT_PLAIN) // special :/
+#define STR JSLJT_STRING
+#define STAR JSLJT_STAR
+#define TOK (JSLJT_TOKENISED|JSLCT_PLAIN)
+#define OP(X) (JSLJT_##X|JSLCT_PLAIN)
+static const unsigned char jslCharTable[256] = {
+  END, CH, CH, CH, CH, CH, CH, CH, CH, WS, NL, CH, CH, WS, CH, CH, // 0: 0 \t \n \r
+  CH, CH, CH, CH, CH, CH, CH, CH, CH, CH, CH, CH, CH, CH, CH, CH, // 16:
+  WS, OP(EXCLAMATION), STR, CH, ID, OP(PERCENT), OP(AND), STR, CH, CH, STAR, OP(PLUS), CH, OP(MINUS), DOT, OP(FORWARDSLASH), // 32: ' ' ! " # $ % & ' ( ) * + , - . /
+  NUM, NUM, NUM, NUM, NUM, NUM, NUM, NUM, NUM, NUM, CH, CH, OP(LESSTHAN), OP(EQUAL), OP(GREATERTHAN), CH, // 48: 0 1 2 3 4 5 6 7 8 9 : ; < = > ?
+  CH, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, // 64: @ A B C D E F G H I J K L M N O
+  ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, CH, END, CH, OP(TOPHAT), ID, // 80: P Q R S T U V W X Y Z [ \ ] ^ _
+  CH, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, // 96: ` a b c d e f g h i j k l m n o
+  ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, CH, OP(OR), CH, CH, CH, // 112: p q r s t u v w x y z { | } ~ 127
+  TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK,
+  TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK,
+  TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK,
+  TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK,
+  TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK,
+  TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK,
+  TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK,
+  TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK, TOK
+};
+#undef END
+#undef CH
+#undef WS
+#undef NL
+#undef ID
+#undef NUM
+#undef DOT
+#undef STR
+#undef STAR
+#undef TOK
+#undef OP
+
+static inline bool jslIsCharClass(char ch, unsigned char classMask) {
+  return (jslCharTable[(unsigned char)ch] & classMask) != 0;
+}
+
+/** Move on while the current character is in the given class, optionally
+ * adding the characters to the token and/or appending them to a string */
+static inline void jslGetCharsOfClass(JsLex *lex, unsigned char classMask, bool appendToToken, JsvStringIterator *appendTo) {
+  while (jslIsCharClass(lex->currCh, classMask)) {
+    if (appendToToken) jslTokenAppendChar(lex, lex->currCh);
+    if (appendTo) jsvStringIteratorAppend(appendTo, lex->currCh);
+    /* Scan straight over the rest of this block's data. We leave the
+     * last character for jslGetNextCh, as it moves us on to the next block */
+    if (lex->it.var) {
+      const char *str = lex->it.var->varData.str;
+      size_t idx = lex->it.charIdx;
+      while (idx+1 < lex->it.charsInVar && jslIsCharClass(str[idx], classMask)) {
+        if (appendToToken) jslTokenAppendChar(lex, str[idx]);
+        if (appendTo) jsvStringIteratorAppend(appendTo, str[idx]);
+        idx++;
+      }
+      lex->it.charIdx = idx;
+    }
+    jslGetNextCh(lex);
+  }
+}
+
+/// Reserved words, in the order of LEX_R_LIST_START..LEX_R_LIST_END
+static const char *const jslReservedWords[LEX_R_LIST_END-LEX_R_LIST_START] = {
+  "if", "else", "do", "while", "for", "break", "continue", "function", "return",
+  "var", "this", "throw", "try", "catch", "finally", "true", "false", "null",
+  "undefined", "new", "in", "instanceof", "switch", "case", "default",
+  "delete", "typeof", "void"
+};
+#define JSL_RESERVED_WORD_MAX_LENGTH 10 // instanceof
+/* Perfect hash of the reserved words - each has a different
+ * (first char + 3*second char + 3*length) & 63, and the entry for it
+ * is the index in jslReservedWords plus one (or 0 if no word) */
+#define JSL_RESERVED_WORD_HASH(TOKEN, LEN) (((unsigned char)(TOKEN)[0] + 3*(unsigned char)(TOKEN)[1] + 3*(LEN)) & 63)
+static const unsigned char jslReservedWordHash[64] = {
+   0,  0,  0,  0,  0,  0,  0,  6,  7,  0,  0,  0,  0,  0,  0, 28,
+   0, 22, 24, 13,  0, 14, 16,  0, 17, 18, 19,  0,  0,  8,  0,  0,
+   0,  1, 10,  0,  0, 26, 20,  0, 25,  0, 23,  0,  0,  0,  0,  0,
+   0, 27,  0,  9,  0,  2, 15,  3, 11, 21,  0, 12,  5,  0,  4,  0
 };
 
+/// Return the reserved word token for the identifier in lex->token, or LEX_ID
+static short jslGetReservedWord(JsLex *lex) {
+  if (lex->tokenl<2 || lex->tokenl>JSL_RESERVED_WORD_MAX_LENGTH) return LEX_ID;
+  int word = jslReservedWordHash[JSL_RESERVED_WORD_HASH(lex->token, lex->tokenl)];
+  if (!word) return LEX_ID;
+  const char *reserved = jslReservedWords[word-1];
+  if (strncmp(lex->token, reserved, lex->tokenl)!=0 || reserved[lex->tokenl]) return LEX_ID;
+  return (short)(LEX_R_LIST_START + word - 1);
+}
+
 // handle a single char
 static void jslSingleChar(JsLex *lex) {
   lex->tk = lex->currCh;
   jslGetNextCh(lex);
 }
 
+/** Can a '/' after this token start a regular expression? (it can't if the
+ * token could be the end of an expression, as then it'll be a divide) */
+static bool jslCanStartRegex(int lastToken) {
+  switch (lastToken) {
+    case LEX_ID:
+    case LEX_INT:
+    case LEX_FLOAT:
+    case LEX_STR:
+    case LEX_REGEX:
+    case LEX_R_TRUE:
+    case LEX_R_FALSE:
+    case LEX_R_NULL:
+    case LEX_R_UNDEFINED:
+    case LEX_R_THIS:
+    case LEX_PLUSPLUS:
+    case LEX_MINUSMINUS:
+    case ')':
+    case ']':
+    case '}':
+      return false;
+    default:
+      return true;
+  }
+}
+
+/// Lex a regular expression literal - the token's value is all of it, eg. "/ab+c/gi"
+static void jslLexRegex(JsLex *lex) {
+  lex->tokenValue = jsvNewFromEmptyString();
+  if (!lex->tokenValue) {
+    lex->tk = LEX_EOF;
+    return;
+  }
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, lex->tokenValue, 0);
+  jsvStringIteratorAppend(&it, '/');
+  jslGetNextCh(lex);
+  bool inClass = false; // a '/' inside [...] doesn't end the expression
+  while (lex->currCh && lex->currCh!='\n' && (inClass || lex->currCh!='/')) {
+    if (lex->currCh=='\\') {
+      jsvStringIteratorAppend(&it, lex->currCh);
+      jslGetNextCh(lex);
+      if (!lex->currCh) break;
+    } else if (lex->currCh=='[') {
+      inClass = true;
+    } else if (lex->currCh==']') {
+      inClass = false;
+    }
+    jsvStringIteratorAppend(&it, lex->currCh);
+    jslGetNextCh(lex);
+  }
+  if (lex->currCh=='/') {
+    jsvStringIteratorAppend(&it, '/');
+    jslGetNextCh(lex);
+    // flags
+    while (isAlpha(lex->currCh)) {
+      jsvStringIteratorAppend(&it, lex->currCh);
+      jslGetNextCh(lex);
+    }
+  }
+  jsvStringIteratorFreeAppend(&it, lex->tokenValue);
+  lex->tk = LEX_REGEX;
+}
+
 void jslGetNextToken(JsLex *lex) {
+  int lastToken = lex->tk;
 jslGetNextToken_start:
   // Skip whitespace
-  while (isWhitespace(lex->currCh)) jslGetNextCh(lex);
+  jslGetCharsOfClass(lex, JSLCT_WHITESPACE, false, 0);
   // Search for comments
   if (lex->currCh=='/') {
     // newline comments
     if (jslNextCh(lex)=='/') {
-      while (lex->currCh && lex->currCh!='\n') jslGetNextCh(lex);
+      while (lex->currCh && lex->currCh!='\n') {
+        jslGetNextCh(lex);
+        jslGetCharsOfClass(lex, JSLCT_PLAIN, false, 0);
+      }
       jslGetNextCh(lex);
       goto jslGetNextToken_start;
     }
     // block comments
     if (jslNextCh(lex)=='*') {
-      while (lex->currCh && !(lex->currCh=='*' && jslNextCh(lex)=='/'))
+      while (lex->currCh && !(lex->currCh=='*' && jslNextCh(lex)=='/')) {
         jslGetNextCh(lex);
+        jslGetCharsOfClass(lex, JSLCT_PLAIN, false, 0);
+      }
       if (!lex->currCh) {
         lex->tk = LEX_UNFINISHED_COMMENT;
         return; /* an unfinished multi-line comment. When in interactive console,
@@ -239,63 +298,21 @@ jslGetNextToken_start:
   lex->tokenStart.it = lex->it;
   lex->tokenStart.currCh = lex->currCh;
   // tokens
-  if (((unsigned char)lex->currCh) < jslJumpTableStart ||
-      ((unsigned char)lex->currCh) > jslJumpTableEnd) {
-    // if unhandled by the jump table, just pass it through as a single character
-    jslSingleChar(lex);
-  } else {
-    switch(jslJumpTable[((unsigned char)lex->currCh) - jslJumpTableStart]) {
-      case JSLJT_ID: {
-        while (isAlpha(lex->currCh) || isNumeric(lex->currCh) || lex->currCh=='$') {
-            jslTokenAppendChar(lex, lex->currCh);
-            jslGetNextCh(lex);
+  switch((jslJumpTableEnum)(jslCharTable[(unsigned char)lex->currCh] & JSLCT_TYPE_MASK)) {
+      case JSLJT_TOKENISED:
+        if (lex->isTokenised &&
+            ((unsigned char)lex->currCh) < LEX_TOKEN_START+(LEX_R_LIST_END-LEX_EQUAL)) {
+          // an already tokenised reserved word or operator
+          lex->tk = (short)(LEX_EQUAL + ((unsigned char)lex->currCh) - LEX_TOKEN_START);
+          jslGetNextCh(lex);
+        } else {
+          jslSingleChar(lex);
         }
-        lex->tk = LEX_ID;
-        // We do fancy stuff here to reduce number of compares (hopefully GCC creates a jump table)
-        switch (lex->token[0]) {
-          case 'b': if (jslIsToken(lex,"break", 1)) lex->tk = LEX_R_BREAK;
-                    break;
-          case 'c': if (jslIsToken(lex,"case", 1)) lex->tk = LEX_R_CASE;
-                    else if (jslIsToken(lex,"catch", 1)) lex->tk = LEX_R_CATCH;
-                    else if (jslIsToken(lex,"continue", 1)) lex->tk = LEX_R_CONTINUE;
-                    break;
-          case 'd': if (jslIsToken(lex,"default", 1)) lex->tk = LEX_R_DEFAULT;
-                    else if (jslIsToken(lex,"delete", 1)) lex->tk = LEX_R_DELETE;
-                    else if (jslIsToken(lex,"do", 1)) lex->tk = LEX_R_DO;
-                    break;
-          case 'e': if (jslIsToken(lex,"else", 1)) lex->tk = LEX_R_ELSE;
-                    break;
-          case 'f': if (jslIsToken(lex,"false", 1)) lex->tk = LEX_R_FALSE;
-                    else if (jslIsToken(lex,"finally", 1)) lex->tk = LEX_R_FINALLY;
-                    else if (jslIsToken(lex,"for", 1)) lex->tk = LEX_R_FOR;
-                    else if (jslIsToken(lex,"function", 1)) lex->tk = LEX_R_FUNCTION;
-                    break;
-          case 'i': if (jslIsToken(lex,"if", 1)) lex->tk = LEX_R_IF;
-                    else if (jslIsToken(lex,"in", 1)) lex->tk = LEX_R_IN;
-                    else if (jslIsToken(lex,"instanceof", 1)) lex->tk = LEX_R_INSTANCEOF;
-                    break;
-          case 'n': if (jslIsToken(lex,"new", 1)) lex->tk = LEX_R_NEW;
-                    else if (jslIsToken(lex,"null", 1)) lex->tk = LEX_R_NULL;
-                    break;
-          case 'r': if (jslIsToken(lex,"return", 1)) lex->tk = LEX_R_RETURN;
-                    break;
-          case 's': if (jslIsToken(lex,"switch", 1)) lex->tk = LEX_R_SWITCH;
-                    break;
-          case 't': if (jslIsToken(lex,"this", 1)) lex->tk = LEX_R_THIS;
-                    else if (jslIsToken(lex,"throw", 1)) lex->tk = LEX_R_THROW;
-                    else if (jslIsToken(lex,"true", 1)) lex->tk = LEX_R_TRUE;
-                    else if (jslIsToken(lex,"try", 1)) lex->tk = LEX_R_TRY;
-                    else if (jslIsToken(lex,"typeof", 1)) lex->tk = LEX_R_TYPEOF;
-                    break;
-          case 'u': if (jslIsToken(lex,"undefined", 1)) lex->tk = LEX_R_UNDEFINED;
-                    break;
-          case 'w': if (jslIsToken(lex,"while", 1)) lex->tk = LEX_R_WHILE;
-                    break;
-          case 'v': if (jslIsToken(lex,"var", 1)) lex->tk = LEX_R_VAR;
-                    else if (jslIsToken(lex,"void", 1)) lex->tk = LEX_R_VOID;
-                    break;
-          default: break;
-        } break;
+        break;
+      case JSLJT_ID:
+        jslGetCharsOfClass(lex, JSLCT_ID, true, 0);
+        lex->tk = jslGetReservedWord(lex);
+        break;
       case JSLJT_NUMBER: {
         // TODO: check numbers aren't the wrong format
         bool canBeFloating = true;
@@ -409,6 +426,8 @@ jslGetNextToken_start:
               }
               jslTokenAppendChar(lex, ch);
               jsvStringIteratorAppend(&it, ch);
+            } else if (jslIsCharClass(lex->currCh, JSLCT_PLAIN)) {
+              jslGetCharsOfClass(lex, JSLCT_PLAIN, true, &it);
             } else {
               jslTokenAppendChar(lex, lex->currCh);
               jsvStringIteratorAppend(&it, lex->currCh);
@@ -470,7 +489,12 @@ jslGetNextToken_start:
             lex->tk = LEX_MULEQUAL;
             jslGetNextCh(lex);
           } break;
-      case JSLJT_FORWARDSLASH: jslSingleChar(lex);
+      case JSLJT_FORWARDSLASH:
+          if (jslCanStartRegex(lastToken)) {
+            jslLexRegex(lex);
+            break;
+          }
+          jslSingleChar(lex);
           if (lex->currCh=='=') {
             lex->tk = LEX_DIVEQUAL;
             jslGetNextCh(lex);
@@ -524,8 +548,6 @@ jslGetNextToken_start:
 
       case JSLJT_SINGLECHAR: jslSingleChar(lex); break;
       default: assert(0);break;
-      }
-    }
   }
 }
 
@@ -544,12 +566,23 @@ void jslInit(JsLex *lex, JsVar *var) {
   lex->tokenLastStart = 0;
   lex->tokenl = 0;
   lex->tokenValue = 0;
+  lex->isTokenised = false;
+  lex->tokenisedFrom = 0;
+  lex->tokenisedFromIndex = 0;
   // set up iterator
   jsvStringIteratorNew(&lex->it, lex->sourceVar, 0);
   jsvUnLock(lex->it.var); // see jslGetNextCh
   jslPreload(lex);
 }
 
+void jslInitTokenised(JsLex *lex, JsVar *var, JsVar *tokenisedFrom, size_t tokenisedFromIndex) {
+  jslInit(lex, var);
+  lex->isTokenised = true;
+  lex->tokenisedFrom = jsvLockAgain(tokenisedFrom);
+  lex->tokenisedFromIndex = tokenisedFromIndex;
+  jslSeekTo(lex, 0); // lex the first token again, now we know it's tokenised
+}
+
 void jslKill(JsLex *lex) {
   lex->tk = LEX_EOF; // safety ;)
   if (lex->it.var) jsvLockAgain(lex->it.var); // see jslGetNextCh
@@ -559,6 +592,10 @@ void jslKill(JsLex *lex) {
     lex->tokenValue = 0;
   }
   jsvUnLock(lex->sourceVar);
+  if (lex->tokenisedFrom) {
+    jsvUnLock(lex->tokenisedFrom);
+    lex->tokenisedFrom = 0;
+  }
   lex->tokenStart.it.var = 0;
   lex->tokenStart.currCh = 0;
 }
@@ -570,6 +607,7 @@ void jslSeekTo(JsLex *lex, size_t seekToChar) {
   jsvUnLock(lex->it.var); // see jslGetNextCh
   lex->tokenStart.it.var = 0;
   lex->tokenStart.currCh = 0;
+  lex->tk = LEX_EOF; // we're at the start of an expression, so '/' is a RegExp
   jslPreload(lex);
 }
 
@@ -581,6 +619,7 @@ void jslSeekToP(JsLex *lex, JslCharPos *seekToChar) {
   lex->currCh = seekToChar->currCh;
   lex->tokenStart.it.var = 0;
   lex->tokenStart.currCh = 0;
+  lex->tk = LEX_EOF; // we're at the start of an expression, so '/' is a RegExp
   jslGetNextToken(lex);
 }
 
@@ -605,8 +644,13 @@ void jslTokenAsString(int token, char *str, size_t len) {
       case LEX_INT : strncpy(str, "INT", len); return;
       case LEX_FLOAT : strncpy(str, "FLOAT", len); return;
       case LEX_STR : strncpy(str, "STRING", len); return;
+      case LEX_REGEX : strncpy(str, "REGEX", len); return;
   }
-  if (token>=LEX_EQUAL && token<LEX_R_LIST_END) {
+  if (token>=LEX_R_LIST_START && token<LEX_R_LIST_END) {
+    strncpy(str, jslReservedWords[token-LEX_R_LIST_START], len);
+    return;
+  }
+  if (token>=LEX_EQUAL && token<LEX_R_LIST_START) {
     const char tokenNames[] =
       /* LEX_EQUAL      :   */ "==\0"
       /* LEX_TYPEEQUAL  :   */ "===\0"
@@ -632,36 +676,6 @@ void jslTokenAsString(int token, char *str, size_t len) {
       /* LEX_OREQUAL :      */ "|=\0"
       /* LEX_OROR :         */ "||\0"
       /* LEX_XOREQUAL :     */ "^=\0"
-
-      // reserved words
-      /*LEX_R_IF :       */ "if\0"
-      /*LEX_R_ELSE :     */ "else\0"
-      /*LEX_R_DO :       */ "do\0"
-      /*LEX_R_WHILE :    */ "while\0"
-      /*LEX_R_FOR :      */ "for\0"
-      /*LEX_R_BREAK :    */ "return\0"
-      /*LEX_R_CONTINUE   */ "continue\0"
-      /*LEX_R_FUNCTION   */ "function\0"
-      /*LEX_R_RETURN     */ "return\0"
-      /*LEX_R_VAR :      */ "var\0"
-      /*LEX_R_THIS :     */ "this\0"
-      /*LEX_R_THROW :    */ "throw\0"
-      /*LEX_R_TRY :      */ "try\0"
-      /*LEX_R_CATCH :    */ "catch\0"
-      /*LEX_R_FINALLY :  */ "finally\0"
-      /*LEX_R_TRUE :     */ "true\0"
-      /*LEX_R_FALSE :    */ "false\0"
-      /*LEX_R_NULL :     */ "null\0"
-      /*LEX_R_UNDEFINED  */ "undefined\0"
-      /*LEX_R_NEW :      */ "new\0"
-      /*LEX_R_IN :       */ "in\0"
-      /*LEX_R_INSTANCEOF */ "instanceof\0"
-      /*LEX_R_SWITCH */     "switch\0"
-      /*LEX_R_CASE */       "case\0"
-      /*LEX_R_DEFAULT */    "default\0"
-      /*LEX_R_DELETE */     "delete\0"
-      /*LEX_R_TYPEOF :   */ "typeof\0"
-      /*LEX_R_VOID :     */ "void\0"
         ;
     unsigned int p = 0;
     int n = token-LEX_EQUAL;
@@ -770,17 +784,143 @@ JsVar *jslNewFromLexer(JslCharPos *charFrom, size_t charTo) {
   return var;
 }
 
+static bool jslIsIDChar(char ch) {
+  return isAlpha(ch) || isNumeric(ch) || ch=='$';
+}
+
+/** Would the two characters merge into a different token (or a comment)
+ * if there was no whitespace between them? */
+static bool jslNeedsSpaceBetween(int lastTk, char lastCh, char ch) {
+  if (jslIsIDChar(lastCh) && jslIsIDChar(ch)) return true;
+  if ((lastTk==LEX_INT || lastTk==LEX_FLOAT) && ch=='.') return true; // 1 .toString()
+  if ((lastCh=='+' || lastCh=='-') && ch==lastCh) return true; // a - -b
+  if (lastCh=='/' && (ch=='/' || ch=='*')) return true; // don't start a comment
+  if (lastTk==LEX_REGEX && jslIsIDChar(ch)) return true; // /a/ in b - don't add flags
+  return false;
+}
+
+/** Append the tokens from lex (up to the character index charTo) to dst,
+ * with comments and unneeded whitespace removed. If tokenise is set, reserved
+ * words and operators are written as single characters (see LEX_TOKEN_START),
+ * and if a token starts at one of the character indices in 'positions' then
+ * that index is replaced with the token's index in dst. Returns false if the
+ * tokens can't be tokenised. */
+static bool jslAppendTokens(JsLex *lex, JsvStringIterator *dst, size_t charTo, bool tokenise, size_t *positions, int positionCount) {
+  size_t dstLength = 0;
+  int lastTk = LEX_EOF;
+  char lastCh = 0;
+  while (lex->tk!=LEX_EOF && lex->tk!=LEX_UNFINISHED_COMMENT) {
+    /* Both iterators point one character past the one in currCh (see jslGetNextCh) */
+    size_t tokenStart = jsvStringIteratorGetIndex(&lex->tokenStart.it)-1;
+    if (tokenStart >= charTo) break;
+    /* Functions store their code as text, which would end up tokenised
+     * and wouldn't be printable */
+    if (tokenise && lex->tk==LEX_R_FUNCTION) return false;
+    char ch = lex->tokenStart.currCh;
+    if (jslNeedsSpaceBetween(lastTk, lastCh, ch)) {
+      jsvStringIteratorAppend(dst, ' ');
+      dstLength++;
+    }
+    int i;
+    for (i=0;i<positionCount;i++)
+      if (positions[i]==tokenStart) positions[i] = dstLength;
+    if (tokenise && lex->tk>=LEX_EQUAL && lex->tk<LEX_R_LIST_END) {
+      ch = (char)(LEX_TOKEN_START + lex->tk - LEX_EQUAL);
+      jsvStringIteratorAppend(dst, ch);
+      dstLength++;
+    } else {
+      /* Copy the token's text straight from the source - so strings keep
+       * their escapes and numbers their original format. */
+      size_t tokenLength = jsvStringIteratorGetIndex(&lex->it) - 1 - tokenStart;
+      jsvStringIteratorAppend(dst, ch);
+      dstLength++;
+      JsvStringIterator it = jsvStringIteratorClone(&lex->tokenStart.it);
+      while (--tokenLength > 0 && jsvStringIteratorHasChar(&it)) {
+        ch = jsvStringIteratorGetChar(&it);
+        jsvStringIteratorAppend(dst, ch);
+        dstLength++;
+        jsvStringIteratorNext(&it);
+      }
+      jsvStringIteratorFree(&it);
+    }
+    lastTk = lex->tk;
+    lastCh = ch;
+    jslGetNextToken(lex);
+  }
+  return true;
+}
+
+JsVar *jslNewMinifiedFromString(JsVar *source) {
+  JsVar *result = jsvNewFromEmptyString();
+  if (!result) return 0; // out of memory
+  JsvStringIterator dst;
+  jsvStringIteratorNew(&dst, result, 0);
+  JsLex lex;
+  jslInit(&lex, source);
+  jslAppendTokens(&lex, &dst, jsvGetStringLength(source), false, 0, 0);
+  jslKill(&lex);
+  jsvStringIteratorFree(&dst);
+  return result;
+}
+
+JsVar *jslNewTokenisedStringFromLexer(JsLex *lex, JslCharPos *charFrom, size_t charTo, size_t *positions, int positionCount) {
+  JsVar *result = jsvNewFromEmptyString();
+  if (!result) return 0; // out of memory
+  JsvStringIterator dst;
+  jsvStringIteratorNew(&dst, result, 0);
+  JsLex newLex;
+  jslInit(&newLex, lex->sourceVar);
+  jslSeekToP(&newLex, charFrom);
+  bool ok = jslAppendTokens(&newLex, &dst, charTo, true, positions, positionCount);
+  jslKill(&newLex);
+  // if we ran out of memory, the iterator will have been cleared
+  if (!dst.var) ok = false;
+  jsvStringIteratorFree(&dst);
+  if (!ok) {
+    jsvUnLock(result);
+    return 0;
+  }
+  return result;
+}
+
+/** If lex is running from a tokenised copy of some code, change tokenPos to
+ * the position of the same token in the original code and return that.
+ * Otherwise just return lex->sourceVar. Neither is locked again. */
+static JsVar *jslGetOriginalPosition(JsLex *lex, size_t *tokenPos) {
+  if (!lex->tokenisedFrom) return lex->sourceVar;
+  /* Every token in the copy was copied from a token in the original, in the
+   * same order - so lex both from the start of the copy, in step. This is
+   * slow, but it only happens when we report an error. */
+  JsLex copyLex, origLex;
+  jslInitTokenised(&copyLex, lex->sourceVar, lex->tokenisedFrom, lex->tokenisedFromIndex);
+  jslInit(&origLex, lex->tokenisedFrom);
+  jslSeekTo(&origLex, lex->tokenisedFromIndex);
+  size_t pos = lex->tokenisedFromIndex;
+  while (copyLex.tk!=LEX_EOF && origLex.tk!=LEX_EOF &&
+         jsvStringIteratorGetIndex(&copyLex.tokenStart.it)-1 <= *tokenPos) {
+    pos = jsvStringIteratorGetIndex(&origLex.tokenStart.it)-1;
+    jslGetNextToken(&copyLex);
+    jslGetNextToken(&origLex);
+  }
+  jslKill(&copyLex);
+  jslKill(&origLex);
+  *tokenPos = pos;
+  return lex->tokenisedFrom;
+}
+
 void jslPrintPosition(vcbprintf_callback user_callback, void *user_data, struct JsLex *lex, size_t tokenPos) {
   size_t line,col;
-  jsvGetLineAndCol(lex->sourceVar, tokenPos, &line, &col);
+  JsVar *sourceVar = jslGetOriginalPosition(lex, &tokenPos);
+  jsvGetLineAndCol(sourceVar, tokenPos, &line, &col);
   cbprintf(user_callback, user_data, "line %d col %d\n",line,col);
 }
 
 void jslPrintTokenLineMarker(vcbprintf_callback user_callback, void *user_data, struct JsLex *lex, size_t tokenPos) {
   size_t line = 1,col = 1;
-  jsvGetLineAndCol(lex->sourceVar, tokenPos, &line, &col);
-  size_t startOfLine = jsvGetIndexFromLineAndCol(lex->sourceVar, line, 1);
-  size_t lineLength = jsvGetCharsOnLine(lex->sourceVar, line);
+  JsVar *sourceVar = jslGetOriginalPosition(lex, &tokenPos);
+  jsvGetLineAndCol(sourceVar, tokenPos, &line, &col);
+  size_t startOfLine = jsvGetIndexFromLineAndCol(sourceVar, line, 1);
+  size_t lineLength = jsvGetCharsOnLine(sourceVar, line);
 
   if (lineLength>60 && tokenPos-startOfLine>30) {
     cbprintf(user_callback, user_data, "...");
@@ -793,7 +933,7 @@ void jslPrintTokenLineMarker(vcbprintf_callback user_callback, void *user_data,
   // print the string until the end of the line, or 60 chars (whichever is lesS)
   int chars = 0;
   JsvStringIterator it;
-  jsvStringIteratorNew(&it, lex->sourceVar, startOfLine);
+  jsvStringIteratorNew(&it, sourceVar, startOfLine);
   while (jsvStringIteratorHasChar(&it) && chars<60) {
     char ch = jsvStringIteratorGetChar(&it);
     if (ch == '\n') break;
@@ -26,6 +26,11 @@ typedef struct JslCharPos {
 void jslCharPosFree(JslCharPos *pos);
 JslCharPos jslCharPosClone(JslCharPos *pos);
 
+/** In tokenised strings (see jslNewTokenisedStringFromLexer), reserved words and
+ * multi-character operators (LEX_EQUAL onwards) are stored as a single character,
+ * starting from this one */
+#define LEX_TOKEN_START 128
+
 typedef struct JsLex
 {
   // Actual Lexing related stuff
@@ -46,9 +51,13 @@ typedef struct JsLex
    */
   JsVar *sourceVar; // the actual string var
   JsvStringIterator it; // Iterator for the string
+  bool isTokenised; ///< Was sourceVar created with jslNewTokenisedStringFromLexer?
+  JsVar *tokenisedFrom; ///< If isTokenised, the code sourceVar was made from (so errors can report where they really are)
+  size_t tokenisedFromIndex; ///< If isTokenised, the character index in tokenisedFrom that sourceVar starts at
 } JsLex;
 
 void jslInit(JsLex *lex, JsVar *var);
+void jslInitTokenised(JsLex *lex, JsVar *var, JsVar *tokenisedFrom, size_t tokenisedFromIndex); ///< Like jslInit, but for a string from jslNewTokenisedStringFromLexer
 void jslKill(JsLex *lex);
 void jslReset(JsLex *lex);
 void jslSeekTo(JsLex *lex, size_t seekToChar);
@@ -66,6 +75,8 @@ void jslSeek(JsLex *lex, JslCharPos seekToChar); // like jslSeekTo, but doesn't
 void jslGetNextToken(JsLex *lex); ///< Get the text token from our text string
 
 JsVar *jslNewFromLexer(JslCharPos *charFrom, size_t charTo); // Create a new STRING from part of the lexer
+JsVar *jslNewMinifiedFromString(JsVar *source); // Create a new STRING containing the tokens of source, with comments and unneeded whitespace removed
+JsVar *jslNewTokenisedStringFromLexer(JsLex *lex, JslCharPos *charFrom, size_t charTo, size_t *positions, int positionCount); // Like jslNewMinifiedFromString, but for part of the lexer, and with tokens stored as single characters
 
 void jslPrintPosition(vcbprintf_callback user_callback, void *user_data, struct JsLex *lex, size_t tokenPos);
 void jslPrintTokenLineMarker(vcbprintf_callback user_callback, void *user_data, struct JsLex *lex, size_t tokenPos);
@@ -20,6 +20,17 @@
 
 #define MAX_ARGS 12
 
+/** Create an array containing paramData[first] onwards - used for JSWAT_ARGUMENT_ARRAY */
+JsVar *jsnNewArgumentArray(JsVar **paramData, int paramCount, int first) {
+  JsVar *argsArray = jsvNewWithFlags(JSV_ARRAY);
+  if (argsArray) {
+    int i;
+    for (i=first;i<paramCount;i++)
+      jsvArrayPush(argsArray, paramData[i]);
+  }
+  return argsArray;
+}
+
 /** Call a function with the given argument specifiers */
 JsVar *jsnCallFunction(void *function, JsnArgumentType argumentSpecifier, JsVar *thisParam, JsVar **paramData, int paramCount) {
   JsnArgumentType returnType = (JsnArgumentType)(argumentSpecifier&JSWAT_MASK);
@@ -63,15 +74,7 @@ JsVar *jsnCallFunction(void *function, JsnArgumentType argumentSpecifier, JsVar
         break;
       }
       case JSWAT_ARGUMENT_ARRAY: { // a JsVar array containing all subsequent arguments
-        argsArray = jsvNewWithFlags(JSV_ARRAY);
-        if (argsArray) {
-          // push everything into the array
-          while (paramNumber<=paramCount) {
-            jsvArrayPush(argsArray, param);
-            param = (paramNumber<paramCount) ? paramData[paramNumber] : 0;
-            paramNumber++;
-          }
-        }
+        argsArray = jsnNewArgumentArray(paramData, paramCount, paramNumber-1);
         // push the array
         argData[argCount++] = (size_t)argsArray;
         break;
@@ -38,5 +38,8 @@
  */
 JsVar *jsnCallFunction(void *function, JsnArgumentType argumentSpecifier, JsVar *thisParam, JsVar **paramData, int paramCount) ;
 
+/// Create an array containing paramData[first] onwards - used for JSWAT_ARGUMENT_ARRAY
+JsVar *jsnNewArgumentArray(JsVar **paramData, int paramCount, int first);
+
 
 #endif //JSNATIVE_H
@@ -16,10 +16,23 @@
 #include "jswrapper.h"
 #include "jsnative.h"
 #include "jswrap_object.h" // for function_replacewith
+#include "jswrap_regexp.h" // for regex literals
 
 /* Info about execution when Parsing - this saves passing it on the stack
  * for each call */
-JsExecInfo execInfo;
+THREAD_LOCAL JsExecInfo execInfo;
+
+/* Activation records (what a function's parameters and locals are stored in when it
+ * is called) that have been finished with and can be reused. Each is still locked,
+ * and has just its scope link and return value names as children. */
+static THREAD_LOCAL JsVar *jspeiActivationPool[JSPARSE_ACTIVATION_POOL_SIZE];
+static THREAD_LOCAL int jspeiActivationPoolCount = 0;
+
+/* Built-in methods we've already created native function vars for. The vars
+ * themselves are kept alive in hiddenRoot (JSPARSE_BUILTIN_CACHE_NAME), this
+ * is just a direct-mapped index of them so lookups are fast. */
+static THREAD_LOCAL unsigned short jspMethodCacheKeys[JSPARSE_METHOD_CACHE_SIZE];
+static THREAD_LOCAL JsVarRef jspMethodCacheRefs[JSPARSE_METHOD_CACHE_SIZE];
 
 // ----------------------------------------------- Forward decls
 JsVar *jspeAssignmentExpression();
@@ -100,53 +113,89 @@ void jspReplaceWith(JsVar *dst, JsVar *src) {
 
 void jspeiInit(JsLex *lex) {
   execInfo.lex = lex;
-  execInfo.scopeCount = 0;
+  execInfo.scope = 0;
   execInfo.execute = EXEC_YES;
   execInfo.thisVar = 0;
 }
 
 void jspeiKill() {
   execInfo.lex = 0;
-  assert(execInfo.scopeCount==0);
-}
-
-bool jspeiAddScope(JsVar *scope) {
-  if (execInfo.scopeCount >= JSPARSE_MAX_SCOPES) {
-    jsExceptionHere(JSET_ERROR, "Maximum number of scopes exceeded");
-    jspSetError(false);
-    return false;
-  }
-  execInfo.scopes[execInfo.scopeCount++] = jsvLockAgain(scope);
-  return true;
-}
-
-void jspeiRemoveScope() {
-  if (execInfo.scopeCount <= 0) {
-    jsExceptionHere(JSET_INTERNALERROR, "Too many scopes removed");
-    jspSetError(false);
-    return;
+  assert(execInfo.scope==0);
+}
+
+/** Return the scope that the given scope was defined in (or 0 if it was root). The
+ * link is always added as a scope's first child, so we don't have to search for it.
+ * Like jsvFindChildFromString, we don't lock - the scope chain can't change under us */
+static JsVar *jspeiGetParentScope(JsVar *scope) {
+  JsVarRef childRef = jsvGetFirstChild(scope);
+  if (!childRef) return 0;
+  JsVar *child = _jsvGetAddressOf(childRef);
+  // quick check of the name - this is done for every scope we search through
+  if (!jsvIsString(child) ||
+      jsvGetCharactersInVar(child)!=sizeof(JSPARSE_FUNCTION_SCOPE_NAME)-1 ||
+      memcmp(child->varData.str, JSPARSE_FUNCTION_SCOPE_NAME, sizeof(JSPARSE_FUNCTION_SCOPE_NAME)-1)!=0)
+    return 0;
+  JsVarRef parentRef = jsvGetFirstChild(child);
+  return parentRef ? _jsvGetAddressOf(parentRef) : 0;
+}
+
+/** Get a new activation record for calling a function. Its first two children are the
+ * link to the scope the function was defined in (not set yet) and the return value. */
+static JsVar *jspeiNewActivation() {
+  if (jspeiActivationPoolCount)
+    return jspeiActivationPool[--jspeiActivationPoolCount];
+  JsVar *functionRoot = jsvNewWithFlags(JSV_FUNCTION);
+  if (!functionRoot) return 0; // out of memory
+  JsVar *scopeName = jsvAddNamedChild(functionRoot, 0, JSPARSE_FUNCTION_SCOPE_NAME);
+  JsVar *returnName = jsvAddNamedChild(functionRoot, 0, JSPARSE_RETURN_VAR);
+  jsvUnLock(scopeName);
+  jsvUnLock(returnName);
+  if (!scopeName || !returnName) { // out of memory
+    jsvUnLock(functionRoot);
+    return 0;
   }
-  jsvUnLock(execInfo.scopes[--execInfo.scopeCount]);
+  return functionRoot;
+}
+
+/** Finished with an activation record. If nothing else kept hold of it (eg. a closure
+ * defined inside the function) then clear it out and keep it for the next call */
+static void jspeiFreeActivation(JsVar *functionRoot) {
+  if (jsvGetRefs(functionRoot)==0 && jsvGetLocks(functionRoot)==1 &&
+      jspeiActivationPoolCount < JSPARSE_ACTIVATION_POOL_SIZE) {
+    JsVar *scopeName = jsvLock(jsvGetFirstChild(functionRoot));
+    JsVarRef returnRef = jsvGetNextSibling(scopeName);
+    // remove parameters and locals - everything after the return value
+    while (jsvGetLastChild(functionRoot)!=returnRef) {
+      JsVar *child = jsvLock(jsvGetLastChild(functionRoot));
+      jsvRemoveChild(functionRoot, child);
+      jsvUnLock(child);
+    }
+    jsvSetValueOfName(scopeName, 0);
+    jsvUnLock(scopeName);
+    jspeiActivationPool[jspeiActivationPoolCount++] = functionRoot;
+  } else
+    jsvUnLock(functionRoot);
 }
 
 JsVar *jspeiFindInScopes(const char *name) {
-  int i;
-  for (i=execInfo.scopeCount-1;i>=0;i--) {
-    JsVar *ref = jsvFindChildFromString(execInfo.scopes[i], name, false);
+  JsVar *scope = execInfo.scope;
+  while (scope) {
+    JsVar *ref = jsvFindChildFromString(scope, name, false);
     if (ref) return ref;
+    scope = jspeiGetParentScope(scope);
   }
   return jsvFindChildFromString(execInfo.root, name, false);
 }
 
 // TODO: get rid of these, use jspeiGetTopScope instead
 JsVar *jspeiFindOnTop(const char *name, bool createIfNotFound) {
-  if (execInfo.scopeCount>0)
-    return jsvFindChildFromString(execInfo.scopes[execInfo.scopeCount-1], name, createIfNotFound);
+  if (execInfo.scope)
+    return jsvFindChildFromString(execInfo.scope, name, createIfNotFound);
   return jsvFindChildFromString(execInfo.root, name, createIfNotFound);
 }
 JsVar *jspeiFindNameOnTop(JsVar *childName, bool createIfNotFound) {
-  if (execInfo.scopeCount>0)
-    return jsvFindChildFromVar(execInfo.scopes[execInfo.scopeCount-1], childName, createIfNotFound);
+  if (execInfo.scope)
+    return jsvFindChildFromVar(execInfo.scope, childName, createIfNotFound);
   return jsvFindChildFromVar(execInfo.root, childName, createIfNotFound);
 }
 
@@ -208,40 +257,6 @@ JsVar *jspeiFindChildFromStringInParents(JsVar *parent, const char *name) {
   return 0;
 }
 
-JsVar *jspeiGetScopesAsVar() {
-  if (execInfo.scopeCount==0)
-    return 0;
-  if (execInfo.scopeCount==1)
-    return jsvLockAgain(execInfo.scopes[0]);
-
-  JsVar *arr = jsvNewWithFlags(JSV_ARRAY);
-  int i;
-  for (i=0;i<execInfo.scopeCount;i++) {
-      JsVar *idx = jsvMakeIntoVariableName(jsvNewFromInteger(i), execInfo.scopes[i]);
-      if (!idx) { // out of memory
-        jspSetError(false);
-        return arr;
-      }
-      jsvAddName(arr, idx);
-      jsvUnLock(idx);
-  }
-  return arr;
-}
-
-void jspeiLoadScopesFromVar(JsVar *arr) {
-    execInfo.scopeCount = 0;
-
-    if (jsvIsArray(arr)) {
-      JsvObjectIterator it;
-      jsvObjectIteratorNew(&it, arr);
-      while (jsvObjectIteratorHasValue(&it)) {
-        execInfo.scopes[execInfo.scopeCount++] = jsvObjectIteratorGetValue(&it);
-        jsvObjectIteratorNext(&it);
-      }
-      jsvObjectIteratorFree(&it);
-    } else
-      execInfo.scopes[execInfo.scopeCount++] = jsvLockAgain(arr);
-}
 // -----------------------------------------------
 bool jspCheckStackPosition() {
   if (jsuGetFreeStack() < 512) { // giving us 512 bytes leeway
@@ -264,7 +279,7 @@ void jspAppendStackTrace(JsVar *stackTrace) {
   jsvStringIteratorGotoEnd(&it);
   jslPrintPosition((vcbprintf_callback)jsvStringIteratorPrintfCallback, &it, execInfo.lex, execInfo.lex->tokenLastStart);
   jslPrintTokenLineMarker((vcbprintf_callback)jsvStringIteratorPrintfCallback, &it, execInfo.lex, execInfo.lex->tokenLastStart);
-  jsvStringIteratorFree(&it);
+  jsvStringIteratorFreeAppend(&it, stackTrace);
 }
 
 /// We had an exception (argument is the exception's value)
@@ -374,12 +389,9 @@ NO_INLINE JsVar *jspeFunctionDefinition(bool parseNamedFunction) {
     JsVar *funcCodeVar = jslNewFromLexer(&funcBegin, (size_t)(execInfo.lex->tokenLastStart+1));
     jsvUnLock(jsvAddNamedChild(funcVar, funcCodeVar, JSPARSE_FUNCTION_CODE_NAME));
     jsvUnLock(funcCodeVar);
-    // scope var
-    JsVar *funcScopeVar = jspeiGetScopesAsVar();
-    if (funcScopeVar) {
-      jsvUnLock(jsvAddNamedChild(funcVar, funcScopeVar, JSPARSE_FUNCTION_SCOPE_NAME));
-      jsvUnLock(funcScopeVar);
-    }
+    // scope var - just the innermost scope, as that links to the ones outside it
+    if (execInfo.scope)
+      jsvUnLock(jsvAddNamedChild(funcVar, execInfo.scope, JSPARSE_FUNCTION_SCOPE_NAME));
     // if we had a function name, add it to the end
     if (functionInternalName)
       jsvUnLock(jsvObjectSetChild(funcVar, JSPARSE_FUNCTION_NAME_NAME, functionInternalName));
@@ -457,7 +469,7 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
       else
         execInfo.thisVar = jsvRef(execInfo.root); // 'this' should always default to root
 
-      returnVar = jsnCallFunction(function->varData.native.ptr, function->varData.native.argTypes, thisArg, argPtr, argCount);
+      returnVar = jswCallFunction(function->varData.native.ptr, function->varData.native.argTypes, thisArg, argPtr, argCount);
 
       // unlock values if we locked them
       if (isParsing) {
@@ -473,13 +485,11 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
       // create a new symbol table entry for execution of this function
       // OPT: can we cache this function execution environment + param variables?
       // OPT: Probably when calling a function ONCE, use it, otherwise when recursing, make new?
-      functionRoot = jsvNewWithFlags(JSV_FUNCTION);
+      functionRoot = jspeiNewActivation();
       if (!functionRoot) { // out of memory
         jspSetError(false);
         return 0;
       }
-
-      JsVar *functionScope = 0;
       JsVar *functionCode = 0;
       JsVar *functionInternalName = 0;
 
@@ -542,13 +552,19 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
           if (paramDefined) jsvObjectIteratorNext(&it);
         }
       }
+      // the activation record starts with the link to the scope the function was defined in, then the return value
+      JsVar *scopeName = jsvLock(jsvGetFirstChild(functionRoot));
+      returnVarName = jsvLock(jsvGetNextSibling(scopeName));
       // Now go through what's left
       while (jsvObjectIteratorHasValue(&it)) {
         JsVar *param = jsvObjectIteratorGetKey(&it);
         if (jsvIsString(param)) {
-          if (jsvIsStringEqual(param, JSPARSE_FUNCTION_SCOPE_NAME)) functionScope = jsvSkipName(param);
-          else if (jsvIsStringEqual(param, JSPARSE_FUNCTION_CODE_NAME)) functionCode = jsvSkipName(param);
-          else if (jsvIsStringEqual(param, JSPARSE_FUNCTION_NAME_NAME)) functionInternalName = jsvSkipName(param);
+          if (jsvIsStringEqual(param, JSPARSE_FUNCTION_CODE_NAME)) functionCode = jsvSkipName(param);
+          else if (jsvIsStringEqual(param, JSPARSE_FUNCTION_SCOPE_NAME)) {
+            JsVar *functionScope = jsvSkipName(param);
+            jsvSetValueOfName(scopeName, functionScope);
+            jsvUnLock(functionScope);
+          } else if (jsvIsStringEqual(param, JSPARSE_FUNCTION_NAME_NAME)) functionInternalName = jsvSkipName(param);
           else if (jsvIsFunctionParameter(param)) {
             JsVar *paramName = jsvCopy(param);
             // paramName is already a name (it's a function parameter)
@@ -562,6 +578,7 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
         jsvObjectIteratorNext(&it);
       }
       jsvObjectIteratorFree(&it);
+      jsvUnLock(scopeName);
 
       // setup a the function's name (if a named function)
       if (functionInternalName) {
@@ -570,93 +587,60 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
         jsvUnLock(name);
         jsvUnLock(functionInternalName);
       }
-      // setup a return variable
-      returnVarName = jsvAddNamedChild(functionRoot, 0, JSPARSE_RETURN_VAR);
-      if (!returnVarName) // out of memory
-        jspSetError(false);
-
       if (!JSP_HAS_ERROR) {
-        // save old scopes
-        JsVar *oldScopes[JSPARSE_MAX_SCOPES];
-        int oldScopeCount;
-        int i;
-        oldScopeCount = execInfo.scopeCount;
-        for (i=0;i<execInfo.scopeCount;i++)
-          oldScopes[i] = execInfo.scopes[i];
-        // if we have a scope var, load it up. We may not have one if there were no scopes apart from root
-        if (functionScope) {
-            jspeiLoadScopesFromVar(functionScope);
-            jsvUnLock(functionScope);
-        } else {
-            // no scope var defined? We have no scopes at all!
-            execInfo.scopeCount = 0;
-        }
-        // add the function's execute space to the symbol table so we can recurse
-        if (jspeiAddScope(functionRoot)) {
-          /* Adding scope may have failed - we may have descended too deep - so be sure
-           * not to pull somebody else's scope off
-           */
-
-          JsVar *oldThisVar = execInfo.thisVar;
-          if (thisArg)
-            execInfo.thisVar = jsvRef(thisArg);
-          else
-            execInfo.thisVar = jsvRef(execInfo.root); // 'this' should always default to root
-
-
-          /* we just want to execute the block, but something could
-           * have messed up and left us with the wrong ScriptLex, so
-           * we want to be careful here... */
-          if (functionCode) {
-            JsLex *oldLex;
-            JsLex newLex;
-            jslInit(&newLex, functionCode);
-
-            oldLex = execInfo.lex;
-            execInfo.lex = &newLex;
-            JSP_SAVE_EXECUTE();
-            execInfo.execute = EXEC_YES; // force execute without any previous state
-            jspeBlock();
-            bool hasError = JSP_HAS_ERROR;
-            JSP_RESTORE_EXECUTE(); // because return will probably have set execute to false
-            jslKill(&newLex);
-            execInfo.lex = oldLex;
-            if (hasError) {
-              JsVar *stackTrace = jsvObjectGetChild(execInfo.hiddenRoot, JSPARSE_STACKTRACE_VAR, JSV_STRING_0);
-              if (stackTrace) {
-                jsvAppendPrintf(stackTrace, jsvIsString(functionName)?"in function %q called from ":
-                                                           "in function called from ", functionName);
-                if (execInfo.lex) {
-                  jspAppendStackTrace(stackTrace);
-                } else
-                  jsvAppendPrintf(stackTrace, "system\n");
-                jsvUnLock(stackTrace);
-              }
+        // the function's execute space becomes the innermost scope (so we can recurse)
+        JsVar *oldScope = execInfo.scope;
+        execInfo.scope = functionRoot;
+        JsVar *oldThisVar = execInfo.thisVar;
+        if (thisArg)
+          execInfo.thisVar = jsvRef(thisArg);
+        else
+          execInfo.thisVar = jsvRef(execInfo.root); // 'this' should always default to root
+
+
+        /* we just want to execute the block, but something could
+         * have messed up and left us with the wrong ScriptLex, so
+         * we want to be careful here... */
+        if (functionCode) {
+          JsLex *oldLex;
+          JsLex newLex;
+          jslInit(&newLex, functionCode);
+
+          oldLex = execInfo.lex;
+          execInfo.lex = &newLex;
+          JSP_SAVE_EXECUTE();
+          execInfo.execute = EXEC_YES; // force execute without any previous state
+          jspeBlock();
+          bool hasError = JSP_HAS_ERROR;
+          JSP_RESTORE_EXECUTE(); // because return will probably have set execute to false
+          jslKill(&newLex);
+          execInfo.lex = oldLex;
+          if (hasError) {
+            JsVar *stackTrace = jsvObjectGetChild(execInfo.hiddenRoot, JSPARSE_STACKTRACE_VAR, JSV_STRING_0);
+            if (stackTrace) {
+              jsvAppendPrintf(stackTrace, jsvIsString(functionName)?"in function %q called from ":
+                                                         "in function called from ", functionName);
+              if (execInfo.lex) {
+                jspAppendStackTrace(stackTrace);
+              } else
+                jsvAppendPrintf(stackTrace, "system\n");
+              jsvUnLock(stackTrace);
             }
           }
-
-          /* Return to old 'this' var. No need to unlock as we never locked before */
-          if (execInfo.thisVar) jsvUnRef(execInfo.thisVar);
-          execInfo.thisVar = oldThisVar;
-
-          jspeiRemoveScope();
         }
 
-        // Unref old scopes
-        for (i=0;i<execInfo.scopeCount;i++)
-            jsvUnLock(execInfo.scopes[i]);
-        // restore function scopes
-        for (i=0;i<oldScopeCount;i++)
-            execInfo.scopes[i] = oldScopes[i];
-        execInfo.scopeCount = oldScopeCount;
+        /* Return to old 'this' var. No need to unlock as we never locked before */
+        if (execInfo.thisVar) jsvUnRef(execInfo.thisVar);
+        execInfo.thisVar = oldThisVar;
+        execInfo.scope = oldScope;
       }
       jsvUnLock(functionCode);
 
       /* get the real return var before we remove it from our function */
-      returnVar = jsvSkipNameAndUnLock(returnVarName);
-      if (returnVarName) // could have failed with out of memory
-        jsvSetValueOfName(returnVarName, 0); // remove return value (which helps stops circular references)
-      jsvUnLock(functionRoot);
+      returnVar = jsvSkipName(returnVarName);
+      jsvSetValueOfName(returnVarName, 0); // remove return value (which helps stops circular references)
+      jsvUnLock(returnVarName);
+      jspeiFreeActivation(functionRoot);
     }
 
 
@@ -1164,6 +1148,15 @@ NO_INLINE JsVar *jspeFactor() {
       JSP_ASSERT_MATCH(LEX_STR);
       return 0;
     }
+  } else if (execInfo.lex->tk==LEX_REGEX) {
+    JsVar *regex = 0;
+    if (JSP_SHOULD_EXECUTE) {
+      JsVar *literal = jslGetTokenValueAsVar(execInfo.lex);
+      regex = jswrap_regexp_fromLiteral(literal);
+      jsvUnLock(literal);
+    }
+    JSP_ASSERT_MATCH(LEX_REGEX);
+    return regex;
   } else if (execInfo.lex->tk=='{') {
     return jspeFactorObject();
   } else if (execInfo.lex->tk=='[') {
@@ -1188,19 +1181,33 @@ NO_INLINE JsVar *jspeFactor() {
   return 0;
 }
 
+/** If the next token is an integer literal that is the whole of an operand
+ * (it is followed directly by something that ends an expression, as in
+ * 'x*2;' or 'i<10)'), we can use its value without allocating a JsVar for
+ * it. If so, match it, put its value in 'value' and return true */
+static bool jspeIntLiteralOperand(JsVarInt *value) {
+  if (execInfo.lex->tk!=LEX_INT || !JSP_SHOULD_EXECUTE) return false;
+  char ch = execInfo.lex->currCh;
+  if (ch!=';' && ch!=')' && ch!=']' && ch!=',' && ch!='}' && ch!=':') return false;
+  long long v = stringToInt(jslGetTokenValueAsString(execInfo.lex));
+  if (v<-2147483648LL || v>2147483647LL) return false;
+  *value = (JsVarInt)v;
+  JSP_ASSERT_MATCH(LEX_INT);
+  return true;
+}
+
 NO_INLINE JsVar *__jspePostfixExpression(JsVar *a) {
   while (execInfo.lex->tk==LEX_PLUSPLUS || execInfo.lex->tk==LEX_MINUSMINUS) {
     int op = execInfo.lex->tk;
     JSP_ASSERT_MATCH(op);
     if (JSP_SHOULD_EXECUTE) {
-        JsVar *one = jsvNewFromInteger(1);
         JsVar *oldValue = jsvAsNumberAndUnLock(jsvSkipName(a)); // keep the old value (but convert to number)
-        JsVar *res = jsvMathsOpSkipNames(oldValue, one, op==LEX_PLUSPLUS ? '+' : '-');
-        jsvUnLock(one);
-
-        // in-place add/subtract
-        jspReplaceWith(a, res);
-        jsvUnLock(res);
+        // in-place add/subtract, directly on the name if it stores an int
+        if (!jsvNameIntAdd(a, op==LEX_PLUSPLUS ? 1 : -1)) {
+          JsVar *res = jsvMathsOpIntAndUnLock(jsvLockAgainSafe(oldValue), 1, op==LEX_PLUSPLUS ? '+' : '-');
+          jspReplaceWith(a, res);
+          jsvUnLock(res);
+        }
         // but then use the old value
         jsvUnLock(a);
         a = oldValue;
@@ -1215,10 +1222,8 @@ NO_INLINE JsVar *jspePostfixExpression() {
       int op = execInfo.lex->tk;
       JSP_ASSERT_MATCH(op);
       a = jspePostfixExpression();
-      if (JSP_SHOULD_EXECUTE) {
-          JsVar *one = jsvNewFromInteger(1);
-          JsVar *res = jsvMathsOpSkipNames(a, one, op==LEX_PLUSPLUS ? '+' : '-');
-          jsvUnLock(one);
+      if (JSP_SHOULD_EXECUTE && !jsvNameIntAdd(a, op==LEX_PLUSPLUS ? 1 : -1)) {
+          JsVar *res = jsvMathsOpIntAndUnLock(jsvLockAgainSafe(a), 1, op==LEX_PLUSPLUS ? '+' : '-');
           // in-place add/subtract
           jspReplaceWith(a, res);
           jsvUnLock(res);
@@ -1258,12 +1263,16 @@ NO_INLINE JsVar *__MultiplicativeExpression(JsVar *a) {
         JsVar *b;
         int op = execInfo.lex->tk;
         JSP_ASSERT_MATCH(op);
+        JsVarInt bInt;
+        if (jspeIntLiteralOperand(&bInt)) {
+          a = jsvMathsOpIntAndUnLock(a, bInt, op);
+          continue;
+        }
         b = jspeUnaryExpression();
         if (JSP_SHOULD_EXECUTE) {
-          JsVar *res = jsvMathsOpSkipNames(a, b, op);
-          jsvUnLock(a); a = res;
-        }
-        jsvUnLock(b);
+          a = jsvMathsOpSkipNamesAndUnLock(a, b, op);
+        } else
+          jsvUnLock(b);
     }
     return a;
 }
@@ -1276,13 +1285,17 @@ NO_INLINE JsVar *__jspeAdditiveExpression(JsVar *a) {
   while (execInfo.lex->tk=='+' || execInfo.lex->tk=='-') {
       int op = execInfo.lex->tk;
       JSP_ASSERT_MATCH(op);
+      JsVarInt bInt;
+      if (jspeIntLiteralOperand(&bInt)) {
+        a = jsvMathsOpIntAndUnLock(a, bInt, op);
+        continue;
+      }
       JsVar *b = jspeMultiplicativeExpression();
       if (JSP_SHOULD_EXECUTE) {
-          // not in-place, so just replace
-        JsVar *res = jsvMathsOpSkipNames(a, b, op);
-        jsvUnLock(a); a = res;
-      }
-      jsvUnLock(b);
+        // not in-place, so just replace (but a or b may be reused for the result)
+        a = jsvMathsOpSkipNamesAndUnLock(a, b, op);
+      } else
+        jsvUnLock(b);
   }
   return a;
 }
@@ -1297,12 +1310,16 @@ NO_INLINE JsVar *__jspeShiftExpression(JsVar *a) {
     JsVar *b;
     int op = execInfo.lex->tk;
     JSP_ASSERT_MATCH(op);
+    JsVarInt bInt;
+    if (jspeIntLiteralOperand(&bInt)) {
+      a = jsvMathsOpIntAndUnLock(a, bInt, op);
+      continue;
+    }
     b = jspeAdditiveExpression();
     if (JSP_SHOULD_EXECUTE) {
-      JsVar *res = jsvMathsOpSkipNames(a, b, op);
-      jsvUnLock(a); a = res;
-    }
-    jsvUnLock(b);
+      a = jsvMathsOpSkipNamesAndUnLock(a, b, op);
+    } else
+      jsvUnLock(b);
   }
   return a;
 }
@@ -1321,6 +1338,11 @@ NO_INLINE JsVar *__jspeRelationalExpression(JsVar *a) {
            (execInfo.lex->tk==LEX_R_IN && !(execInfo.execute&EXEC_FOR_INIT))) {
         int op = execInfo.lex->tk;
         JSP_ASSERT_MATCH(op);
+        JsVarInt bInt;
+        if (op!=LEX_R_IN && op!=LEX_R_INSTANCEOF && jspeIntLiteralOperand(&bInt)) {
+          a = jsvMathsOpIntAndUnLock(a, bInt, op);
+          continue;
+        }
         b = jspeShiftExpression();
         if (JSP_SHOULD_EXECUTE) {
           JsVar *res = 0;
@@ -1400,10 +1422,9 @@ NO_INLINE JsVar *__jspeLogicalExpression(JsVar *a) {
         } else { // else it's a more 'normal' logical expression - just use Maths
           JsVar *b = jspeRelationalExpression();
           if (JSP_SHOULD_EXECUTE) {
-              JsVar *res = jsvMathsOpSkipNames(a, b, op);
-              jsvUnLock(a); a = res;
-          }
-          jsvUnLock(b);
+              a = jsvMathsOpSkipNamesAndUnLock(a, b, op);
+          } else
+            jsvUnLock(b);
         }
     }
     return a;
@@ -1485,7 +1506,7 @@ NO_INLINE JsVar *__jspeAssignmentExpression(JsVar *lhs) {
                 else if (op==LEX_RSHIFTEQUAL) op=LEX_RSHIFT;
                 else if (op==LEX_LSHIFTEQUAL) op=LEX_LSHIFT;
                 else if (op==LEX_RSHIFTUNSIGNEDEQUAL) op=LEX_RSHIFTUNSIGNED;
-                if (op=='+' && jsvIsName(lhs)) {
+                if (op=='+' && jsvIsName(lhs) && !jsvIsNameWithValue(lhs)) {
                   JsVar *currentValue = jsvSkipName(lhs);
                   if (jsvIsString(currentValue) && jsvGetRefs(currentValue)==1) {
                     /* A special case for string += where this is the only use of the string,
@@ -1499,7 +1520,8 @@ NO_INLINE JsVar *__jspeAssignmentExpression(JsVar *lhs) {
                 }
                 if (op) {
                   /* Fallback which does a proper add */
-                  JsVar *res = jsvMathsOpSkipNames(lhs,rhs,op);
+                  JsVar *res = jsvMathsOpSkipNamesAndUnLock(jsvLockAgain(lhs),rhs,op);
+                  rhs = 0; // unlocked above
                   jspReplaceWith(lhs, res);
                   jsvUnLock(res);
                 }
@@ -1686,6 +1708,41 @@ NO_INLINE JsVar *jspeStatementSwitch() {
   return 0;
 }
 
+/** Loops are executed by seeking back in the lexer, so everything in them is
+ * lexed again on every iteration. Once a loop has gone round
+ * JSPARSE_LOOP_TOKENISE_ITERATIONS times, we make a tokenised copy of it (from
+ * the first of 'positions' up to 'loopEnd') which is much faster to lex, and
+ * point 'positions' at the same tokens in that. Making the copy costs about as
+ * much as lexing the loop a few times, so short loops aren't worth it.
+ * Returns false and leaves everything alone if we can't - because we're
+ * already in a tokenised loop, the loop defines a function, or we're out of
+ * memory */
+static bool jspeLoopTokenise(JsLex *loopLex, JslCharPos **positions, int positionCount, size_t loopEnd) {
+  if (execInfo.lex->isTokenised) return false;
+#ifdef JSVAR_ALLOC_PROFILER
+  // allocation sites are recorded as lines in the code, so don't make a copy of it
+  if (jsvProfilerIsRunning()) return false;
+#endif
+  size_t idx[3];
+  assert(positionCount <= 3);
+  int i, first = 0;
+  for (i=0;i<positionCount;i++) {
+    idx[i] = jsvStringIteratorGetIndex(&positions[i]->it)-1;
+    if (idx[i] < idx[first]) first = i;
+  }
+  size_t codeStart = idx[first];
+  JsVar *code = jslNewTokenisedStringFromLexer(execInfo.lex, positions[first], loopEnd, idx, positionCount);
+  if (!code) return false;
+  jslInitTokenised(loopLex, code, execInfo.lex->sourceVar, codeStart);
+  jsvUnLock(code);
+  for (i=0;i<positionCount;i++) {
+    jslSeekTo(loopLex, idx[i]);
+    jslCharPosFree(positions[i]);
+    *positions[i] = jslCharPosClone(&loopLex->tokenStart);
+  }
+  return true;
+}
+
 NO_INLINE JsVar *jspeStatementDoOrWhile(bool isWhile) {
 #ifdef JSPARSE_MAX_LOOP_ITERATIONS
   int loopCount = JSPARSE_MAX_LOOP_ITERATIONS;
@@ -1731,11 +1788,21 @@ NO_INLINE JsVar *jspeStatementDoOrWhile(bool isWhile) {
     JSP_MATCH(')');
   }
 
+  JsLex loopLex, *oldLex = 0;
+  JslCharPos *positions[] = { &whileCondStart, &whileBodyStart };
+  size_t loopEnd = jsvStringIteratorGetIndex(&execInfo.lex->tokenStart.it)-1;
+  int iterations = 0;
+
   while (!hasHadBreak && loopCond
 #ifdef JSPARSE_MAX_LOOP_ITERATIONS
          && loopCount-->0
 #endif
          ) {
+      if (++iterations==JSPARSE_LOOP_TOKENISE_ITERATIONS && JSP_SHOULD_EXECUTE &&
+          jspeLoopTokenise(&loopLex, positions, 2, loopEnd)) {
+        oldLex = execInfo.lex;
+        execInfo.lex = &loopLex;
+      }
       jslSeekToP(execInfo.lex, &whileCondStart);
       cond = jspeAssignmentExpression();
       loopCond = JSP_SHOULD_EXECUTE && jsvGetBoolAndUnLock(jsvSkipName(cond));
@@ -1753,9 +1820,13 @@ NO_INLINE JsVar *jspeStatementDoOrWhile(bool isWhile) {
           }
       }
   }
-  jslSeekToP(execInfo.lex, &whileBodyEnd);
   jslCharPosFree(&whileCondStart);
   jslCharPosFree(&whileBodyStart);
+  if (oldLex) {
+    execInfo.lex = oldLex;
+    jslKill(&loopLex);
+  }
+  jslSeekToP(execInfo.lex, &whileBodyEnd);
   jslCharPosFree(&whileBodyEnd);
 #ifdef JSPARSE_MAX_LOOP_ITERATIONS
   if (loopCount<=0) {
@@ -1908,6 +1979,10 @@ NO_INLINE JsVar *jspeStatementFor() {
       hasHadBreak = true;
     }
     if (!loopCond) JSP_RESTORE_EXECUTE();
+    JsLex loopLex, *oldLex = 0;
+    JslCharPos *positions[] = { &forCondStart, &forIterStart, &forBodyStart };
+    size_t loopEnd = jsvStringIteratorGetIndex(&forBodyEnd.it)-1;
+    int iterations = 0;
     if (loopCond) {
         jslSeekToP(execInfo.lex, &forIterStart);
         if (execInfo.lex->tk != ')') jsvUnLock(jspeExpression());
@@ -1917,6 +1992,11 @@ NO_INLINE JsVar *jspeStatementFor() {
            && loopCount-->0
 #endif
            ) {
+        if (++iterations==JSPARSE_LOOP_TOKENISE_ITERATIONS &&
+            jspeLoopTokenise(&loopLex, positions, 3, loopEnd)) {
+          oldLex = execInfo.lex;
+          execInfo.lex = &loopLex;
+        }
         jslSeekToP(execInfo.lex, &forCondStart);
         ;
         if (execInfo.lex->tk == ';') {
@@ -1943,11 +2023,14 @@ NO_INLINE JsVar *jspeStatementFor() {
             if (execInfo.lex->tk != ')') jsvUnLock(jspeExpression());
         }
     }
-    jslSeekToP(execInfo.lex, &forBodyEnd);
-
     jslCharPosFree(&forCondStart);
     jslCharPosFree(&forIterStart);
     jslCharPosFree(&forBodyStart);
+    if (oldLex) {
+      execInfo.lex = oldLex;
+      jslKill(&loopLex);
+    }
+    jslSeekToP(execInfo.lex, &forBodyEnd);
     jslCharPosFree(&forBodyEnd);
 
 #ifdef JSPARSE_MAX_LOOP_ITERATIONS
@@ -2080,10 +2163,14 @@ NO_INLINE JsVar *jspeStatementFunctionDecl() {
 }
 
 NO_INLINE JsVar *jspeStatement() {
+#ifndef SAVE_ON_FLASH
+    jsvStartStatement();
+#endif
     if (execInfo.lex->tk==LEX_ID ||
         execInfo.lex->tk==LEX_INT ||
         execInfo.lex->tk==LEX_FLOAT ||
         execInfo.lex->tk==LEX_STR ||
+        execInfo.lex->tk==LEX_REGEX ||
         execInfo.lex->tk==LEX_R_NEW ||
         execInfo.lex->tk==LEX_R_NULL ||
         execInfo.lex->tk==LEX_R_UNDEFINED ||
@@ -2158,6 +2245,71 @@ JsVar *jspNewBuiltin(const char *instanceOf) {
   return objFunc;
 }
 
+/// Find the child of 'parent' with the integer name 'key', and return its value (locked)
+static JsVar *jspFindIntChild(JsVar *parent, JsVarInt key) {
+  JsVarRef childref = jsvGetFirstChild(parent);
+  while (childref) {
+    JsVar *child = jsvLock(childref);
+    if (jsvIsInt(child) && child->varData.integer == key)
+      return jsvSkipNameAndUnLock(child);
+    childref = jsvGetNextSibling(child);
+    jsvUnLock(child);
+  }
+  return 0;
+}
+
+/** Add 'value' to 'parent' with the integer name 'key', and return the value
+ * (still locked). If we're out of memory, 'value' is unlocked and 0 is returned. */
+static JsVar *jspAddIntChild(JsVar *parent, JsVarInt key, JsVar *value) {
+  if (!value) return 0; // out of memory
+  JsVar *name = jsvNewFromInteger(key);
+  if (!name) { // out of memory - value isn't in parent, so don't return it
+    jsvUnLock(value);
+    return 0;
+  }
+  name = jsvMakeIntoVariableName(name, value);
+  jsvAddName(parent, name);
+  jsvUnLock(name);
+  return value;
+}
+
+/** Return the native function var for a built-in method - symbolIndex of the
+ * symbol table tableIndex. These are kept in hiddenRoot, one object per
+ * class, so that repeated accesses (eg. `arr.push`) return the same var
+ * rather than allocating a new one every time. */
+JsVar *jspGetBuiltInMethod(int tableIndex, int symbolIndex, void (*functionPtr)(void), unsigned short functionSpec) {
+  if (!execInfo.hiddenRoot)
+    return jsvNewNativeFunction(functionPtr, functionSpec);
+  unsigned short key = (unsigned short)(((tableIndex<<8) | symbolIndex) + 1); // 0 means an empty slot
+  int slot = (symbolIndex + tableIndex*7) % JSPARSE_METHOD_CACHE_SIZE;
+  if (jspMethodCacheKeys[slot] == key)
+    return jsvLock(jspMethodCacheRefs[slot]);
+  JsVar *cache = jsvObjectGetChild(execInfo.hiddenRoot, JSPARSE_BUILTIN_CACHE_NAME, JSV_OBJECT);
+  if (!cache) return 0; // out of memory
+  JsVar *classCache = jspFindIntChild(cache, tableIndex);
+  if (!classCache)
+    classCache = jspAddIntChild(cache, tableIndex, jsvNewWithFlags(JSV_OBJECT));
+  jsvUnLock(cache);
+  if (!classCache) return 0; // out of memory
+  JsVar *method = jspFindIntChild(classCache, symbolIndex);
+  if (!method)
+    method = jspAddIntChild(classCache, symbolIndex, jsvNewNativeFunction(functionPtr, functionSpec));
+  jsvUnLock(classCache);
+  if (method) { // it's now referenced from hiddenRoot, so it's safe to remember
+    jspMethodCacheKeys[slot] = key;
+    jspMethodCacheRefs[slot] = jsvGetRef(method);
+  }
+  return method;
+}
+
+/// Called from jsvDefragment (via jsiDefragmentRemapRefs) - update the cached built-in method refs
+void jspDefragmentRemapRefs() {
+  int i;
+  for (i=0;i<JSPARSE_METHOD_CACHE_SIZE;i++)
+    if (jspMethodCacheKeys[i])
+      jspMethodCacheRefs[i] = jsvDefragmentRemapRef(jspMethodCacheRefs[i]);
+}
+
 /// Create a new Class of the given instance and return its prototype
 NO_INLINE JsVar *jspNewPrototype(const char *instanceOf) {
   JsVar *objFuncName = jsvFindChildFromString(execInfo.root, instanceOf, true);
@@ -2244,6 +2396,12 @@ void jspSoftInit() {
 }
 
 void jspSoftKill() {
+  // cached built-in methods are cheap to recreate, so don't keep (or save) them
+  jsvRemoveNamedChild(execInfo.hiddenRoot, JSPARSE_BUILTIN_CACHE_NAME);
+  memset(jspMethodCacheKeys, 0, sizeof(jspMethodCacheKeys));
+  // free activation records we were keeping for reuse
+  while (jspeiActivationPoolCount)
+    jsvUnLock(jspeiActivationPool[--jspeiActivationPoolCount]);
   jsvUnLock(execInfo.hiddenRoot);
   execInfo.hiddenRoot = 0;
   jsvUnLock(execInfo.root);
@@ -2277,9 +2435,7 @@ JsVar *jspEvaluateVar(JsVar *str, JsVar *scope, bool parseTwice) {
   jslInit(&lex, str);
 
   jspeiInit(&lex);
-  bool scopeAdded = false;
-  if (scope)
-    scopeAdded = jspeiAddScope(scope);
+  execInfo.scope = scope;
 
   if (parseTwice) {
     JsExecFlags oldFlags = execInfo.execute;
@@ -2297,7 +2453,7 @@ JsVar *jspEvaluateVar(JsVar *str, JsVar *scope, bool parseTwice) {
     v = jspeBlockOrStatement();
   }
   // clean up
-  if (scopeAdded) jspeiRemoveScope();
+  execInfo.scope = 0;
   jspeiKill();
   jslKill(&lex);
 
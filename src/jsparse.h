@@ -30,6 +30,12 @@ bool jspIsConstructor(JsVar *constructor, const char *constructorName);
 /// Create a new built-in object that jswrapper can use to check for built-in functions
 JsVar *jspNewBuiltin(const char *name);
 
+/// Return the (cached) native function var for the built-in method symbolIndex in symbol table tableIndex
+JsVar *jspGetBuiltInMethod(int tableIndex, int symbolIndex, void (*functionPtr)(void), unsigned short functionSpec);
+
+/// Called from jsvDefragment (via jsiDefragmentRemapRefs) - update the cached built-in method refs
+void jspDefragmentRemapRefs();
+
 /// Create a new Class of the given instance and return its prototype
 NO_INLINE JsVar *jspNewPrototype(const char *instanceOf);
 
@@ -116,9 +122,9 @@ typedef struct {
   JsVar  *hiddenRoot;   ///< root of the symbol table that's hidden
   JsLex *lex;
 
-  // TODO: could store scopes as JsVar array for speed
-  JsVar *scopes[JSPARSE_MAX_SCOPES];
-  int scopeCount;
+  /** The innermost scope (or 0 if we're in root). Scopes are chained - each one
+   * starts with a JSPARSE_FUNCTION_SCOPE_NAME child for the scope it was defined in */
+  JsVar *scope;
   /// Value of 'this' reserved word
   JsVar *thisVar;
 
@@ -127,7 +133,7 @@ typedef struct {
 
 /* Info about execution when Parsing - this saves passing it on the stack
  * for each call */
-extern JsExecInfo execInfo;
+extern THREAD_LOCAL JsExecInfo execInfo;
 
 /// flags for jspParseFunction
 typedef enum {
@@ -0,0 +1,660 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Regular Expressions - compiled to bytecode and run directly over JsVar strings
+ * ----------------------------------------------------------------------------
+ */
+#include "jsregex.h"
+#include "jsvariterator.h"
+
+/* Compiled code is stored in a String. It starts with a header:
+ *   [0] flags, [1] number of groups, [2..3] number of instructions a thread can wait at
+ * and is followed by instructions. Jumps are signed 16 bit offsets from the start
+ * of the instruction they are in.
+ *
+ * Code is run as a 'Pike VM' - every possible way of matching is stepped along together,
+ * one character at a time. That means we only ever go forwards through the string (so
+ * we can use a JsvStringIterator and don't have to copy it) and we don't blow up the
+ * stack or take exponential time backtracking. The downside is no backreferences. */
+
+typedef enum {
+  JSRE_OP_MATCH,  ///< The whole expression has matched
+  JSRE_OP_CHAR,   ///< [ch] match a character (lowercase if JSRE_IGNORECASE)
+  JSRE_OP_ANY,    ///< match any character except a newline
+  JSRE_OP_CLASS,  ///< [32 byte bitmap] match any character in the bitmap
+  JSRE_OP_BOL,    ///< beginning of line
+  JSRE_OP_EOL,    ///< end of line
+  JSRE_OP_WORDB,  ///< word boundary
+  JSRE_OP_NWORDB, ///< not a word boundary
+  JSRE_OP_SPLIT,  ///< [x16, y16] carry on at both x and y, preferring x
+  JSRE_OP_JMP,    ///< [x16] carry on at x
+  JSRE_OP_SAVE,   ///< [n] record the current position in group slot n
+} JsreOp;
+
+#define JSRE_HEADER_SIZE 4
+#define JSRE_CLASS_SIZE 32
+#define JSRE_SPLIT_SIZE 5
+#define JSRE_JMP_SIZE 3
+
+typedef struct {
+  const char *p, *end; ///< where we are in the pattern
+  unsigned char *code; ///< where to write code - or 0 if we're just working out how big it will be
+  size_t len;          ///< amount of code so far
+  int threads;         ///< number of instructions a thread can wait at (CHAR/ANY/CLASS/MATCH)
+  int groups;          ///< number of groups so far
+  JsreFlags flags;
+  const char *error;   ///< set if there was an error
+} JsreCompiler;
+
+static void jsreCompileAlternation(JsreCompiler *c);
+
+// ----------------------------------------------------------------------------
+
+static void jsreEmit(JsreCompiler *c, int byte) {
+  if (c->len >= JSRE_MAX_CODE_SIZE) {
+    if (!c->error) c->error = "Too large";
+    return;
+  }
+  if (c->code) c->code[c->len] = (unsigned char)byte;
+  c->len++;
+}
+
+static void jsreEmitBytes(JsreCompiler *c, const unsigned char *bytes, size_t len) {
+  if (c->len+len > JSRE_MAX_CODE_SIZE) {
+    if (!c->error) c->error = "Too large";
+    return;
+  }
+  if (c->code) memcpy(&c->code[c->len], bytes, len);
+  c->len += len;
+}
+
+/// Write a relative jump at the given position in the code
+static void jsreSetRel(JsreCompiler *c, size_t pos, int rel) {
+  if (!c->code || c->error) return;
+  c->code[pos] = (unsigned char)(rel&255);
+  c->code[pos+1] = (unsigned char)((rel>>8)&255);
+}
+
+static void jsreEmitSplit(JsreCompiler *c, int relX, int relY, bool swap) {
+  size_t pos = c->len;
+  jsreEmit(c, JSRE_OP_SPLIT);
+  jsreEmit(c, 0); jsreEmit(c, 0);
+  jsreEmit(c, 0); jsreEmit(c, 0);
+  jsreSetRel(c, pos+1, swap ? relY : relX);
+  jsreSetRel(c, pos+3, swap ? relX : relY);
+}
+
+static void jsreEmitJmp(JsreCompiler *c, int rel) {
+  size_t pos = c->len;
+  jsreEmit(c, JSRE_OP_JMP);
+  jsreEmit(c, 0); jsreEmit(c, 0);
+  jsreSetRel(c, pos+1, rel);
+}
+
+static void jsreEmitChar(JsreCompiler *c, char ch) {
+  if ((c->flags & JSRE_IGNORECASE) && ch>='A' && ch<='Z') ch = (char)(ch + 'a' - 'A');
+  jsreEmit(c, JSRE_OP_CHAR);
+  jsreEmit(c, (unsigned char)ch);
+  c->threads++;
+}
+
+static void jsreEmitClass(JsreCompiler *c, const unsigned char *bits) {
+  jsreEmit(c, JSRE_OP_CLASS);
+  jsreEmitBytes(c, bits, JSRE_CLASS_SIZE);
+  c->threads++;
+}
+
+// ----------------------------------------------------------------------------
+
+static int jsreHexDigit(char ch) {
+  if (ch>='0' && ch<='9') return ch-'0';
+  if (ch>='a' && ch<='f') return ch-'a'+10;
+  if (ch>='A' && ch<='F') return ch-'A'+10;
+  return -1;
+}
+
+/// Parse a hex number of 'digits' digits, or return -1 (not moving on) if it's not there
+static int jsreParseHex(JsreCompiler *c, int digits) {
+  if (c->end-c->p < digits) return -1;
+  int i, v = 0;
+  for (i=0;i<digits;i++) {
+    int d = jsreHexDigit(c->p[i]);
+    if (d<0) return -1;
+    v = (v<<4) | d;
+  }
+  c->p += digits;
+  return v;
+}
+
+/// We've just had a backslash followed by ch - get the character it represents
+static char jsreEscapeChar(JsreCompiler *c, char ch) {
+  int v;
+  switch (ch) {
+    case 'n': return 0x0A;
+    case 'r': return 0x0D;
+    case 't': return 0x09;
+    case 'v': return 0x0B;
+    case 'f': return 0x0C;
+    case '0': return 0;
+    case 'x': v = jsreParseHex(c, 2);
+              return (char)((v<0) ? 'x' : v);
+    case 'u': v = jsreParseHex(c, 4); // We don't support unicode, so just take the bottom 8 bits
+              return (char)((v<0) ? 'u' : (v&255));
+    case 'c': if (c->p<c->end && isAlpha(*c->p) && *c->p!='_')
+                return (char)(*(c->p++) & 31);
+              return 'c';
+    default: return ch;
+  }
+}
+
+#define JSRE_CLASS_SET(bits, ch) (bits)[((unsigned char)(ch))>>3] |= (unsigned char)(1<<((ch)&7))
+
+static void jsreClassAddRange(JsreCompiler *c, unsigned char *bits, int lo, int hi) {
+  int ch;
+  for (ch=lo;ch<=hi;ch++) {
+    JSRE_CLASS_SET(bits, ch);
+    if (c->flags & JSRE_IGNORECASE) {
+      if (ch>='A' && ch<='Z') JSRE_CLASS_SET(bits, ch+'a'-'A');
+      if (ch>='a' && ch<='z') JSRE_CLASS_SET(bits, ch-'a'+'A');
+    }
+  }
+}
+
+/// If ch is one of d,D,w,W,s,S add its characters to bits and return true
+static bool jsreClassAddEscape(unsigned char *bits, char ch) {
+  unsigned char set[JSRE_CLASS_SIZE];
+  memset(set, 0, sizeof(set));
+  int i;
+  switch (ch) {
+    case 'd': case 'D':
+      for (i='0';i<='9';i++) JSRE_CLASS_SET(set, i);
+      break;
+    case 'w': case 'W':
+      for (i='0';i<='9';i++) JSRE_CLASS_SET(set, i);
+      for (i='a';i<='z';i++) JSRE_CLASS_SET(set, i);
+      for (i='A';i<='Z';i++) JSRE_CLASS_SET(set, i);
+      JSRE_CLASS_SET(set, '_');
+      break;
+    case 's': case 'S':
+      for (i=0x09;i<=0x0D;i++) JSRE_CLASS_SET(set, i); // \t \n \v \f \r
+      JSRE_CLASS_SET(set, ' ');
+      JSRE_CLASS_SET(set, 0xA0);
+      break;
+    default:
+      return false;
+  }
+  bool negate = ch>='A' && ch<='Z';
+  for (i=0;i<JSRE_CLASS_SIZE;i++)
+    bits[i] |= negate ? (unsigned char)~set[i] : set[i];
+  return true;
+}
+
+/// Get a character for a [class]. Returns -1 if it was something like \d which has been added already
+static int jsreClassChar(JsreCompiler *c, unsigned char *bits) {
+  char ch = *(c->p++);
+  if (ch!='\\') return (unsigned char)ch;
+  if (c->p>=c->end) {
+    c->error = "\\ at end of pattern";
+    return -1;
+  }
+  ch = *(c->p++);
+  if (jsreClassAddEscape(bits, ch)) return -1;
+  if (ch=='b') return 0x08; // backspace, not word boundary
+  return (unsigned char)jsreEscapeChar(c, ch);
+}
+
+/// We've had '[' - compile the character class
+static void jsreCompileClass(JsreCompiler *c) {
+  unsigned char bits[JSRE_CLASS_SIZE];
+  memset(bits, 0, sizeof(bits));
+  bool negate = false;
+  if (c->p<c->end && *c->p=='^') {
+    negate = true;
+    c->p++;
+  }
+  while (!c->error && c->p<c->end && *c->p!=']') {
+    int lo = jsreClassChar(c, bits);
+    if (lo<0) continue;
+    int hi = lo;
+    if (c->p+1<c->end && *c->p=='-' && c->p[1]!=']') {
+      c->p++;
+      hi = jsreClassChar(c, bits);
+      if (hi<0) { // eg. [a-\d] - the '-' is just a character
+        jsreClassAddRange(c, bits, lo, lo);
+        jsreClassAddRange(c, bits, '-', '-');
+        continue;
+      }
+      if (hi<lo) c->error = "Range out of order in character class";
+    }
+    jsreClassAddRange(c, bits, lo, hi);
+  }
+  if (c->error) return;
+  if (c->p>=c->end) {
+    c->error = "Unterminated character class";
+    return;
+  }
+  c->p++; // ']'
+  if (negate) {
+    int i;
+    for (i=0;i<JSRE_CLASS_SIZE;i++) bits[i] = (unsigned char)~bits[i];
+  }
+  jsreEmitClass(c, bits);
+}
+
+static void jsreCompileAtom(JsreCompiler *c) {
+  char ch = *(c->p++);
+  switch (ch) {
+    case '(': {
+      int group = -1;
+      if (c->p<c->end && *c->p=='?') {
+        if (c->p+1<c->end && c->p[1]==':') {
+          c->p += 2; // non-capturing group
+        } else {
+          c->error = "Lookahead not supported";
+          return;
+        }
+      } else {
+        group = c->groups++;
+        if (group >= JSRE_MAX_GROUPS) {
+          c->error = "Too many groups";
+          return;
+        }
+        jsreEmit(c, JSRE_OP_SAVE);
+        jsreEmit(c, group*2);
+      }
+      jsreCompileAlternation(c);
+      if (c->error) return;
+      if (c->p>=c->end || *c->p!=')') {
+        c->error = "Unterminated group";
+        return;
+      }
+      c->p++;
+      if (group>=0) {
+        jsreEmit(c, JSRE_OP_SAVE);
+        jsreEmit(c, group*2+1);
+      }
+    } break;
+    case '*':
+    case '+':
+    case '?':
+      c->error = "Nothing to repeat";
+      break;
+    case '[':
+      jsreCompileClass(c);
+      break;
+    case '.':
+      jsreEmit(c, JSRE_OP_ANY);
+      c->threads++;
+      break;
+    case '^':
+      jsreEmit(c, JSRE_OP_BOL);
+      break;
+    case '$':
+      jsreEmit(c, JSRE_OP_EOL);
+      break;
+    case '\\': {
+      if (c->p>=c->end) {
+        c->error = "\\ at end of pattern";
+        return;
+      }
+      ch = *(c->p++);
+      unsigned char bits[JSRE_CLASS_SIZE];
+      memset(bits, 0, sizeof(bits));
+      if (ch=='b') jsreEmit(c, JSRE_OP_WORDB);
+      else if (ch=='B') jsreEmit(c, JSRE_OP_NWORDB);
+      else if (ch>='1' && ch<='9') c->error = "Backreferences not supported";
+      else if (jsreClassAddEscape(bits, ch)) jsreEmitClass(c, bits);
+      else jsreEmitChar(c, jsreEscapeChar(c, ch));
+    } break;
+    default:
+      jsreEmitChar(c, ch);
+      break;
+  }
+}
+
+static int jsreParseInt(JsreCompiler *c) {
+  int v = 0;
+  while (c->p<c->end && isNumeric(*c->p)) {
+    v = v*10 + (*(c->p++) - '0');
+    if (v > 10000) v = 10000; // it'll be too large anyway
+  }
+  return v;
+}
+
+/// Parse a quantifier (if there is one) and return true. max<0 means no maximum
+static bool jsreParseQuantifier(JsreCompiler *c, int *min, int *max) {
+  if (c->p>=c->end) return false;
+  switch (*c->p) {
+    case '*': *min = 0; *max = -1; c->p++; return true;
+    case '+': *min = 1; *max = -1; c->p++; return true;
+    case '?': *min = 0; *max = 1; c->p++; return true;
+    case '{': {
+      // {n}, {n,} or {n,m} - anything else is just a '{' character
+      const char *start = c->p++;
+      if (c->p>=c->end || !isNumeric(*c->p)) { c->p = start; return false; }
+      *min = *max = jsreParseInt(c);
+      if (c->p<c->end && *c->p==',') {
+        c->p++;
+        *max = (c->p<c->end && isNumeric(*c->p)) ? jsreParseInt(c) : -1;
+      }
+      if (c->p>=c->end || *c->p!='}') { c->p = start; return false; }
+      c->p++;
+      if (*max>=0 && *max<*min) c->error = "Numbers out of order in {} quantifier";
+      return true;
+    }
+    default: return false;
+  }
+}
+
+/// The atom at atomStart has just been compiled - make it repeat
+static void jsreCompileRepeat(JsreCompiler *c, size_t atomStart, int atomThreads, int min, int max, bool lazy) {
+  size_t atomLen = c->len - atomStart;
+  unsigned char *atom = 0;
+  if (c->code) {
+    atom = (unsigned char*)alloca(atomLen);
+    memcpy(atom, &c->code[atomStart], atomLen);
+  }
+  c->len = atomStart;
+  c->threads -= atomThreads;
+  // jumps are relative, so we can just copy the atom's code as many times as we need it
+  int i;
+  for (i=0;i<min && !c->error;i++) {
+    jsreEmitBytes(c, atom, atomLen);
+    c->threads += atomThreads;
+  }
+  if (max<0) {
+    if (min>0) {
+      // e+ : go back to the start of the last copy
+      jsreEmitSplit(c, -(int)atomLen, JSRE_SPLIT_SIZE, lazy);
+    } else {
+      // e* : L1: SPLIT L2, L3; L2: e; JMP L1; L3:
+      jsreEmitSplit(c, JSRE_SPLIT_SIZE, (int)(JSRE_SPLIT_SIZE+atomLen+JSRE_JMP_SIZE), lazy);
+      jsreEmitBytes(c, atom, atomLen);
+      c->threads += atomThreads;
+      jsreEmitJmp(c, -(int)(JSRE_SPLIT_SIZE+atomLen));
+    }
+  } else {
+    // e? as many times as needed
+    for (;i<max && !c->error;i++) {
+      jsreEmitSplit(c, JSRE_SPLIT_SIZE, (int)(JSRE_SPLIT_SIZE+atomLen), lazy);
+      jsreEmitBytes(c, atom, atomLen);
+      c->threads += atomThreads;
+    }
+  }
+}
+
+static void jsreCompileSequence(JsreCompiler *c) {
+  while (!c->error && c->p<c->end && *c->p!='|' && *c->p!=')') {
+    size_t atomStart = c->len;
+    int threadsBefore = c->threads;
+    jsreCompileAtom(c);
+    int min, max;
+    if (!c->error && jsreParseQuantifier(c, &min, &max) && !c->error) {
+      bool lazy = c->p<c->end && *c->p=='?';
+      if (lazy) c->p++;
+      jsreCompileRepeat(c, atomStart, c->threads-threadsBefore, min, max, lazy);
+    }
+  }
+}
+
+static void jsreCompileAlternation(JsreCompiler *c) {
+  size_t start = c->len;
+  jsreCompileSequence(c);
+  if (c->error || c->p>=c->end || *c->p!='|') return;
+  c->p++;
+  // a|b : SPLIT L1, L2; L1: a; JMP L3; L2: b; L3:
+  if (c->len+JSRE_SPLIT_SIZE > JSRE_MAX_CODE_SIZE) {
+    c->error = "Too large";
+    return;
+  }
+  if (c->code) memmove(&c->code[start+JSRE_SPLIT_SIZE], &c->code[start], c->len-start);
+  c->len += JSRE_SPLIT_SIZE;
+  size_t jmp = c->len;
+  jsreEmitJmp(c, 0);
+  jsreCompileAlternation(c);
+  if (c->code && !c->error) c->code[start] = JSRE_OP_SPLIT;
+  jsreSetRel(c, start+1, JSRE_SPLIT_SIZE);
+  jsreSetRel(c, start+3, (int)(jmp+JSRE_JMP_SIZE-start));
+  jsreSetRel(c, jmp+1, (int)(c->len-jmp));
+}
+
+static void jsreCompilePattern(JsreCompiler *c, const char *src, size_t len, JsreFlags flags, unsigned char *code) {
+  c->p = src;
+  c->end = src+len;
+  c->code = code;
+  c->len = 0;
+  c->threads = 0;
+  c->groups = 1; // group 0 is the whole match
+  c->flags = flags;
+  c->error = 0;
+  int i;
+  for (i=0;i<JSRE_HEADER_SIZE;i++) jsreEmit(c, 0);
+  jsreEmit(c, JSRE_OP_SAVE);
+  jsreEmit(c, 0);
+  jsreCompileAlternation(c);
+  if (!c->error && c->p<c->end) c->error = "Unmatched ')'";
+  jsreEmit(c, JSRE_OP_SAVE);
+  jsreEmit(c, 1);
+  jsreEmit(c, JSRE_OP_MATCH);
+  c->threads++;
+  if (c->code && !c->error) {
+    c->code[0] = (unsigned char)c->flags;
+    c->code[1] = (unsigned char)c->groups;
+    c->code[2] = (unsigned char)(c->threads&255);
+    c->code[3] = (unsigned char)(c->threads>>8);
+  }
+}
+
+JsVar *jsreCompile(JsVar *source, JsVar *flagsVar) {
+  JsreFlags flags = 0;
+  if (jsvIsString(flagsVar)) {
+    JsvStringIterator it;
+    jsvStringIteratorNew(&it, flagsVar, 0);
+    while (jsvStringIteratorHasChar(&it)) {
+      char ch = jsvStringIteratorGetChar(&it);
+      if (ch=='g') flags |= JSRE_GLOBAL;
+      else if (ch=='i') flags |= JSRE_IGNORECASE;
+      else if (ch=='m') flags |= JSRE_MULTILINE;
+      else {
+        jsExceptionHere(JSET_SYNTAXERROR, "Invalid RegExp flag '%c'", ch);
+        jsvStringIteratorFree(&it);
+        return 0;
+      }
+      jsvStringIteratorNext(&it);
+    }
+    jsvStringIteratorFree(&it);
+  }
+
+  size_t srcLen = jsvGetStringLength(source);
+  if (srcLen+JSRE_MAX_CODE_SIZE+256 > jsuGetFreeStack()) {
+    jsExceptionHere(JSET_ERROR, "Not enough free stack to compile RegExp");
+    return 0;
+  }
+  char *src = (char*)alloca(srcLen+1);
+  jsvGetStringChars(source, 0, src, srcLen);
+
+  // Work out how much code we need, then actually write it
+  JsreCompiler c;
+  jsreCompilePattern(&c, src, srcLen, flags, 0);
+  if (!c.error) {
+    unsigned char *code = (unsigned char*)alloca(c.len);
+    jsreCompilePattern(&c, src, srcLen, flags, code);
+    if (!c.error) {
+      JsVar *codeVar = jsvNewFromEmptyString();
+      if (codeVar && !jsvAppendStringBuf(codeVar, (const char*)code, c.len)) {
+        jsvUnLock(codeVar);
+        codeVar = 0; // out of memory
+      }
+      return codeVar;
+    }
+  }
+  jsExceptionHere(JSET_SYNTAXERROR, "Invalid RegExp: %s", c.error);
+  return 0;
+}
+
+JsreFlags jsreGetFlags(JsVar *code) {
+  return (JsreFlags)(unsigned char)jsvGetCharInString(code, 0);
+}
+
+int jsreGetGroupCount(JsVar *code) {
+  return (unsigned char)jsvGetCharInString(code, 1);
+}
+
+// ----------------------------------------------------------------------------
+
+typedef struct {
+  const unsigned char *code;
+  size_t groupSlots;      ///< entries in each thread's list of groups (2 per group)
+  unsigned char *visited; ///< bitmap of instructions already added to the list we're building
+  bool multiline;
+  size_t idx;             ///< index of the character we're about to match
+  int lastCh;             ///< character before idx (or -1)
+  int ch;                 ///< character at idx (or -1)
+} JsreVM;
+
+typedef struct {
+  unsigned short *pc; ///< instruction each thread is waiting at
+  size_t *groups;     ///< groupSlots entries per thread
+  size_t count;
+} JsreThreads;
+
+static inline int jsreGetRel(const unsigned char *p) {
+  return (int)(short)(p[0] | (p[1]<<8));
+}
+
+static bool jsreIsWordChar(int ch) {
+  return ch>=0 && (isAlpha((char)ch) || isNumeric((char)ch));
+}
+
+/// Follow instructions that don't need a character until we get to one that does, and add a thread there
+static void jsreAddThread(JsreVM *vm, JsreThreads *list, size_t pc, size_t *groups) {
+  if (vm->visited[pc>>3] & (1<<(pc&7))) return; // a higher priority thread already got here
+  vm->visited[pc>>3] |= (unsigned char)(1<<(pc&7));
+  const unsigned char *op = &vm->code[pc];
+  switch (*op) {
+    case JSRE_OP_JMP:
+      jsreAddThread(vm, list, (size_t)((int)pc + jsreGetRel(&op[1])), groups);
+      break;
+    case JSRE_OP_SPLIT:
+      jsreAddThread(vm, list, (size_t)((int)pc + jsreGetRel(&op[1])), groups);
+      jsreAddThread(vm, list, (size_t)((int)pc + jsreGetRel(&op[3])), groups);
+      break;
+    case JSRE_OP_SAVE: {
+      size_t old = groups[op[1]];
+      groups[op[1]] = vm->idx;
+      jsreAddThread(vm, list, pc+2, groups);
+      groups[op[1]] = old;
+    } break;
+    case JSRE_OP_BOL:
+      if (vm->lastCh<0 || (vm->multiline && (vm->lastCh=='\n' || vm->lastCh=='\r')))
+        jsreAddThread(vm, list, pc+1, groups);
+      break;
+    case JSRE_OP_EOL:
+      if (vm->ch<0 || (vm->multiline && (vm->ch=='\n' || vm->ch=='\r')))
+        jsreAddThread(vm, list, pc+1, groups);
+      break;
+    case JSRE_OP_WORDB:
+    case JSRE_OP_NWORDB:
+      if ((jsreIsWordChar(vm->lastCh) != jsreIsWordChar(vm->ch)) == (*op==JSRE_OP_WORDB))
+        jsreAddThread(vm, list, pc+1, groups);
+      break;
+    default: // CHAR, ANY, CLASS or MATCH - wait here for the next character
+      list->pc[list->count] = (unsigned short)pc;
+      memcpy(&list->groups[list->count*vm->groupSlots], groups, vm->groupSlots*sizeof(size_t));
+      list->count++;
+      break;
+  }
+}
+
+bool jsreExec(JsVar *codeVar, JsVar *str, size_t startIdx, size_t *groups) {
+  size_t codeLen = jsvGetStringLength(codeVar);
+  if (codeLen <= JSRE_HEADER_SIZE) return false;
+  unsigned char header[JSRE_HEADER_SIZE];
+  jsvGetStringChars(codeVar, 0, (char*)header, JSRE_HEADER_SIZE);
+  size_t groupSlots = (size_t)header[1]*2;
+  size_t maxThreads = (size_t)(header[2] | (header[3]<<8));
+  size_t visitedSize = (codeLen+7)>>3;
+  size_t stackNeeded = codeLen+1 + visitedSize + (2*maxThreads+1)*groupSlots*sizeof(size_t) + 2*maxThreads*sizeof(unsigned short);
+  if (stackNeeded+256 > jsuGetFreeStack()) {
+    jsExceptionHere(JSET_ERROR, "Not enough free stack to run RegExp");
+    return false;
+  }
+
+  JsreVM vm;
+  unsigned char *code = (unsigned char*)alloca(codeLen+1);
+  jsvGetStringChars(codeVar, 0, (char*)code, codeLen);
+  vm.code = code;
+  vm.groupSlots = groupSlots;
+  vm.visited = (unsigned char*)alloca(visitedSize);
+  vm.multiline = (header[0] & JSRE_MULTILINE)!=0;
+  bool ignoreCase = (header[0] & JSRE_IGNORECASE)!=0;
+  JsreThreads lists[2];
+  int i;
+  for (i=0;i<2;i++) {
+    lists[i].pc = (unsigned short*)alloca(maxThreads*sizeof(unsigned short));
+    lists[i].groups = (size_t*)alloca(maxThreads*groupSlots*sizeof(size_t));
+    lists[i].count = 0;
+  }
+  size_t *noGroups = (size_t*)alloca(groupSlots*sizeof(size_t));
+  size_t g;
+  for (g=0;g<groupSlots;g++) noGroups[g] = JSRE_NO_MATCH;
+  JsreThreads *clist = &lists[0];
+  JsreThreads *nlist = &lists[1];
+
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, str, startIdx);
+  vm.idx = startIdx;
+  vm.lastCh = startIdx ? (unsigned char)jsvGetCharInString(str, startIdx-1) : -1;
+  vm.ch = jsvStringIteratorGetCharOrMinusOne(&it);
+
+  bool matched = false;
+  memset(vm.visited, 0, visitedSize);
+  jsreAddThread(&vm, clist, JSRE_HEADER_SIZE, noGroups);
+  // keep going while there are threads left - or if nothing matched, until the end of the string
+  while (clist->count || !matched) {
+    int ch = vm.ch;
+    if (ignoreCase && ch>='A' && ch<='Z') ch += 'a'-'A';
+    // move on - any threads we add now are for the next character
+    if (vm.ch>=0) jsvStringIteratorNextInline(&it);
+    vm.lastCh = vm.ch;
+    vm.idx++;
+    vm.ch = jsvStringIteratorGetCharOrMinusOne(&it);
+    nlist->count = 0;
+    memset(vm.visited, 0, visitedSize);
+
+    size_t t;
+    for (t=0;t<clist->count;t++) {
+      size_t pc = clist->pc[t];
+      size_t *threadGroups = &clist->groups[t*groupSlots];
+      const unsigned char *op = &code[pc];
+      if (*op==JSRE_OP_MATCH) {
+        // this is the best match so far - and lower priority threads can't beat it
+        matched = true;
+        memcpy(groups, threadGroups, groupSlots*sizeof(size_t));
+        break;
+      } else if (*op==JSRE_OP_CHAR) {
+        if (ch==op[1]) jsreAddThread(&vm, nlist, pc+2, threadGroups);
+      } else if (*op==JSRE_OP_ANY) {
+        if (ch>=0 && ch!='\n' && ch!='\r') jsreAddThread(&vm, nlist, pc+1, threadGroups);
+      } else if (*op==JSRE_OP_CLASS) {
+        if (ch>=0 && (op[1+(ch>>3)] & (1<<(ch&7)))) jsreAddThread(&vm, nlist, pc+1+JSRE_CLASS_SIZE, threadGroups);
+      }
+    }
+    if (ch<0) break; // end of the string
+    // if we haven't found anything yet, try starting a match at the next character
+    if (!matched) jsreAddThread(&vm, nlist, JSRE_HEADER_SIZE, noGroups);
+    JsreThreads *tmp = clist;
+    clist = nlist;
+    nlist = tmp;
+  }
+  jsvStringIteratorFree(&it);
+  for (g=groupSlots;g<JSRE_MAX_GROUPS*2;g++) groups[g] = JSRE_NO_MATCH;
+  return matched;
+}
@@ -0,0 +1,41 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Regular Expressions - compiled to bytecode and run directly over JsVar strings
+ * ----------------------------------------------------------------------------
+ */
+#ifndef JSREGEX_H_
+#define JSREGEX_H_
+
+#include "jsvar.h"
+
+#define JSRE_MAX_GROUPS 10 ///< Maximum number of groups (including the whole match, group 0)
+#define JSRE_MAX_CODE_SIZE 4096 ///< Maximum size of compiled bytecode
+#define JSRE_NO_MATCH ((size_t)-1) ///< Start/end index of a group that didn't match
+
+typedef enum {
+  JSRE_GLOBAL = 1,     ///< 'g' - search for all matches
+  JSRE_IGNORECASE = 2, ///< 'i' - case insensitive
+  JSRE_MULTILINE = 4,  ///< 'm' - ^ and $ match at newlines
+} JsreFlags;
+
+/** Compile a regular expression (and a String of flags, eg "gi", or undefined) into a String
+ * of bytecode. Returns 0 and raises a SyntaxError if it can't be compiled */
+JsVar *jsreCompile(JsVar *source, JsVar *flags);
+/// Get the flags that a compiled regular expression was created with
+JsreFlags jsreGetFlags(JsVar *code);
+/// Get the number of groups (including the whole match) in a compiled regular expression
+int jsreGetGroupCount(JsVar *code);
+/** Search for the compiled regular expression in str, starting at startIdx. If found, returns
+ * true and sets groups[n*2] and groups[n*2+1] to the start and end index of each group
+ * (or JSRE_NO_MATCH). groups must have space for JSRE_MAX_GROUPS*2 entries. */
+bool jsreExec(JsVar *code, JsVar *str, size_t startIdx, size_t *groups);
+
+#endif /* JSREGEX_H_ */
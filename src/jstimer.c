@@ -15,51 +15,183 @@
 #include "jsparse.h"
 #include "jsinteractive.h"
 
-UtilTimerTask utilTimerTasks[UTILTIMERTASK_TASKS];
-volatile unsigned char utilTimerTasksHead = 0;
-volatile unsigned char utilTimerTasksTail = 0;
+/** Timer tasks, stored as a binary heap ordered by time - so utilTimerTasks[0]
+ * is always the next task to execute, and the children of task N are
+ * tasks 2N+1 and 2N+2 */
+THREAD_LOCAL UtilTimerTask utilTimerTasks[UTILTIMERTASK_TASKS];
+THREAD_LOCAL volatile unsigned int utilTimerTasksCount = 0;
+
+#ifndef SAVE_ON_FLASH
+/// Statistics for the whole timer queue (for E.dumpTimers)
+typedef struct {
+  unsigned int full; ///< How many times a task couldn't be added because the queue was full
+  unsigned int skipped; ///< How many repeats were skipped because a task was executed too late
+  unsigned int maxTasks; ///< The most tasks there have been in the queue at once
+} UtilTimerStats;
+THREAD_LOCAL UtilTimerStats utilTimerStats;
+#endif
 
 
-volatile bool utilTimerOn = false;
-unsigned int utilTimerBit;
-bool utilTimerState;
-unsigned int utilTimerData;
-uint16_t utilTimerReload0H, utilTimerReload0L, utilTimerReload1H, utilTimerReload1L;
+THREAD_LOCAL volatile bool utilTimerOn = false;
+THREAD_LOCAL unsigned int utilTimerBit;
+THREAD_LOCAL bool utilTimerState;
+THREAD_LOCAL unsigned int utilTimerData;
+THREAD_LOCAL uint16_t utilTimerReload0H, utilTimerReload0L, utilTimerReload1H, utilTimerReload1L;
 
 
 #ifndef SAVE_ON_FLASH
-static void jstUtilTimerInterruptHandlerNextByte(UtilTimerTask *task) {
+THREAD_LOCAL UtilTimerChannel utilTimerChannels[UTILTIMER_CHANNELS];
+
+/// Move to the next byte in a channel's data - returns false if there is no more
+static bool jstChannelNextByte(UtilTimerChannel *channel) {
   // move to next element in var
-  task->data.buffer.charIdx++;
-  size_t maxChars = jsvGetCharactersInVar(task->data.buffer.var);
-  if (task->data.buffer.charIdx >= maxChars) {
-    task->data.buffer.charIdx = (unsigned char)(task->data.buffer.charIdx - maxChars);
+  channel->charIdx++;
+  size_t maxChars = jsvGetCharactersInVar(channel->var);
+  if (channel->charIdx >= maxChars) {
+    channel->charIdx = (unsigned char)(channel->charIdx - maxChars);
     /* NOTE: We don't Lock/UnLock here. We assume that the string has already been
      * referenced elsewhere (in the Waveform class) so won't get freed. Why? Because
      * we can't lock easily. We could get an IRQ right as some other code was in the
      * middle of read/modify/write of the flags member, and then the locks would get
      * out of sync. */
-    if (jsvGetLastChild(task->data.buffer.var)) {
-      task->data.buffer.var = _jsvGetAddressOf(jsvGetLastChild(task->data.buffer.var));
+    if (jsvGetLastChild(channel->var)) {
+      channel->var = _jsvGetAddressOf(jsvGetLastChild(channel->var));
     } else { // else no more... move on to the next
-      if (task->data.buffer.nextBuffer) {
-        task->data.buffer.charIdx = 0;
-        task->data.buffer.var = _jsvGetAddressOf(task->data.buffer.nextBuffer);
+      if (channel->nextBuffer) {
+        channel->charIdx = 0;
+        channel->var = _jsvGetAddressOf(channel->nextBuffer);
         // flip buffers
-        JsVarRef t = task->data.buffer.nextBuffer;
-        task->data.buffer.nextBuffer = task->data.buffer.currentBuffer;
-        task->data.buffer.currentBuffer = t;
+        JsVarRef t = channel->nextBuffer;
+        channel->nextBuffer = channel->currentBuffer;
+        channel->currentBuffer = t;
       } else {
-        task->data.buffer.var = 0;
-        // No more data - make sure we don't repeat!
-        task->repeatInterval = 0;
+        channel->var = 0;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static inline unsigned char *jstChannelByte(UtilTimerChannel *channel) {
+  return (unsigned char*)&channel->var->varData.str[channel->charIdx];
+}
+
+/** Read a sample from the data into block 'b' of an output channel, until the
+ * block is full or there is no more data. Interrupts must be off (or we must be in the IRQ) */
+static void jstChannelRender(UtilTimerChannel *channel, unsigned char b) {
+  unsigned char n = 0;
+  while (n<UTILTIMER_BLOCK_SIZE && channel->var) {
+    // get data
+    int v;
+    if (channel->type == UET_WRITE_SHORT) {
+      v = *jstChannelByte(channel);  // LSB first
+      if ((size_t)channel->charIdx+1 < jsvGetCharactersInVar(channel->var))
+        v |= jstChannelByte(channel)[1] << 8;
+      else { // the MSB is in the next block of the string
+        unsigned char charIdx = channel->charIdx;
+        JsVar *var = channel->var;
+        JsVarRef currentBuffer = channel->currentBuffer, nextBuffer = channel->nextBuffer;
+        if (jstChannelNextByte(channel)) v |= *jstChannelByte(channel) << 8;
+        channel->charIdx = charIdx;
+        channel->var = var;
+        channel->currentBuffer = currentBuffer;
+        channel->nextBuffer = nextBuffer;
       }
+    } else {
+      v = *jstChannelByte(channel) << 8;
+    }
+    channel->block[b][n++] = (short)(v - 32768);
+    // now move on by however many samples we need to
+    channel->phase += channel->step;
+    while (channel->var && channel->phase >= 0x10000) {
+      channel->phase -= 0x10000;
+      if (jstChannelNextByte(channel) && channel->type == UET_WRITE_SHORT)
+        jstChannelNextByte(channel);
+    }
+  }
+  channel->blockLength[b] = n;
+}
+
+/// Get the next sample from an output channel - returns false (and frees the channel) if there are no more
+static bool jstChannelNextSample(UtilTimerChannel *channel, int *sample) {
+  if (channel->sampleIdx >= channel->blockLength[channel->blockIdx]) {
+    // finished with this block - move on to the next
+    channel->blockLength[channel->blockIdx] = 0;
+    channel->blockIdx ^= 1;
+    channel->sampleIdx = 0;
+    // if the idle loop didn't get around to rendering it (because we're busy), do it now
+    if (!channel->blockLength[channel->blockIdx])
+      jstChannelRender(channel, channel->blockIdx);
+    if (!channel->blockLength[channel->blockIdx]) {
+      channel->type = UET_WAKEUP; // no more data - free the channel
+      return false;
     }
   }
+  *sample = channel->block[channel->blockIdx][channel->sampleIdx++];
+  return true;
+}
+
+void jstRenderChannels() {
+  int i;
+  for (i=0;i<UTILTIMER_CHANNELS;i++) {
+    UtilTimerChannel *channel = &utilTimerChannels[i];
+    if (!UET_IS_BUFFER_WRITE_EVENT(channel->type)) continue;
+    jshInterruptOff();
+    unsigned char b = channel->blockIdx^1;
+    if (UET_IS_BUFFER_WRITE_EVENT(channel->type) && !channel->blockLength[b])
+      jstChannelRender(channel, b);
+    jshInterruptOn();
+  }
+}
+#endif
+
+/// Move the task at the given index towards the root of the heap until it's in the right place
+static void utilTimerSiftUp(unsigned int idx) {
+  UtilTimerTask task = utilTimerTasks[idx];
+  while (idx>0) {
+    unsigned int parent = (idx-1) >> 1;
+    if (utilTimerTasks[parent].time <= task.time) break;
+    utilTimerTasks[idx] = utilTimerTasks[parent];
+    idx = parent;
+  }
+  utilTimerTasks[idx] = task;
+}
+
+/// Move the task at the given index away from the root of the heap until it's in the right place
+static void utilTimerSiftDown(unsigned int idx) {
+  UtilTimerTask task = utilTimerTasks[idx];
+  while (true) {
+    unsigned int child = idx*2 + 1;
+    if (child >= utilTimerTasksCount) break;
+    if (child+1 < utilTimerTasksCount && utilTimerTasks[child+1].time < utilTimerTasks[child].time)
+      child++;
+    if (task.time <= utilTimerTasks[child].time) break;
+    utilTimerTasks[idx] = utilTimerTasks[child];
+    idx = child;
+  }
+  utilTimerTasks[idx] = task;
 }
 
-static inline unsigned char *jstUtilTimerInterruptHandlerByte(UtilTimerTask *task) {
-  return (unsigned char*)&task->data.buffer.var->varData.str[task->data.buffer.charIdx];
+/// Remove the task at the given index from the heap. Interrupts must be off (or we must be in the IRQ)
+static void utilTimerRemoveTask(unsigned int idx) {
+  utilTimerTasksCount--;
+  if (idx == utilTimerTasksCount) return; // it was the last task anyway
+  utilTimerTasks[idx] = utilTimerTasks[utilTimerTasksCount];
+  if (idx>0 && utilTimerTasks[idx].time < utilTimerTasks[(idx-1)>>1].time)
+    utilTimerSiftUp(idx);
+  else
+    utilTimerSiftDown(idx);
+}
+
+#ifndef SAVE_ON_FLASH
+/// Record how late a task was executed
+static void utilTimerTaskStatsUpdate(UtilTimerTaskStats *stats, JsSysTime late) {
+  unsigned int l = (late > 0xFFFFFFFF) ? 0xFFFFFFFF : (unsigned int)late;
+  if (!stats->count || l < stats->lateMin) stats->lateMin = l;
+  if (!stats->count || l > stats->lateMax) stats->lateMax = l;
+  stats->lateSum = (stats->lateSum+l < stats->lateSum) ? 0xFFFFFFFF : stats->lateSum+l;
+  if (stats->count != 0xFFFFFFFF) stats->count++;
 }
 #endif
 
@@ -67,8 +199,11 @@ void jstUtilTimerInterruptHandler() {
   if (utilTimerOn) {
     JsSysTime time = jshGetSystemTime();
     // execute any timers that are due
-    while (utilTimerTasksTail!=utilTimerTasksHead && utilTimerTasks[utilTimerTasksTail].time <= time) {
-      UtilTimerTask *task = &utilTimerTasks[utilTimerTasksTail];
+    while (utilTimerTasksCount && utilTimerTasks[0].time <= time) {
+      UtilTimerTask *task = &utilTimerTasks[0];
+#ifndef SAVE_ON_FLASH
+      utilTimerTaskStatsUpdate(&task->stats, time - task->time);
+#endif
       // actually perform the task
       switch (task->type) {
         case UET_SET: {
@@ -80,46 +215,57 @@ void jstUtilTimerInterruptHandler() {
         } break;
 #ifndef SAVE_ON_FLASH
         case UET_READ_SHORT: {
-          if (!task->data.buffer.var) break;
-          int v = jshPinAnalogFast(task->data.buffer.pin);
-          *jstUtilTimerInterruptHandlerByte(task) = (unsigned char)v;  // LSB first
-          jstUtilTimerInterruptHandlerNextByte(task);
-          *jstUtilTimerInterruptHandlerByte(task) = (unsigned char)(v >> 8);
-          jstUtilTimerInterruptHandlerNextByte(task);
+          UtilTimerChannel *channel = &utilTimerChannels[task->data.channel];
+          if (!channel->var) break;
+          int v = jshPinAnalogFast(channel->pin);
+          *jstChannelByte(channel) = (unsigned char)v;  // LSB first
+          if (jstChannelNextByte(channel))
+            *jstChannelByte(channel) = (unsigned char)(v >> 8);
+          if (!jstChannelNextByte(channel)) {
+            task->repeatInterval = 0; // No more data - make sure we don't repeat!
+            channel->type = UET_WAKEUP;
+          }
           break;
         }
         case UET_READ_BYTE: {
-          if (!task->data.buffer.var) break;
-          *jstUtilTimerInterruptHandlerByte(task) = (unsigned char)(jshPinAnalogFast(task->data.buffer.pin) >> 8);
-          jstUtilTimerInterruptHandlerNextByte(task);
+          UtilTimerChannel *channel = &utilTimerChannels[task->data.channel];
+          if (!channel->var) break;
+          *jstChannelByte(channel) = (unsigned char)(jshPinAnalogFast(channel->pin) >> 8);
+          if (!jstChannelNextByte(channel)) {
+            task->repeatInterval = 0; // No more data - make sure we don't repeat!
+            channel->type = UET_WAKEUP;
+          }
           break;
         }
-        case UET_WRITE_SHORT:
-        case UET_WRITE_BYTE: {
-          if (!task->data.buffer.var) break;
-          // get data
-          int sum;
-          if (task->type == UET_WRITE_SHORT) {
-             sum = *jstUtilTimerInterruptHandlerByte(task);  // LSB first
-             jstUtilTimerInterruptHandlerNextByte(task);
-          } else {
-            sum = 0;
+        case UET_WRITE_MIX: {
+          // sum the samples from every channel writing to this pin function
+          int sum = 0;
+          bool hasChannels = false;
+          int i;
+          for (i=0;i<UTILTIMER_CHANNELS;i++) {
+            UtilTimerChannel *channel = &utilTimerChannels[i];
+            int sample;
+            if (!UET_IS_BUFFER_WRITE_EVENT(channel->type) ||
+                channel->pinFunction != task->data.pinFunction) continue;
+            if (channel->startDelay) {
+              // not started yet, but we still need to keep outputting
+              channel->startDelay--;
+              hasChannels = true;
+            } else if (jstChannelNextSample(channel, &sample)) {
+              sum += (sample * channel->gain) / UTILTIMER_GAIN_UNITY;
+              hasChannels = true;
+            }
           }
-          sum |=  (unsigned short)(*jstUtilTimerInterruptHandlerByte(task) << 8);
-          jstUtilTimerInterruptHandlerNextByte(task);
-          task->data.buffer.currentValue = (unsigned short)sum;
-          // now search for other tasks writing to this pin... (polyphony)
-          int t = (utilTimerTasksTail+1) & (UTILTIMERTASK_TASKS-1);
-          while (t!=utilTimerTasksHead) {
-            if (UET_IS_BUFFER_WRITE_EVENT(utilTimerTasks[t].type))
-              sum += ((int)(unsigned int)utilTimerTasks[t].data.buffer.currentValue) - 32768;
-            t = (t+1) & (UTILTIMERTASK_TASKS-1);
+          if (!hasChannels) {
+            task->repeatInterval = 0; // Nothing left to output - make sure we don't repeat!
+            break;
           }
+          sum += 32768;
           // saturate
           if (sum<0) sum = 0;
           if (sum>65535) sum = 65535;
           // and output...
-          jshSetOutputValue(task->data.buffer.pinFunction, sum);
+          jshSetOutputValue(task->data.pinFunction, sum);
           break;
         }
 #endif
@@ -129,30 +275,28 @@ void jstUtilTimerInterruptHandler() {
       // If we need to repeat
       if (task->repeatInterval) {
         // update time (we know time > task->time) - what if we're being asked to do too fast? skip one (or 500 :)
+#ifdef LINUX
+        // There's no real-time output on Linux (tasks are run from the idle loop), so catch up rather than skipping
+        unsigned int t = 1;
+#else
         unsigned int t = ((unsigned int)(time+task->repeatInterval - task->time)) / task->repeatInterval;
         if (t<1) t=1;
+#endif
+#ifndef SAVE_ON_FLASH
+        utilTimerStats.skipped += t-1;
+#endif
         task->time = task->time + (JsSysTime)task->repeatInterval*t;
-        // do an in-place bubble sort to ensure that times are still in the right order
-        unsigned char ta = utilTimerTasksTail;
-        unsigned char tb = (ta+1) & (UTILTIMERTASK_TASKS-1);
-        while (tb != utilTimerTasksHead) {
-          if (utilTimerTasks[ta].time > utilTimerTasks[tb].time) {
-            UtilTimerTask task = utilTimerTasks[ta];
-            utilTimerTasks[ta] = utilTimerTasks[tb];
-            utilTimerTasks[tb] = task;
-          }
-          ta = tb;
-          tb = (tb+1) & (UTILTIMERTASK_TASKS-1);
-        }
+        // it's now later than it was - move it down the heap
+        utilTimerSiftDown(0);
       } else {
         // Otherwise no repeat - just go straight to the next one!
-        utilTimerTasksTail = (utilTimerTasksTail+1) & (UTILTIMERTASK_TASKS-1);
+        utilTimerRemoveTask(0);
       }
     }
 
     // re-schedule the timer if there is something left to do
-    if (utilTimerTasksTail != utilTimerTasksHead) {
-      jshUtilTimerReschedule(utilTimerTasks[utilTimerTasksTail].time - time);
+    if (utilTimerTasksCount) {
+      jshUtilTimerReschedule(utilTimerTasks[0].time - time);
     } else {
       utilTimerOn = false;
       jshUtilTimerDisable();
@@ -174,88 +318,91 @@ void jstUtilTimerWaitEmpty() {
 
 /// Return the latest task for a pin (false if not found)
 bool jstGetLastPinTimerTask(Pin pin, UtilTimerTask *task) {
-  unsigned char ptr = utilTimerTasksHead;
-  if (ptr == utilTimerTasksTail) return false; // nothing in here
-  ptr = (ptr+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
-  // now we're at the last timer task - work back until we've just gone back past utilTimerTasksTail
-  while (ptr != ((utilTimerTasksTail+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1))) {
-    if (utilTimerTasks[ptr].type == UET_SET) {
+  bool found = false;
+  unsigned int t;
+  jshInterruptOff();
+  for (t=0;t<utilTimerTasksCount;t++) {
+    if (utilTimerTasks[t].type == UET_SET && (!found || utilTimerTasks[t].time > task->time)) {
       int i;
       for (i=0;i<UTILTIMERTASK_PIN_COUNT;i++)
-        if (utilTimerTasks[ptr].data.set.pins[i] == pin) {
-          *task = utilTimerTasks[ptr];
-          return true;
-        } else if (utilTimerTasks[ptr].data.set.pins[i]==PIN_UNDEFINED)
+        if (utilTimerTasks[t].data.set.pins[i] == pin) {
+          *task = utilTimerTasks[t];
+          found = true;
+          break;
+        } else if (utilTimerTasks[t].data.set.pins[i]==PIN_UNDEFINED)
           break;
     }
-    ptr = (ptr+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
   }
-  return false;
+  jshInterruptOn();
+  return found;
 }
 
 #ifndef SAVE_ON_FLASH
-/// Return true if a timer task for the given variable exists (and set 'task' to it)
-bool jstGetLastBufferTimerTask(JsVar *var, UtilTimerTask *task) {
+/// Return the index of the channel using the given variable, or -1. Interrupts must be off
+static int jstFindBufferChannel(JsVarRef ref) {
+  int i;
+  for (i=0;i<UTILTIMER_CHANNELS;i++) {
+    UtilTimerChannel *channel = &utilTimerChannels[i];
+    if (UET_IS_BUFFER_EVENT(channel->type) &&
+        (channel->currentBuffer==ref || channel->nextBuffer==ref))
+      return i;
+  }
+  return -1;
+}
+
+bool jstGetBufferChannel(JsVar *var, JsVarRef *currentBuffer) {
   JsVarRef ref = jsvGetRef(var);
   jshInterruptOff();
-  unsigned char ptr = utilTimerTasksHead;
-  if (ptr != utilTimerTasksTail) {
-    ptr = (ptr+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
-    // now we're at the last timer task - work back until we've just gone back past utilTimerTasksTail
-    while (ptr != ((utilTimerTasksTail+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1))) {
-      if (UET_IS_BUFFER_EVENT(utilTimerTasks[ptr].type)) {
-        if (utilTimerTasks[ptr].data.buffer.currentBuffer==ref || utilTimerTasks[ptr].data.buffer.nextBuffer==ref) {
-          *task = utilTimerTasks[ptr];
-          jshInterruptOn();
-          return true;
-        }
-      }
-      ptr = (ptr+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
-    }
-  }
+  int idx = jstFindBufferChannel(ref);
+  if (idx>=0) *currentBuffer = utilTimerChannels[idx].currentBuffer;
   jshInterruptOn();
+  return idx>=0;
+}
+
+bool jstHasBufferChannels() {
+  int i;
+  for (i=0;i<UTILTIMER_CHANNELS;i++)
+    if (UET_IS_BUFFER_EVENT(utilTimerChannels[i].type))
+      return true;
   return false;
 }
 #endif
 
 /// Is the timer full - can it accept any other signals?
 static bool utilTimerIsFull() {
-  unsigned char nextHead = (utilTimerTasksHead+1) & (UTILTIMERTASK_TASKS-1);
-  return nextHead == utilTimerTasksTail;
+  return utilTimerTasksCount >= UTILTIMERTASK_TASKS;
 }
 
 // Queue a task up to be executed when a timer fires... return false on failure
 static bool utilTimerInsertTask(UtilTimerTask *task) {
   // check if queue is full or not
-  if (utilTimerIsFull()) return false;
+  if (utilTimerIsFull()) {
+#ifndef SAVE_ON_FLASH
+    utilTimerStats.full++;
+#endif
+    return false;
+  }
 
+#ifndef SAVE_ON_FLASH
+  memset(&task->stats, 0, sizeof(task->stats));
+#endif
 
   jshInterruptOff();
 
-  // find out where to insert
-  unsigned char insertPos = utilTimerTasksTail;
-  while (insertPos != utilTimerTasksHead && utilTimerTasks[insertPos].time < task->time)
-    insertPos = (insertPos+1) & (UTILTIMERTASK_TASKS-1);
-
-  bool haveChangedTimer = insertPos==utilTimerTasksTail;
-  //jsiConsolePrint("Insert at ");jsiConsolePrintInt(insertPos);jsiConsolePrint(", Tail is ");jsiConsolePrintInt(utilTimerTasksTail);jsiConsolePrint("\n");
-  // shift items forward
-  int i = utilTimerTasksHead;
-  while (i != insertPos) {
-    unsigned char next = (i+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
-    utilTimerTasks[i] = utilTimerTasks[next];
-    i = next;
-  }
-  // add new item
+  // add the new item at the end of the heap, and move it up to where it should be
+  unsigned int insertPos = utilTimerTasksCount++;
   utilTimerTasks[insertPos] = *task;
-  // increase task list size
-  utilTimerTasksHead = (utilTimerTasksHead+1) & (UTILTIMERTASK_TASKS-1);
+  utilTimerSiftUp(insertPos);
+  bool haveChangedTimer = utilTimerTasks[0].time == task->time;
+#ifndef SAVE_ON_FLASH
+  if (utilTimerTasksCount > utilTimerStats.maxTasks)
+    utilTimerStats.maxTasks = utilTimerTasksCount;
+#endif
 
-  //jsiConsolePrint("Head is ");jsiConsolePrintInt(utilTimerTasksHead);jsiConsolePrint("\n");
   // now set up timer if not already set up...
   if (!utilTimerOn || haveChangedTimer) {
     utilTimerOn = true;
-    jshUtilTimerStart(utilTimerTasks[utilTimerTasksTail].time - jshGetSystemTime());
+    jshUtilTimerStart(utilTimerTasks[0].time - jshGetSystemTime());
   }
 
   jshInterruptOn();
@@ -290,9 +437,9 @@ bool jstSetWakeUp(JsSysTime period) {
   // work out if we're waiting for a timer,
   // and if so, when it's going to be
   jshInterruptOff();
-  if (utilTimerTasksTail!=utilTimerTasksHead) {
+  if (utilTimerTasksCount) {
     hasTimer = true;
-    nextTime = utilTimerTasks[utilTimerTasksTail].time;
+    nextTime = utilTimerTasks[0].time;
   }
   jshInterruptOn();
 
@@ -314,119 +461,175 @@ void jstClearWakeUp() {
   bool removedTimer = false;
   jshInterruptOff();
   // while the first item is a wakeup, remove it
-  while (utilTimerTasksTail!=utilTimerTasksHead &&
-      utilTimerTasks[utilTimerTasksTail].type == UET_WAKEUP) {
-    utilTimerTasksTail = (utilTimerTasksTail+1) & (UTILTIMERTASK_TASKS-1);
+  while (utilTimerTasksCount && utilTimerTasks[0].type == UET_WAKEUP) {
+    utilTimerRemoveTask(0);
     removedTimer = true;
   }
   // if the queue is now empty, and we stop the timer
-  if (utilTimerTasksTail==utilTimerTasksHead && removedTimer)
+  if (!utilTimerTasksCount && removedTimer)
     jshUtilTimerDisable();
   jshInterruptOn();
 }
 
 #ifndef SAVE_ON_FLASH
-bool jstStartSignal(JsSysTime startTime, JsSysTime period, Pin pin, JsVar *currentData, JsVar *nextData, UtilTimerEventType type) {
+bool jstStartSignal(JsSysTime startTime, JsSysTime period, Pin pin, JsVar *currentData, JsVar *nextData, UtilTimerEventType type, unsigned short gain) {
   if (!jshIsPinValid(pin)) return false;
+  UtilTimerChannel channel;
+  memset(&channel, 0, sizeof(channel));
+  channel.type = type;
+  channel.gain = gain;
   UtilTimerTask task;
   task.repeatInterval = (unsigned int)period;
   task.time = startTime + period;
-  task.type = type;
   if (UET_IS_BUFFER_WRITE_EVENT(type)) {
-    task.data.buffer.pinFunction = jshGetCurrentPinFunction(pin);
-    if (!task.data.buffer.pinFunction) return false; // no pin function found...
+    channel.pinFunction = jshGetCurrentPinFunction(pin);
+    if (!channel.pinFunction) return false; // no pin function found...
+    channel.step = 0x10000;
+    channel.blockIdx = 1; // so we start by rendering into (and outputting) block 0
+    task.type = UET_WRITE_MIX;
+    task.data.pinFunction = channel.pinFunction;
   } else if (UET_IS_BUFFER_READ_EVENT(type)) {
 #ifndef LINUX
     if (pinInfo[pin].analog == JSH_ANALOG_NONE) return false; // no analog...
 #endif
-    task.data.buffer.pin = pin;
+    channel.pin = pin;
+    task.type = type;
   } else {
     assert(0);
     return false;
   }
-  task.data.buffer.charIdx = 0;
-  task.data.buffer.var = currentData; // no locks (this needs to already be reffed)
-  task.data.buffer.currentBuffer = jsvGetRef(currentData);
+  channel.charIdx = 0;
+  channel.var = currentData; // no locks (this needs to already be reffed)
+  channel.currentBuffer = jsvGetRef(currentData);
   if (nextData) {
     // then we're repeating!
-    task.data.buffer.nextBuffer = jsvGetRef(nextData);
+    channel.nextBuffer = jsvGetRef(nextData);
   } else {
     // then we're not repeating
-    task.data.buffer.nextBuffer = 0;
+    channel.nextBuffer = 0;
   }
-  return utilTimerInsertTask(&task);
+
+  jshInterruptOff();
+  // find a free channel
+  int c = 0;
+  while (c<UTILTIMER_CHANNELS && utilTimerChannels[c].type!=UET_WAKEUP) c++;
+  if (c>=UTILTIMER_CHANNELS) {
+    jshInterruptOn();
+    return false;
+  }
+  // If we're writing to something that's already being written to, mix into the existing output
+  unsigned int t;
+  bool hasMixer = false;
+  if (task.type == UET_WRITE_MIX) {
+    for (t=0;t<utilTimerTasksCount;t++)
+      if (utilTimerTasks[t].type == UET_WRITE_MIX && utilTimerTasks[t].data.pinFunction == channel.pinFunction) {
+        UtilTimerTask *mixer = &utilTimerTasks[t];
+        // resample to the rate the output is already going at
+        channel.step = (unsigned int)(((JsSysTime)mixer->repeatInterval << 16) / period);
+        // and if we should start later than the mixer's next sample, wait that many samples
+        if (task.time > mixer->time && mixer->repeatInterval)
+          channel.startDelay = (unsigned int)((task.time - mixer->time + mixer->repeatInterval/2) / mixer->repeatInterval);
+        hasMixer = true;
+      }
+  }
+  if (task.type != UET_WRITE_MIX) task.data.channel = (unsigned char)c;
+  utilTimerChannels[c] = channel;
+  jshInterruptOn();
+  if (hasMixer) return true;
+  if (!utilTimerInsertTask(&task)) {
+    utilTimerChannels[c].type = UET_WAKEUP; // free the channel again
+    return false;
+  }
+  return true;
 }
 
-/// Return true if a timer task for the given variable exists (and set 'task' to it)
+/// Stop the channel for the given variable - return false if there wasn't one
 bool jstStopBufferTimerTask(JsVar *var) {
   JsVarRef ref = jsvGetRef(var);
   jshInterruptOff();
-  unsigned char ptr = utilTimerTasksHead;
-  if (ptr != utilTimerTasksTail) {
-    unsigned char endPtr = ((utilTimerTasksTail+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1));
-    ptr = (ptr+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
-    // now we're at the last timer task - work back until we've just gone back past utilTimerTasksTail
-    while (ptr != endPtr) {
-      if (UET_IS_BUFFER_EVENT(utilTimerTasks[ptr].type)) {
-        if (utilTimerTasks[ptr].data.buffer.currentBuffer==ref || utilTimerTasks[ptr].data.buffer.nextBuffer==ref) {
-          // shift tail back along
-          unsigned char next = (ptr+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
-          while (next!=endPtr) {
-            utilTimerTasks[ptr] = utilTimerTasks[next];
-            ptr = next;
-            next = (ptr+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
-          }
-          // move 'end' pointer back
-          utilTimerTasksTail = (utilTimerTasksTail+1) & (UTILTIMERTASK_TASKS-1);
-          jshInterruptOn();
-          return true;
+  int idx = jstFindBufferChannel(ref);
+  if (idx>=0) {
+    UtilTimerChannel *channel = &utilTimerChannels[idx];
+    if (UET_IS_BUFFER_READ_EVENT(channel->type)) {
+      // remove the task reading into this channel
+      unsigned int t;
+      for (t=0;t<utilTimerTasksCount;t++)
+        if (utilTimerTasks[t].type == channel->type && utilTimerTasks[t].data.channel == idx) {
+          utilTimerRemoveTask(t);
+          break;
         }
-      }
-      ptr = (ptr+UTILTIMERTASK_TASKS-1) & (UTILTIMERTASK_TASKS-1);
-    }
+    } // else the UET_WRITE_MIX task will stop by itself when it has no more channels
+    channel->type = UET_WAKEUP;
   }
   jshInterruptOn();
-  return false;
+  return idx>=0;
 }
 #endif
 
 void jstReset() {
   jshUtilTimerDisable();
-  utilTimerTasksTail = utilTimerTasksHead = 0;
+  utilTimerTasksCount = 0;
+#ifndef SAVE_ON_FLASH
+  memset(&utilTimerStats, 0, sizeof(utilTimerStats));
+  int i;
+  for (i=0;i<UTILTIMER_CHANNELS;i++)
+    utilTimerChannels[i].type = UET_WAKEUP;
+#endif
 }
 
 void jstDumpUtilityTimers() {
-  int i;
+  unsigned int i;
   UtilTimerTask uTimerTasks[UTILTIMERTASK_TASKS];
   jshInterruptOff();
-  for (i=0;i<UTILTIMERTASK_TASKS;i++)
+  for (i=0;i<utilTimerTasksCount;i++)
     uTimerTasks[i] = utilTimerTasks[i];
-  unsigned char uTimerTasksHead = utilTimerTasksHead;
-  unsigned char uTimerTasksTail = utilTimerTasksTail;
+  unsigned int uTimerTasksCount = utilTimerTasksCount;
   jshInterruptOn();
 
-  unsigned char t = uTimerTasksTail;
-  while (t!=uTimerTasksHead) {
-    UtilTimerTask task = uTimerTasks[t];
+  // The heap is only partly sorted - sort our copy by time so the list makes sense
+  for (i=1;i<uTimerTasksCount;i++) {
+    UtilTimerTask task = uTimerTasks[i];
+    unsigned int j = i;
+    while (j>0 && uTimerTasks[j-1].time > task.time) {
+      uTimerTasks[j] = uTimerTasks[j-1];
+      j--;
+    }
+    uTimerTasks[j] = task;
+  }
+
+  for (i=0;i<uTimerTasksCount;i++) {
+    UtilTimerTask task = uTimerTasks[i];
     jsiConsolePrintf("%08d us : ", (int)(1000*jshGetMillisecondsFromTime(task.time-jsiLastIdleTime)));
 
     switch (task.type) {
-    case UET_WAKEUP : jsiConsolePrintf("WAKEUP\n"); break;
+    case UET_WAKEUP : jsiConsolePrintf("WAKEUP"); break;
     case UET_SET : jsiConsolePrintf("SET ");
-         for (i=0;i<UTILTIMERTASK_PIN_COUNT;i++)
-           jsiConsolePrintf("%p=%d,", task.data.set.pins[i],  (task.data.set.value>>i)&1);
-         jsiConsolePrintf("\n");
+         int j;
+         for (j=0;j<UTILTIMERTASK_PIN_COUNT;j++)
+           jsiConsolePrintf("%p=%d,", task.data.set.pins[j],  (task.data.set.value>>j)&1);
          break;
 #ifndef SAVE_ON_FLASH
-    case UET_WRITE_BYTE : jsiConsolePrintf("WRITE_BYTE\n"); break;
-    case UET_READ_BYTE : jsiConsolePrintf("READ_BYTE\n"); break;
-    case UET_WRITE_SHORT : jsiConsolePrintf("WRITE_SHORT\n"); break;
-    case UET_READ_SHORT : jsiConsolePrintf("READ_SHORT\n"); break;
+    case UET_READ_BYTE : jsiConsolePrintf("READ_BYTE"); break;
+    case UET_READ_SHORT : jsiConsolePrintf("READ_SHORT"); break;
+    case UET_WRITE_MIX : jsiConsolePrintf("WRITE_MIX"); break;
 #endif
-    default : jsiConsolePrintf("Unknown type %d\n", task.type); break;
+    default : jsiConsolePrintf("Unknown type %d", task.type); break;
     }
-
-    t = (t+1) & (UTILTIMERTASK_TASKS-1);
+#ifndef SAVE_ON_FLASH
+    if (task.stats.count) {
+      // how late the task has been executed, and how much that varies (the jitter)
+      jsiConsolePrintf(" (ran %d, late us avg %d, min %d, max %d, jitter %d)",
+          task.stats.count,
+          (int)(1000*jshGetMillisecondsFromTime(task.stats.lateSum / task.stats.count)),
+          (int)(1000*jshGetMillisecondsFromTime(task.stats.lateMin)),
+          (int)(1000*jshGetMillisecondsFromTime(task.stats.lateMax)),
+          (int)(1000*jshGetMillisecondsFromTime(task.stats.lateMax - task.stats.lateMin)));
+    }
+#endif
+    jsiConsolePrintf("\n");
   }
-
+#ifndef SAVE_ON_FLASH
+  jsiConsolePrintf("%d/%d tasks, max %d, %d refused as full, %d repeats skipped\n",
+      uTimerTasksCount, UTILTIMERTASK_TASKS, utilTimerStats.maxTasks, utilTimerStats.full, utilTimerStats.skipped);
+#endif
 }
@@ -22,10 +22,11 @@ typedef enum {
   UET_WAKEUP, ///< Does nothing except wake the device up!
   UET_SET, ///< Set a pin to a value
 #ifndef SAVE_ON_FLASH
-  UET_WRITE_BYTE, ///< Write a byte to a DAC/Timer
+  UET_WRITE_BYTE, ///< Write bytes to a DAC/Timer (only used for channels - see UET_WRITE_MIX)
   UET_READ_BYTE, ///< Read a byte from an analog input
-  UET_WRITE_SHORT, ///< Write a short to a DAC/Timer
+  UET_WRITE_SHORT, ///< Write shorts to a DAC/Timer (only used for channels - see UET_WRITE_MIX)
   UET_READ_SHORT, ///< Read a short from an analog input
+  UET_WRITE_MIX, ///< Mix together all channels writing to a DAC/Timer, and write the result
 #endif
 } PACKED_FLAGS UtilTimerEventType;
 
@@ -55,34 +56,70 @@ typedef struct UtilTimerTaskSet {
   uint8_t value; ///< value to set pins to
 } PACKED_FLAGS UtilTimerTaskSet;
 
-/** Task to write to a specific pin function - eg. a DAC or Timer or to read from an Analog
+#ifndef SAVE_ON_FLASH
+#ifndef UTILTIMER_CHANNELS
+#define UTILTIMER_CHANNELS 4 ///< How many Waveforms can be input/output at once
+#endif
+#define UTILTIMER_BLOCK_SIZE 16 ///< How many samples are rendered into a channel's block at once
+#define UTILTIMER_GAIN_UNITY 256 ///< Channel gain that leaves samples unchanged
+
+/** A Waveform being input or output, read from/written to a variable.
  * To send once, set var=buffer1, currentBuffer==nextBuffer==0
  * To repeat, set var=buffer1, currentBuffer==nextBuffer==buffer
  * To repeat, flipping between 2 buffers, set var=buffer1, currentBuffer==buffer1, nextBuffer=buffer2
+ *
+ * Output channels are rendered a block at a time (from the idle loop if we can,
+ * or from the timer IRQ if the interpreter is busy) into a double buffer, and
+ * the UET_WRITE_MIX task for their output mixes the blocks of all channels together.
  */
-typedef struct UtilTimerTaskBuffer {
-  JsVar *var; ///< variable to get data from
+typedef struct UtilTimerChannel {
+  JsVar *var; ///< variable to get data from (or 0 if there is no more)
   JsVarRef currentBuffer; ///< The current buffer we're reading from (or 0)
   JsVarRef nextBuffer; ///< Subsequent buffer to read from (or 0)
-  unsigned short currentValue; ///< current value being written (for writes)
   unsigned char charIdx; ///< Index of character in variable
+  UtilTimerEventType type; ///< What this channel does (UET_READ_BYTE/etc) - or UET_WAKEUP if it is unused
   union {
     JshPinFunction pinFunction; ///< Pin function to write to
     Pin pin; ///< Pin to read from
   };
-} PACKED_FLAGS UtilTimerTaskBuffer;
-
+  // Output only
+  unsigned short gain; ///< Volume, where UTILTIMER_GAIN_UNITY is 1
+  unsigned int step; ///< Samples to step through the data for each output sample (16.16 fixed point)
+  unsigned int phase; ///< Fractional position between samples (16.16 fixed point)
+  unsigned int startDelay; ///< Output samples to wait before starting (if mixed into an output that was already running)
+  short block[2][UTILTIMER_BLOCK_SIZE]; ///< Rendered samples (signed)
+  unsigned char blockLength[2]; ///< How many samples are in each block (0 if it needs rendering)
+  unsigned char blockIdx; ///< Which block we are outputting from
+  unsigned char sampleIdx; ///< Which sample in the block we're outputting next
+} UtilTimerChannel;
+#endif
 
 typedef union UtilTimerTaskData {
   UtilTimerTaskSet set;
-  UtilTimerTaskBuffer buffer;
+#ifndef SAVE_ON_FLASH
+  unsigned char channel; ///< For UET_READ_*, the index in utilTimerChannels to read into
+  JshPinFunction pinFunction; ///< For UET_WRITE_MIX, the Pin function to write to
+#endif
 } UtilTimerTaskData;
 
+#ifndef SAVE_ON_FLASH
+/// How late a task has been executed, in JsSysTime units (for E.dumpTimers)
+typedef struct UtilTimerTaskStats {
+  unsigned int count; ///< How many times the task has been executed
+  unsigned int lateMin; ///< The least late it has been executed
+  unsigned int lateMax; ///< The latest it has been executed
+  unsigned int lateSum; ///< Total lateness (saturates rather than overflowing)
+} PACKED_FLAGS UtilTimerTaskStats;
+#endif
+
 typedef struct UtilTimerTask {
   JsSysTime time; // time at which to set pins
   unsigned int repeatInterval; // if nonzero, repeat the timer
   UtilTimerTaskData data; // data used when timer is hit
   UtilTimerEventType type; // the type of this task - do we set pin(s) or read/write data
+#ifndef SAVE_ON_FLASH
+  UtilTimerTaskStats stats; // timing statistics
+#endif
 } PACKED_FLAGS UtilTimerTask;
 
 void jstUtilTimerInterruptHandler();
@@ -96,8 +133,17 @@ bool jstUtilTimerIsRunning();
 /// Return true if a timer task for the given pin exists (and set 'task' to it)
 bool jstGetLastPinTimerTask(Pin pin, UtilTimerTask *task);
 
-/// Return true if a timer task for the given variable exists (and set 'task' to it)
-bool jstGetLastBufferTimerTask(JsVar *var, UtilTimerTask *task);
+#ifndef SAVE_ON_FLASH
+/** Return true if a channel is reading/writing the given variable, and set
+ * 'currentBuffer' to the buffer it is currently on */
+bool jstGetBufferChannel(JsVar *var, JsVarRef *currentBuffer);
+
+/// Return true if any channel is reading/writing a variable (so JsVars can't be moved - see jsvDefragment)
+bool jstHasBufferChannels();
+
+/// Render the next block of each output channel (call from the idle loop)
+void jstRenderChannels();
+#endif
 
 /// returns false if timer queue was full... Changes the state of one or more pins at a certain time (using a timer)
 bool jstPinOutputAtTime(JsSysTime time, Pin *pins, int pinCount, uint8_t value);
@@ -110,16 +156,17 @@ bool jstSetWakeUp(JsSysTime period);
  * before the wakeup event */
 void jstClearWakeUp();
 
-/// Start writing a string out at the given period between samples
-bool jstStartSignal(JsSysTime startTime, JsSysTime period, Pin pin, JsVar *currentData, JsVar *nextData, UtilTimerEventType type);
+/** Start writing a string out (or reading into it) at the given period between samples.
+ * Output channels on the same pin are mixed, each scaled by 'gain' (UTILTIMER_GAIN_UNITY=1) */
+bool jstStartSignal(JsSysTime startTime, JsSysTime period, Pin pin, JsVar *currentData, JsVar *nextData, UtilTimerEventType type, unsigned short gain);
 
-/// Stop a timer task
+/// Stop the channel reading/writing the given variable
 bool jstStopBufferTimerTask(JsVar *var);
 
 /// Stop ALL timer tasks (including digitalPulse - use this when resetting the VM)
 void jstReset();
 
-/// Dump the current list of timers
+/// Dump the current list of timers (and how late they have been executed)
 void jstDumpUtilityTimers();
 
 #endif /* JSTIMER_H_ */
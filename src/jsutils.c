@@ -21,7 +21,7 @@
 
 /** Error flags for things that we don't really want to report on the console,
  * but which are good to know about */
-JsErrorFlags jsErrorFlags;
+THREAD_LOCAL JsErrorFlags jsErrorFlags;
 
 bool isIDString(const char *s) {
     if (!isAlpha(*s))
@@ -45,7 +45,7 @@ const char *escapeCharacter(char ch) {
   if (ch=='\t') return "\\t";
   if (ch=='\\') return "\\\\";
   if (ch=='"') return "\\\"";
-  static char buf[5];
+  static THREAD_LOCAL char buf[5];
   if (ch<32) {
     /** just encode as hex - it's more understandable
      * and doesn't have the issue of "\16"+"1" != "\161" */
@@ -190,7 +190,7 @@ NO_INLINE void jsExceptionHere(JsExceptionType type, const char *fmt, ...) {
   vcbprintf(cb,&it, fmt, argp);
   va_end(argp);
 
-  jsvStringIteratorFree(&it);
+  jsvStringIteratorFreeAppend(&it, var);
 
   if (type != JSET_STRING) {
     JsVar *obj = 0;
@@ -287,12 +287,44 @@ int strcmp(const char *a, const char *b) {
         }
         return *a - *b;
 }
+int strncmp(const char *a, const char *b, size_t c) {
+        while (c && *a && *b) {
+                if (*a != *b)
+                        return *a - *b;
+                a++;b++;c--;
+        }
+        return c ? *a - *b : 0;
+}
 void *memcpy(void *dst, const void *src, size_t size) {
         size_t i;
         for (i=0;i<size;i++)
                 ((char*)dst)[i] = ((char*)src)[i];
         return dst;
 }
+void *memmove(void *dst, const void *src, size_t size) {
+        size_t i;
+        if (dst < src) {
+                for (i=0;i<size;i++)
+                        ((char*)dst)[i] = ((char*)src)[i];
+        } else {
+                for (i=size;i>0;i--)
+                        ((char*)dst)[i-1] = ((char*)src)[i-1];
+        }
+        return dst;
+}
+void *memset(void *dst, int c, size_t size) {
+        size_t i;
+        for (i=0;i<size;i++)
+                ((unsigned char*)dst)[i] = (unsigned char)c;
+        return dst;
+}
+int memcmp(const void *a, const void *b, size_t size) {
+        size_t i;
+        for (i=0;i<size;i++)
+                if (((unsigned char*)a)[i] != ((unsigned char*)b)[i])
+                        return ((unsigned char*)a)[i] - ((unsigned char*)b)[i];
+        return 0;
+}
 
 unsigned int rand() {
     static unsigned int m_w = 0xDEADBEEF;    /* must not be zero */
@@ -304,6 +336,401 @@ unsigned int rand() {
 }
 #endif
 
+#if !defined(USE_FLOATS) && !defined(SAVE_ON_FLASH)
+// ----------------------------------------------------------------------------
+// Exact float <-> decimal conversion. We use 64 bit 'DIY' floating point values
+// (f * 2^e) with a table of cached powers of 10, to generate the shortest string
+// that round-trips (Grisu2) and to parse decimal strings without accumulating error.
+#define JSF_EXACT_FLOATS
+
+typedef struct {
+  uint64_t f;
+  int e;
+} JsfDiyFp; ///< A 'DIY' floating point number: f * 2^e
+
+typedef union {
+  double d;
+  uint64_t u;
+} JsfDoubleBits;
+
+#define JSF_DP_HIDDEN_BIT 0x0010000000000000ULL ///< Hidden (implicit) bit of a double's significand
+#define JSF_DP_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define JSF_DP_EXPONENT_BIAS 1075 ///< Exponent bias for a double, with the significand treated as an integer
+
+/// Normalised significands of 10^k, for k = -348, -340, ..., 340
+static const uint64_t jsfCachedPowersF[] = {
+  0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+  0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+  0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+  0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+  0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+  0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+  0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+  0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+  0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+  0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+  0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+  0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+  0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+  0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+  0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+  0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+  0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+  0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+  0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+  0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+  0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+  0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+/// Binary exponents of jsfCachedPowersF
+static const short jsfCachedPowersE[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+  -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+  -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+  -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+  56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+  375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+  694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+  1013, 1039, 1066
+};
+#define JSF_CACHED_POWERS_MIN_K (-348) ///< Decimal exponent of jsfCachedPowersF[0]
+#define JSF_CACHED_POWERS_STEP 8 ///< Decimal exponent step between jsfCachedPowersF entries
+
+static const uint64_t jsfPow10[] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+  10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+  1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+#define JSF_POW10_COUNT 20
+
+static JsfDiyFp jsfDiyFp(uint64_t f, int e) {
+  JsfDiyFp r;
+  r.f = f;
+  r.e = e;
+  return r;
+}
+
+/// Get the exact value of a (positive) double
+static JsfDiyFp jsfDiyFpFromDouble(double v) {
+  JsfDoubleBits bits;
+  bits.d = v;
+  int biasedE = (int)((bits.u >> 52) & 0x7FF);
+  if (biasedE) return jsfDiyFp((bits.u & JSF_DP_SIGNIFICAND_MASK) + JSF_DP_HIDDEN_BIT, biasedE - JSF_DP_EXPONENT_BIAS);
+  return jsfDiyFp(bits.u & JSF_DP_SIGNIFICAND_MASK, 1 - JSF_DP_EXPONENT_BIAS); // denormal
+}
+
+static JsfDiyFp jsfDiyFpNormalize(JsfDiyFp x) {
+#ifdef __GNUC__
+  int shift = __builtin_clzll(x.f);
+  x.f <<= shift;
+  x.e -= shift;
+#else
+  while (!(x.f & 0x8000000000000000ULL)) {
+    x.f <<= 1;
+    x.e--;
+  }
+#endif
+  return x;
+}
+
+/// Multiply two DIY floats, rounding the result to 64 bits
+static JsfDiyFp jsfDiyFpMultiply(JsfDiyFp x, JsfDiyFp y) {
+  const uint64_t M32 = 0xFFFFFFFFULL;
+  uint64_t a = x.f >> 32, b = x.f & M32;
+  uint64_t c = y.f >> 32, d = y.f & M32;
+  uint64_t ac = a*c, bc = b*c, ad = a*d, bd = b*d;
+  uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+  tmp += 1U << 31; // round
+  return jsfDiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64);
+}
+
+/// Get the cached power of 10 (10^-k) that brings a DIY float with exponent e into the range we want for Grisu
+static JsfDiyFp jsfGetCachedPower(int e, int *k) {
+  double dk = (-61 - e) * 0.30102999566398114 + 347; // dk must be positive, so can do ceiling in positive
+  int ik = (int)dk;
+  if (dk - ik > 0.0) ik++;
+  unsigned int index = (unsigned int)((ik >> 3) + 1);
+  *k = -(JSF_CACHED_POWERS_MIN_K + (int)index*JSF_CACHED_POWERS_STEP);
+  return jsfDiyFp(jsfCachedPowersF[index], jsfCachedPowersE[index]);
+}
+
+static int jsfCountDecimalDigits(uint32_t n) {
+  int digits = 1;
+  while (digits<10 && n>=jsfPow10[digits]) digits++;
+  return digits;
+}
+
+static void jsfGrisuRound(char *buffer, int len, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t wpw) {
+  while (rest < wpw && delta - rest >= tenKappa &&
+         (rest + tenKappa < wpw || wpw - rest > rest + tenKappa - wpw)) {
+    buffer[len-1]--;
+    rest += tenKappa;
+  }
+}
+
+/// Generate the digits of W, which is between the boundaries Mp-delta and Mp
+static int jsfDigitGen(JsfDiyFp W, JsfDiyFp Mp, uint64_t delta, char *buffer, int *K) {
+  JsfDiyFp one = jsfDiyFp(1ULL << -Mp.e, Mp.e);
+  uint64_t wpw = Mp.f - W.f;
+  uint32_t p1 = (uint32_t)(Mp.f >> -one.e);
+  uint64_t p2 = Mp.f & (one.f - 1);
+  int kappa = jsfCountDecimalDigits(p1);
+  int len = 0;
+  while (kappa > 0) {
+    uint32_t pow10 = (uint32_t)jsfPow10[kappa-1];
+    uint32_t d = p1 / pow10;
+    p1 %= pow10;
+    if (d || len) buffer[len++] = (char)('0' + d);
+    kappa--;
+    uint64_t tmp = ((uint64_t)p1 << -one.e) + p2;
+    if (tmp <= delta) {
+      *K += kappa;
+      jsfGrisuRound(buffer, len, delta, tmp, jsfPow10[kappa] << -one.e, wpw);
+      return len;
+    }
+  }
+  while (true) {
+    p2 *= 10;
+    delta *= 10;
+    char d = (char)(p2 >> -one.e);
+    if (d || len) buffer[len++] = (char)('0' + d);
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      *K += kappa;
+      jsfGrisuRound(buffer, len, delta, p2, one.f, (-kappa < JSF_POW10_COUNT) ? wpw * jsfPow10[-kappa] : 0);
+      return len;
+    }
+  }
+}
+
+/** Write the shortest string of digits that parses back to v (which must be positive and
+ * finite) into buffer (at least 18 chars). Returns the number of digits, and sets K such
+ * that v = digits * 10^K. Because of rounding errors Grisu2 has to exclude the exact
+ * boundaries between v and the adjacent doubles - if 'widen' is set we include them,
+ * but the result must then be checked to see if it round-trips. */
+static int jsfGrisu2(double v, char *buffer, int *K, bool widen) {
+  JsfDiyFp w = jsfDiyFpFromDouble(v);
+  // work out the boundaries between us and the adjacent doubles
+  JsfDiyFp wp = jsfDiyFp((w.f << 1) + 1, w.e - 1);
+  while (!(wp.f & (JSF_DP_HIDDEN_BIT << 1))) {
+    wp.f <<= 1;
+    wp.e--;
+  }
+  wp.f <<= 10; // 64 - 52 - 2
+  wp.e -= 10;
+  JsfDiyFp wm = (w.f == JSF_DP_HIDDEN_BIT) ? jsfDiyFp((w.f << 2) - 1, w.e - 2) : jsfDiyFp((w.f << 1) - 1, w.e - 1);
+  wm.f <<= wm.e - wp.e;
+  wm.e = wp.e;
+  // scale everything by a power of 10 so the digits can be generated with integer arithmetic
+  JsfDiyFp cmk = jsfGetCachedPower(wp.e, K);
+  JsfDiyFp W = jsfDiyFpMultiply(jsfDiyFpNormalize(w), cmk);
+  JsfDiyFp Wp = jsfDiyFpMultiply(wp, cmk);
+  JsfDiyFp Wm = jsfDiyFpMultiply(wm, cmk);
+  if (widen) {
+    Wm.f--;
+    Wp.f++;
+  } else {
+    Wm.f++;
+    Wp.f--;
+  }
+  return jsfDigitGen(W, Wp, Wp.f - Wm.f, buffer, K);
+}
+
+/// Exact powers of 10 that can be represented as doubles
+static const double jsfExactPow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define JSF_BIGNUM_WORDS 40 ///< 1280 bits - enough for 5^343 * 2^64 or 2^1100
+typedef struct {
+  uint32_t w[JSF_BIGNUM_WORDS]; ///< least significant word first
+  int len; ///< number of words used - everything above this is zero
+} JsfBignum;
+
+static void jsfBignumSet(JsfBignum *b, uint64_t v) {
+  b->w[0] = (uint32_t)v;
+  b->w[1] = (uint32_t)(v >> 32);
+  b->len = b->w[1] ? 2 : 1;
+}
+
+static void jsfBignumMultiplyAdd(JsfBignum *b, uint32_t m, uint32_t add) {
+  uint64_t carry = add;
+  int i;
+  for (i=0;i<b->len;i++) {
+    carry += (uint64_t)b->w[i] * m;
+    b->w[i] = (uint32_t)carry;
+    carry >>= 32;
+  }
+  if (carry && b->len<JSF_BIGNUM_WORDS)
+    b->w[b->len++] = (uint32_t)carry;
+}
+
+static void jsfBignumMultiplyPow5(JsfBignum *b, int n) {
+  while (n >= 13) {
+    jsfBignumMultiplyAdd(b, 1220703125, 0); // 5^13
+    n -= 13;
+  }
+  if (n) jsfBignumMultiplyAdd(b, (uint32_t)(jsfPow10[n] >> n), 0); // 5^n
+}
+
+static void jsfBignumShiftLeft(JsfBignum *b, int n) {
+  int words = n >> 5, bits = n & 31, i;
+  int len = b->len + words + 1;
+  if (len > JSF_BIGNUM_WORDS) len = JSF_BIGNUM_WORDS;
+  for (i=len-1;i>=0;i--) {
+    uint32_t v = (i-words >= 0 && i-words < b->len) ? (b->w[i-words] << bits) : 0;
+    if (bits && i-words-1 >= 0 && i-words-1 < b->len) v |= b->w[i-words-1] >> (32-bits);
+    b->w[i] = v;
+  }
+  while (len>1 && !b->w[len-1]) len--;
+  b->len = len;
+}
+
+static int jsfBignumCompare(const JsfBignum *a, const JsfBignum *b) {
+  if (a->len != b->len) return (a->len < b->len) ? -1 : 1;
+  int i;
+  for (i=a->len-1;i>=0;i--)
+    if (a->w[i] != b->w[i]) return (a->w[i] < b->w[i]) ? -1 : 1;
+  return 0;
+}
+
+/** Set b from a string of decimal digits (which may contain a '.'). After JSF_BIGNUM_MAX_DIGITS
+ * digits the rest are ignored, and the number of digits ignored is returned */
+#define JSF_BIGNUM_MAX_DIGITS 100
+static int jsfBignumSetDigits(JsfBignum *b, const char *s) {
+  int digits = 0;
+  jsfBignumSet(b, 0);
+  while ((*s >= '0' && *s <= '9') || *s == '.') {
+    if (*s != '.') {
+      if (digits < JSF_BIGNUM_MAX_DIGITS) jsfBignumMultiplyAdd(b, 10, (uint32_t)(*s - '0'));
+      digits++;
+    }
+    s++;
+  }
+  return (digits > JSF_BIGNUM_MAX_DIGITS) ? digits-JSF_BIGNUM_MAX_DIGITS : 0;
+}
+
+/// Compare x * 10^a10 * 2^a2 with b * 2^b2 exactly (x is modified). Returns <0, 0 or >0
+static int jsfCompareExact(JsfBignum *x, int a10, int a2, uint64_t b, int b2) {
+  JsfBignum y;
+  jsfBignumSet(&y, b);
+  // 10^a10 = 5^a10 * 2^a10, and put the power of 5 on whichever side keeps it positive
+  if (a10 >= 0) jsfBignumMultiplyPow5(x, a10);
+  else jsfBignumMultiplyPow5(&y, -a10);
+  a2 += a10;
+  int minShift = (a2 < b2) ? a2 : b2;
+  jsfBignumShiftLeft(x, a2 - minShift);
+  jsfBignumShiftLeft(&y, b2 - minShift);
+  return jsfBignumCompare(x, &y);
+}
+
+/** Get mantissa * 10^exponent (mantissa!=0, exponent from -348 to 347) as a normalised
+ * DIY float. This is accurate to within JSF_DECIMAL_ERROR of the last bit */
+static JsfDiyFp jsfDiyFpFromDecimal(uint64_t mantissa, int exponent) {
+  int index = (exponent - JSF_CACHED_POWERS_MIN_K) / JSF_CACHED_POWERS_STEP;
+  int remainder = exponent - (JSF_CACHED_POWERS_MIN_K + index*JSF_CACHED_POWERS_STEP);
+  JsfDiyFp x = jsfDiyFpMultiply(jsfDiyFpNormalize(jsfDiyFp(mantissa, 0)), jsfDiyFp(jsfCachedPowersF[index], jsfCachedPowersE[index]));
+  if (remainder)
+    x = jsfDiyFpMultiply(x, jsfDiyFpNormalize(jsfDiyFp(jsfPow10[remainder], 0)));
+  return jsfDiyFpNormalize(x);
+}
+#define JSF_DECIMAL_ERROR 16
+
+/** Compare mantissa * 10^exponent * 2^e2 with w exactly. Returns <0, 0 or >0. This is
+ * done with 64 bit precision, unless the two are so close we have to use bignums */
+static int jsfCompareDecimal(uint64_t mantissa, int exponent, int e2, JsfDiyFp w) {
+  if (mantissa && exponent >= JSF_CACHED_POWERS_MIN_K && exponent < -JSF_CACHED_POWERS_MIN_K) {
+    JsfDiyFp x = jsfDiyFpFromDecimal(mantissa, exponent);
+    JsfDiyFp y = jsfDiyFpNormalize(w);
+    x.e += e2;
+    // line up the exponents (if they're more than 1 apart, the answer is obvious)
+    if (x.e > y.e+1) return 1;
+    if (x.e < y.e-1) return -1;
+    if (x.e > y.e) { y.f >>= 1; y.e++; }
+    if (x.e < y.e) { x.f >>= 1; x.e++; }
+    if (x.f > y.f && x.f - y.f > JSF_DECIMAL_ERROR) return 1;
+    if (x.f < y.f && y.f - x.f > JSF_DECIMAL_ERROR) return -1;
+  }
+  JsfBignum b;
+  jsfBignumSet(&b, mantissa);
+  return jsfCompareExact(&b, exponent, e2, w.f, w.e);
+}
+
+/** Put the exact value of the decimal (see jsfDecimalToDouble) in x as an integer,
+ * and return the power of 10 it must be multiplied by */
+static int jsfDecimalToBignum(JsfBignum *x, uint64_t mantissa, int exponent, const char *allDigits, int allExponent) {
+  if (allDigits) return allExponent + jsfBignumSetDigits(x, allDigits);
+  jsfBignumSet(x, mantissa);
+  return exponent;
+}
+
+/** Convert mantissa * 10^exponent to the nearest double. If the mantissa had more digits
+ * than would fit, allDigits should point to the full string of digits (which are worth
+ * allDigits * 10^allExponent), otherwise it should be 0. */
+static double jsfDecimalToDouble(uint64_t mantissa, int exponent, const char *allDigits, int allExponent) {
+  bool isTruncated = allDigits!=0;
+  if (!mantissa) return 0;
+  // If the mantissa and power of 10 are both exact doubles, one FP operation gives the correctly rounded result
+  if (!isTruncated && mantissa <= (1ULL<<53) && exponent>=-22 && exponent<=22) {
+    if (exponent<0) return (double)mantissa / jsfExactPow10[-exponent];
+    return (double)mantissa * jsfExactPow10[exponent];
+  }
+  /* mantissa < 10^19, so check for underflow/overflow. Below 10^-343 the value is
+   * less than 10^-324, which is under half the smallest denormal (2^-1075) so rounds to 0 */
+  if (exponent < -343) return 0;
+  if (exponent > 308) return INFINITY;
+  // Otherwise multiply by the nearest cached power of 10 in 64 bit precision
+  JsfDiyFp x = jsfDiyFpFromDecimal(mantissa, exponent);
+  // Now round the 64 bit significand to the bits we have available in a double
+  int e = x.e + 63; // exponent of the top bit
+  if (e > 1023) return INFINITY;
+  int precision = (e < -1022) ? (53 - (-1022 - e)) : 53; // denormals have less precision
+  if (precision <= 0) {
+    /* Less than the smallest denormal (2^-1074), so the answer is that or 0, depending
+     * on which side of 2^-1075 we are. x may be a little out, so if its top bit is
+     * at (or just below) 2^-1075, check exactly */
+    if (precision < -1) return 0;
+    JsfBignum b;
+    exponent = jsfDecimalToBignum(&b, mantissa, exponent, allDigits, allExponent);
+    if (jsfCompareExact(&b, exponent, 0, 1, -1075) <= 0) return 0; // ties go to even (0)
+    JsfDoubleBits bits;
+    bits.u = 1;
+    return bits.d;
+  }
+  int shift = 64 - precision;
+  uint64_t significand = x.f >> shift;
+  uint64_t rest = x.f & ((1ULL << shift) - 1);
+  uint64_t half = 1ULL << (shift-1);
+  e = x.e + shift; // the exponent of the lowest bit
+  /* x is only accurate to a few bits (and a little less if the mantissa was truncated),
+   * so if we're too close to halfway to know which way to round, check exactly */
+  const uint64_t maxError = 32;
+  if (rest+maxError >= half && rest <= half+maxError) {
+    // compare with the point halfway between significand and the next double up
+    JsfBignum x;
+    exponent = jsfDecimalToBignum(&x, mantissa, exponent, allDigits, allExponent);
+    int cmp = jsfCompareExact(&x, exponent, 0, significand*2 + 1, e-1);
+    if (cmp > 0 || (cmp==0 && (significand&1)))
+      significand++; // round to nearest, ties to even
+  } else if (rest > half)
+    significand++; // round to nearest
+  if (significand == (1ULL << 53)) {
+    significand >>= 1;
+    e++;
+  }
+  JsfDoubleBits bits;
+  if (precision < 53) {
+    bits.u = significand; // denormal (or if rounding reached the hidden bit, the smallest normal)
+  } else {
+    if (e + 52 + 1023 >= 0x7FF) return INFINITY;
+    bits.u = ((uint64_t)(e + JSF_DP_EXPONENT_BIAS) << 52) | (significand & JSF_DP_SIGNIFICAND_MASK);
+  }
+  return bits.d;
+}
+#endif
+
 JsVarFloat stringToFloatWithRadix(const char *s, int forceRadix) {
   // skip whitespace (strange parseFloat behaviour)
   while (isWhitespace(*s)) s++;
@@ -319,30 +746,37 @@ JsVarFloat stringToFloatWithRadix(const char *s, int forceRadix) {
     isNegated = true;
     s++;
   }
-  // handle integer part
-  while (*s) {
-    int digit = chtod(*s);
-    if (digit<0 || digit>=radix)
-      break;
-    v = (v*radix) + digit;
-    s++;
-  }
-
+#ifdef JSF_EXACT_FLOATS
   if (radix == 10) {
-    // handle decimal point
+    // Collect up to 19 significant digits as an integer, and convert that in one go
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool isTruncated = false;
+    const char *allDigits = s; // if we have to truncate, we need all the digits for exact rounding
+    int fractionalDigits = 0;
+    while (*s >= '0' && *s <= '9') {
+      if (digits<19) {
+        mantissa = mantissa*10 + (uint64_t)(*s - '0');
+        if (mantissa) digits++;
+      } else {
+        exponent++;
+        if (*s != '0') isTruncated = true;
+      }
+      s++;
+    }
     if (*s == '.') {
       s++; // skip .
-
-      while (*s) {
-        if (*s >= '0' && *s <= '9')
-          v += mul*(*s - '0');
-        else break;
-        mul /= 10;
+      while (*s >= '0' && *s <= '9') {
+        if (digits<19) {
+          mantissa = mantissa*10 + (uint64_t)(*s - '0');
+          if (mantissa) digits++;
+          exponent--;
+        } else if (*s != '0') isTruncated = true;
+        fractionalDigits++;
         s++;
       }
     }
-
-    // handle exponentials
     if (*s == 'e' || *s == 'E') {
       s++;  // skip E
       bool isENegated = false;
@@ -351,21 +785,66 @@ JsVarFloat stringToFloatWithRadix(const char *s, int forceRadix) {
         s++;
       }
       int e = 0;
-      while (*s) {
-        if (*s >= '0' && *s <= '9')
-          e = (e*10) + (*s - '0');
-        else break;
+      while (*s >= '0' && *s <= '9') {
+        if (e < 100000) e = (e*10) + (*s - '0');
         s++;
       }
       if (isENegated) e=-e;
-      // TODO: faster INTEGER pow? Normal pow has floating point inaccuracies
-      while (e>0) {
-        v*=10;
-        e--;
+      exponent += e;
+      fractionalDigits -= e;
+    }
+    v = jsfDecimalToDouble(mantissa, exponent, isTruncated ? allDigits : 0, -fractionalDigits);
+  } else
+#endif
+  {
+    // handle integer part
+    while (*s) {
+      int digit = chtod(*s);
+      if (digit<0 || digit>=radix)
+        break;
+      v = (v*radix) + digit;
+      s++;
+    }
+
+    if (radix == 10) {
+      // handle decimal point
+      if (*s == '.') {
+        s++; // skip .
+
+        while (*s) {
+          if (*s >= '0' && *s <= '9')
+            v += mul*(*s - '0');
+          else break;
+          mul /= 10;
+          s++;
+        }
       }
-      while (e<0) {
-        v/=10;
-        e++;
+
+      // handle exponentials
+      if (*s == 'e' || *s == 'E') {
+        s++;  // skip E
+        bool isENegated = false;
+        if (*s == '-' || *s == '+') {
+          isENegated = *s=='-';
+          s++;
+        }
+        int e = 0;
+        while (*s) {
+          if (*s >= '0' && *s <= '9')
+            e = (e*10) + (*s - '0');
+          else break;
+          s++;
+        }
+        if (isENegated) e=-e;
+        // TODO: faster INTEGER pow? Normal pow has floating point inaccuracies
+        while (e>0) {
+          v*=10;
+          e--;
+        }
+        while (e<0) {
+          v/=10;
+          e++;
+        }
       }
     }
   }
@@ -411,6 +890,116 @@ void itostr_extra(JsVarInt vals,char *str,bool signedVal, unsigned int base) {
   str[digits] = 0;
 }
 
+#ifdef JSF_EXACT_FLOATS
+/// Get the digits written by jsfGrisu2 as an integer
+static uint64_t jsfDigitsToInteger(const char *digits, int digitCount) {
+  uint64_t m = 0;
+  int i;
+  for (i=0;i<digitCount;i++) m = m*10 + (uint64_t)(digits[i]-'0');
+  return m;
+}
+
+/** Get the shortest (and then closest) digits that parse back to val (which must be positive
+ * and finite) into digits (at least 20 chars). Returns the number of digits, and sets K such
+ * that val = digits * 10^K. */
+static int jsfShortestDigits(double val, char *digits, int *K) {
+  int digitCount;
+  uint64_t mantissa;
+  if (val < 9007199254740992.0 && val == (double)(uint64_t)val) {
+    // Integers that fit exactly don't need anything clever
+    mantissa = (uint64_t)val;
+    *K = 0;
+  } else {
+    /* Grisu2 has to exclude the boundaries, so can miss a shorter result that is exactly on
+     * one (eg. 1e23). So first include them, and just check that the result parses back the same */
+    digitCount = jsfGrisu2(val, digits, K, true);
+    mantissa = jsfDigitsToInteger(digits, digitCount);
+    if (jsfDecimalToDouble(mantissa, *K, 0, 0) != val) {
+      digitCount = jsfGrisu2(val, digits, K, false);
+      mantissa = jsfDigitsToInteger(digits, digitCount);
+    }
+    // Grisu2 gets almost everything right - but it's long results that it may have got wrong
+    if (digitCount < 16) return digitCount;
+    if (digitCount == 17) {
+      // We can miss a 16 digit result - see if one either side of us parses back the same
+      uint64_t m = mantissa / 10;
+      if (jsfDecimalToDouble(m, *K+1, 0, 0) != val) m++;
+      if (jsfDecimalToDouble(m, *K+1, 0, 0) == val) {
+        mantissa = m;
+        (*K)++;
+      }
+    }
+    /* We may also not have picked the closest digits, so compare the exact value with the
+     * points halfway to the digits either side (picking the even one on a tie) */
+    JsfDiyFp w = jsfDiyFpFromDouble(val);
+    int cmp = jsfCompareDecimal(mantissa*2 + 1, *K, -1, w);
+    if ((cmp < 0 || (cmp==0 && (mantissa&1))) && jsfDecimalToDouble(mantissa+1, *K, 0, 0) == val) {
+      mantissa++;
+    } else {
+      cmp = jsfCompareDecimal(mantissa*2 - 1, *K, -1, w);
+      if ((cmp > 0 || (cmp==0 && (mantissa&1))) && jsfDecimalToDouble(mantissa-1, *K, 0, 0) == val)
+        mantissa--;
+    }
+  }
+  while (!(mantissa%10)) { // remove trailing zeros
+    mantissa /= 10;
+    (*K)++;
+  }
+  digitCount = 0;
+  while (mantissa) {
+    memmove(&digits[1], digits, (size_t)digitCount++);
+    digits[0] = (char)('0' + (mantissa%10));
+    mantissa /= 10;
+  }
+  return digitCount;
+}
+
+/// Write the shortest string that parses back to val (which must be positive and finite), formatted like JS's Number.toString
+static void jsfFormatShortest(JsVarFloat val, char *str, size_t len) {
+  char digits[20];
+  int digitCount = 0, K = 0;
+  int i, l = 0;
+  if (val == 0) {
+    digits[digitCount++] = '0';
+  } else {
+    digitCount = jsfShortestDigits(val, digits, &K);
+  }
+  char buf[40];
+  int n = digitCount + K; // position of the decimal point relative to the start of the digits
+  if (digitCount <= n && n <= 21) {
+    // integer - digits then trailing zeros
+    for (i=0;i<digitCount;i++) buf[l++] = digits[i];
+    for (i=digitCount;i<n;i++) buf[l++] = '0';
+  } else if (0 < n && n <= 21) {
+    // decimal point within the digits
+    for (i=0;i<digitCount;i++) {
+      if (i==n) buf[l++] = '.';
+      buf[l++] = digits[i];
+    }
+  } else if (-6 < n && n <= 0) {
+    // 0.000ddd
+    buf[l++] = '0';
+    buf[l++] = '.';
+    for (i=n;i<0;i++) buf[l++] = '0';
+    for (i=0;i<digitCount;i++) buf[l++] = digits[i];
+  } else {
+    // exponential, d.ddde+xx
+    buf[l++] = digits[0];
+    if (digitCount>1) {
+      buf[l++] = '.';
+      for (i=1;i<digitCount;i++) buf[l++] = digits[i];
+    }
+    buf[l++] = 'e';
+    buf[l++] = (n-1 < 0) ? '-' : '+';
+    itostr((n-1 < 0) ? 1-n : n-1, &buf[l], 10);
+    l += (int)strlen(&buf[l]);
+  }
+  buf[l] = 0;
+  strncpy(str, buf, len);
+  if (len) str[len-1] = 0; // bounds check
+}
+#endif
+
 void ftoa_bounded_extra(JsVarFloat val,char *str, size_t len, int radix, int fractionalDigits) {
   const JsVarFloat stopAtError = 0.0000001;
   if (isnan(val)) strncpy(str,"NaN",len);
@@ -424,6 +1013,13 @@ void ftoa_bounded_extra(JsVarFloat val,char *str, size_t len, int radix, int fra
       val = -val;
     }
 
+#ifdef JSF_EXACT_FLOATS
+    if (radix==10 && fractionalDigits<0) {
+      jsfFormatShortest(val, str, len);
+      return;
+    }
+#endif
+
     // what if we're really close to an integer? Just use that...      
     if (((JsVarInt)(val+stopAtError)) == (1+(JsVarInt)val))
       val = (JsVarFloat)(1+(JsVarInt)val);
@@ -145,7 +145,9 @@ typedef long long JsSysTime;
 
 #define JS_NUMBER_BUFFER_SIZE 66 // 64 bit base 2 + minus + terminating 0
 
-#define JSPARSE_MAX_SCOPES  8
+#define JSPARSE_ACTIVATION_POOL_SIZE 4 // function activation records kept for reuse (see jspeiNewActivation)
+#define JSPARSE_METHOD_CACHE_SIZE 32 // slots for quickly finding cached built-in methods (see jspGetBuiltInMethod)
+#define JSPARSE_LOOP_TOKENISE_ITERATIONS 8 // loops that go round this many times are run from a tokenised copy (see jspeLoopTokenise)
 // Don't restrict number of iterations now
 //#define JSPARSE_MAX_LOOP_ITERATIONS 8192
 
@@ -162,11 +164,12 @@ typedef long long JsSysTime;
 #define JS_HIDDEN_CHAR '>' // initial character of var name determines that we shouldn't see this stuff
 #define JS_HIDDEN_CHAR_STR ">"
 #define JSPARSE_FUNCTION_CODE_NAME JS_HIDDEN_CHAR_STR"cod" // the function's code!
-#define JSPARSE_FUNCTION_SCOPE_NAME JS_HIDDEN_CHAR_STR"sco" // the scope of the function's definition
+#define JSPARSE_FUNCTION_SCOPE_NAME JS_HIDDEN_CHAR_STR"sco" // the scope of the function's definition (and in a scope, the scope it was defined in)
 #define JSPARSE_FUNCTION_NAME_NAME JS_HIDDEN_CHAR_STR"nam" // for named functions (a = function foo() { foo(); })
 #define JSPARSE_EXCEPTION_VAR "except" // when exceptions are thrown, they're stored in the root scope
 #define JSPARSE_STACKTRACE_VAR "sTrace" // for errors/exceptions, a stack trace is stored as a string
 #define JSPARSE_MODULE_CACHE_NAME "modules"
+#define JSPARSE_BUILTIN_CACHE_NAME "methods" // built-in methods' native function vars, so we don't create them each time
 
 #if !defined(NO_ASSERT)
  #ifdef __STRING
@@ -184,6 +187,15 @@ typedef long long JsSysTime;
 /// Used before functions that we want to ensure are not inlined (eg. "void NO_INLINE foo() {}")
 #define NO_INLINE __attribute__ ((noinline))
 
+/** Used before the interpreter's global state (eg. "THREAD_LOCAL JsExecInfo execInfo"). On Linux
+ * each thread then gets its own copy, so several isolated interpreters can run at once on
+ * different threads (see --threads in targets/linux/main.c) */
+#ifdef LINUX
+#define THREAD_LOCAL __thread
+#else
+#define THREAD_LOCAL
+#endif
+
 /// Maximum amount of locks we ever expect to have on a variable (this could limit recursion) must be 2^n-1
 #define JSV_LOCK_MAX  15
 
@@ -276,6 +288,7 @@ typedef enum LEX_TYPES {
     LEX_INT,
     LEX_FLOAT,
     LEX_STR,
+    LEX_REGEX,
     LEX_UNFINISHED_COMMENT,
 
     LEX_EQUAL,
@@ -396,11 +409,12 @@ typedef enum {
   JSERR_CALLBACK = 4, ///< A callback (on data/watch/timer) caused an error and was removed
   JSERR_LOW_MEMORY = 8, ///< Memory is running low - Espruino had to run a garbage collection pass or remove some of the command history
   JSERR_MEMORY = 16, ///< Espruino ran out of memory and was unable to allocate some data that it needed.
+  JSERR_EVENT_QUEUE_FULL = 32, ///< The queue of events waiting to be executed (in jsinteractive.c) was full, so an event was lost
 } PACKED_FLAGS JsErrorFlags;
 
 /** Error flags for things that we don't really want to report on the console,
  * but which are good to know about */
-extern JsErrorFlags jsErrorFlags;
+extern THREAD_LOCAL JsErrorFlags jsErrorFlags;
 
 
 #ifdef FAKE_STDLIB
@@ -409,7 +423,11 @@ char *strncat(char *dst, const char *src, size_t c);
 char *strncpy(char *dst, const char *src, size_t c);
 size_t strlen(const char *s);
 int strcmp(const char *a, const char *b);
+int strncmp(const char *a, const char *b, size_t c);
 void *memcpy(void *dst, const void *src, size_t size);
+void *memmove(void *dst, const void *src, size_t size);
+void *memset(void *dst, int c, size_t size);
+int memcmp(const void *a, const void *b, size_t size);
 #define RAND_MAX (0xFFFFFFFFU)
 unsigned int rand();
 #endif
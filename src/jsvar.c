@@ -29,16 +29,20 @@
  */
 
 #ifdef RESIZABLE_JSVARS
-JsVar **jsVarBlocks = 0;
-unsigned int jsVarsSize = 0;
+THREAD_LOCAL JsVar **jsVarBlocks = 0;
+THREAD_LOCAL unsigned int jsVarsSize = 0;
 #define JSVAR_BLOCK_SIZE 1024
 #define JSVAR_BLOCK_SHIFT 10
 #else
-JsVar jsVars[JSVAR_CACHE_SIZE];
-unsigned int jsVarsSize = JSVAR_CACHE_SIZE;
+THREAD_LOCAL JsVar jsVars[JSVAR_CACHE_SIZE];
+THREAD_LOCAL unsigned int jsVarsSize = JSVAR_CACHE_SIZE;
 #endif
 
-JsVarRef jsVarFirstEmpty; ///< reference of first unused variable (variables are in a linked list)
+THREAD_LOCAL JsVarRef jsVarFirstEmpty; ///< reference of first unused variable (variables are in a linked list)
+#ifndef SAVE_ON_FLASH
+THREAD_LOCAL JsVarStats jsVarStats;
+THREAD_LOCAL unsigned int jsVarsFreedInStatement;
+#endif
 
 /** Return a pointer - UNSAFE for null refs.
  * This is effectively a Lock without locking! */
@@ -98,9 +102,12 @@ void jsvSetMaxVarsUsed(unsigned int size) {
 }
 
 
-// maps the empty variables in...
-void jsvSoftInit() {
+/// Rebuild the list of free JsVars so that it goes in order of address
+static void jsvCreateEmptyVarList() {
   jsVarFirstEmpty = 0;
+#ifndef SAVE_ON_FLASH
+  jsVarsFreedInStatement = 0;
+#endif
   JsVar *lastEmpty = 0;
   JsVarRef i;
   for (i=1;i<=jsVarsSize;i++) {
@@ -115,6 +122,14 @@ void jsvSoftInit() {
   }
 }
 
+// maps the empty variables in...
+void jsvSoftInit() {
+  jsvCreateEmptyVarList();
+#ifndef SAVE_ON_FLASH
+  jsvResetStats();
+#endif
+}
+
 void jsvSoftKill() {
 }
 
@@ -133,6 +148,182 @@ static JsVarRef jsvInitJsVars(JsVarRef start, unsigned int count) {
   return start;
 }
 
+#ifdef JSVAR_ALLOC_PROFILER
+/* The allocation profiler stores an allocation site index for every
+ * JsVar (in jsvProfilerVarSite) and keeps counts for each site. A site
+ * is a line in a string of code (either the main code or a function's).
+ * Sites are keyed by the JsVarRef of the code, so when that is freed (and the
+ * ref may be reused for other code) its sites are marked as freed. */
+
+#define JSV_PROFILER_SITES 127 ///< Max number of sites (site 0 is used for anything we can't record)
+#define JSV_PROFILER_CACHE 256 ///< Size of the cache from code position -> site
+#define JSV_PROFILER_IS_SOURCE 0x80 ///< Set in jsvProfilerVarSite (above site+1) if the JsVar is the code for a site
+
+typedef struct {
+  JsVarRef source; ///< The string of code that was executing (or 0 if unknown or freed)
+  unsigned int line; ///< The line in source
+  unsigned int live; ///< The number of JsVars allocated here that haven't been freed
+  unsigned int allocs; ///< The total number of JsVars allocated here
+} JsvProfilerSite;
+
+typedef struct {
+  JsVarRef source;
+  size_t position;
+  unsigned char site;
+} JsvProfilerCacheEntry;
+
+static THREAD_LOCAL unsigned char *jsvProfilerVarSite = 0; ///< site+1 for each JsVar (0 if untracked), ORed with JSV_PROFILER_IS_SOURCE. Null if profiler isn't running
+static THREAD_LOCAL JsvProfilerSite *jsvProfilerSites = 0;
+static THREAD_LOCAL JsvProfilerCacheEntry *jsvProfilerCache = 0;
+static THREAD_LOCAL int jsvProfilerSiteCount = 0;
+
+void jsvProfilerStop() {
+  free(jsvProfilerVarSite);
+  free(jsvProfilerSites);
+  free(jsvProfilerCache);
+  jsvProfilerVarSite = 0;
+  jsvProfilerSites = 0;
+  jsvProfilerCache = 0;
+  jsvProfilerSiteCount = 0;
+}
+
+void jsvProfilerStart() {
+  jsvProfilerStop();
+  jsvProfilerVarSite = calloc(jsVarsSize, 1);
+  jsvProfilerSites = calloc(JSV_PROFILER_SITES, sizeof(JsvProfilerSite));
+  jsvProfilerCache = calloc(JSV_PROFILER_CACHE, sizeof(JsvProfilerCacheEntry));
+  if (!jsvProfilerVarSite || !jsvProfilerSites || !jsvProfilerCache) {
+    jsvProfilerStop();
+    return;
+  }
+  jsvProfilerSiteCount = 1; // site 0 is 'unknown'
+}
+
+bool jsvProfilerIsRunning() {
+  return jsvProfilerVarSite != 0;
+}
+
+/// Called when the number of JsVars has changed
+static void jsvProfilerResize(unsigned int oldSize, unsigned int newSize) {
+  if (!jsvProfilerVarSite) return;
+  unsigned char *sites = realloc(jsvProfilerVarSite, newSize);
+  if (!sites) {
+    jsvProfilerStop();
+    return;
+  }
+  if (newSize > oldSize)
+    memset(&sites[oldSize], 0, newSize-oldSize);
+  jsvProfilerVarSite = sites;
+}
+
+/// Get the site index for the code that is currently executing
+static unsigned char jsvProfilerGetCurrentSite() {
+  JsLex *lex = execInfo.lex;
+  if (!lex || !lex->sourceVar) return 0;
+  JsVarRef source = jsvGetRef(lex->sourceVar);
+  size_t position = lex->tokenLastStart;
+  JsvProfilerCacheEntry *cache = &jsvProfilerCache[(source*31 + position) & (JSV_PROFILER_CACHE-1)];
+  if (cache->source==source && cache->position==position)
+    return cache->site;
+  // not cached - work out the line and find or add the site for it
+  size_t line, col;
+  jsvGetLineAndCol(lex->sourceVar, position, &line, &col);
+  unsigned char site = 0;
+  int i;
+  for (i=1;i<jsvProfilerSiteCount;i++)
+    if (jsvProfilerSites[i].source==source && jsvProfilerSites[i].line==line)
+      site = (unsigned char)i;
+  if (!site && jsvProfilerSiteCount<JSV_PROFILER_SITES) {
+    site = (unsigned char)jsvProfilerSiteCount++;
+    jsvProfilerSites[site].source = source;
+    jsvProfilerSites[site].line = (unsigned int)line;
+    jsvProfilerVarSite[source-1] |= JSV_PROFILER_IS_SOURCE;
+  }
+  cache->source = source;
+  cache->position = position;
+  cache->site = site;
+  return site;
+}
+
+static void jsvProfilerAllocated(JsVarRef ref) {
+  unsigned char site = jsvProfilerGetCurrentSite();
+  jsvProfilerVarSite[ref-1] = (unsigned char)(site+1);
+  jsvProfilerSites[site].live++;
+  jsvProfilerSites[site].allocs++;
+}
+
+/// The code for some sites has been freed - so its ref may be reused for different code
+static void jsvProfilerSourceFreed(JsVarRef source) {
+  int i;
+  for (i=1;i<jsvProfilerSiteCount;i++)
+    if (jsvProfilerSites[i].source==source)
+      jsvProfilerSites[i].source = 0;
+  for (i=0;i<JSV_PROFILER_CACHE;i++)
+    if (jsvProfilerCache[i].source==source)
+      jsvProfilerCache[i].source = 0;
+}
+
+static void jsvProfilerFreed(JsVarRef ref) {
+  unsigned char site = jsvProfilerVarSite[ref-1];
+  if (!site) return; // allocated before we started
+  jsvProfilerVarSite[ref-1] = 0;
+  if (site & JSV_PROFILER_IS_SOURCE) {
+    jsvProfilerSourceFreed(ref);
+    site &= (unsigned char)~JSV_PROFILER_IS_SOURCE;
+  }
+  if (site) jsvProfilerSites[site-1].live--;
+}
+
+/// Get a readable name for an allocation site. Uses a linear search to find which function the code belongs to
+static JsVar *jsvProfilerGetSiteName(JsvProfilerSite *site) {
+  if (!site->source)
+    return site->line ? jsvVarPrintf("freed code line %d", site->line) : jsvNewFromString("unknown");
+  JsVar *function = 0;
+  JsVarRef i;
+  for (i=1;i<=jsVarsSize && !function;i++) {
+    JsVar *v = jsvGetAddressOf(i);
+    if (jsvIsFunction(v) && !jsvIsNative(v)) {
+      JsVar *code = jsvFindChildFromString(v, JSPARSE_FUNCTION_CODE_NAME, false);
+      if (code && jsvGetFirstChild(code)==site->source)
+        function = jsvLock(i);
+      jsvUnLock(code);
+    }
+  }
+  if (!function) return jsvVarPrintf("line %d", site->line);
+  JsVar *path = jsvGetPathTo(execInfo.root, function, 4, 0);
+  jsvUnLock(function);
+  JsVar *name = path ? jsvVarPrintf("%v line %d", path, site->line) : jsvVarPrintf("function line %d", site->line);
+  jsvUnLock(path);
+  return name;
+}
+
+JsVar *jsvProfilerGetSites() {
+  JsVar *arr = jsvNewWithFlags(JSV_ARRAY);
+  if (!arr || !jsvProfilerSites) return arr;
+  // Take a copy, as allocating while we make the array may change the counts
+  int count = jsvProfilerSiteCount;
+  JsvProfilerSite sites[JSV_PROFILER_SITES];
+  memcpy(sites, jsvProfilerSites, sizeof(JsvProfilerSite)*(size_t)count);
+  // Add sites with the most live variables first
+  while (true) {
+    int best = -1, i;
+    for (i=0;i<count;i++)
+      if (sites[i].allocs && (best<0 || sites[i].live>sites[best].live))
+        best = i;
+    if (best<0) break;
+    JsVar *obj = jsvNewWithFlags(JSV_OBJECT);
+    if (!obj) break;
+    jsvUnLock(jsvObjectSetChild(obj, "site", jsvProfilerGetSiteName(&sites[best])));
+    jsvUnLock(jsvObjectSetChild(obj, "live", jsvNewFromInteger((JsVarInt)sites[best].live)));
+    jsvUnLock(jsvObjectSetChild(obj, "bytes", jsvNewFromInteger((JsVarInt)(sites[best].live*sizeof(JsVar)))));
+    jsvUnLock(jsvObjectSetChild(obj, "allocs", jsvNewFromInteger((JsVarInt)sites[best].allocs)));
+    jsvArrayPushAndUnLock(arr, obj);
+    sites[best].allocs = 0; // don't use it again
+  }
+  return arr;
+}
+#endif
+
 void jsvInit() {
 #ifdef RESIZABLE_JSVARS
   jsVarsSize = JSVAR_BLOCK_SIZE;
@@ -153,6 +344,9 @@ void jsvKill() {
   jsVarBlocks = 0;
   jsVarsSize = 0;
 #endif
+#ifdef JSVAR_ALLOC_PROFILER
+  jsvProfilerStop();
+#endif
 }
 
 /** Find or create the ROOT variable item - used mainly
@@ -166,6 +360,16 @@ JsVar *jsvFindOrCreateRoot() {
   return jsvRef(jsvNewWithFlags(JSV_ROOT));
 }
 
+#ifndef SAVE_ON_FLASH
+void jsvResetStats() {
+  jsVarStats.allocations = 0;
+  jsVarStats.scratchAllocations = 0;
+  jsVarStats.garbageCollects = 0;
+  jsVarStats.memoryUsage = jsvGetMemoryUsage();
+  jsVarStats.peakMemoryUsage = jsVarStats.memoryUsage;
+}
+#endif
+
 /// Get number of memory records (JsVars) used
 unsigned int jsvGetMemoryUsage() {
   unsigned int usage = 0;
@@ -183,10 +387,35 @@ unsigned int jsvGetMemoryTotal() {
   return jsVarsSize;
 }
 
-/// Try and allocate more memory - only works if RESIZABLE_JSVARS is defined
+/// Try and allocate more (or free unused) memory - only works if RESIZABLE_JSVARS is defined
 void jsvSetMemoryTotal(unsigned int jsNewVarCount) {
 #ifdef RESIZABLE_JSVARS
-  if (jsNewVarCount <= jsVarsSize) return; // never allow us to have less!
+  if (jsNewVarCount == jsVarsSize) return;
+  if (jsNewVarCount < jsVarsSize) {
+    // We can only free blocks at the end that are completely unused (and we always keep one)
+    unsigned int lastUsed = jsVarsSize;
+    while (lastUsed>0 && (jsvGetAddressOf((JsVarRef)lastUsed)->flags&JSV_VARTYPEMASK) == JSV_UNUSED)
+      lastUsed--;
+    if (jsNewVarCount < lastUsed) jsNewVarCount = lastUsed;
+    unsigned int oldSize = jsVarsSize;
+    unsigned int oldBlockCount = jsVarsSize >> JSVAR_BLOCK_SHIFT;
+    unsigned int newBlockCount = (jsNewVarCount+JSVAR_BLOCK_SIZE-1) >> JSVAR_BLOCK_SHIFT;
+    if (newBlockCount < 1) newBlockCount = 1;
+    if (newBlockCount >= oldBlockCount) return;
+    unsigned int i;
+    for (i=newBlockCount;i<oldBlockCount;i++)
+      free(jsVarBlocks[i]);
+    jsVarBlocks = realloc(jsVarBlocks, sizeof(JsVar*)*newBlockCount);
+    jsVarsSize = newBlockCount << JSVAR_BLOCK_SHIFT;
+    // the free list may have pointed into the blocks we freed
+    jsvCreateEmptyVarList();
+#ifdef JSVAR_ALLOC_PROFILER
+    jsvProfilerResize(oldSize, jsVarsSize);
+#else
+    NOT_USED(oldSize);
+#endif
+    return;
+  }
   // When resizing, we just allocate a bunch more
   unsigned int oldSize = jsVarsSize;
   unsigned int oldBlockCount = jsVarsSize >> JSVAR_BLOCK_SHIFT;
@@ -198,10 +427,16 @@ void jsvSetMemoryTotal(unsigned int jsNewVarCount) {
   unsigned int i;
   for (i=oldBlockCount;i<newBlockCount;i++)
     jsVarBlocks[i] = malloc(sizeof(JsVar) * JSVAR_BLOCK_SIZE);
-  /** and now reset all the newly allocated vars. We know jsVarFirstEmpty
+  /** and now reset all the newly allocated vars. Usually jsVarFirstEmpty
    * is 0 (because jsiFreeMoreMemory returned 0) so we can just assign it.  */
-  assert(!jsVarFirstEmpty);
-  jsVarFirstEmpty = jsvInitJsVars(oldSize+1, jsVarsSize-oldSize);
+  JsVarRef newVars = jsvInitJsVars(oldSize+1, jsVarsSize-oldSize);
+  if (jsVarFirstEmpty)
+    jsvCreateEmptyVarList(); // keep the JsVars that were already free
+  else
+    jsVarFirstEmpty = newVars;
+#ifdef JSVAR_ALLOC_PROFILER
+  jsvProfilerResize(oldSize, jsVarsSize);
+#endif
   // jsiConsolePrintf("Resized memory from %d blocks to %d\n", oldBlockCount, newBlockCount);
 #else
   NOT_USED(jsNewVarCount);
@@ -260,6 +495,18 @@ JsVar *jsvNewWithFlags(JsVarFlags flags) {
       // set flags
       assert(!(flags & JSV_LOCK_MASK));
       v->flags = flags | JSV_LOCK_ONE;
+#ifndef SAVE_ON_FLASH
+      jsVarStats.allocations++;
+      if (jsVarsFreedInStatement) {
+        jsVarsFreedInStatement--;
+        jsVarStats.scratchAllocations++;
+      }
+      if (++jsVarStats.memoryUsage > jsVarStats.peakMemoryUsage)
+        jsVarStats.peakMemoryUsage = jsVarStats.memoryUsage;
+#endif
+#ifdef JSVAR_ALLOC_PROFILER
+      if (jsvProfilerVarSite) jsvProfilerAllocated(jsvGetRef(v));
+#endif
 
       // return pointer
       return v;
@@ -291,6 +538,13 @@ static inline void jsvFreePtrInternal(JsVar *var) {
   // add this to our free list
   jsvSetNextSibling(var, jsVarFirstEmpty);
   jsVarFirstEmpty = jsvGetRef(var);
+#ifndef SAVE_ON_FLASH
+  jsVarStats.memoryUsage--;
+  jsVarsFreedInStatement++;
+#endif
+#ifdef JSVAR_ALLOC_PROFILER
+  if (jsvProfilerVarSite) jsvProfilerFreed(jsVarFirstEmpty);
+#endif
 }
 
 void jsvFreePtr(JsVar *var) {
@@ -343,6 +597,7 @@ void jsvFreePtr(JsVar *var) {
         jsvUnLock(child);
       }
     } else {
+      jsvSetStringTail(var, 0, 0);
       assert(!jsvGetFirstChild(var));
       assert(!jsvGetLastChild(var));
       if (jsvIsName(var)) {
@@ -397,6 +652,11 @@ JsVar *jsvLockAgain(JsVar *var) {
   return var;
 }
 
+/// Lock this pointer and return a pointer - SAFE for null pointer
+JsVar *jsvLockAgainSafe(JsVar *var) {
+  return var ? jsvLockAgain(var) : 0;
+}
+
 /// Unlock this variable - this is SAFE for null variables
 void jsvUnLock(JsVar *var) {
   if (!var) return;
@@ -572,6 +832,7 @@ JsVar *jsvMakeIntoVariableName(JsVar *var, JsVar *valueOrZero) {
     }
     var->flags = (JsVarFlags)(var->flags & ~JSV_VARTYPEMASK) | t;
   } else if ((var->flags & JSV_VARTYPEMASK)>=JSV_STRING_0 && (var->flags & JSV_VARTYPEMASK)<=JSV_STRING_MAX) {
+    jsvSetStringTail(var, 0, 0); // names use these fields
     size_t t = JSV_NAME_STRING_0;
     if (jsvIsInt(valueOrZero) && !jsvIsPin(valueOrZero)) {
       JsVarInt v = valueOrZero->varData.integer;
@@ -869,23 +1130,66 @@ bool jsvIsEmptyString(JsVar *v) {
   return jsvGetCharactersInVar(v)==0;
 }
 
-size_t jsvGetStringLength(JsVar *v) {
-  size_t strLength = 0;
-  JsVar *var = v;
-  JsVarRef ref = 0;
+/* The first block of a String (not a Name) doesn't use nextSibling/prevSibling/firstChild, so
+ * once a string has StringExts we store the ref of its last block in firstChild and the number
+ * of characters before that block in nextSibling/prevSibling. Strings only ever grow at the
+ * end, so even if something appends without updating this it's still valid - it just
+ * means walking a few extra blocks. */
+static inline bool jsvCanHaveStringTail(const JsVar *v) {
+#ifndef JSVARREF_PACKED_BITS
+  return (v->flags&JSV_VARTYPEMASK)>=JSV_STRING_0 && (v->flags&JSV_VARTYPEMASK)<=JSV_STRING_MAX;
+#else
+  NOT_USED(v);
+  return false; // bits of refs are stored in 'pack' - not worth it for the tiny strings we'll have here
+#endif
+}
 
-  if (!jsvHasCharacterData(v)) return 0;
+JsVarRef jsvGetStringTail(const JsVar *str, size_t *charsBefore) {
+  if (!jsvCanHaveStringTail(str)) return 0;
+  JsVarRef tail = jsvGetFirstChild(str);
+  if (tail) {
+#if JSVARREF_SIZE<4
+    *charsBefore = (size_t)jsvGetNextSibling(str) | ((size_t)jsvGetPrevSibling(str) << (8*JSVARREF_SIZE));
+#else
+    *charsBefore = (size_t)jsvGetNextSibling(str);
+#endif
+  }
+  return tail;
+}
 
-  while (var) {
-    JsVarRef refNext = jsvGetLastChild(var);
-    strLength += jsvGetCharactersInVar(var);
+void jsvSetStringTail(JsVar *str, JsVarRef tail, size_t charsBefore) {
+  if (!jsvCanHaveStringTail(str)) return;
+  if (tail == jsvGetRef(str)) tail = 0; // no StringExts
+  jsvSetFirstChild(str, tail);
+  jsvSetNextSibling(str, tail ? (JsVarRef)charsBefore : 0);
+#if JSVARREF_SIZE<4
+  jsvSetPrevSibling(str, tail ? (JsVarRef)(charsBefore >> (8*JSVARREF_SIZE)) : 0);
+#endif
+}
 
-    // Go to next
-    if (ref) jsvUnLock(var); // note use of if (ref), not var
-    ref = refNext;
-    var = ref ? jsvLock(ref) : 0;
+/// Lock the last block of the given string, and set charsBefore to the number of characters before it
+static JsVar *jsvLockStringTail(JsVar *str, size_t *charsBefore) {
+  *charsBefore = 0;
+  JsVarRef tail = jsvGetStringTail(str, charsBefore);
+  JsVar *block = tail ? jsvLock(tail) : jsvLockAgain(str);
+  while (jsvGetLastChild(block)) {
+    JsVarRef next = jsvGetLastChild(block);
+    *charsBefore += jsvGetCharactersInVar(block);
+    jsvUnLock(block);
+    block = jsvLock(next);
   }
-  if (ref) jsvUnLock(var); // note use of if (ref), not var
+  return block;
+}
+
+size_t jsvGetStringLength(JsVar *v) {
+  if (!jsvHasCharacterData(v)) return 0;
+  if (!jsvGetLastChild(v)) return jsvGetCharactersInVar(v);
+
+  size_t charsBefore;
+  JsVar *tail = jsvLockStringTail(v, &charsBefore);
+  size_t strLength = charsBefore + jsvGetCharactersInVar(tail);
+  jsvSetStringTail(v, jsvGetRef(tail), charsBefore); // so we don't have to walk it next time
+  jsvUnLock(tail);
   return strLength;
 }
 
@@ -977,13 +1281,9 @@ size_t jsvGetIndexFromLineAndCol(JsVar *v, size_t line, size_t col) {
 
 void jsvAppendString(JsVar *var, const char *str) {
   assert(jsvIsString(var));
-  JsVar *block = jsvLockAgain(var);
   // Find the block at end of the string...
-  while (jsvGetLastChild(block)) {
-    JsVarRef next = jsvGetLastChild(block);
-    jsvUnLock(block);
-    block = jsvLock(next);
-  }
+  size_t charsBefore;
+  JsVar *block = jsvLockStringTail(var, &charsBefore);
   // find how full the block is
   size_t blockChars = jsvGetCharactersInVar(block);
   // now start appending
@@ -1003,22 +1303,20 @@ void jsvAppendString(JsVar *var, const char *str) {
       jsvSetLastChild(block, jsvGetRef(next));
       jsvUnLock(block);
       block = next;
+      charsBefore += l;
       blockChars=0; // it's new, so empty
     }
   }
+  jsvSetStringTail(var, jsvGetRef(block), charsBefore);
   jsvUnLock(block);
 }
 
 // Append the given string to this one - but does not use null-terminated strings. returns false on failure (from out of memory)
 bool jsvAppendStringBuf(JsVar *var, const char *str, size_t length) {
   assert(jsvIsString(var));
-  JsVar *block = jsvLockAgain(var);
   // Find the block at end of the string...
-  while (jsvGetLastChild(block)) {
-    JsVarRef next = jsvGetLastChild(block);
-    jsvUnLock(block);
-    block = jsvLock(next);
-  }
+  size_t charsBefore;
+  JsVar *block = jsvLockStringTail(var, &charsBefore);
   // find how full the block is
   size_t blockChars = jsvGetCharactersInVar(block);
   // now start appending
@@ -1036,6 +1334,7 @@ bool jsvAppendStringBuf(JsVar *var, const char *str, size_t length) {
       JsVar *next = jsvNewWithFlags(JSV_STRING_EXT_0);
       if (!next) {
         jsvSetLastChild(block, 0);
+        jsvSetStringTail(var, jsvGetRef(block), charsBefore);
         jsvUnLock(block);
         return false;
       }
@@ -1043,9 +1342,11 @@ bool jsvAppendStringBuf(JsVar *var, const char *str, size_t length) {
       jsvSetLastChild(block, jsvGetRef(next));
       jsvUnLock(block);
       block = next;
+      charsBefore += l;
       blockChars=0; // it's new, so empty
     }
   }
+  jsvSetStringTail(var, jsvGetRef(block), charsBefore);
   jsvUnLock(block);
   return true;
 }
@@ -1066,7 +1367,7 @@ void jsvAppendPrintf(JsVar *var, const char *fmt, ...) {
   vcbprintf((vcbprintf_callback)jsvStringIteratorPrintfCallback,&it, fmt, argp);
   va_end(argp);
 
-  jsvStringIteratorFree(&it);
+  jsvStringIteratorFreeAppend(&it, var);
 }
 
 JsVar *jsvVarPrintf( const char *fmt, ...) {
@@ -1081,20 +1382,16 @@ JsVar *jsvVarPrintf( const char *fmt, ...) {
   vcbprintf((vcbprintf_callback)jsvStringIteratorPrintfCallback,&it, fmt, argp);
   va_end(argp);
 
-  jsvStringIteratorFree(&it);
+  jsvStringIteratorFreeAppend(&it, str);
   return str;
 }
 
 /** Append str to var. Both must be strings. stridx = start char or str, maxLength = max number of characters (can be JSVAPPENDSTRINGVAR_MAXLENGTH) */
 void jsvAppendStringVar(JsVar *var, const JsVar *str, size_t stridx, size_t maxLength) {
-  JsVar *block = jsvLockAgain(var);
   assert(jsvIsString(var));
   // Find the block at end of the string...
-  while (jsvGetLastChild(block)) {
-    JsVarRef next = jsvGetLastChild(block);
-    jsvUnLock(block);
-    block = jsvLock(next);
-  }
+  size_t charsBefore;
+  JsVar *block = jsvLockStringTail(var, &charsBefore);
   // find how full the block is
   size_t blockChars = jsvGetCharactersInVar(block);
   // now start appending
@@ -1110,6 +1407,7 @@ void jsvAppendStringVar(JsVar *var, const JsVar *str, size_t stridx, size_t maxL
       jsvSetLastChild(block, jsvGetRef(next));
       jsvUnLock(block);
       block = next;
+      charsBefore += blockChars;
       blockChars=0; // it's new, so empty
     }
     block->varData.str[blockChars++] = ch;
@@ -1117,6 +1415,7 @@ void jsvAppendStringVar(JsVar *var, const JsVar *str, size_t stridx, size_t maxL
   }
   jsvStringIteratorFree(&it);
   jsvSetCharactersInVar(block, blockChars);
+  jsvSetStringTail(var, jsvGetRef(block), charsBefore);
   jsvUnLock(block);
 }
 
@@ -1414,6 +1713,13 @@ bool jsvIsStringEqualOrStartsWith(JsVar *var, const char *str, bool isStartsWith
   if (!jsvHasCharacterData(var)) {
     return 0; // not a string so not equal!
   }
+  if (!isStartsWith && !jsvGetLastChild(var)) {
+    // All in one block (as most names are) - compare directly without an iterator
+    size_t i, len = jsvGetCharactersInVar(var);
+    for (i=0;i<len;i++)
+      if (!str[i] || var->varData.str[i]!=str[i]) return false;
+    return str[len]==0;
+  }
 
   JsvStringIterator it;
   jsvStringIteratorNew(&it, var, 0);
@@ -1558,16 +1864,25 @@ JsVar *jsvCopy(JsVar *src) {
   }
 
   if (jsvHasStringExt(src)) {
-    // copy extra bits of string if there were any
-    if (jsvGetLastChild(src)) {
-      JsVar *child = jsvLock(jsvGetLastChild(src));
-      JsVar *childCopy = jsvCopy(child);
-      if (childCopy) {// could be out of memory
-        jsvSetLastChild(dst, jsvGetRef(childCopy)); // no ref for stringext
-        jsvUnLock(childCopy);
-      }
+    // copy extra bits of string if there were any - a block at a time rather than recursing, as strings can be long
+    JsVar *block = jsvLockAgain(dst);
+    size_t charsBefore = 0;
+    JsVarRef childRef = jsvGetLastChild(src);
+    while (childRef) {
+      JsVar *child = jsvLock(childRef);
+      JsVar *childCopy = jsvNewWithFlags(child->flags & JSV_VARIABLEINFOMASK);
+      if (childCopy) { // could be out of memory
+        memcpy(&childCopy->varData, &child->varData, JSVAR_DATA_STRING_MAX_LEN);
+        jsvSetLastChild(block, jsvGetRef(childCopy)); // no ref for stringext
+        charsBefore += jsvGetCharactersInVar(block);
+        jsvUnLock(block);
+        block = childCopy;
+        childRef = jsvGetLastChild(child);
+      } else childRef = 0;
       jsvUnLock(child);
     }
+    jsvSetStringTail(dst, jsvGetRef(block), charsBefore);
+    jsvUnLock(block);
   } else if (jsvHasChildren(src)) {
     // Copy children..
     JsVarRef vr;
@@ -2229,17 +2544,214 @@ void jsvArrayInsertBefore(JsVar *arr, JsVar *beforeIndex, JsVar *element) {
     jsvArrayPush(arr, element);
 }
 
+/** The result of maths on numbers or booleans, before it has been put in a JsVar */
+typedef struct {
+  JsVarFlags type; ///< JSV_INTEGER, JSV_FLOAT or JSV_BOOLEAN
+  long long integer; ///< For JSV_INTEGER and JSV_BOOLEAN. May be out of the range of JsVarInt (see jsvNewFromLongInteger)
+  JsVarFloat floating; ///< For JSV_FLOAT
+} JsvImmediate;
+
+static JsVar *jsvNewFromImmediate(JsvImmediate *r) {
+  if (r->type==JSV_BOOLEAN) return jsvNewFromBool(r->integer!=0);
+  if (r->type==JSV_INTEGER) return jsvNewFromLongInteger(r->integer);
+  return jsvNewFromFloat(r->floating);
+}
+
+/// Overwrite the value of v (which must be a temporary number - see jsvIsTemporaryNumber)
+static void jsvSetImmediate(JsVar *v, JsvImmediate *r) {
+  JsVarFlags type = r->type;
+  if (type==JSV_INTEGER && (r->integer<-2147483648LL || r->integer>2147483647LL)) {
+    type = JSV_FLOAT;
+    v->varData.floating = (JsVarFloat)r->integer;
+  } else if (type==JSV_FLOAT) {
+    v->varData.floating = r->floating;
+  } else {
+    v->varData.integer = (JsVarInt)r->integer;
+  }
+  v->flags = (JsVarFlags)((v->flags & ~JSV_VARTYPEMASK) | type);
+}
+
+/// Is this a plain number or boolean (not a pin, name or null)?
+static bool jsvIsNumberOrBool(const JsVar *v) {
+  if (!v) return false;
+  JsVarFlags t = v->flags&JSV_VARTYPEMASK;
+  return t==JSV_INTEGER || t==JSV_FLOAT || t==JSV_BOOLEAN;
+}
+
+/** Is this a number that nothing else can see (it has just the one lock
+ * the caller has, and no references), so can be overwritten with a result? */
+static bool jsvIsTemporaryNumber(JsVar *v) {
+  return jsvIsNumberOrBool(v) && !(v->flags&JSV_NATIVE) &&
+         jsvGetRefs(v)==0 && jsvGetLocks(v)==1;
+}
+
+/** Like jsvSkipName, but names that contain their integer/boolean values
+ * are read into 'imm' (which is returned, and must NOT be locked or unlocked)
+ * rather than into a newly allocated JsVar */
+static JsVar *jsvSkipNameToImmediate(JsVar *a, JsVar *imm) {
+  if (jsvIsNameInt(a)) {
+    imm->flags = JSV_INTEGER;
+    imm->varData.integer = (JsVarInt)jsvGetFirstChildSigned(a);
+    return imm;
+  }
+  if (jsvIsNameIntBool(a)) {
+    imm->flags = JSV_BOOLEAN;
+    imm->varData.integer = jsvGetFirstChild(a)!=0;
+    return imm;
+  }
+  return jsvSkipName(a);
+}
+
+/** Do maths on a and b (which are both numeric, null or undefined), as
+ * integers if useInts is set. Returns false if op isn't supported */
+static bool jsvMathsOpNumeric(JsVar *a, JsVar *b, int op, bool useInts, JsvImmediate *r) {
+  r->type = JSV_BOOLEAN;
+  if (useInts) {
+    // note that int+undefined should be handled as a double
+    // use ints
+    JsVarInt da = jsvGetInteger(a);
+    JsVarInt db = jsvGetInteger(b);
+    r->type = JSV_INTEGER;
+    switch (op) {
+        case '+': r->integer = (long long)da + (long long)db; break;
+        case '-': r->integer = (long long)da - (long long)db; break;
+        case '*': r->integer = (long long)da * (long long)db; break;
+        case '/': r->type = JSV_FLOAT; r->floating = (JsVarFloat)da/(JsVarFloat)db; break;
+        case '&': r->integer = da&db; break;
+        case '|': r->integer = da|db; break;
+        case '^': r->integer = da^db; break;
+        case '%': if (db) r->integer = da%db;
+                  else { r->type = JSV_FLOAT; r->floating = NAN; }
+                  break;
+        case LEX_LSHIFT: r->integer = (JsVarInt)(da << db); break;
+        case LEX_RSHIFT: r->integer = da >> db; break;
+        case LEX_RSHIFTUNSIGNED: r->integer = (JsVarInt)(((JsVarIntUnsigned)da) >> db); break;
+        case LEX_EQUAL:     r->type = JSV_BOOLEAN; r->integer = da==db && jsvIsNull(a)==jsvIsNull(b); break;
+        case LEX_NEQUAL:    r->type = JSV_BOOLEAN; r->integer = da!=db || jsvIsNull(a)!=jsvIsNull(b); break;
+        case '<':           r->type = JSV_BOOLEAN; r->integer = da<db; break;
+        case LEX_LEQUAL:    r->type = JSV_BOOLEAN; r->integer = da<=db; break;
+        case '>':           r->type = JSV_BOOLEAN; r->integer = da>db; break;
+        case LEX_GEQUAL:    r->type = JSV_BOOLEAN; r->integer = da>=db; break;
+        default: return false;
+    }
+  } else {
+    // use doubles
+    JsVarFloat da = jsvGetFloat(a);
+    JsVarFloat db = jsvGetFloat(b);
+    r->type = JSV_FLOAT;
+    switch (op) {
+        case '+': r->floating = da+db; break;
+        case '-': r->floating = da-db; break;
+        case '*': r->floating = da*db; break;
+        case '/': r->floating = da/db; break;
+        case '%': r->floating = jswrap_math_mod(da, db); break;
+        case LEX_EQUAL:
+        case LEX_NEQUAL:  { bool equal = da==db;
+                            if ((jsvIsNull(a) && jsvIsUndefined(b)) ||
+                                (jsvIsNull(b) && jsvIsUndefined(a))) equal = true; // JS quirk :)
+                            r->type = JSV_BOOLEAN;
+                            r->integer = (op==LEX_EQUAL) ? equal : ((bool)!equal);
+                            break;
+                          }
+        case '<':           r->type = JSV_BOOLEAN; r->integer = da<db; break;
+        case LEX_LEQUAL:    r->type = JSV_BOOLEAN; r->integer = da<=db; break;
+        case '>':           r->type = JSV_BOOLEAN; r->integer = da>db; break;
+        case LEX_GEQUAL:    r->type = JSV_BOOLEAN; r->integer = da>=db; break;
+        default: return false;
+    }
+  }
+  return true;
+}
+
 /** Same as jsvMathsOpPtr, but if a or b are a name, skip them
  * and go to what they point to. */
 JsVar *jsvMathsOpSkipNames(JsVar *a, JsVar *b, int op) {
-  JsVar *pa = jsvSkipName(a);
-  JsVar *pb = jsvSkipName(b);
-  JsVar *res = jsvMathsOp(pa,pb,op);
-  jsvUnLock(pa);
-  jsvUnLock(pb);
+  // Extra locks mean that neither a or b can be treated as temporary
+  return jsvMathsOpSkipNamesAndUnLock(jsvLockAgainSafe(a), jsvLockAgainSafe(b), op);
+}
+
+/** Same as jsvMathsOpSkipNames, but a and b are unlocked. Maths on numbers
+ * and booleans is done without creating JsVars for the values of names
+ * (which may store their values directly), and if a or b is a number that
+ * nothing else is using, the result is stored in it rather than in a new JsVar.
+ * If useInt is set, b is ignored and the integer bInt is used instead. */
+static JsVar *jsvMathsOpSkipNamesAndUnLockInternal(JsVar *a, JsVar *b, bool useInt, JsVarInt bInt, int op) {
+  JsVar immA, immB;
+  bool aIsTemp = jsvIsTemporaryNumber(a);
+  bool bIsTemp = !useInt && jsvIsTemporaryNumber(b);
+  JsVar *pa = jsvSkipNameToImmediate(a, &immA);
+  JsVar *pb;
+  if (useInt) {
+    immB.flags = JSV_INTEGER;
+    immB.varData.integer = bInt;
+    pb = &immB;
+  } else
+    pb = jsvSkipNameToImmediate(b, &immB);
+  JsVar *res = 0;
+
+  if (jsvIsNumberOrBool(pa) && jsvIsNumberOrBool(pb)) {
+    JsvImmediate r;
+    bool handled;
+    if (op == LEX_TYPEEQUAL || op == LEX_NTYPEEQUAL) {
+      bool eql = (!jsvIsBoolean(pa) && !jsvIsBoolean(pb)) ||
+                 ((pa->flags & JSV_VARTYPEMASK) == (pb->flags & JSV_VARTYPEMASK));
+      if (eql) {
+        jsvMathsOpNumeric(pa, pb, LEX_EQUAL, jsvIsIntegerish(pa) && jsvIsIntegerish(pb), &r);
+        eql = r.integer!=0;
+      }
+      r.type = JSV_BOOLEAN;
+      r.integer = (op == LEX_TYPEEQUAL) ? eql : !eql;
+      handled = true;
+    } else {
+      bool needsInt = op=='&' || op=='|' || op=='^' || op==LEX_LSHIFT || op==LEX_RSHIFT || op==LEX_RSHIFTUNSIGNED;
+      handled = jsvMathsOpNumeric(pa, pb, op, needsInt || (jsvIsIntegerish(pa) && jsvIsIntegerish(pb)), &r);
+    }
+    if (handled) {
+      if (aIsTemp) {
+        jsvSetImmediate(a, &r);
+        res = a; // keep our lock on a, as we return it
+        a = 0;
+      } else if (bIsTemp) {
+        jsvSetImmediate(b, &r);
+        res = b;
+        b = 0;
+      } else
+        res = jsvNewFromImmediate(&r);
+    }
+  }
+  if (!res) {
+    // jsvMathsOp may lock its arguments, so they must be real JsVars
+    if (pa==&immA) pa = jsvSkipName(a);
+    if (pb==&immB) pb = useInt ? jsvNewFromInteger(bInt) : jsvSkipName(b);
+    res = jsvMathsOp(pa,pb,op);
+  }
+  if (pa!=&immA) jsvUnLock(pa);
+  if (pb!=&immB) jsvUnLock(pb);
+  jsvUnLock(a);
+  jsvUnLock(b);
   return res;
 }
 
+JsVar *jsvMathsOpSkipNamesAndUnLock(JsVar *a, JsVar *b, int op) {
+  return jsvMathsOpSkipNamesAndUnLockInternal(a, b, false, 0, op);
+}
+
+/** Same as jsvMathsOpSkipNamesAndUnLock, but b is an integer (eg. a literal
+ * in the code, or the 1 for ++ and --), so no JsVar is allocated for it */
+JsVar *jsvMathsOpIntAndUnLock(JsVar *a, JsVarInt b, int op) {
+  return jsvMathsOpSkipNamesAndUnLockInternal(a, 0, true, b, op);
+}
+
+/** If 'name' stores its integer value directly (see jsvIsNameInt), add
+ * 'amount' to it in place and return true. Returns false (and does nothing)
+ * if it doesn't, or if the result won't fit. Used for ++ and -- */
+bool jsvNameIntAdd(JsVar *name, JsVarInt amount) {
+  if (!jsvIsNameInt(name)) return false;
+  long long v = (long long)jsvGetFirstChildSigned(name) + amount;
+  if (v<JSVARREF_MIN || v>JSVARREF_MAX) return false;
+  jsvSetFirstChild(name, (JsVarRef)(JsVarRefSigned)v);
+  return true;
+}
 
 JsVar *jsvMathsOpError(int op, const char *datatype) {
     char opName[32];
@@ -2294,54 +2806,11 @@ JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op) {
     } else if (needsNumeric ||
                ((jsvIsNumeric(a) || jsvIsUndefined(a) || jsvIsNull(a)) &&
                 (jsvIsNumeric(b) || jsvIsUndefined(b) || jsvIsNull(b)))) {
-      if (needsInt || (jsvIsIntegerish(a) && jsvIsIntegerish(b))) {
-            // note that int+undefined should be handled as a double
-            // use ints
-            JsVarInt da = jsvGetInteger(a);
-            JsVarInt db = jsvGetInteger(b);
-            switch (op) {
-                case '+': return jsvNewFromLongInteger((long long)da + (long long)db);
-                case '-': return jsvNewFromLongInteger((long long)da - (long long)db);
-                case '*': return jsvNewFromLongInteger((long long)da * (long long)db);
-                case '/': return jsvNewFromFloat((JsVarFloat)da/(JsVarFloat)db);
-                case '&': return jsvNewFromInteger(da&db);
-                case '|': return jsvNewFromInteger(da|db);
-                case '^': return jsvNewFromInteger(da^db);
-                case '%': return db ? jsvNewFromInteger(da%db) : jsvNewFromFloat(NAN);
-                case LEX_LSHIFT: return jsvNewFromInteger(da << db);
-                case LEX_RSHIFT: return jsvNewFromInteger(da >> db);
-                case LEX_RSHIFTUNSIGNED: return jsvNewFromInteger((JsVarInt)(((JsVarIntUnsigned)da) >> db));
-                case LEX_EQUAL:     return jsvNewFromBool(da==db && jsvIsNull(a)==jsvIsNull(b));
-                case LEX_NEQUAL:    return jsvNewFromBool(da!=db || jsvIsNull(a)!=jsvIsNull(b));
-                case '<':           return jsvNewFromBool(da<db);
-                case LEX_LEQUAL:    return jsvNewFromBool(da<=db);
-                case '>':           return jsvNewFromBool(da>db);
-                case LEX_GEQUAL:    return jsvNewFromBool(da>=db);
-                default: return jsvMathsOpError(op, "Integer");
-            }
-        } else {
-            // use doubles
-            JsVarFloat da = jsvGetFloat(a);
-            JsVarFloat db = jsvGetFloat(b);
-            switch (op) {
-                case '+': return jsvNewFromFloat(da+db);
-                case '-': return jsvNewFromFloat(da-db);
-                case '*': return jsvNewFromFloat(da*db);
-                case '/': return jsvNewFromFloat(da/db);
-                case '%': return jsvNewFromFloat(jswrap_math_mod(da, db));
-                case LEX_EQUAL:
-                case LEX_NEQUAL:  { bool equal = da==db;
-                                    if ((jsvIsNull(a) && jsvIsUndefined(b)) ||
-                                        (jsvIsNull(b) && jsvIsUndefined(a))) equal = true; // JS quirk :)
-                                    return jsvNewFromBool((op==LEX_EQUAL) ? equal : ((bool)!equal));
-                                  }
-                case '<':           return jsvNewFromBool(da<db);
-                case LEX_LEQUAL:    return jsvNewFromBool(da<=db);
-                case '>':           return jsvNewFromBool(da>db);
-                case LEX_GEQUAL:    return jsvNewFromBool(da>=db);
-                default: return jsvMathsOpError(op, "Double");
-            }
-        }
+      bool useInts = needsInt || (jsvIsIntegerish(a) && jsvIsIntegerish(b));
+      JsvImmediate r;
+      if (!jsvMathsOpNumeric(a, b, op, useInts, &r))
+        return jsvMathsOpError(op, useInts ? "Integer" : "Double");
+      return jsvNewFromImmediate(&r);
     } else if ((jsvIsArray(a) || jsvIsObject(a) || jsvIsFunction(a) ||
                 jsvIsArray(b) || jsvIsObject(b) || jsvIsFunction(b)) &&
                 jsvIsArray(a)==jsvIsArray(b) && // Fix #283 - convert to string and test if only one is an array
@@ -2395,11 +2864,7 @@ JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op) {
 }
 
 JsVar *jsvNegateAndUnLock(JsVar *v) {
-  JsVar *zero = jsvNewFromInteger(0);
-  JsVar *res = jsvMathsOpSkipNames(zero, v, '-');
-  jsvUnLock(zero);
-  jsvUnLock(v);
-  return res;
+  return jsvMathsOpSkipNamesAndUnLock(jsvNewFromInteger(0), v, '-');
 }
 
 /** If the given element is found, return the path to it as a string of
@@ -2414,6 +2879,7 @@ JsVar *jsvGetPathTo(JsVar *root, JsVar *element, int maxDepth, JsVar *ignorePare
     if (el == element && root != ignoreParent) {
       // if we found it - send the key name back!
       JsVar *name = jsvAsString(jsvIteratorGetKey(&it), true);
+      jsvUnLock(el);
       jsvIteratorFree(&it);
       return name;
     } else if (jsvIsObject(el) || jsvIsArray(el) || jsvIsFunction(el)) {
@@ -2425,10 +2891,12 @@ JsVar *jsvGetPathTo(JsVar *root, JsVar *element, int maxDepth, JsVar *ignorePare
         JsVar *name = jsvVarPrintf(jsvIsObject(el) ? "%v.%v" : "%v[%q]",keyName,n);
         jsvUnLock(keyName);
         jsvUnLock(n);
+        jsvUnLock(el);
         jsvIteratorFree(&it);
         return name;
       }
     }
+    jsvUnLock(el);
     jsvIteratorNext(&it);
   }
   jsvIteratorFree(&it);
@@ -2593,9 +3061,20 @@ static void jsvGarbageCollectMarkUsed(JsVar *var) {
   }
 }
 
+/// Mark a variable as used during a garbage collection (see jsiGarbageCollectMarkUsed)
+void jsvGarbageCollectMarkUsedRef(JsVarRef ref) {
+  JsVar *var = jsvGetAddressOf(ref);
+  if (var->flags & JSV_GARBAGE_COLLECT)
+    jsvGarbageCollectMarkUsed(var);
+}
+
 /** Run a garbage collection sweep - return true if things have been freed */
 bool jsvGarbageCollect() {
   JsVarRef i;
+#ifndef SAVE_ON_FLASH
+  jsVarStats.garbageCollects++;
+  jsVarsFreedInStatement = 0; // what we free goes on top of the free list
+#endif
   // clear garbage collect flags
   for (i=1;i<=jsVarsSize;i++)  {
     JsVar *var = jsvGetAddressOf(i);
@@ -2609,6 +3088,8 @@ bool jsvGarbageCollect() {
         jsvGetLocks(var)>0) // or it is locked
       jsvGarbageCollectMarkUsed(var);
   }
+  // mark anything that is only referenced from C code
+  jsiGarbageCollectMarkUsed();
   // now sweep for things that we can GC!
   bool freedSomething = false;
   for (i=1;i<=jsVarsSize;i++)  {
@@ -2619,12 +3100,252 @@ bool jsvGarbageCollect() {
       var->flags = JSV_UNUSED;
       // add this to our free list
       jsvSetNextSibling(var, jsVarFirstEmpty);
-      jsVarFirstEmpty = jsvGetRef(var);
+      jsVarFirstEmpty = i;
+#ifndef SAVE_ON_FLASH
+      jsVarStats.memoryUsage--;
+#endif
+#ifdef JSVAR_ALLOC_PROFILER
+      if (jsvProfilerVarSite) jsvProfilerFreed(i);
+#endif
     }
   }
   return freedSomething;
 }
 
+/* Defragmentation slides used JsVars down into the free JsVars below them,
+ * keeping them in the same order. There's nowhere to store a forwarding
+ * address for every JsVar, so we work in batches: work out a batch of moves
+ * (sorted by 'from'), rewrite every reference to the JsVars being moved (looking
+ * them up with a binary search), and then actually move them. */
+#if defined(RESIZABLE_JSVARS)
+#define JSV_DEFRAG_BATCH 1024 ///< Max number of JsVars moved for each pass over all JsVars
+#elif defined(SAVE_ON_FLASH)
+#define JSV_DEFRAG_BATCH 32
+#else
+#define JSV_DEFRAG_BATCH 64
+#endif
+#define JSV_DEFRAG_MIN_HOLES 32 ///< jsvIsFragmented needs at least this many free JsVars below used ones
+
+typedef struct {
+  JsVarRef from;
+  JsVarRef to;
+} JsvDefragMove;
+
+static THREAD_LOCAL JsvDefragMove *jsvDefragMoves; ///< The batch of moves being made (sorted by 'from')
+static THREAD_LOCAL unsigned int jsvDefragMoveCount = 0; ///< The number of moves in jsvDefragMoves (0 if not defragmenting)
+
+JsVarRef jsvDefragmentRemapRef(JsVarRef ref) {
+  if (!ref || !jsvDefragMoveCount ||
+      ref<jsvDefragMoves[0].from || ref>jsvDefragMoves[jsvDefragMoveCount-1].from)
+    return ref;
+  unsigned int lo = 0, hi = jsvDefragMoveCount;
+  while (lo < hi) {
+    unsigned int mid = (lo+hi)>>1;
+    if (jsvDefragMoves[mid].from < ref) lo = mid+1;
+    else hi = mid;
+  }
+  if (lo<jsvDefragMoveCount && jsvDefragMoves[lo].from==ref)
+    return jsvDefragMoves[lo].to;
+  return ref;
+}
+
+/// Rewrite all the references in a JsVar. This uses the same idea of which fields are references as jsvGarbageCollectMarkUsed
+static void jsvDefragmentRemapVar(JsVar *var) {
+  if (jsvHasStringExt(var))
+    jsvSetLastChild(var, jsvDefragmentRemapRef(jsvGetLastChild(var)));
+  size_t charsBefore;
+  JsVarRef tail = jsvGetStringTail(var, &charsBefore);
+  if (tail)
+    jsvSetStringTail(var, jsvDefragmentRemapRef(tail), charsBefore);
+  if (jsvHasSingleChild(var)) {
+    jsvSetFirstChild(var, jsvDefragmentRemapRef(jsvGetFirstChild(var)));
+  } else if (jsvHasChildren(var)) {
+    jsvSetFirstChild(var, jsvDefragmentRemapRef(jsvGetFirstChild(var)));
+    jsvSetLastChild(var, jsvDefragmentRemapRef(jsvGetLastChild(var)));
+  }
+  if (jsvIsName(var)) {
+    jsvSetNextSibling(var, jsvDefragmentRemapRef(jsvGetNextSibling(var)));
+    jsvSetPrevSibling(var, jsvDefragmentRemapRef(jsvGetPrevSibling(var)));
+  }
+}
+
+bool jsvIsFragmented() {
+  unsigned int i, used = 0, unused = 0, holes = 0;
+  for (i=1;i<=jsVarsSize;i++) {
+    if ((jsvGetAddressOf((JsVarRef)i)->flags&JSV_VARTYPEMASK) == JSV_UNUSED) {
+      unused++;
+    } else {
+      used++;
+      holes = unused; // free JsVars below this one
+    }
+  }
+  return holes >= JSV_DEFRAG_MIN_HOLES && holes*4 > used;
+}
+
+unsigned int jsvDefragment() {
+  JsvDefragMove moves[JSV_DEFRAG_BATCH];
+  unsigned int moved = 0;
+  JsVarRef to = 1; // where the next JsVar will be moved to
+  JsVarRef from = 1; // the next JsVar that could be moved
+  jsvDefragMoves = moves;
+  while (true) {
+    // Work out a batch of moves
+    unsigned int count = 0;
+    unsigned int f = 0; // JsVars that are moved from in this batch will be free
+    while (count < JSV_DEFRAG_BATCH) {
+      while (to<=jsVarsSize) {
+        while (f<count && moves[f].from<to) f++;
+        if ((f<count && moves[f].from==to) ||
+            (jsvGetAddressOf(to)->flags&JSV_VARTYPEMASK) == JSV_UNUSED)
+          break;
+        to++;
+      }
+      if (from <= to) from = (JsVarRef)(to+1);
+      while (from<=jsVarsSize) {
+        JsVar *v = jsvGetAddressOf(from);
+        if ((v->flags&JSV_VARTYPEMASK) != JSV_UNUSED && jsvGetLocks(v)==0)
+          break; // locked JsVars can't move as C code has pointers to them
+        from++;
+      }
+      if (from>jsVarsSize) break;
+      moves[count].from = from++;
+      moves[count].to = to++;
+      count++;
+    }
+    if (!count) break;
+    jsvDefragMoveCount = count;
+    // Update all references to the JsVars we're moving - in JsVars, and those stored in C code
+    JsVarRef i;
+    for (i=1;i<=jsVarsSize;i++) {
+      JsVar *v = jsvGetAddressOf(i);
+      if ((v->flags&JSV_VARTYPEMASK) != JSV_UNUSED)
+        jsvDefragmentRemapVar(v);
+    }
+    jsiDefragmentRemapRefs();
+#ifdef JSVAR_ALLOC_PROFILER
+    if (jsvProfilerVarSite) {
+      int s;
+      for (s=0;s<jsvProfilerSiteCount;s++)
+        jsvProfilerSites[s].source = jsvDefragmentRemapRef(jsvProfilerSites[s].source);
+      memset(jsvProfilerCache, 0, JSV_PROFILER_CACHE*sizeof(JsvProfilerCacheEntry));
+    }
+#endif
+    // Now actually move them
+    unsigned int m;
+    for (m=0;m<count;m++) {
+      JsVar *src = jsvGetAddressOf(moves[m].from);
+      *jsvGetAddressOf(moves[m].to) = *src;
+      src->flags = JSV_UNUSED;
+#ifdef JSVAR_ALLOC_PROFILER
+      if (jsvProfilerVarSite) {
+        jsvProfilerVarSite[moves[m].to-1] = jsvProfilerVarSite[moves[m].from-1];
+        jsvProfilerVarSite[moves[m].from-1] = 0;
+      }
+#endif
+    }
+    jsvDefragMoveCount = 0;
+    moved += count;
+  }
+  jsvDefragMoves = 0;
+  // New JsVars should now be allocated from the bottom up, so they stay together
+  jsvCreateEmptyVarList();
+#ifdef RESIZABLE_JSVARS
+  // free any unused blocks at the end, but leave one spare so we don't have to allocate again straight away
+  unsigned int wanted = jsvGetMemoryUsage() + JSVAR_BLOCK_SIZE;
+  if (wanted < jsVarsSize) jsvSetMemoryTotal(wanted);
+#endif
+  return moved;
+}
+
+#ifndef SAVE_ON_FLASH
+#define JSV_DUMP_HEAP_LARGEST 8 ///< How many of the largest objects to show in jsvDumpHeap
+
+/// Output a heap snapshot - a histogram of variable types, the largest objects and the paths to them, and allocation sites
+void jsvDumpHeap(vcbprintf_callback user_callback, void *user_data) {
+  const char *typeNames[] = { "Name", "String", "StringExt", "Array", "Object", "Function", "ArrayBuffer", "Int", "Float", "Boolean", "Pin", "Null", "Other" };
+  unsigned int typeCounts[sizeof(typeNames)/sizeof(const char*)];
+  JsVarRef largest[JSV_DUMP_HEAP_LARGEST];
+  size_t largestSize[JSV_DUMP_HEAP_LARGEST];
+  unsigned int i, j, used = 0;
+  memset(typeCounts, 0, sizeof(typeCounts));
+  memset(largest, 0, sizeof(largest));
+  memset(largestSize, 0, sizeof(largestSize));
+
+  for (i=1;i<=jsVarsSize;i++) {
+    JsVar *v = jsvGetAddressOf((JsVarRef)i);
+    if ((v->flags&JSV_VARTYPEMASK) == JSV_UNUSED) continue;
+    used++;
+    int t;
+    if (jsvIsName(v)) t=0;
+    else if (jsvIsString(v)) t=1;
+    else if (jsvIsStringExt(v)) t=2;
+    else if (jsvIsArray(v)) t=3;
+    else if (jsvIsObject(v)) t=4;
+    else if (jsvIsFunction(v)) t=5;
+    else if (jsvIsArrayBuffer(v)) t=6;
+    else if (jsvIsPin(v)) t=10;
+    else if (jsvIsInt(v)) t=7;
+    else if (jsvIsFloat(v)) t=8;
+    else if (jsvIsBoolean(v)) t=9;
+    else if (jsvIsNull(v)) t=11;
+    else t=12;
+    typeCounts[t]++;
+    // Is this one of the largest objects? (that are referenced from somewhere)
+    if ((jsvIsArray(v) || jsvIsObject(v) || jsvIsFunction(v)) && !jsvIsRoot(v) &&
+        v!=execInfo.hiddenRoot && jsvGetRefs(v)>0) {
+      size_t size = jsvCountJsVarsUsed(v);
+      for (j=0;j<JSV_DUMP_HEAP_LARGEST;j++) {
+        if (size > largestSize[j]) {
+          memmove(&largest[j+1], &largest[j], sizeof(JsVarRef)*(JSV_DUMP_HEAP_LARGEST-1-j));
+          memmove(&largestSize[j+1], &largestSize[j], sizeof(size_t)*(JSV_DUMP_HEAP_LARGEST-1-j));
+          largest[j] = (JsVarRef)i;
+          largestSize[j] = size;
+          break;
+        }
+      }
+    }
+  }
+
+  cbprintf(user_callback, user_data, "Heap: %d of %d vars used (%d bytes each)\nTypes:\n", used, jsVarsSize, (int)sizeof(JsVar));
+  for (i=0;i<sizeof(typeNames)/sizeof(const char*);i++)
+    if (typeCounts[i])
+      cbprintf(user_callback, user_data, "  %s: %d\n", typeNames[i], typeCounts[i]);
+  cbprintf(user_callback, user_data, "Largest:\n");
+  for (j=0;j<JSV_DUMP_HEAP_LARGEST && largest[j];j++) {
+    JsVar *v = jsvLock(largest[j]);
+    JsVar *path = jsvGetPathTo(execInfo.root, v, 4, 0);
+    if (path)
+      cbprintf(user_callback, user_data, "  #%d %d vars: %v\n", largest[j], (int)largestSize[j], path);
+    else
+      cbprintf(user_callback, user_data, "  #%d %d vars: (not reachable from root)\n", largest[j], (int)largestSize[j]);
+    jsvUnLock(path);
+    jsvUnLock(v);
+  }
+#ifdef JSVAR_ALLOC_PROFILER
+  if (jsvProfilerIsRunning()) {
+    cbprintf(user_callback, user_data, "Allocation sites (live vars, bytes, allocations):\n");
+    JsVar *sites = jsvProfilerGetSites();
+    JsvObjectIterator it;
+    jsvObjectIteratorNew(&it, sites);
+    while (jsvObjectIteratorHasValue(&it)) {
+      JsVar *site = jsvObjectIteratorGetValue(&it);
+      JsVar *name = jsvObjectGetChild(site, "site", 0);
+      cbprintf(user_callback, user_data, "  %d, %d, %d: %v\n",
+          jsvGetIntegerAndUnLock(jsvObjectGetChild(site, "live", 0)),
+          jsvGetIntegerAndUnLock(jsvObjectGetChild(site, "bytes", 0)),
+          jsvGetIntegerAndUnLock(jsvObjectGetChild(site, "allocs", 0)),
+          name);
+      jsvUnLock(name);
+      jsvUnLock(site);
+      jsvObjectIteratorNext(&it);
+    }
+    jsvObjectIteratorFree(&it);
+    jsvUnLock(sites);
+  }
+#endif
+}
+#endif
+
 /** Remove whitespace to the right of a string - on MULTIPLE LINES */
 JsVar *jsvStringTrimRight(JsVar *srcString) {
   JsvStringIterator src, dst;
@@ -198,6 +198,40 @@ void jsvShowAllocated(); ///< Show what is still allocated, for debugging memory
 /// Try and allocate more memory - only works if RESIZABLE_JSVARS is defined
 void jsvSetMemoryTotal(unsigned int jsNewVarCount);
 
+#ifndef SAVE_ON_FLASH
+/// Counters for how variables have been used since jsvResetStats was called
+typedef struct {
+  unsigned int allocations; ///< Number of JsVars allocated
+  unsigned int scratchAllocations; ///< Number of those that reused a JsVar freed earlier in the same statement
+  unsigned int garbageCollects; ///< Number of times jsvGarbageCollect was run
+  unsigned int memoryUsage; ///< Number of JsVars currently used
+  unsigned int peakMemoryUsage; ///< Highest value that memoryUsage has had
+} JsVarStats;
+extern THREAD_LOCAL JsVarStats jsVarStats;
+void jsvResetStats(); ///< Reset jsVarStats (memoryUsage is set to jsvGetMemoryUsage())
+/** The free list is LIFO, so the JsVars freed during a statement sit at its
+ * head and are what the statement allocates next. This is how many of them
+ * are still there (it's what jsVarStats.scratchAllocations counts) */
+extern THREAD_LOCAL unsigned int jsVarsFreedInStatement;
+/// Called at the start of every statement
+static inline void jsvStartStatement() { jsVarsFreedInStatement = 0; }
+#endif
+
+#if defined(RESIZABLE_JSVARS) && !defined(SAVE_ON_FLASH)
+#define JSVAR_ALLOC_PROFILER ///< We can record where in the code each JsVar was allocated (uses malloc)
+#endif
+#ifdef JSVAR_ALLOC_PROFILER
+void jsvProfilerStart(); ///< Start recording allocation sites (clearing any previous results)
+void jsvProfilerStop(); ///< Stop recording allocation sites and free the memory used
+bool jsvProfilerIsRunning(); ///< Are we recording allocation sites?
+/// Return an array of {site,live,bytes,allocs} for each allocation site, sorted by the amount of live variables
+JsVar *jsvProfilerGetSites();
+#endif
+#ifndef SAVE_ON_FLASH
+/// Output a heap snapshot - a histogram of variable types, the largest objects and the paths to them, and allocation sites
+void jsvDumpHeap(vcbprintf_callback user_callback, void *user_data);
+#endif
+
 
 // Note that jsvNew* don't REF a variable for you, but the do LOCK it
 JsVar *jsvNewWithFlags(JsVarFlags flags); ///< Create a new variable with the given flags
@@ -234,6 +268,9 @@ JsVar *jsvLock(JsVarRef ref);
 /// Lock this pointer and return a pointer - UNSAFE for null pointer
 JsVar *jsvLockAgain(JsVar *var);
 
+/// Lock this pointer and return a pointer - SAFE for null pointer
+JsVar *jsvLockAgainSafe(JsVar *var);
+
 /// Unlock this variable - this is SAFE for null variables
 void jsvUnLock(JsVar *var);
 
@@ -381,6 +418,10 @@ void jsvSetString(JsVar *v, char *str, size_t len); ///< Set the Data in this st
 JsVar *jsvAsString(JsVar *var, bool unlockVar); ///< If var is a string, lock and return it, else create a new string
 bool jsvIsEmptyString(JsVar *v); ///< Returns true if the string is empty - faster than jsvGetStringLength(v)==0
 size_t jsvGetStringLength(JsVar *v); ///< Get the length of this string, IF it is a string
+/// Get the ref of the last block of a long string (or 0 if not known), and set charsBefore to the number of characters before it
+JsVarRef jsvGetStringTail(const JsVar *str, size_t *charsBefore);
+/// Remember the last block of a string (see jsvGetStringTail) - does nothing if str isn't the start of a String
+void jsvSetStringTail(JsVar *str, JsVarRef tail, size_t charsBefore);
 size_t jsvGetLinesInString(JsVar *v); ///<  IN A STRING get the number of lines in the string (min=1)
 size_t jsvGetCharsOnLine(JsVar *v, size_t line); ///<  IN A STRING Get the number of characters on a line - lines start at 1
 void jsvGetLineAndCol(JsVar *v, size_t charIdx, size_t* line, size_t *col); ///< IN A STRING, get the line and column of the given character. Both values must be non-null
@@ -486,6 +527,9 @@ JsVar *jsvAsName(JsVar *var);
 
 /// MATHS!
 JsVar *jsvMathsOpSkipNames(JsVar *a, JsVar *b, int op);
+JsVar *jsvMathsOpSkipNamesAndUnLock(JsVar *a, JsVar *b, int op); ///< Same as jsvMathsOpSkipNames, but unlocks a and b (and may reuse them for the result if they're temporary numbers)
+JsVar *jsvMathsOpIntAndUnLock(JsVar *a, JsVarInt b, int op); ///< Same as jsvMathsOpSkipNamesAndUnLock, but b is an integer that needs no JsVar
+bool jsvNameIntAdd(JsVar *name, JsVarInt amount); ///< If name stores its integer value directly, add amount to it and return true
 JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op);
 /// Negates an integer/double value
 JsVar *jsvNegateAndUnLock(JsVar *v);
@@ -550,6 +594,22 @@ void jsvTrace(JsVar *var, int indent);
 /** Run a garbage collection sweep - return true if things have been freed */
 bool jsvGarbageCollect();
 
+/// Mark a variable as used during a garbage collection (see jsiGarbageCollectMarkUsed)
+void jsvGarbageCollectMarkUsedRef(JsVarRef ref);
+
+/// Returns true if enough free JsVars are in holes between used ones that jsvDefragment is worth running
+bool jsvIsFragmented();
+
+/** Slide all unlocked JsVars down into the free JsVars below them (keeping them
+ * in the same order) and update every reference to them. Locked JsVars stay where
+ * they are. On RESIZABLE_JSVARS builds, unused blocks at the end are then freed.
+ * Returns the number of JsVars that were moved. Must only be called when no C
+ * code is holding on to a JsVarRef (or unlocked JsVar*) - eg. from the idle loop */
+unsigned int jsvDefragment();
+
+/// Whilst jsvDefragment is running, return the new value for a JsVarRef stored outside of a JsVar (see jsiDefragmentRemapRefs)
+JsVarRef jsvDefragmentRemapRef(JsVarRef ref);
+
 /** Remove whitespace to the right of a string - on MULTIPLE LINES */
 JsVar *jsvStringTrimRight(JsVar *srcString);
 
@@ -109,6 +109,17 @@ void jsvStringIteratorNext(JsvStringIterator *it) {
 
 void jsvStringIteratorGotoEnd(JsvStringIterator *it) {
   assert(it->var);
+  if (it->varIndex==0) {
+    // skip straight to the last block we know about
+    size_t charsBefore;
+    JsVarRef tail = jsvGetStringTail(it->var, &charsBefore);
+    if (tail) {
+      jsvUnLock(it->var);
+      it->var = jsvLock(tail);
+      it->varIndex = charsBefore;
+      it->charsInVar = jsvGetCharactersInVar(it->var);
+    }
+  }
   while (jsvGetLastChild(it->var)) {
      JsVar *next = jsvLock(jsvGetLastChild(it->var));
      jsvUnLock(it->var);
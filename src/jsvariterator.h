@@ -111,6 +111,12 @@ static inline void jsvStringIteratorFree(JsvStringIterator *it) {
   jsvUnLock(it->var);
 }
 
+/// Free a string iterator that has been appending to str, remembering where the end of str is for next time
+static inline void jsvStringIteratorFreeAppend(JsvStringIterator *it, JsVar *str) {
+  if (it->var) jsvSetStringTail(str, jsvGetRef(it->var), it->varIndex);
+  jsvUnLock(it->var);
+}
+
 /// Special version of append designed for use with vcbprintf_callback (See jsvAppendPrintf)
 void jsvStringIteratorPrintfCallback(const char *str, void *user_data);
 
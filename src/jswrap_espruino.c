@@ -18,6 +18,9 @@
 #include "jswrapper.h"
 #include "jsinteractive.h"
 #include "jstimer.h"
+#ifdef USE_FILESYSTEM
+#include "jswrap_fs.h"
+#endif
 
 /*JSON{
   "type" : "class",
@@ -566,6 +569,8 @@ Get and reset the error flags. Returns an array that can contain:
 `'LOW_MEMORY'`: Memory is running low - Espruino had to run a garbage collection pass or remove some of the command history
 
 `'MEMORY'`: Espruino ran out of memory and was unable to allocate some data that it needed.
+
+`'EVENT_QUEUE_FULL'`: Too many events (eg. from `emit`, or data arriving) were waiting to be executed, and some were lost.
 */
 JsVar *jswrap_espruino_getErrorFlags() {
   JsVar *arr = jsvNewWithFlags(JSV_ARRAY);
@@ -575,6 +580,7 @@ JsVar *jswrap_espruino_getErrorFlags() {
   if (jsErrorFlags&JSERR_CALLBACK) jsvArrayPushAndUnLock(arr, jsvNewFromString("CALLBACK"));
   if (jsErrorFlags&JSERR_LOW_MEMORY) jsvArrayPushAndUnLock(arr, jsvNewFromString("LOW_MEMORY"));
   if (jsErrorFlags&JSERR_MEMORY) jsvArrayPushAndUnLock(arr, jsvNewFromString("MEMORY"));
+  if (jsErrorFlags&JSERR_EVENT_QUEUE_FULL) jsvArrayPushAndUnLock(arr, jsvNewFromString("EVENT_QUEUE_FULL"));
   jsErrorFlags = JSERR_NONE;
   return arr;
 }
@@ -630,6 +636,8 @@ int jswrap_espruino_reverseByte(int v) {
   "generate" : "jswrap_espruino_dumpTimers"
 }
 Output the current list of Utility Timer Tasks - for debugging only
+
+For each task that has run, this also shows how many times it ran, how late (in microseconds) it was executed, and the jitter (the difference between the latest and least late executions). The last line shows how full the queue is, how many tasks have been refused because it was full, and how many repeats were skipped because a task was executed too late.
 */
 void jswrap_espruino_dumpTimers() {
   jstDumpUtilityTimers();
@@ -654,3 +662,102 @@ int jswrap_espruino_getSizeOf(JsVar *v) {
   return (int)jsvCountJsVarsUsed(v);
 }
 
+/*JSON{
+  "type" : "staticmethod",
+  "ifdef" : "LINUX",
+  "class" : "E",
+  "name" : "setAllocationProfiler",
+  "generate" : "jswrap_espruino_setAllocationProfiler",
+  "params" : [
+    ["enabled","bool","Whether to record where variables are allocated"]
+  ]
+}
+Start (or stop) recording which line of code each variable block is allocated from. Starting clears any previous results. See `E.getAllocationSites()` and `E.dumpHeap()`.
+
+Allocations are grouped by line, in either the main code or the code of a function. This slows execution down, and loops aren't optimised while it is running.
+*/
+void jswrap_espruino_setAllocationProfiler(bool enabled) {
+#ifdef JSVAR_ALLOC_PROFILER
+  if (enabled) {
+    jsvProfilerStart();
+    if (!jsvProfilerIsRunning()) jsExceptionHere(JSET_ERROR, "Not enough memory to start the allocation profiler");
+  } else
+    jsvProfilerStop();
+#else
+  NOT_USED(enabled);
+#endif
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifdef" : "LINUX",
+  "class" : "E",
+  "name" : "getAllocationSites",
+  "generate" : "jswrap_espruino_getAllocationSites",
+  "return" : ["JsVar","An array of allocation sites, or undefined if the profiler isn't running"]
+}
+Return the results of the allocation profiler started with `E.setAllocationProfiler(true)`, as an array of `{site:"fn line 3", live, bytes, allocs}`, sorted with the site that has most variable blocks still allocated first.
+
+`live` and `bytes` are the variable blocks (and the memory they use) allocated from that line that haven't yet been freed, and `allocs` is the total number of blocks allocated there.
+
+If the code a site was in has since been freed (eg. a function that was deleted), `site` is `"freed code line N"`.
+*/
+JsVar *jswrap_espruino_getAllocationSites() {
+#ifdef JSVAR_ALLOC_PROFILER
+  if (jsvProfilerIsRunning())
+    return jsvProfilerGetSites();
+#endif
+  return 0;
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "class" : "E",
+  "name" : "dumpHeap",
+  "generate" : "jswrap_espruino_dumpHeap",
+  "params" : [
+    ["filename","JsVar","(optional) If specified, write the snapshot to this file rather than the console"]
+  ]
+}
+Output a snapshot of memory usage - the number of variable blocks of each type, the largest objects (with a path to each of them from the global scope) and, if `E.setAllocationProfiler(true)` has been called, the lines of code that variables were allocated from.
+
+This is useful for finding out what has used up all the available memory.
+*/
+static void jswrap_espruino_dumpHeapToConsole(const char *str, void *user_data) {
+  NOT_USED(user_data);
+  jsiConsolePrint(str);
+}
+
+void jswrap_espruino_dumpHeap(JsVar *filename) {
+#ifdef USE_FILESYSTEM
+  if (!jsvIsUndefined(filename)) {
+    JsVar *str = jsvNewFromEmptyString();
+    if (!str) return;
+    JsvStringIterator it;
+    jsvStringIteratorNew(&it, str, 0);
+    jsvDumpHeap((vcbprintf_callback)jsvStringIteratorPrintfCallback, &it);
+    jsvStringIteratorFree(&it);
+    jswrap_fs_writeOrAppendFile(filename, str, false, 0);
+    jsvUnLock(str);
+    return;
+  }
+#else
+  NOT_USED(filename);
+#endif
+  jsvDumpHeap(jswrap_espruino_dumpHeapToConsole, 0);
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "E",
+  "name" : "defrag",
+  "generate" : "jswrap_espruino_defrag"
+}
+Once the current code has finished executing, run a Garbage Collection pass and then move all variable blocks down into the free blocks below them, so that related blocks end up next to each other. On Linux, any unused memory at the end is then freed.
+
+This is also done automatically when Espruino is idle and memory has become fragmented, and before `save()`. It can't be done while a `Waveform` is running.
+*/
+void jswrap_espruino_defrag() {
+  jsiSetTodo(TODO_DEFRAG);
+}
@@ -31,3 +31,8 @@ JsVar *jswrap_espruino_toArrayBuffer(JsVar *str);
 int jswrap_espruino_reverseByte(int v);
 void jswrap_espruino_dumpTimers();
 int jswrap_espruino_getSizeOf(JsVar *v);
+
+void jswrap_espruino_setAllocationProfiler(bool enabled);
+JsVar *jswrap_espruino_getAllocationSites();
+void jswrap_espruino_dumpHeap(JsVar *filename);
+void jswrap_espruino_defrag();
@@ -27,11 +27,9 @@
 }
 A variable containing the arguments given to the function
 */
-extern JsExecInfo execInfo;
+extern THREAD_LOCAL JsExecInfo execInfo;
 JsVar *jswrap_arguments() {
-  JsVar *scope = 0;
-  if (execInfo.scopeCount>0)
-    scope = execInfo.scopes[execInfo.scopeCount-1];
+  JsVar *scope = execInfo.scope;
   if (!jsvIsFunction(scope)) {
     jsExceptionHere(JSET_ERROR, "Can only use 'arguments' variable inside a function");
     return 0;
@@ -139,6 +139,8 @@ Save program memory into flash. It will then be loaded automatically every time
 
 This command only executes when the Interpreter returns to the Idle state - for instance ```a=1;save();a=2;``` will save 'a' as 2.
 
+Only variables that are in use are saved, and they are compressed. If you've saved before, only the pages of flash that have changed are rewritten.
+
 When Espruino powers on, it will resume from where it was when you typed `save()`. If you want code to be executed right after loading (for instance to initialise devices connected to Espruino), create a function called `onInit` (which will be automatically executed by Espruino).
 
 In order to stop the program saved with this command being loaded automatically, hold down Button 1 while also pressing reset. On some boards, Button 1 enters bootloader mode, so you will need to press Reset with Button 1 raised, and then hold Button 1 down a fraction of a second later.
@@ -289,7 +289,7 @@ JsVar *jswrap_io_getPinMode(Pin pin) {
   "params" : [
     ["function","JsVar","A Function or String to be executed"],
     ["pin","pin","The pin to watch"],
-    ["options","JsVar",["If this is a boolean or integer, it determines whether to call this once (false = default) or every time a change occurs (true)","If this is an object, it can contain the following information: ```{ repeat: true/false(default), edge:'rising'/'falling'/'both'(default), debounce:10}```. `debounce` is the time in ms to wait for bounces to subside, or 0."]]
+    ["options","JsVar",["If this is a boolean or integer, it determines whether to call this once (false = default) or every time a change occurs (true)","If this is an object, it can contain the following information: ```{ repeat: true/false(default), edge:'rising'/'falling'/'both'(default), debounce:10, capture:new Uint32Array(n) }```. `debounce` is the time in ms to wait for bounces to subside, or 0. `capture` is a typed array to record edge times into (see below)."]]
   ],
   "return" : ["JsVar","An ID that can be passed to clearWatch"]
 }
@@ -301,6 +301,8 @@ The function may also take an argument, which is an object of type `{time:float,
 
 For instance, if you want to measure the length of a positive pusle you could use: ```setWatch(function(e) { console.log(e.time-e.lastTime); }, BTN, { repeat:true, edge:'falling' });```
 
+If `capture` is set to a typed array, the function isn't called for every edge. Instead, the time of each edge (in microseconds since the first edge) is written into the array, and the function is only called once the array is full - with an argument of type `{time:float, state:bool, data:array}`, where `time` and `state` are for the first edge. This is much faster, so is useful for decoding signals such as those from IR remotes or 433MHz radio: ```setWatch(function(e) { console.log(e.data); }, A0, { repeat:true, capture:new Uint32Array(64) });```. `debounce` is ignored when capturing.
+
 This can also be removed using clearWatch
 */
 JsVar *jswrap_interface_setWatch(JsVar *func, Pin pin, JsVar *repeatOrObject) {
@@ -313,11 +315,19 @@ JsVar *jswrap_interface_setWatch(JsVar *func, Pin pin, JsVar *repeatOrObject) {
   bool repeat = false;
   JsVarFloat debounce = 0;
   int edge = 0;
+  JsVar *capture = 0;
   if (jsvIsObject(repeatOrObject)) {
     JsVar *v;
     repeat = jsvGetBoolAndUnLock(jsvObjectGetChild(repeatOrObject, "repeat", 0));
     debounce = jsvGetFloatAndUnLock(jsvObjectGetChild(repeatOrObject, "debounce", 0));
     if (isnan(debounce) || debounce<0) debounce=0;
+    capture = jsvObjectGetChild(repeatOrObject, "capture", 0);
+    if (capture && !(jsvIsArrayBuffer(capture) && jsvGetArrayBufferLength(capture)>0)) {
+      jsExceptionHere(JSET_ERROR, "'capture' in setWatch should be a non-empty typed array, got %t", capture);
+      jsvUnLock(capture);
+      return 0;
+    }
+    if (capture) debounce = 0;
     v = jsvObjectGetChild(repeatOrObject, "edge", 0);
     if (jsvIsString(v)) {
       if (jsvIsStringEqual(v, "rising")) edge=1;
@@ -341,18 +351,21 @@ JsVar *jswrap_interface_setWatch(JsVar *func, Pin pin, JsVar *repeatOrObject) {
       if (repeat) jsvUnLock(jsvObjectSetChild(watchPtr, "recur", jsvNewFromBool(repeat)));
       if (debounce>0) jsvUnLock(jsvObjectSetChild(watchPtr, "debounce", jsvNewFromInteger((JsVarInt)jshGetTimeFromMilliseconds(debounce))));
       if (edge) jsvUnLock(jsvObjectSetChild(watchPtr, "edge", jsvNewFromInteger(edge)));
+      if (capture) jsvObjectSetChild(watchPtr, "capture", capture); // no unlock intentionally
       jsvObjectSetChild(watchPtr, "callback", func); // no unlock intentionally
-    }
 
-    // If nothing already watching the pin, set up a watch
-    if (!jsiIsWatchingPin(pin))
-      jshPinWatch(pin, true);
+      // If nothing already watching the pin, set up a watch
+      if (!jsiIsWatchingPin(pin))
+        jshPinWatch(pin, true);
 
-    JsVar *watchArrayPtr = jsvLock(watchArray);
-    itemIndex = jsvArrayAddToEnd(watchArrayPtr, watchPtr, 1) - 1;
-    jsvUnLock(watchArrayPtr);
-    jsvUnLock(watchPtr);
+      JsVar *watchArrayPtr = jsvLock(watchArray);
+      itemIndex = jsvArrayAddToEnd(watchArrayPtr, watchPtr, 1) - 1;
+      jsvUnLock(watchArrayPtr);
+      jsiAddWatch(watchPtr);
+      jsvUnLock(watchPtr);
+    }
   }
+  jsvUnLock(capture);
   return (itemIndex>=0) ? jsvNewFromInteger(itemIndex) : 0/*undefined*/;
 }
 
@@ -369,38 +382,15 @@ Clear the Watch that was created with setWatch. If no parameter is supplied, all
 void jswrap_interface_clearWatch(JsVar *idVar) {
 
   if (jsvIsUndefined(idVar)) {
-    JsVar *watchArrayPtr = jsvLock(watchArray);
-    JsvObjectIterator it;
-    jsvObjectIteratorNew(&it, watchArrayPtr);
-    while (jsvObjectIteratorHasValue(&it)) {
-      JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
-      JsVar *watchPin = jsvObjectGetChild(watchPtr, "pin", 0);
-      jshPinWatch(jshGetPinFromVar(watchPin), false);
-      jsvUnLock(watchPin);
-      jsvUnLock(watchPtr);
-      jsvObjectIteratorNext(&it);
-    }
-    jsvObjectIteratorFree(&it);
-    // remove all items
-    jsvRemoveAllChildren(watchArrayPtr);
-    jsvUnLock(watchArrayPtr);
+    jsiRemoveAllWatches();
   } else {
     JsVar *watchArrayPtr = jsvLock(watchArray);
     JsVar *watchNamePtr = jsvFindChildFromVar(watchArrayPtr, idVar, false);
     jsvUnLock(watchArrayPtr);
     if (watchNamePtr) { // child is a 'name'
-      JsVar *watchPtr = jsvSkipName(watchNamePtr);
-      Pin pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
+      JsVar *watchPtr = jsvSkipNameAndUnLock(watchNamePtr);
+      jsiRemoveWatch(watchPtr);
       jsvUnLock(watchPtr);
-
-      JsVar *watchArrayPtr = jsvLock(watchArray);
-      jsvRemoveChild(watchArrayPtr, watchNamePtr);
-      jsvUnLock(watchNamePtr);
-      jsvUnLock(watchArrayPtr);
-
-      // Now check if this pin is still being watched
-      if (!jsiIsWatchingPin(pin))
-        jshPinWatch(pin, false); // 'unwatch' pin
     } else {
       jsExceptionHere(JSET_ERROR, "Unknown Watch");
     }
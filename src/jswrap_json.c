@@ -347,7 +347,7 @@ void jsfGetJSON(JsVar *var, JsVar *result, JSONFlags flags) {
 
   jsfGetJSONWithCallback(var, flags, (vcbprintf_callback)&jsvStringIteratorPrintfCallback, &it);
 
-  jsvStringIteratorFree(&it);
+  jsvStringIteratorFreeAppend(&it, result);
 }
 
 void jsfPrintJSON(JsVar *var, JSONFlags flags) {
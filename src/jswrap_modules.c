@@ -21,6 +21,7 @@
 #include "jswrapper.h"
 #ifdef USE_FILESYSTEM
 #include "jswrap_fs.h"
+#include "jswrap_date.h"
 #endif
 
 /*JSON{
@@ -34,6 +35,165 @@ static JsVar *jswrap_modules_getModuleList() {
   return jsvObjectGetChild(execInfo.hiddenRoot, JSPARSE_MODULE_CACHE_NAME, JSV_OBJECT);
 }
 
+#ifdef USE_FILESYSTEM
+/* Minified modules start with this comment, followed by the size, the
+ * modification time (in seconds) and an FNV-1a hash of the source they were
+ * created from in hex, and a newline. Being a comment, it is skipped by the
+ * lexer when the module is executed. */
+#define MODULE_MIN_HEADER "//ESPRUINO_MIN "
+#define MODULE_MIN_HEADER_LEN 15
+
+/// Set if we failed to write a minified module, so we don't keep trying (until reset)
+static THREAD_LOCAL bool jswrap_modules_minifiedWriteFailed = false;
+
+/*JSON{
+  "type" : "init",
+  "generate" : "jswrap_modules_init",
+  "ifdef" : "USE_FILESYSTEM"
+}*/
+void jswrap_modules_init() {
+  // the filesystem may have changed (eg. a new SD card), so try writing again
+  jswrap_modules_minifiedWriteFailed = false;
+}
+
+/// Get the path of a module's file, eg. node_modules/foo.min.js
+static JsVar *jswrap_modules_getPath(JsVar *moduleName, const char *extension) {
+  JsVar *modulePath = jsvNewFromString("node_modules/");
+  if (!modulePath) return 0; // out of memory
+  jsvAppendStringVarComplete(modulePath, moduleName);
+  jsvAppendString(modulePath, extension);
+  return modulePath;
+}
+
+/** Get the size and modification time (in seconds) of a file without reading
+ * it. Returns false if it doesn't exist */
+static bool jswrap_modules_getFileInfo(JsVar *path, unsigned int *size, unsigned int *mtime) {
+  JsVar *stat = path ? jswrap_fs_stat(path) : 0;
+  if (!stat) return false;
+  *size = (unsigned int)jsvGetIntegerAndUnLock(jsvObjectGetChild(stat, "size", 0));
+  JsVar *date = jsvObjectGetChild(stat, "mtime", 0);
+  *mtime = (unsigned int)(jswrap_date_getTime(date) / 1000);
+  jsvUnLock(date);
+  jsvUnLock(stat);
+  return true;
+}
+
+/// FNV-1a hash of a module's source code, stored in the header of the minified version
+static unsigned int jswrap_modules_hash(JsVar *str) {
+  unsigned int hash = 2166136261U;
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, str, 0);
+  while (jsvStringIteratorHasChar(&it)) {
+    hash = (hash ^ (unsigned char)jsvStringIteratorGetChar(&it)) * 16777619U;
+    jsvStringIteratorNext(&it);
+  }
+  jsvStringIteratorFree(&it);
+  return hash;
+}
+
+/// Read a hex number from the iterator, and return the character after it
+static char jswrap_modules_getHex(JsvStringIterator *it, unsigned int *value) {
+  *value = 0;
+  while (chtod(jsvStringIteratorGetChar(it))>=0) {
+    *value = (*value<<4) | (unsigned int)chtod(jsvStringIteratorGetChar(it));
+    jsvStringIteratorNext(it);
+  }
+  char ch = jsvStringIteratorGetChar(it);
+  jsvStringIteratorNext(it);
+  return ch;
+}
+
+/** Return true if the (minified) file has our header, and put the size,
+ * modification time and hash of the source it was created from in 'size',
+ * 'mtime' and 'hash' */
+static bool jswrap_modules_getMinifiedInfo(JsVar *minified, unsigned int *size, unsigned int *mtime, unsigned int *hash) {
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, minified, 0);
+  int i;
+  for (i=0;i<MODULE_MIN_HEADER_LEN;i++) {
+    if (jsvStringIteratorGetChar(&it)!=MODULE_MIN_HEADER[i]) {
+      jsvStringIteratorFree(&it);
+      return false;
+    }
+    jsvStringIteratorNext(&it);
+  }
+  bool ok = jswrap_modules_getHex(&it, size)==' ' &&
+            jswrap_modules_getHex(&it, mtime)==' ' &&
+            jswrap_modules_getHex(&it, hash)=='\n';
+  jsvStringIteratorFree(&it);
+  return ok;
+}
+
+/** Minify the source code of a module and write it to 'minifiedPath' with our
+ * header. Returns the minified code, or 0 if we're out of memory. */
+static JsVar *jswrap_modules_minify(JsVar *minifiedPath, JsVar *source, unsigned int sourceSize, unsigned int sourceTime) {
+  JsVar *code = jslNewMinifiedFromString(source);
+  if (!code) return 0; // out of memory - don't write a file with just a header
+  JsVar *minified = jsvNewFromEmptyString();
+  if (minified) {
+    jsvAppendPrintf(minified, MODULE_MIN_HEADER"%x %x %x\n", sourceSize, sourceTime, jswrap_modules_hash(source));
+    jsvAppendStringVarComplete(minified, code);
+    if (!minifiedPath || !jsfsWriteFileQuietly(minifiedPath, minified))
+      jswrap_modules_minifiedWriteFailed = true;
+  }
+  jsvUnLock(code);
+  return minified;
+}
+
+/** Load a module from the filesystem. node_modules/NAME.min.js is preferred
+ * if it exists. If it has a header describing the source code and that doesn't
+ * match node_modules/NAME.js, or it doesn't exist, it is (re)created from
+ * NAME.js, with comments and whitespace stripped so it is faster to parse and
+ * uses less memory when functions are defined.
+ *
+ * The hash of the source is what says whether the minified file is up to date,
+ * but if the source's size and modification time match the header and it was
+ * modified before the minified file was written, it can't have changed since -
+ * so then it is only stat'd, not read. Minified files without a header (eg.
+ * ones written by the Web IDE) are left alone, and only used if there's no
+ * source code. If the minified file can't be written (eg. a read-only
+ * filesystem) the source is used from then on. */
+static JsVar *jswrap_modules_loadFile(JsVar *moduleName) {
+  JsVar *sourcePath = jswrap_modules_getPath(moduleName, ".js");
+  JsVar *minifiedPath = jswrap_modules_getPath(moduleName, ".min.js");
+  unsigned int sourceSize, sourceTime, minifiedFileSize, minifiedFileTime;
+  bool hasSource = jswrap_modules_getFileInfo(sourcePath, &sourceSize, &sourceTime) && sourceSize>0;
+  JsVar *minified = 0;
+  if (jswrap_modules_getFileInfo(minifiedPath, &minifiedFileSize, &minifiedFileTime))
+    minified = jswrap_fs_readFile(minifiedPath, 0);
+  JsVar *source = 0;
+
+  if (hasSource) {
+    unsigned int minifiedSize, minifiedTime, minifiedHash;
+    if (minified && !jswrap_modules_getMinifiedInfo(minified, &minifiedSize, &minifiedTime, &minifiedHash)) {
+      // We didn't create it, so the source code is what we should use
+      jsvUnLock(minified);
+      minified = 0;
+      source = jswrap_fs_readFile(sourcePath, 0);
+    } else if (!minified || minifiedSize!=sourceSize || minifiedTime!=sourceTime ||
+               sourceTime>=minifiedFileTime) {
+      /* The source has changed, or might have been edited in the same second
+       * the minified file was written (so its time is the same) - check */
+      source = jswrap_fs_readFile(sourcePath, 0);
+      if (source && (!minified || minifiedSize!=sourceSize || minifiedTime!=sourceTime ||
+                     minifiedHash!=jswrap_modules_hash(source))) {
+        jsvUnLock(minified);
+        minified = 0;
+        if (!jswrap_modules_minifiedWriteFailed)
+          minified = jswrap_modules_minify(minifiedPath, source, sourceSize, sourceTime);
+      }
+    }
+  }
+  jsvUnLock(sourcePath);
+  jsvUnLock(minifiedPath);
+  if (minified) {
+    jsvUnLock(source);
+    return minified;
+  }
+  return source;
+}
+#endif
+
 /*JSON{
   "type" : "function",
   "name" : "require",
@@ -76,12 +236,7 @@ JsVar *jswrap_require(JsVar *moduleName) {
     //if (jsvIsStringEqual(moduleName,"http")) {}
     //if (jsvIsStringEqual(moduleName,"fs")) {}
   #ifdef USE_FILESYSTEM
-    JsVar *modulePath = jsvNewFromString("node_modules/");
-    if (!modulePath) { jsvUnLock(moduleExportName); return 0; } // out of memory
-    jsvAppendStringVarComplete(modulePath, moduleName);
-    jsvAppendString(modulePath,".js");
-    fileContents = jswrap_fs_readFile(modulePath);
-    jsvUnLock(modulePath);
+    fileContents = jswrap_modules_loadFile(moduleName);
   #endif
     if (!fileContents || jsvIsStringEqual(fileContents,"")) {
       jsvUnLock(moduleExportName);
@@ -14,6 +14,7 @@
 #include "jsvar.h"
 
 JsVar *jswrap_require(JsVar *modulename);
+void jswrap_modules_init();
 
 JsVar *jswrap_modules_getCached();
 void jswrap_modules_removeCached(JsVar *id);
@@ -385,12 +385,11 @@ void jswrap_object_on(JsVar *parent, JsVar *event, JsVar *listener) {
   /* Special case if we're a data listener and data has already arrived then
    * we queue an event immediately. */
   if (jsvIsStringEqual(event, "data")) {
-    JsVar *buf = jsvObjectGetChild(parent, STREAM_BUFFER_NAME, 0);
-    if (jsvIsString(buf)) {
+    if (jswrap_stream_available(parent)) {
+      JsVar *buf = jswrap_stream_read(parent, 0);
       jsiQueueObjectCallbacks(parent, "#ondata", &buf, 1);
-      jsvRemoveNamedChild(parent, STREAM_BUFFER_NAME);
+      jsvUnLock(buf);
     }
-    jsvUnLock(buf);
   }
 }
 
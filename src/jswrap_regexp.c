@@ -0,0 +1,348 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * This file is designed to be parsed during the build process
+ *
+ * JavaScript methods for Regular Expressions
+ * ----------------------------------------------------------------------------
+ */
+#include "jswrap_regexp.h"
+#include "jsregex.h"
+#include "jsparse.h"
+#include "jsvariterator.h"
+
+/*JSON{
+  "type" : "class",
+  "class" : "RegExp"
+}
+The built-in class for handling Regular Expressions.
+
+Expressions are compiled when the RegExp is created, and are then run
+directly over the String being searched (without copying it). Character
+classes, groups (capturing and `(?:...)`), alternation, greedy and lazy
+quantifiers (`*`, `+`, `?`, `{n,m}`), anchors and `\b` are supported, along
+with the `g`, `i` and `m` flags. Lookahead and backreferences are not.
+*/
+
+JsVar *jswrap_regexp_getCode(JsVar *v) {
+  if (!jsvIsObject(v)) return 0;
+  JsVar *code = jsvObjectGetChild(v, JSWRAP_REGEXP_CODE_NAME, 0);
+  if (jsvIsString(code)) return code;
+  jsvUnLock(code);
+  return 0;
+}
+
+/*JSON{
+  "type" : "constructor",
+  "class" : "RegExp",
+  "name" : "RegExp",
+  "generate" : "jswrap_regexp_constructor",
+  "params" : [
+    ["regex","JsVar","A regular expression as a string (or another RegExp)"],
+    ["flags","JsVar","Flags for the regular expression as a string - any of `g` (global), `i` (ignore case) and `m` (multiline)"]
+  ],
+  "return" : ["JsVar","A RegExp object"],
+  "return_object" : "RegExp"
+}
+Creates a RegExp object, eg. `new RegExp("ab+c","i")`. You can also use the literal form, `/ab+c/i`.
+*/
+JsVar *jswrap_regexp_constructor(JsVar *str, JsVar *flags) {
+  JsVar *source;
+  JsVar *code = jswrap_regexp_getCode(str);
+  if (code) { // copying another RegExp
+    jsvUnLock(code);
+    source = jsvObjectGetChild(str, "source", 0);
+    if (jsvIsUndefined(flags)) {
+      flags = jsvObjectGetChild(str, "flags", 0);
+      JsVar *r = jswrap_regexp_constructor(source, flags);
+      jsvUnLock(source);
+      jsvUnLock(flags);
+      return r;
+    }
+  } else
+    source = jsvIsUndefined(str) ? jsvNewFromString("(?:)") : jsvAsString(str, false);
+  flags = jsvIsUndefined(flags) ? jsvNewFromEmptyString() : jsvAsString(flags, false);
+  if (!source || !flags) { // out of memory
+    jsvUnLock(source);
+    jsvUnLock(flags);
+    return 0;
+  }
+
+  JsVar *r = 0;
+  code = jsreCompile(source, flags);
+  if (code) {
+    r = jspNewObject(0, "RegExp");
+    if (r) {
+      jsvUnLock(jsvObjectSetChild(r, "source", source));
+      jsvUnLock(jsvObjectSetChild(r, "flags", flags));
+      jsvUnLock(jsvObjectSetChild(r, "lastIndex", jsvNewFromInteger(0)));
+      jsvObjectSetChild(r, JSWRAP_REGEXP_CODE_NAME, code);
+    }
+    jsvUnLock(code);
+  } else {
+    jsvUnLock(source);
+    jsvUnLock(flags);
+  }
+  return r;
+}
+
+JsVar *jswrap_regexp_fromLiteral(JsVar *literal) {
+  // literal is "/source/flags", and the source can't contain an unescaped '/'
+  size_t lastSlash = 0;
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, literal, 0);
+  while (jsvStringIteratorHasChar(&it)) {
+    if (jsvStringIteratorGetChar(&it)=='/') lastSlash = jsvStringIteratorGetIndex(&it);
+    jsvStringIteratorNext(&it);
+  }
+  jsvStringIteratorFree(&it);
+  if (!lastSlash) lastSlash = jsvGetStringLength(literal); // no closing '/'
+  JsVar *source = jsvNewFromStringVar(literal, 1, lastSlash-1);
+  JsVar *flags = jsvNewFromStringVar(literal, lastSlash+1, JSVAPPENDSTRINGVAR_MAXLENGTH);
+  JsVar *r = 0;
+  if (source && flags) r = jswrap_regexp_constructor(source, flags);
+  jsvUnLock(source);
+  jsvUnLock(flags);
+  return r;
+}
+
+/// Get a group from a match as a String (or 0 if it didn't match)
+static JsVar *jswrap_regexp_getGroup(JsVar *str, size_t *groups, int group) {
+  if (groups[group*2]==JSRE_NO_MATCH) return 0;
+  return jsvNewFromStringVar(str, groups[group*2], groups[group*2+1]-groups[group*2]);
+}
+
+/// Run the RegExp on str, starting from (and updating) lastIndex if it's global
+static bool jswrap_regexp_run(JsVar *regex, JsVar *code, JsVar *str, size_t *groups) {
+  bool global = (jsreGetFlags(code) & JSRE_GLOBAL)!=0;
+  size_t startIdx = 0;
+  if (global) {
+    JsVarInt lastIndex = jsvGetIntegerAndUnLock(jsvObjectGetChild(regex, "lastIndex", 0));
+    if (lastIndex<0 || lastIndex>(JsVarInt)jsvGetStringLength(str)) {
+      jsvUnLock(jsvObjectSetChild(regex, "lastIndex", jsvNewFromInteger(0)));
+      return false;
+    }
+    startIdx = (size_t)lastIndex;
+  }
+  bool found = jsreExec(code, str, startIdx, groups);
+  if (global)
+    jsvUnLock(jsvObjectSetChild(regex, "lastIndex", jsvNewFromInteger(found ? (JsVarInt)groups[1] : 0)));
+  return found;
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "RegExp",
+  "name" : "exec",
+  "generate" : "jswrap_regexp_exec",
+  "params" : [
+    ["str","JsVar","A String to match on"]
+  ],
+  "return" : ["JsVar","An array of the match and the groups within it (with `index` and `input` set), or null"]
+}
+Search `str` for this RegExp. If the RegExp is global (`g`), the search starts from `lastIndex`, which is then set to the end of the match.
+
+eg. `/(\d+)-(\d+)/.exec("Range: 10-20")` returns `["10-20", "10", "20"]`, with `index` set to `7`.
+*/
+JsVar *jswrap_regexp_exec(JsVar *parent, JsVar *arg) {
+  JsVar *code = jswrap_regexp_getCode(parent);
+  if (!code) {
+    jsExceptionHere(JSET_ERROR, "Not a RegExp");
+    return 0;
+  }
+  JsVar *str = jsvAsString(arg, false);
+  JsVar *result = 0;
+  size_t groups[JSRE_MAX_GROUPS*2];
+  if (str && jswrap_regexp_run(parent, code, str, groups)) {
+    result = jsvNewWithFlags(JSV_ARRAY);
+    if (result) {
+      int i, groupCount = jsreGetGroupCount(code);
+      for (i=0;i<groupCount;i++)
+        jsvArrayPushAndUnLock(result, jswrap_regexp_getGroup(str, groups, i));
+      jsvUnLock(jsvObjectSetChild(result, "index", jsvNewFromInteger((JsVarInt)groups[0])));
+      jsvObjectSetChild(result, "input", str);
+    }
+  } else if (!jspHasError())
+    result = jsvNewNull();
+  jsvUnLock(str);
+  jsvUnLock(code);
+  return result;
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "RegExp",
+  "name" : "test",
+  "generate" : "jswrap_regexp_test",
+  "params" : [
+    ["str","JsVar","A String to match on"]
+  ],
+  "return" : ["bool","true if the RegExp matches somewhere in `str`"]
+}
+Return true if this RegExp matches `str`. As with `exec`, a global RegExp starts from (and updates) `lastIndex`.
+*/
+bool jswrap_regexp_test(JsVar *parent, JsVar *arg) {
+  JsVar *code = jswrap_regexp_getCode(parent);
+  if (!code) {
+    jsExceptionHere(JSET_ERROR, "Not a RegExp");
+    return false;
+  }
+  JsVar *str = jsvAsString(arg, false);
+  size_t groups[JSRE_MAX_GROUPS*2];
+  bool found = str && jswrap_regexp_run(parent, code, str, groups);
+  jsvUnLock(str);
+  jsvUnLock(code);
+  return found;
+}
+
+/// After a match that ended at 'end', where should the next search start? (don't get stuck on empty matches)
+static size_t jswrap_regexp_nextIndex(size_t *groups) {
+  return (groups[1]==groups[0]) ? groups[1]+1 : groups[1];
+}
+
+JsVar *jswrap_regexp_match(JsVar *regex, JsVar *str) {
+  JsVar *code = jswrap_regexp_getCode(regex);
+  if (!code) return 0;
+  if (!(jsreGetFlags(code) & JSRE_GLOBAL)) {
+    jsvUnLock(code);
+    return jswrap_regexp_exec(regex, str);
+  }
+  // global - return an array of every match
+  JsVar *result = 0;
+  size_t groups[JSRE_MAX_GROUPS*2];
+  size_t idx = 0, len = jsvGetStringLength(str);
+  while (idx<=len && jsreExec(code, str, idx, groups)) {
+    if (!result) result = jsvNewWithFlags(JSV_ARRAY);
+    if (!result) break; // out of memory
+    jsvArrayPushAndUnLock(result, jswrap_regexp_getGroup(str, groups, 0));
+    idx = jswrap_regexp_nextIndex(groups);
+  }
+  jsvUnLock(jsvObjectSetChild(regex, "lastIndex", jsvNewFromInteger(0)));
+  jsvUnLock(code);
+  if (!result && !jspHasError()) result = jsvNewNull();
+  return result;
+}
+
+int jswrap_regexp_search(JsVar *regex, JsVar *str) {
+  JsVar *code = jswrap_regexp_getCode(regex);
+  if (!code) return -1;
+  size_t groups[JSRE_MAX_GROUPS*2];
+  int idx = jsreExec(code, str, 0, groups) ? (int)groups[0] : -1;
+  jsvUnLock(code);
+  return idx;
+}
+
+/// Append the replacement for a match to dst - either the result of calling a function, or a String with $1, $& and so on filled in
+static void jswrap_regexp_appendReplacement(JsVar *dst, JsVar *str, JsVar *replace, size_t *groups, int groupCount) {
+  if (jsvIsFunction(replace)) {
+    // function(match, p1, p2, ..., offset, string)
+    JsVar *args[JSRE_MAX_GROUPS+2];
+    int i, argCount = 0;
+    for (i=0;i<groupCount;i++) args[argCount++] = jswrap_regexp_getGroup(str, groups, i);
+    args[argCount++] = jsvNewFromInteger((JsVarInt)groups[0]);
+    args[argCount++] = jsvLockAgain(str);
+    JsVar *r = jsvAsString(jspExecuteFunction(replace, 0, argCount, args), true);
+    for (i=0;i<argCount;i++) jsvUnLock(args[i]);
+    if (r) jsvAppendStringVarComplete(dst, r);
+    jsvUnLock(r);
+    return;
+  }
+
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, replace, 0);
+  while (jsvStringIteratorHasChar(&it)) {
+    char ch = jsvStringIteratorGetChar(&it);
+    jsvStringIteratorNext(&it);
+    if (ch=='$' && jsvStringIteratorHasChar(&it)) {
+      char n = jsvStringIteratorGetChar(&it);
+      int group = -1;
+      if (n=='&') group = 0;
+      else if (n>='1' && n<='9' && n-'0'<groupCount) group = n-'0';
+      if (group>=0) {
+        if (groups[group*2]!=JSRE_NO_MATCH)
+          jsvAppendStringVar(dst, str, groups[group*2], groups[group*2+1]-groups[group*2]);
+        jsvStringIteratorNext(&it);
+        continue;
+      } else if (n=='`') { // before the match
+        jsvAppendStringVar(dst, str, 0, groups[0]);
+        jsvStringIteratorNext(&it);
+        continue;
+      } else if (n=='\'') { // after the match
+        jsvAppendStringVar(dst, str, groups[1], JSVAPPENDSTRINGVAR_MAXLENGTH);
+        jsvStringIteratorNext(&it);
+        continue;
+      } else if (n=='$') {
+        jsvStringIteratorNext(&it);
+      }
+    }
+    jsvAppendStringBuf(dst, &ch, 1);
+  }
+  jsvStringIteratorFree(&it);
+}
+
+JsVar *jswrap_regexp_replace(JsVar *regex, JsVar *str, JsVar *replace, bool all) {
+  JsVar *code = jswrap_regexp_getCode(regex);
+  if (!code) return 0;
+  bool global = all || (jsreGetFlags(code) & JSRE_GLOBAL);
+  int groupCount = jsreGetGroupCount(code);
+  JsVar *newStr = jsvNewFromEmptyString();
+  if (!newStr) {
+    jsvUnLock(code);
+    return 0;
+  }
+  size_t groups[JSRE_MAX_GROUPS*2];
+  size_t idx = 0, last = 0, len = jsvGetStringLength(str);
+  while (idx<=len && jsreExec(code, str, idx, groups)) {
+    jsvAppendStringVar(newStr, str, last, groups[0]-last);
+    jswrap_regexp_appendReplacement(newStr, str, replace, groups, groupCount);
+    last = groups[1];
+    if (!global || jspHasError()) break;
+    idx = jswrap_regexp_nextIndex(groups);
+  }
+  jsvAppendStringVar(newStr, str, last, JSVAPPENDSTRINGVAR_MAXLENGTH);
+  if (global) jsvUnLock(jsvObjectSetChild(regex, "lastIndex", jsvNewFromInteger(0)));
+  jsvUnLock(code);
+  return newStr;
+}
+
+JsVar *jswrap_regexp_split(JsVar *regex, JsVar *str) {
+  JsVar *code = jswrap_regexp_getCode(regex);
+  if (!code) return 0;
+  JsVar *array = jsvNewWithFlags(JSV_ARRAY);
+  if (!array) {
+    jsvUnLock(code);
+    return 0;
+  }
+  int i, groupCount = jsreGetGroupCount(code);
+  size_t groups[JSRE_MAX_GROUPS*2];
+  size_t len = jsvGetStringLength(str);
+  if (len==0) {
+    // an empty string is only split if the RegExp matches it
+    if (!jsreExec(code, str, 0, groups)) jsvArrayPush(array, str);
+    jsvUnLock(code);
+    return array;
+  }
+
+  size_t p = 0, q = 0; // p = start of the next part, q = where to search from
+  while (q<len && jsreExec(code, str, q, groups)) {
+    if (groups[0]>=len) break;
+    if (groups[1]==p) { // an empty match right where we are - try the next character
+      q = groups[0]+1;
+      continue;
+    }
+    jsvArrayPushAndUnLock(array, jsvNewFromStringVar(str, p, groups[0]-p));
+    for (i=1;i<groupCount;i++) // captured groups go in the array too
+      jsvArrayPushAndUnLock(array, jswrap_regexp_getGroup(str, groups, i));
+    p = q = groups[1];
+  }
+  jsvArrayPushAndUnLock(array, jsvNewFromStringVar(str, p, JSVAPPENDSTRINGVAR_MAXLENGTH));
+  jsvUnLock(code);
+  return array;
+}
@@ -0,0 +1,33 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * JavaScript methods for Regular Expressions
+ * ----------------------------------------------------------------------------
+ */
+#include "jsvar.h"
+
+#define JSWRAP_REGEXP_CODE_NAME JS_HIDDEN_CHAR_STR"re" // the RegExp's compiled code
+
+JsVar *jswrap_regexp_constructor(JsVar *str, JsVar *flags);
+JsVar *jswrap_regexp_exec(JsVar *parent, JsVar *str);
+bool jswrap_regexp_test(JsVar *parent, JsVar *str);
+
+/// If v is a RegExp, return its compiled code - otherwise return 0
+JsVar *jswrap_regexp_getCode(JsVar *v);
+/// Create a RegExp from the token value of a regex literal (eg. "/ab+c/gi")
+JsVar *jswrap_regexp_fromLiteral(JsVar *literal);
+/// String.match with a RegExp
+JsVar *jswrap_regexp_match(JsVar *regex, JsVar *str);
+/// String.search with a RegExp
+int jswrap_regexp_search(JsVar *regex, JsVar *str);
+/// String.replace with a RegExp (replace can be a String or a function). If all, replace all matches even if regex isn't global
+JsVar *jswrap_regexp_replace(JsVar *regex, JsVar *str, JsVar *replace, bool all);
+/// String.split with a RegExp
+JsVar *jswrap_regexp_split(JsVar *regex, JsVar *str);
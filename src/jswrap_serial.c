@@ -304,6 +304,29 @@ Return how many bytes are available to read. If there is already a listener for
 Return a string containing characters that have been received
 */
 
+/*JSON{
+  "type" : "method",
+  "class" : "Serial",
+  "name" : "readUntil",
+  "generate" : "jswrap_stream_readUntil",
+  "params" : [
+    ["ch","JsVar","The character to read up to"]
+  ],
+  "return" : ["JsVar","A string containing all data up to and including 'ch', or undefined if 'ch' hasn't been received yet"]
+}
+Return (and remove) all received characters up to and including the first occurrence of `ch`. If `ch` hasn't been received yet, nothing is removed and `undefined` is returned.
+*/
+
+/*JSON{
+  "type" : "method",
+  "class" : "Serial",
+  "name" : "readLine",
+  "generate" : "jswrap_stream_readLine",
+  "return" : ["JsVar","A string containing the next line (without the '\\n' or '\\r\\n'), or undefined if a whole line hasn't been received yet"]
+}
+Return (and remove) the next line of received characters. If a whole line hasn't been received yet, nothing is removed and `undefined` is returned.
+*/
+
 /*JSON{
   "type" : "method",
   "class" : "Serial",
@@ -26,39 +26,181 @@
   "include" : "jswrap_stream.c"
 }*/
 
+/* When there's no 'data' listener, received data is stored in
+ * STREAM_BUFFER_NAME - an array of strings (chunks) of at most
+ * STREAM_CHUNK_SIZE characters. STREAM_BUFFER_OFFSET_NAME is how many
+ * characters of the first chunk have already been read, and
+ * STREAM_BUFFER_LENGTH_NAME is the total number of characters waiting. This
+ * means reading a few characters at a time doesn't have to copy everything
+ * that is left. */
+
+static JsVarInt jswrap_stream_getInt(JsVar *parent, const char *name) {
+  return jsvGetIntegerAndUnLock(jsvObjectGetChild(parent, name, 0));
+}
+
+static void jswrap_stream_setInt(JsVar *parent, const char *name, JsVarInt value) {
+  jsvUnLock(jsvObjectSetChild(parent, name, jsvNewFromInteger(value)));
+}
+
+/// Remove everything from the stream's buffer
+static void jswrap_stream_clearBuffer(JsVar *parent) {
+  jsvRemoveNamedChild(parent, STREAM_BUFFER_NAME);
+  jsvRemoveNamedChild(parent, STREAM_BUFFER_OFFSET_NAME);
+  jsvRemoveNamedChild(parent, STREAM_BUFFER_LENGTH_NAME);
+}
+
+/// Add some data to the end of the buffer, without checking the buffer's size
+static void jswrap_stream_appendBuffer(JsVar *parent, JsVar *dataString, size_t dataLen) {
+  JsVar *buf = jsvObjectGetChild(parent, STREAM_BUFFER_NAME, JSV_ARRAY);
+  if (!buf) return; // out of memory
+  JsVar *last = jsvGetLastChild(buf) ? jsvSkipNameAndUnLock(jsvLock(jsvGetLastChild(buf))) : 0;
+  size_t lastLen = last ? jsvGetStringLength(last) : 0;
+  size_t idx = 0;
+  while (idx < dataLen) {
+    if (last && lastLen < STREAM_CHUNK_SIZE) {
+      // fill up the last chunk first
+      size_t n = STREAM_CHUNK_SIZE - lastLen;
+      if (n > dataLen-idx) n = dataLen-idx;
+      jsvAppendStringVar(last, dataString, idx, n);
+      lastLen += n;
+      idx += n;
+    } else {
+      jsvUnLock(last);
+      if (idx==0 && dataLen<=STREAM_CHUNK_SIZE && jsvGetStringLength(dataString)==dataLen) {
+        last = jsvLockAgain(dataString); // just use the string we were given
+      } else {
+        last = jsvNewFromStringVar(dataString, idx, (dataLen-idx < STREAM_CHUNK_SIZE) ? dataLen-idx : STREAM_CHUNK_SIZE);
+        if (!last) break; // out of memory
+      }
+      jsvArrayPush(buf, last);
+      lastLen = jsvGetStringLength(last);
+      idx += lastLen;
+    }
+  }
+  jsvUnLock(last);
+  jsvUnLock(buf);
+  jswrap_stream_setInt(parent, STREAM_BUFFER_LENGTH_NAME, jswrap_stream_getInt(parent, STREAM_BUFFER_LENGTH_NAME) + (JsVarInt)idx);
+}
+
+/// Remove exactly 'chars' characters from the buffer and return them (or just discard them if 'discard' is set)
+static JsVar *jswrap_stream_readInternal(JsVar *parent, JsVarInt chars, bool discard) {
+  JsVarInt available = jswrap_stream_getInt(parent, STREAM_BUFFER_LENGTH_NAME);
+  if (chars > available) chars = available;
+  if (chars == available) {
+    // We're taking everything - can we just return the buffer?
+    JsVar *buf = jsvObjectGetChild(parent, STREAM_BUFFER_NAME, 0);
+    JsVar *data = 0;
+    if (!discard && buf && jsvGetFirstChild(buf) && jsvGetFirstChild(buf)==jsvGetLastChild(buf) &&
+        jswrap_stream_getInt(parent, STREAM_BUFFER_OFFSET_NAME)==0)
+      data = jsvSkipNameAndUnLock(jsvArrayPopFirst(buf));
+    jsvUnLock(buf);
+    if (data) {
+      jswrap_stream_clearBuffer(parent);
+      return data;
+    }
+  }
+  JsVar *data = discard ? 0 : jsvNewFromEmptyString();
+  if (!discard && !data) return 0; // out of memory
+  if (chars <= 0) return data;
+
+  JsVar *buf = jsvObjectGetChild(parent, STREAM_BUFFER_NAME, 0);
+  JsVarInt offset = jswrap_stream_getInt(parent, STREAM_BUFFER_OFFSET_NAME);
+  JsVarInt remaining = chars;
+  while (remaining>0 && buf && jsvGetFirstChild(buf)) {
+    JsVar *chunk = jsvSkipNameAndUnLock(jsvLock(jsvGetFirstChild(buf)));
+    JsVarInt chunkLen = (JsVarInt)jsvGetStringLength(chunk);
+    JsVarInt n = chunkLen - offset;
+    if (n > remaining) n = remaining;
+    if (data) jsvAppendStringVar(data, chunk, (size_t)offset, (size_t)n);
+    jsvUnLock(chunk);
+    offset += n;
+    remaining -= n;
+    if (offset >= chunkLen) {
+      jsvUnLock(jsvArrayPopFirst(buf));
+      offset = 0;
+    }
+  }
+  jsvUnLock(buf);
+  if (available-chars > 0) {
+    jswrap_stream_setInt(parent, STREAM_BUFFER_OFFSET_NAME, offset);
+    jswrap_stream_setInt(parent, STREAM_BUFFER_LENGTH_NAME, available-chars);
+  } else
+    jswrap_stream_clearBuffer(parent);
+  return data;
+}
+
+/** Return the index of 'ch' in the data that is available, or -1. If
+ * prevCh is set, the character before it is returned in it */
+static JsVarInt jswrap_stream_indexOf(JsVar *parent, char ch, char *prevCh) {
+  JsVar *buf = jsvObjectGetChild(parent, STREAM_BUFFER_NAME, 0);
+  if (!buf) return -1;
+  JsVarInt idx = 0;
+  size_t offset = (size_t)jswrap_stream_getInt(parent, STREAM_BUFFER_OFFSET_NAME);
+  char lastCh = 0;
+  bool found = false;
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, buf);
+  while (!found && jsvObjectIteratorHasValue(&it)) {
+    JsVar *chunk = jsvObjectIteratorGetValue(&it);
+    JsvStringIterator sit;
+    jsvStringIteratorNew(&sit, chunk, offset);
+    while (jsvStringIteratorHasChar(&sit)) {
+      char c = jsvStringIteratorGetChar(&sit);
+      if (c==ch) {
+        found = true;
+        break;
+      }
+      lastCh = c;
+      idx++;
+      jsvStringIteratorNext(&sit);
+    }
+    jsvStringIteratorFree(&sit);
+    jsvUnLock(chunk);
+    offset = 0;
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+  jsvUnLock(buf);
+  if (prevCh) *prevCh = lastCh;
+  return found ? idx : -1;
+}
+
 // Return how many bytes are available to read
 JsVarInt jswrap_stream_available(JsVar *parent) {
   if (!jsvIsObject(parent)) return 0;
-  JsVar *buf = jsvObjectGetChild(parent, STREAM_BUFFER_NAME, 0);
-  JsVarInt chars = 0;
-  if (jsvIsString(buf))
-    chars = (JsVarInt)jsvGetStringLength(buf);
-  jsvUnLock(buf);
-  return chars;
+  return jswrap_stream_getInt(parent, STREAM_BUFFER_LENGTH_NAME);
 }
 
 // Return a string containing 'chars' bytes. If chars<=0 the string will be all available data
 JsVar *jswrap_stream_read(JsVar *parent, JsVarInt chars) {
   if (!jsvIsObject(parent)) return 0;
-  JsVar *buf = jsvObjectGetChild(parent, STREAM_BUFFER_NAME, 0);
-  JsVar *data = 0;
-  if (jsvIsString(buf)) {
-    size_t len = jsvGetStringLength(buf);
-    if (chars <= 0 || (size_t)chars>=len) {
-      // return the whole buffer and remove it
-      data = buf;
-      buf = 0;
-      jsvRemoveNamedChild(parent, STREAM_BUFFER_NAME);
-    } else {
-      // return just part of the buffer, and shorten it accordingly
-      data = jsvNewFromStringVar(buf, 0, (size_t)chars);
-      JsVar *newBuf = jsvNewFromStringVar(buf, (size_t)chars, JSVAPPENDSTRINGVAR_MAXLENGTH);
-      jsvUnLock(jsvObjectSetChild(parent, STREAM_BUFFER_NAME, newBuf));
-    }
-  } else
-    data = jsvNewFromEmptyString();
-  jsvUnLock(buf);
-  return data;
+  if (chars <= 0) chars = jswrap_stream_available(parent);
+  return jswrap_stream_readInternal(parent, chars, false);
+}
+
+// Return all data up to and including 'ch', or undefined if 'ch' hasn't been received
+JsVar *jswrap_stream_readUntil(JsVar *parent, JsVar *ch) {
+  if (!jsvIsObject(parent)) return 0;
+  char chars[2];
+  if (!jsvIsString(ch) || jsvGetString(ch, chars, sizeof(chars))!=1) {
+    jsExceptionHere(JSET_ERROR, "Expecting a single character, got %q", ch);
+    return 0;
+  }
+  JsVarInt idx = jswrap_stream_indexOf(parent, chars[0], 0);
+  if (idx<0) return 0;
+  return jswrap_stream_readInternal(parent, idx+1, false);
+}
+
+// Return the next line of data (without '\r\n' or '\n' on the end), or undefined if a whole line hasn't been received
+JsVar *jswrap_stream_readLine(JsVar *parent) {
+  if (!jsvIsObject(parent)) return 0;
+  char prevCh;
+  JsVarInt idx = jswrap_stream_indexOf(parent, '\n', &prevCh);
+  if (idx<0) return 0;
+  JsVarInt lineEnd = (idx>0 && prevCh=='\r') ? 2 : 1;
+  JsVar *line = jswrap_stream_readInternal(parent, idx+1-lineEnd, false);
+  jswrap_stream_readInternal(parent, lineEnd, true);
+  return line;
 }
 
 /** Push data into a stream. To be used by Espruino (not a user).
@@ -79,22 +221,22 @@ void jswrap_stream_pushData(JsVar *parent, JsVar *dataString) {
     }
     jsvUnLock(callback);
   } else {
-    // No callback - try and add buffer
-    JsVar *buf = jsvObjectGetChild(parent, STREAM_BUFFER_NAME, 0);
-    if (!jsvIsString(buf)) {
-      // no buffer, just set this one up
-      jsvObjectSetChild(parent, STREAM_BUFFER_NAME, dataString);
-    } else {
-      // append (if there is room!)
-      size_t bufLen = jsvGetStringLength(buf);
-      size_t dataLen = jsvGetStringLength(dataString);
-      if (bufLen + dataLen > STREAM_MAX_BUFFER_SIZE) {
-        jsErrorFlags |= JSERR_BUFFER_FULL;
-        // jsWarn("String buffer overflowed maximum size (%d)", STREAM_MAX_BUFFER_SIZE);
-      }
-      if (bufLen < STREAM_MAX_BUFFER_SIZE)
-        jsvAppendStringVar(buf, dataString, 0, STREAM_MAX_BUFFER_SIZE-bufLen);
+    // No callback - try and add to the buffer (if there is room!)
+    size_t bufLen = (size_t)jswrap_stream_available(parent);
+    size_t dataLen = jsvGetStringLength(dataString);
+    if (bufLen + dataLen > STREAM_MAX_BUFFER_SIZE) {
+      jsErrorFlags |= JSERR_BUFFER_FULL;
+      // jsWarn("String buffer overflowed maximum size (%d)", STREAM_MAX_BUFFER_SIZE);
+      dataLen = (bufLen < STREAM_MAX_BUFFER_SIZE) ? STREAM_MAX_BUFFER_SIZE-bufLen : 0;
     }
-    jsvUnLock(buf);
+    if (dataLen)
+      jswrap_stream_appendBuffer(parent, dataString, dataLen);
   }
 }
+
+/// Replace everything in the stream's buffer with the given string (or empty it if 0)
+void jswrap_stream_setBuffer(JsVar *parent, JsVar *dataString) {
+  jswrap_stream_clearBuffer(parent);
+  if (dataString && jsvGetStringLength(dataString))
+    jswrap_stream_appendBuffer(parent, dataString, jsvGetStringLength(dataString));
+}
@@ -14,12 +14,17 @@
 #include "jsvar.h"
 
 
-#define STREAM_BUFFER_NAME JS_HIDDEN_CHAR_STR"buf" // the buffer to store data in when no listener is defined
+#define STREAM_BUFFER_NAME JS_HIDDEN_CHAR_STR"buf" // the buffer (an array of strings) to store data in when no listener is defined
+#define STREAM_BUFFER_OFFSET_NAME JS_HIDDEN_CHAR_STR"bufo" // how many characters of the first string in the buffer have been read
+#define STREAM_BUFFER_LENGTH_NAME JS_HIDDEN_CHAR_STR"bufl" // how many characters in total are in the buffer
+#define STREAM_CHUNK_SIZE 64 // the maximum size of each string in the buffer
 #define STREAM_CALLBACK_NAME "#ondata"
 #define STREAM_MAX_BUFFER_SIZE 512
 
 JsVarInt jswrap_stream_available(JsVar *parent);
 JsVar *jswrap_stream_read(JsVar *parent, JsVarInt chars);
+JsVar *jswrap_stream_readUntil(JsVar *parent, JsVar *ch);
+JsVar *jswrap_stream_readLine(JsVar *parent);
 
 /** Push data into a stream. To be used by Espruino (not a user).
  * This either calls the on('data') handler if it exists, or it
@@ -27,3 +32,6 @@ JsVar *jswrap_stream_read(JsVar *parent, JsVarInt chars);
  * passed in.
  */
 void jswrap_stream_pushData(JsVar *parent, JsVar *dataString);
+
+/// Replace everything in the stream's buffer with the given string (or empty it if 0)
+void jswrap_stream_setBuffer(JsVar *parent, JsVar *dataString);
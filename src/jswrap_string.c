@@ -14,6 +14,7 @@
  * ----------------------------------------------------------------------------
  */
 #include "jswrap_string.h"
+#include "jswrap_regexp.h"
 #include "jsvariterator.h"
 
 /*JSON{
@@ -129,6 +130,93 @@ int jswrap_string_charCodeAt(JsVar *parent, JsVarInt idx) {
 }
 
 
+/// Skip 'count' characters in a string iterator
+static void jswrap_string_skip(JsvStringIterator *it, size_t count) {
+  while (count--) jsvStringIteratorNextInline(it);
+}
+
+/// Longest string we'll build a search table for (on the stack) - longer strings are compared at each position
+#define STRING_SEARCH_MAX_LENGTH 255
+
+/** Call 'found' with the index of each place 'needle' appears in 'str' (at or after startIdx), in order.
+ * This is one forward pass over str using Knuth-Morris-Pratt, so we never go back and re-seek
+ * through the string's blocks. If !overlapping, a match can't start inside the previous one.
+ * Stops as soon as 'found' returns false. */
+static void jswrap_string_find(JsVar *str, JsVar *needle, size_t startIdx, bool overlapping, bool (*found)(size_t idx, void *data), void *data) {
+  size_t len = jsvGetStringLength(needle);
+  size_t idx = startIdx;
+  if (len==0) { // matches everywhere
+    size_t strLen = jsvGetStringLength(str);
+    for (;idx<=strLen;idx++)
+      if (!found(idx, data)) return;
+    return;
+  }
+
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, str, startIdx);
+  if (len <= STRING_SEARCH_MAX_LENGTH) {
+    char *n = (char*)alloca(len+1); // +1 for the trailing 0 jsvGetStringChars adds
+    unsigned char *fail = (unsigned char*)alloca(len); // fail[i] = length of longest proper prefix of n[0..i] that is also a suffix of it
+    jsvGetStringChars(needle, 0, n, len);
+    size_t i, m = 0;
+    fail[0] = 0;
+    for (i=1;i<len;i++) {
+      while (m>0 && n[i]!=n[m]) m = fail[m-1];
+      if (n[i]==n[m]) m++;
+      fail[i] = (unsigned char)m;
+    }
+    // now search - m is the number of characters of needle that currently match
+    m = 0;
+    while (jsvStringIteratorHasChar(&it)) {
+      char ch = jsvStringIteratorGetChar(&it);
+      while (m>0 && n[m]!=ch) m = fail[m-1];
+      if (n[m]==ch) m++;
+      jsvStringIteratorNextInline(&it);
+      idx++;
+      if (m==len) {
+        if (!found(idx-len, data)) break;
+        m = overlapping ? fail[len-1] : 0;
+      }
+    }
+  } else {
+    while (jsvStringIteratorHasChar(&it)) {
+      JsvStringIterator a = jsvStringIteratorClone(&it);
+      JsvStringIterator b;
+      jsvStringIteratorNew(&b, needle, 0);
+      while (jsvStringIteratorHasChar(&a) && jsvStringIteratorHasChar(&b) &&
+             jsvStringIteratorGetChar(&a)==jsvStringIteratorGetChar(&b)) {
+        jsvStringIteratorNextInline(&a);
+        jsvStringIteratorNextInline(&b);
+      }
+      bool match = !jsvStringIteratorHasChar(&b);
+      jsvStringIteratorFree(&a);
+      jsvStringIteratorFree(&b);
+      if (match) {
+        if (!found(idx, data)) break;
+        if (!overlapping) {
+          jswrap_string_skip(&it, len-1);
+          idx += len-1;
+        }
+      }
+      jsvStringIteratorNextInline(&it);
+      idx++;
+    }
+  }
+  jsvStringIteratorFree(&it);
+}
+
+/// Callback for jswrap_string_indexOf - data points to the index to return (and for lastIndexOf, first holds the last index allowed)
+static bool jswrap_string_indexOfCb(size_t idx, void *data) {
+  *(int*)data = (int)idx;
+  return false; // we only want the first one
+}
+static bool jswrap_string_lastIndexOfCb(size_t idx, void *data) {
+  int *d = (int*)data; // [max index, found index]
+  if ((int)idx > d[0]) return false;
+  d[1] = (int)idx;
+  return true;
+}
+
 /*JSON{
   "type" : "method",
   "class" : "String",
@@ -157,7 +245,6 @@ Return the last index of substring in this string, or -1 if not found
 */
 int jswrap_string_indexOf(JsVar *parent, JsVar *substring, JsVar *fromIndex, bool lastIndexOf) {
   if (!jsvIsString(parent)) return 0;
-  // slow, but simple!
   substring = jsvAsString(substring, false);
   if (!substring) return 0; // out of memory
   int parentLength = (int)jsvGetStringLength(parent);
@@ -167,69 +254,178 @@ int jswrap_string_indexOf(JsVar *parent, JsVar *substring, JsVar *fromIndex, boo
     return -1;
   }
   int lastPossibleSearch = parentLength - subStringLength;
-  int idx, dir, end;
-  if (!lastIndexOf) { // normal indexOf
-    dir = 1;
-    end = lastPossibleSearch+1;
-    idx = 0;
-    if (jsvIsNumeric(fromIndex)) {
-      idx = (int)jsvGetInteger(fromIndex);
-      if (idx<0) idx=0;
-      if (idx>end) idx=end;
-    }
-  } else {
-    dir = -1;
-    end = -1;
-    idx = lastPossibleSearch;
-    if (jsvIsNumeric(fromIndex)) {
-      idx = (int)jsvGetInteger(fromIndex);
-      if (idx<0) idx=0;
-      if (idx>lastPossibleSearch) idx=lastPossibleSearch;
-    }
+  int idx = lastIndexOf ? lastPossibleSearch : 0;
+  if (jsvIsNumeric(fromIndex)) {
+    idx = (int)jsvGetInteger(fromIndex);
+    if (idx<0) idx=0;
+    if (idx>lastPossibleSearch) // for indexOf, start past the last possible match so we don't find it (unless searching for "")
+      idx = (lastIndexOf || !subStringLength) ? lastPossibleSearch : lastPossibleSearch+1;
   }
 
-  for (;idx!=end;idx+=dir) {
-    if (jsvCompareString(parent, substring, (size_t)idx, 0, true)==0) {
-      jsvUnLock(substring);
-      return idx;
-    }
+  int result[2] = { idx, -1 };
+  if (!lastIndexOf) {
+    result[0] = -1;
+    jswrap_string_find(parent, substring, (size_t)idx, false, jswrap_string_indexOfCb, &result[0]);
+  } else {
+    // one pass from the start, remembering the last match that's not after idx
+    jswrap_string_find(parent, substring, 0, true, jswrap_string_lastIndexOfCb, result);
+    result[0] = result[1];
   }
   jsvUnLock(substring);
-  return -1;
+  return result[0];
+}
+
+/// Append characters from src to dst until src gets to index idx (or the end)
+static void jswrap_string_copyUntil(JsvStringIterator *src, JsvStringIterator *dst, size_t idx) {
+  while (jsvStringIteratorHasChar(src) && jsvStringIteratorGetIndex(src)<idx) {
+    jsvStringIteratorAppend(dst, jsvStringIteratorGetChar(src));
+    jsvStringIteratorNextInline(src);
+  }
+}
+
+typedef struct {
+  JsvStringIterator src; ///< follows behind the search, copying the parts of the string that didn't match
+  JsvStringIterator dst; ///< the end of the new string
+  JsVar *newSubStr;
+  size_t subStrLength;
+  bool all;
+} JswrapStringReplaceData;
+
+static bool jswrap_string_replaceCb(size_t idx, void *data) {
+  JswrapStringReplaceData *d = (JswrapStringReplaceData*)data;
+  jswrap_string_copyUntil(&d->src, &d->dst, idx);
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, d->newSubStr, 0);
+  while (jsvStringIteratorHasChar(&it)) {
+    jsvStringIteratorAppend(&d->dst, jsvStringIteratorGetChar(&it));
+    jsvStringIteratorNextInline(&it);
+  }
+  jsvStringIteratorFree(&it);
+  if (d->subStrLength==0 && jsvStringIteratorHasChar(&d->src)) {
+    // matching an empty string - make sure we move on past the next character
+    jswrap_string_copyUntil(&d->src, &d->dst, idx+1);
+  } else
+    jswrap_string_skip(&d->src, d->subStrLength);
+  return d->all;
 }
 
 /*JSON{
   "type" : "method",
   "class" : "String",
   "name" : "replace",
-  "generate" : "jswrap_string_replace",
+  "generate_full" : "jswrap_string_replace(parent, subStr, newSubStr, false)",
   "params" : [
     ["subStr","JsVar","The string to search for"],
     ["newSubStr","JsVar","The string to replace it with"]
   ],
   "return" : ["JsVar","This string with `subStr` replaced"]
 }
-Search and replace ONE occurrance of `subStr` with `newSubStr` and return the result. This doesn't alter the original string. Regular expressions not supported.
+Search and replace ONE occurrance of `subStr` with `newSubStr` and return the result. This doesn't alter the original string.
+
+`subStr` can also be a RegExp - if it is global (`/.../g`) every match is replaced. `newSubStr` can then use `$&` for the match, `$1`-`$9` for groups, and `` $` `` / `$'` for the text before/after the match, or it can be a function which is called with `(match, p1, p2, ..., offset, string)` and returns the replacement.
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "String",
+  "name" : "replaceAll",
+  "generate_full" : "jswrap_string_replace(parent, subStr, newSubStr, true)",
+  "params" : [
+    ["subStr","JsVar","The string to search for"],
+    ["newSubStr","JsVar","The string to replace it with"]
+  ],
+  "return" : ["JsVar","This string with every `subStr` replaced"]
+}
+Search and replace ALL occurrances of `subStr` with `newSubStr` and return the result. This doesn't alter the original string. `subStr` can also be a RegExp (see `String.replace`).
 */
-JsVar *jswrap_string_replace(JsVar *parent, JsVar *subStr, JsVar *newSubStr) {
+JsVar *jswrap_string_replace(JsVar *parent, JsVar *subStr, JsVar *newSubStr, bool all) {
+  JsVar *regexCode = jswrap_regexp_getCode(subStr);
+  if (regexCode) {
+    jsvUnLock(regexCode);
+    JsVar *str = jsvAsString(parent, false);
+    JsVar *replace = jsvIsFunction(newSubStr) ? jsvLockAgain(newSubStr) : jsvAsString(newSubStr, false);
+    JsVar *result = (str && replace) ? jswrap_regexp_replace(subStr, str, replace, all) : 0;
+    jsvUnLock(str);
+    jsvUnLock(replace);
+    return result;
+  }
+
   JsVar *str = jsvAsString(parent, false);
   subStr = jsvAsString(subStr, false);
   newSubStr = jsvAsString(newSubStr, false);
-
-  int idx = jswrap_string_indexOf(parent, subStr, 0, false);
-  if (idx>=0) {
-    JsVar *newStr = jsvNewFromStringVar(str, 0, (size_t)idx);
-    jsvAppendStringVar(newStr, newSubStr, 0, JSVAPPENDSTRINGVAR_MAXLENGTH);
-    jsvAppendStringVar(newStr, str, (size_t)idx+jsvGetStringLength(subStr), JSVAPPENDSTRINGVAR_MAXLENGTH);
-    jsvUnLock(str);
-    str = newStr;
+  JsVar *newStr = jsvNewFromEmptyString();
+
+  if (str && subStr && newSubStr && newStr) {
+    // build the new string in one pass, as we search
+    JswrapStringReplaceData d;
+    jsvStringIteratorNew(&d.src, str, 0);
+    jsvStringIteratorNew(&d.dst, newStr, 0);
+    d.newSubStr = newSubStr;
+    d.subStrLength = jsvGetStringLength(subStr);
+    d.all = all;
+    jswrap_string_find(str, subStr, 0, false, jswrap_string_replaceCb, &d);
+    jswrap_string_copyUntil(&d.src, &d.dst, JSVAPPENDSTRINGVAR_MAXLENGTH); // the rest
+    jsvStringIteratorFree(&d.src);
+    jsvStringIteratorFreeAppend(&d.dst, newStr);
   }
 
+  jsvUnLock(str);
   jsvUnLock(subStr);
   jsvUnLock(newSubStr);
-  return str;
+  return newStr;
+}
+
+
+/// Get the argument to String.match/search as a RegExp
+static JsVar *jswrap_string_toRegExp(JsVar *v) {
+  JsVar *code = jswrap_regexp_getCode(v);
+  if (code) {
+    jsvUnLock(code);
+    return jsvLockAgain(v);
+  }
+  return jswrap_regexp_constructor(v, 0);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "String",
+  "name" : "match",
+  "generate" : "jswrap_string_match",
+  "params" : [
+    ["regex","JsVar","The RegExp (or String, which is turned into a RegExp) to match"]
+  ],
+  "return" : ["JsVar","The match (see `RegExp.exec`), or if the RegExp is global an array of all matches. null if not found"]
+}
+Match this string against a RegExp, eg. ```"abc123".match(/\d+/)[0]=="123"```
+*/
+JsVar *jswrap_string_match(JsVar *parent, JsVar *regex) {
+  JsVar *str = jsvAsString(parent, false);
+  regex = jswrap_string_toRegExp(regex);
+  JsVar *result = (str && regex) ? jswrap_regexp_match(regex, str) : 0;
+  jsvUnLock(regex);
+  jsvUnLock(str);
+  return result;
 }
 
+/*JSON{
+  "type" : "method",
+  "class" : "String",
+  "name" : "search",
+  "generate" : "jswrap_string_search",
+  "params" : [
+    ["regex","JsVar","The RegExp (or String, which is turned into a RegExp) to search for"]
+  ],
+  "return" : ["int32","The index of the first match, or -1 if not found"]
+}
+Return the index of the first match of a RegExp in this string
+*/
+int jswrap_string_search(JsVar *parent, JsVar *regex) {
+  JsVar *str = jsvAsString(parent, false);
+  regex = jswrap_string_toRegExp(regex);
+  int idx = (str && regex) ? jswrap_regexp_search(regex, str) : -1;
+  jsvUnLock(regex);
+  jsvUnLock(str);
+  return idx;
+}
 
 /*JSON{
   "type" : "method",
@@ -313,12 +509,35 @@ JsVar *jswrap_string_slice(JsVar *parent, JsVarInt pStart, JsVar *vEnd) {
   "name" : "split",
   "generate" : "jswrap_string_split",
   "params" : [
-    ["separator","JsVar","The start character index"]
+    ["separator","JsVar","The string (or RegExp) to split on"]
   ],
   "return" : ["JsVar","Part of this string from start for len characters"]
 }
 Return an array made by splitting this string up by the separator. eg. ```'1,2,3'.split(',')==[1,2,3]```
+
+The separator can also be a RegExp, eg. ```'1, 2,3'.split(/, ?/)```. Any groups it captures are put in the array too.
 */
+typedef struct {
+  JsvStringIterator src; ///< follows behind the search, copying out each part
+  JsVar *array;
+  size_t splitLength;
+} JswrapStringSplitData;
+
+/// Push the next part of the string (up to idx) onto the array
+static bool jswrap_string_splitCb(size_t idx, void *data) {
+  JswrapStringSplitData *d = (JswrapStringSplitData*)data;
+  JsVar *part = jsvNewFromEmptyString();
+  if (!part) return false; // out of memory
+  JsvStringIterator dst;
+  jsvStringIteratorNew(&dst, part, 0);
+  jswrap_string_copyUntil(&d->src, &dst, idx);
+  jsvStringIteratorFreeAppend(&dst, part);
+  jsvArrayPush(d->array, part);
+  jsvUnLock(part);
+  jswrap_string_skip(&d->src, d->splitLength);
+  return true;
+}
+
 JsVar *jswrap_string_split(JsVar *parent, JsVar *split) {
   JsVar *array = jsvNewWithFlags(JSV_ARRAY);
   if (!array) return 0; // out of memory
@@ -328,27 +547,32 @@ JsVar *jswrap_string_split(JsVar *parent, JsVar *split) {
     return array;
   }
 
-  split = jsvAsString(split, false);
-
-  int idx, last = 0;
-  int splitlen = jsvIsUndefined(split) ? 0 : (int)jsvGetStringLength(split);
-  int l = (int)jsvGetStringLength(parent) + 1 - splitlen;
-
-  for (idx=0;idx<=l;idx++) {
-    if (splitlen==0 && idx==0) continue; // special case for where split string is ""
-    if (idx==l || splitlen==0 || jsvCompareString(parent, split, (size_t)idx, 0, true)==0) {
-      if (idx==l) {
-        idx=l+splitlen; // if the last element, do to the end of the string
-        if (splitlen==0) break;
-      }
+  JsVar *regexCode = jswrap_regexp_getCode(split);
+  if (regexCode) {
+    jsvUnLock(regexCode);
+    jsvUnLock(array);
+    JsVar *str = jsvAsString(parent, false);
+    array = str ? jswrap_regexp_split(split, str) : 0;
+    jsvUnLock(str);
+    return array;
+  }
 
-      JsVar *part = jsvNewFromStringVar(parent, (size_t)last, (size_t)(idx-last));
-      if (!part) break; // out of memory
-      jsvArrayPush(array, part);
-      jsvUnLock(part);
-      last = idx+splitlen;
-    }
+  split = jsvAsString(split, false);
+  if (!split) return array; // out of memory
+
+  JswrapStringSplitData d;
+  d.array = array;
+  d.splitLength = jsvGetStringLength(split);
+  jsvStringIteratorNew(&d.src, parent, 0);
+  if (d.splitLength==0) {
+    // special case for where split string is "" - just one character per element
+    while (jsvStringIteratorHasChar(&d.src))
+      if (!jswrap_string_splitCb(jsvStringIteratorGetIndex(&d.src)+1, &d)) break;
+  } else {
+    jswrap_string_find(parent, split, 0, false, jswrap_string_splitCb, &d);
+    jswrap_string_splitCb(JSVAPPENDSTRINGVAR_MAXLENGTH, &d); // the rest
   }
+  jsvStringIteratorFree(&d.src);
   jsvUnLock(split);
   return array;
 }
@@ -34,6 +34,7 @@ This class handles waveforms. In Espruino, a Waveform is a set of data that you
 
 static JsVar *jswrap_waveform_getBuffer(JsVar *waveform, int bufferNumber, bool *is16Bit) {
   JsVar *buffer = jsvObjectGetChild(waveform, (bufferNumber==0)?"buffer":"buffer2", 0);
+  if (!buffer) return 0; // no second buffer
 
   if (is16Bit) {
     *is16Bit = false;
@@ -63,9 +64,9 @@ bool jswrap_waveform_idle() {
       bool running = jsvGetBoolAndUnLock(jsvObjectGetChild(waveform, "running", 0));
       if (running) {
         JsVar *buffer = jswrap_waveform_getBuffer(waveform,0,0);
-        UtilTimerTask task;
-        // Search for a timer task
-        if (!jstGetLastBufferTimerTask(buffer, &task)) {
+        JsVarRef currentBufferRef;
+        // Search for the channel that's using our buffer
+        if (!jstGetBufferChannel(buffer, &currentBufferRef)) {
           // if the timer task is now gone...
           JsVar *arrayBuffer = jsvObjectGetChild(waveform, "buffer", 0);
           jsiQueueObjectCallbacks(waveform, "#onfinish", &arrayBuffer, 1);
@@ -73,11 +74,11 @@ bool jswrap_waveform_idle() {
           running = false;
           jsvUnLock(jsvObjectSetChild(waveform, "running", jsvNewFromBool(running)));
         } else {
-          // If the timer task is still there...
-          if (task.data.buffer.nextBuffer &&
-              task.data.buffer.nextBuffer != task.data.buffer.currentBuffer) {
-            // if it is a double-buffered task
-            int currentBuffer = (jsvGetRef(buffer)==task.data.buffer.currentBuffer) ? 0 : 1;
+          // If the channel is still there...
+          JsVar *buffer2 = jswrap_waveform_getBuffer(waveform,1,0);
+          if (buffer2) {
+            // if it is double-buffered
+            int currentBuffer = (jsvGetRef(buffer)==currentBufferRef) ? 0 : 1;
             JsVar *oldBuffer = jsvObjectGetChild(waveform, "currentBuffer", JSV_INTEGER);
             if (jsvGetInteger(oldBuffer) !=currentBuffer) {
               // buffers have changed - fire off a 'buffer' event with the buffer that needs to be filled
@@ -88,6 +89,7 @@ bool jswrap_waveform_idle() {
             }
             jsvUnLock(oldBuffer);
           }
+          jsvUnLock(buffer2);
         }
         jsvUnLock(buffer);
       }
@@ -101,6 +103,8 @@ bool jswrap_waveform_idle() {
     jsvObjectIteratorFree(&it);
     jsvUnLock(waveforms);
   }
+  // render the next block of output now, so the timer IRQ doesn't have to
+  jstRenderChannels();
   return false; // no need to stay awake - an IRQ will wake us
 }
 
@@ -131,6 +135,9 @@ void jswrap_waveform_kill() { // be sure to remove all waveforms...
     jsvObjectIteratorFree(&it);
     jsvUnLock(waveforms);
   }
+#ifdef LINUX
+  jshWaveformFileClose();
+#endif
 }
 
 
@@ -209,11 +216,18 @@ static void jswrap_waveform_start(JsVar *waveform, Pin pin, JsVarFloat freq, JsV
 
   JsSysTime startTime = jshGetSystemTime();
   bool repeat = false;
+  JsVarFloat gain = 1;
   if (jsvIsObject(options)) {
     JsVarFloat t = jsvGetFloatAndUnLock(jsvObjectGetChild(options, "time", 0));
     if (isfinite(t) && t>0)
        startTime = jshGetTimeFromMilliseconds(t*1000);
     repeat = jsvGetBoolAndUnLock(jsvObjectGetChild(options, "repeat", 0));
+    JsVar *gainVar = jsvObjectGetChild(options, "gain", 0);
+    if (gainVar) gain = jsvGetFloatAndUnLock(gainVar);
+    if (!isfinite(gain) || gain<0 || gain>255) {
+      jsExceptionHere(JSET_ERROR, "Gain must be between 0 and 255");
+      return;
+    }
   } else if (!jsvIsUndefined(options)) {
     jsExceptionHere(JSET_ERROR, "Expecting options to be undefined or an Object, not %t", options);
   }
@@ -232,7 +246,7 @@ static void jswrap_waveform_start(JsVar *waveform, Pin pin, JsVarFloat freq, JsV
 
 
   // And finally set it up
-  if (!jstStartSignal(startTime, jshGetTimeFromMilliseconds(1000.0 / freq), pin, buffer, repeat?(buffer2?buffer2:buffer):0, eventType))
+  if (!jstStartSignal(startTime, jshGetTimeFromMilliseconds(1000.0 / freq), pin, buffer, repeat?(buffer2?buffer2:buffer):0, eventType, (unsigned short)(gain*UTILTIMER_GAIN_UNITY)))
     jsWarn("Unable to schedule a timer");
   jsvUnLock(buffer);
   jsvUnLock(buffer2);
@@ -256,10 +270,12 @@ static void jswrap_waveform_start(JsVar *waveform, Pin pin, JsVarFloat freq, JsV
   "params" : [
     ["output","pin","The pin to output on"],
     ["freq","float","The frequency to output each sample at"],
-    ["options","JsVar","Optional options struct `{time:float,repeat:bool}` where: `time` is the that the waveform with start output at, e.g. `getTime()+1` (otherwise it is immediate), `repeat` is a boolean specifying whether to repeat the give sample"]
+    ["options","JsVar","Optional options struct `{time:float,repeat:bool,gain:float}` where: `time` is the that the waveform with start output at, e.g. `getTime()+1` (otherwise it is immediate), `repeat` is a boolean specifying whether to repeat the give sample, and `gain` is the volume to output at (default 1)"]
   ]
 }
 Will start outputting the waveform on the given pin - the pin must have previously been initialised with analogWrite. If not repeating, it'll emit a `finish` event when it is done.
+
+Several Waveforms can be output on the same pin at once - they are mixed together (each multiplied by its `gain`). If they have different frequencies, the later ones are resampled to the frequency of the first.
 */
 void jswrap_waveform_startOutput(JsVar *waveform, Pin pin, JsVarFloat freq, JsVar *options) {
   jswrap_waveform_start(waveform, pin, freq, options, true/*write*/);
@@ -309,5 +325,29 @@ void jswrap_waveform_stop(JsVar *waveform) {
   // now run idle loop as this will issue the finish event and will clean up
   jswrap_waveform_idle();
 }
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "Waveform",
+  "name" : "setOutputFile",
+  "ifdef" : "LINUX",
+  "generate" : "jswrap_waveform_setOutputFile",
+  "params" : [
+    ["filename","JsVar","The WAV file to write to, or undefined to close the current file"],
+    ["sampleRate","int32","The sample rate to put in the file's header (default 8000)"]
+  ]
+}
+**Linux only.** Every pin is connected to a virtual DAC - mix together everything output with `Waveform.startOutput` and write it to a 16 bit mono WAV file. The file is completed when this is called again, on `reset()`, or when Espruino exits.
+*/
+#ifdef LINUX
+void jswrap_waveform_setOutputFile(JsVar *filename, int sampleRate) {
+  jshWaveformFileClose();
+  if (jsvIsUndefined(filename)) return;
+  char path[256];
+  jsvGetString(filename, path, sizeof(path));
+  if (sampleRate<=0) sampleRate = 8000;
+  if (!jshWaveformFileOpen(path, sampleRate))
+    jsExceptionHere(JSET_ERROR, "Unable to open file %q", filename);
+}
+#endif
 #endif
 
@@ -20,3 +20,4 @@ void jswrap_waveform_startOutput(JsVar *waveform, Pin pin, JsVarFloat freq, JsVa
 void jswrap_waveform_startInput(JsVar *waveform, Pin pin, JsVarFloat freq, JsVar *options);
 void jswrap_waveform_stop(JsVar *waveform);
 
+void jswrap_waveform_setOutputFile(JsVar *filename, int sampleRate);
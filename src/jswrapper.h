@@ -55,6 +55,10 @@ typedef struct {
   const char *symbolChars;
 } PACKED_FLAGS JswSymList;
 
+/** Call a native function. Built-in functions' argument specifiers have typed
+ * call stubs generated for them, anything else goes via jsnCallFunction */
+JsVar *jswCallFunction(void *function, JsnArgumentType argumentSpecifier, JsVar *thisParam, JsVar **paramData, int paramCount);
+
 /// Do a binary search of the symbol table list
 JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *name);
 
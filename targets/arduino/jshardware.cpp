@@ -219,15 +219,16 @@ void jshI2CRead(IOEventFlags device, unsigned char address, int nBytes, unsigned
 }
 
 
-void jshSaveToFlash() {
+void jshFlashErasePage(uint32_t addr) {
   jsError("Flash not implemented on Arduino");
 }
 
-void jshLoadFromFlash() {
-  jsError("Flash not implemented on Arduino");
+void jshFlashRead(void *buf, uint32_t addr, uint32_t len) {
+  memset(buf, 0xFF, len); // looks like erased flash
 }
 
-bool jshFlashContainsCode() {
+bool jshFlashWrite(void *buf, uint32_t addr, uint32_t len) {
+  jsError("Flash not implemented on Arduino");
   return false;
 }
 
@@ -24,11 +24,18 @@
 #endif//__MINGW32__
  #include <signal.h>
  #include <inttypes.h>
+ #include <pthread.h>
 
 #include "jshardware.h"
 #include "jsutils.h"
 #include "jsparse.h"
 #include "jsinteractive.h"
+#include "jstimer.h"
+#ifdef USE_TRIGGER
+#include "trigger.h"
+#endif
+
+static THREAD_LOCAL bool hasConsole = false; ///< Only the thread that called jshInit reads the console (see --threads)
 
 // ----------------------------------------------------------------------------
 #ifdef SYSFS_GPIO_DIR
@@ -169,6 +176,7 @@ int getch()
 
 void jshInit() {
   jshInitDevices();
+  hasConsole = true;
 #ifndef __MINGW32__
   if (!terminal_set) {
     struct termios new_termios;
@@ -198,6 +206,8 @@ void jshReset() {
 }
 
 void jshKill() {
+  jshWaveformFileClose();
+  jshWorkerKill();
 #ifdef SYSFS_GPIO_DIR
   int i;
   // unexport any GPIO that we exported
@@ -207,8 +217,10 @@ void jshKill() {
 #endif
 }
 
+static void jshWorkerIdle();
+
 void jshIdle() {
-  while (kbhit()) {
+  while (hasConsole && kbhit()) {
     int ch = getch();
     if (ch<0) break;
     jshPushIOCharEvent(EV_USBSERIAL, (char)ch);
@@ -220,11 +232,23 @@ void jshIdle() {
     if (gpioShouldWatch[pin]) {
       bool state = jshPinGetValue(pin);
       if (state != gpioLastState[pin]) {
-        jshPushIOEvent(pinToEVEXTI(pin) | (state?EV_EXTI_IS_HIGH:0), jshGetSystemTime());
+        IOEventFlags channel = pinToEVEXTI(pin) | (state?EV_EXTI_IS_HIGH:0);
+        JsSysTime time = jshGetSystemTime();
+#ifdef USE_TRIGGER
+        if (!trigHandleEXTI(channel, time))
+#endif
+        jshPushIOEvent(channel, time);
         gpioLastState[pin] = state;
       }
     }
 #endif
+
+  // There's no timer interrupt here, so run any utility timer tasks that are due
+  if (jstUtilTimerIsRunning())
+    jstUtilTimerInterruptHandler();
+
+  // Complete any blocking I/O that worker threads have finished
+  jshWorkerIdle();
 }
 
 // ----------------------------------------------------------------------------
@@ -474,48 +498,35 @@ void jshI2CRead(IOEventFlags device, unsigned char address, int nBytes, unsigned
 }
 
 
-void jshSaveToFlash() {
-  FILE *f = fopen("espruino.state","wb");
-  if (f) {
-    unsigned int jsVarCount = jsvGetMemoryTotal();
-    jsiConsolePrintf("\nSaving %d bytes...", jsVarCount*sizeof(JsVar));
-    JsVarRef i;
+// 'Flash' is emulated with a file - bytes that haven't been written read as 0xFF, like erased flash
+#define FLASH_STATE_FILE "espruino.state"
 
-    for (i=1;i<=jsVarCount;i++) {
-      fwrite(_jsvGetAddressOf(i),1,sizeof(JsVar),f);
-    }
-    fclose(f);
-    jsiConsolePrint("\nDone!\n>");
-  } else {
-    jsiConsolePrint("\nFile Open Failed... \n>");
-  }
+void jshFlashErasePage(uint32_t addr) {
+  unsigned char buf[FLASH_PAGE_SIZE];
+  memset(buf, 0xFF, sizeof(buf));
+  jshFlashWrite(buf, addr & ~(uint32_t)(FLASH_PAGE_SIZE-1), FLASH_PAGE_SIZE);
 }
 
-void jshLoadFromFlash() {
-  FILE *f = fopen("espruino.state","rb");
-  if (f) {
-    fseek(f, 0L, SEEK_END);
-    unsigned int fileSize = ftell(f);
-    fseek(f, 0L, SEEK_SET);
-
-    jsiConsolePrintf("\nLoading %d bytes...\n>", fileSize);
-
-    unsigned int jsVarCount = fileSize / sizeof(JsVar);
-    jsvSetMemoryTotal(jsVarCount);
-    JsVarRef i;
-    for (i=1;i<=jsVarCount;i++) {
-      fread(_jsvGetAddressOf(i),1,sizeof(JsVar),f);
-    }
-    fclose(f);
-  } else {
-    jsiConsolePrint("\nFile Open Failed... \n>");
-  }
+void jshFlashRead(void *buf, uint32_t addr, uint32_t len) {
+  memset(buf, 0xFF, len);
+  FILE *f = fopen(FLASH_STATE_FILE, "rb");
+  if (!f) return;
+  if (fseek(f, (long)addr, SEEK_SET)==0)
+    fread(buf, 1, len, f);
+  fclose(f);
 }
 
-bool jshFlashContainsCode() {
-  FILE *f = fopen("espruino.state","rb");
-  if (f) fclose(f);
-  return f!=0;
+bool jshFlashWrite(void *buf, uint32_t addr, uint32_t len) {
+  FILE *f = fopen(FLASH_STATE_FILE, "r+b");
+  if (!f) f = fopen(FLASH_STATE_FILE, "w+b");
+  if (!f) {
+    jsError("Unable to open "FLASH_STATE_FILE);
+    return false;
+  }
+  bool ok = fseek(f, (long)addr, SEEK_SET)==0 &&
+            fwrite(buf, 1, len, f)==len;
+  if (fclose(f)) ok = false;
+  return ok;
 }
 
 /// Enter simple sleep mode (can be woken up by interrupts). Returns true on success
@@ -530,6 +541,10 @@ bool jshSleep(JsSysTime timeUntilWake) {
   unsigned int usecs = (unsigned int)(jshGetMillisecondsFromTime(timeUntilWake)*1000);
   if (hasWatches && usecs>1000) 
     usecs=1000; // don't sleep much if we have watches - we need to keep polling them
+  if (jstUtilTimerIsRunning() && usecs>1000)
+    usecs=1000; // or if we have utility timer tasks - we run them from jshIdle
+  if (jshWorkerIsBusy() && usecs>1000)
+    usecs=1000; // or if we're waiting for worker threads - their completions are picked up in jshIdle
   if (usecs > 50000)
     usecs = 50000; // don't want to sleep too much (user input/HTTP/etc)
   if (usecs >= 1000)  
@@ -546,12 +561,202 @@ void jshUtilTimerReschedule(JsSysTime period) {
 void jshUtilTimerStart(JsSysTime period) {
 }
 
+/// File that the virtual DAC's output is written to as a 16 bit mono WAV
+static THREAD_LOCAL FILE *waveformFile = 0;
+static THREAD_LOCAL unsigned int waveformFileSamples = 0;
+static THREAD_LOCAL int waveformFileSampleRate = 0;
+
+static void jshWaveformWriteInt(unsigned int value, int bytes) {
+  while (bytes--) {
+    fputc((int)(value&255), waveformFile);
+    value >>= 8;
+  }
+}
+
+static void jshWaveformWriteHeader(int sampleRate) {
+  unsigned int dataSize = waveformFileSamples*2;
+  fseek(waveformFile, 0, SEEK_SET);
+  fwrite("RIFF", 1, 4, waveformFile);
+  jshWaveformWriteInt(36+dataSize, 4);
+  fwrite("WAVEfmt ", 1, 8, waveformFile);
+  jshWaveformWriteInt(16, 4); // fmt chunk size
+  jshWaveformWriteInt(1, 2); // PCM
+  jshWaveformWriteInt(1, 2); // mono
+  jshWaveformWriteInt((unsigned int)sampleRate, 4);
+  jshWaveformWriteInt((unsigned int)sampleRate*2, 4); // bytes/sec
+  jshWaveformWriteInt(2, 2); // block align
+  jshWaveformWriteInt(16, 2); // bits per sample
+  fwrite("data", 1, 4, waveformFile);
+  jshWaveformWriteInt(dataSize, 4);
+}
+
+/// Write everything sent to the virtual DAC into the given WAV file (closing any open file)
+bool jshWaveformFileOpen(const char *filename, int sampleRate) {
+  jshWaveformFileClose();
+  waveformFile = fopen(filename, "wb");
+  if (!waveformFile) return false;
+  waveformFileSamples = 0;
+  waveformFileSampleRate = sampleRate;
+  jshWaveformWriteHeader(sampleRate); // placeholder - sizes get filled in on close
+  return true;
+}
+
+/// Finish writing the WAV file (if one was open)
+void jshWaveformFileClose() {
+  if (!waveformFile) return;
+  jshWaveformWriteHeader(waveformFileSampleRate);
+  fclose(waveformFile);
+  waveformFile = 0;
+}
+
 JshPinFunction jshGetCurrentPinFunction(Pin pin) {
+  // Every pin is connected to one virtual DAC, so all Waveform outputs get mixed together
+  if (jshIsPinValid(pin)) return JSH_DAC|JSH_DAC_CH1;
   return JSH_NOTHING;
 }
 
 void jshSetOutputValue(JshPinFunction func, int value) {
+  if (!waveformFile || (func&JSH_MASK_TYPE)!=JSH_DAC) return;
+  jshWaveformWriteInt((unsigned int)(value-32768), 2);
+  waveformFileSamples++;
 }
 
 void jshEnableWatchDog(JsVarFloat timeout) {
 }
+
+// ----------------------------------------------------------------------------
+// Worker threads - blocking I/O (file access, DNS) is done on these so that the idle loop keeps running
+
+#define JSH_WORKER_THREADS 4
+
+typedef struct JshWorkerJob {
+  JshWorkerFn work;
+  JshWorkerDoneFn done;
+  void *data;
+  void *owner; ///< &workerOwner of the thread that queued this, so it completes in the right interpreter
+  struct JshWorkerJob *next;
+} JshWorkerJob;
+
+static pthread_mutex_t workerLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workerQueued = PTHREAD_COND_INITIALIZER; ///< Signalled when a job is added to workerJobs
+static pthread_cond_t workerFinished = PTHREAD_COND_INITIALIZER; ///< Signalled when a job is added to workerDone
+static JshWorkerJob *workerJobs = 0, *workerJobsLast = 0; ///< Jobs waiting for a thread
+static JshWorkerJob *workerDone = 0, *workerDoneLast = 0; ///< Finished jobs waiting for their 'done' call
+static int workerThreads = 0; ///< Threads are started as jobs are queued, up to JSH_WORKER_THREADS
+static THREAD_LOCAL char workerOwner; ///< Only the address of this is used - to tell threads apart
+static THREAD_LOCAL unsigned int workerPending = 0; ///< Jobs queued by this thread that haven't had 'done' called
+
+/// Add a job to the end of a list. Call with workerLock held
+static void jshWorkerAppend(JshWorkerJob **first, JshWorkerJob **last, JshWorkerJob *job) {
+  job->next = 0;
+  if (*last) (*last)->next = job;
+  else *first = job;
+  *last = job;
+}
+
+static void *jshWorkerThread(void *arg) {
+  NOT_USED(arg);
+  pthread_mutex_lock(&workerLock);
+  while (true) {
+    while (!workerJobs)
+      pthread_cond_wait(&workerQueued, &workerLock);
+    JshWorkerJob *job = workerJobs;
+    workerJobs = job->next;
+    if (!workerJobs) workerJobsLast = 0;
+    pthread_mutex_unlock(&workerLock);
+    job->work(job->data);
+    pthread_mutex_lock(&workerLock);
+    jshWorkerAppend(&workerDone, &workerDoneLast, job);
+    pthread_cond_broadcast(&workerFinished);
+  }
+  return 0;
+}
+
+void jshWorkerQueue(JshWorkerFn work, JshWorkerDoneFn done, void *data) {
+  JshWorkerJob *job = (JshWorkerJob*)malloc(sizeof(JshWorkerJob));
+  if (!job) {
+    // can't even queue it, so just block
+    work(data);
+    done(data, false);
+    return;
+  }
+  job->work = work;
+  job->done = done;
+  job->data = data;
+  job->owner = &workerOwner;
+  workerPending++;
+
+  pthread_mutex_lock(&workerLock);
+  if (workerThreads < JSH_WORKER_THREADS) {
+    pthread_t thread;
+    if (pthread_create(&thread, 0, jshWorkerThread, 0)==0) {
+      pthread_detach(thread);
+      workerThreads++;
+    }
+  }
+  if (workerThreads) {
+    jshWorkerAppend(&workerJobs, &workerJobsLast, job);
+    pthread_cond_signal(&workerQueued);
+  } else {
+    // no threads at all - do the work now, but still complete it from jshIdle
+    pthread_mutex_unlock(&workerLock);
+    work(data);
+    pthread_mutex_lock(&workerLock);
+    jshWorkerAppend(&workerDone, &workerDoneLast, job);
+  }
+  pthread_mutex_unlock(&workerLock);
+}
+
+bool jshWorkerIsBusy() {
+  return workerPending!=0;
+}
+
+/// Remove this thread's finished jobs from workerDone and return them (in order). If 'wait', block until there is at least one
+static JshWorkerJob *jshWorkerTakeFinished(bool wait) {
+  JshWorkerJob *first = 0, *last = 0;
+  pthread_mutex_lock(&workerLock);
+  while (true) {
+    JshWorkerJob **prev = &workerDone;
+    workerDoneLast = 0;
+    while (*prev) {
+      JshWorkerJob *job = *prev;
+      if (job->owner == &workerOwner) {
+        *prev = job->next;
+        jshWorkerAppend(&first, &last, job);
+      } else {
+        workerDoneLast = job;
+        prev = &job->next;
+      }
+    }
+    if (first || !wait) break;
+    pthread_cond_wait(&workerFinished, &workerLock);
+  }
+  pthread_mutex_unlock(&workerLock);
+  return first;
+}
+
+/// Call 'done' for all this thread's jobs that have finished
+static void jshWorkerIdle() {
+  if (!workerPending) return;
+  JshWorkerJob *job = jshWorkerTakeFinished(false);
+  while (job) {
+    JshWorkerJob *next = job->next;
+    workerPending--;
+    job->done(job->data, false);
+    free(job);
+    job = next;
+  }
+}
+
+void jshWorkerKill() {
+  while (workerPending) {
+    JshWorkerJob *job = jshWorkerTakeFinished(true);
+    while (job) {
+      JshWorkerJob *next = job->next;
+      workerPending--;
+      job->done(job->data, true);
+      free(job);
+      job = next;
+    }
+  }
+}
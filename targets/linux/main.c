@@ -4,6 +4,10 @@
 #include <sys/stat.h>
 #include <signal.h>
 #include <dirent.h> // for readdir
+#include <time.h> // for clock_gettime
+#include <unistd.h> // for dup
+#include <fcntl.h> // for open
+#include <pthread.h>
 
 #include "jslex.h"
 #include "jsvar.h"
@@ -13,11 +17,16 @@
 #include "jsinteractive.h"
 #include "jshardware.h"
 #include "jswrapper.h"
+#include "jsdevices.h"
 
 
 #define TEST_DIR "tests/"
+#define BENCHMARK_DIR "benchmark/"
+#define BENCHMARK_RUNS 5 ///< How many times to run each benchmark (we report the median time)
+#define BENCHMARK_MAX 64 ///< Maximum number of benchmarks
+#define BENCHMARK_REGRESSION_PERCENT 10 ///< If a benchmark is this much slower than the baseline, --bench-compare fails
 
-bool isRunning = true;
+THREAD_LOCAL bool isRunning = true; ///< Cleared by quit() - each interpreter (see run_threads) has its own
 
 void addNativeFunction(const char *name, void (*callbackPtr)(void)) {
   jsvUnLock(jsvObjectSetChild(execInfo.root, name, jsvNewNativeFunction(callbackPtr, JSWAT_VOID)));
@@ -196,6 +205,228 @@ bool run_memory_tests(int vars) {
   return true;
 }
 
+typedef struct {
+  const char *filename;
+  bool isTest; ///< If true, pass if the script sets 'result' to true (as for run_test)
+  bool pass;
+  pthread_t thread;
+} ContextThread;
+
+/** Run a script in a new interpreter. Interpreter state is thread local (see THREAD_LOCAL),
+ * so this can be run on several threads at once, each with their own JsVars, timers and events */
+void *run_context_thread(void *arg) {
+  ContextThread *ctx = (ContextThread*)arg;
+  ctx->pass = false;
+  char *buffer = read_file(ctx->filename);
+  if (!buffer) return 0;
+
+  jshInitDevices(); // jshInit is only called once, from the main thread
+  jsvInit();
+  jsiInit(false /* do not autoload!!! */);
+  addNativeFunction("quit", nativeQuit);
+  addNativeFunction("interrupt", nativeInterrupt);
+
+  jsvUnLock(jspEvaluate(buffer, true));
+  free(buffer);
+
+  isRunning = true;
+  bool isBusy = true;
+  while (isRunning && (jsiHasTimers() || isBusy))
+    isBusy = jsiLoop();
+
+  JsVar *result = jsvObjectGetChild(execInfo.root, "result", 0/*no create*/);
+  ctx->pass = !ctx->isTest || jsvGetBool(result);
+  jsvUnLock(result);
+  jsiKill();
+  jsvGarbageCollect();
+  if (jsvGetMemoryUsage()) {
+    printf("%s: %d Memory Records not freed\r\n", ctx->filename, jsvGetMemoryUsage());
+    ctx->pass = false;
+  }
+  jsvKill();
+  jshWaveformFileClose();
+  jshWorkerKill();
+  return 0;
+}
+
+/// Run each file in its own interpreter, all at once on separate threads
+bool run_threads(int count, char **filenames, bool isTest) {
+  ContextThread *ctx = (ContextThread*)calloc((size_t)count, sizeof(ContextThread));
+  if (!ctx) return false;
+  jshInit();
+  int i;
+  for (i=0;i<count;i++) {
+    ctx[i].filename = filenames[i];
+    ctx[i].isTest = isTest;
+    if (pthread_create(&ctx[i].thread, 0, run_context_thread, &ctx[i])) {
+      printf("Unable to create thread for %s\r\n", filenames[i]);
+      ctx[i].filename = 0;
+    }
+  }
+  bool ok = true;
+  for (i=0;i<count;i++) {
+    if (ctx[i].filename)
+      pthread_join(ctx[i].thread, 0);
+    if (!ctx[i].pass) ok = false;
+    if (isTest)
+      printf("----------------------------- %s %s\r\n", ctx[i].pass ? "PASS" : "FAIL", filenames[i]);
+  }
+  jshKill();
+  free(ctx);
+  return ok;
+}
+
+typedef struct {
+  char name[64];
+  double medianTime; ///< milliseconds
+  JsVarStats stats; ///< from the last run
+} BenchmarkResult;
+
+double get_time_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec*1000.0 + (double)ts.tv_nsec/1000000.0;
+}
+
+int compare_doubles(const void *a, const void *b) {
+  double da = *(const double*)a, db = *(const double*)b;
+  return (da>db) - (da<db);
+}
+
+int compare_strings(const void *a, const void *b) {
+  return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+/// Run some code in a fresh interpreter, and return the time taken in ms
+double run_benchmark_once(const char *code, JsVarStats *stats) {
+  jshInit();
+  jsvInit();
+  jsiInit(false /* do not autoload!!! */);
+  addNativeFunction("quit", nativeQuit);
+  jsvResetStats();
+
+  double startTime = get_time_ms();
+  jsvUnLock(jspEvaluate(code, true));
+  isRunning = true;
+  bool isBusy = true;
+  while (isRunning && (jsiHasTimers() || isBusy))
+    isBusy = jsiLoop();
+  double time = get_time_ms() - startTime;
+
+  *stats = jsVarStats;
+  jsiKill();
+  jsvKill();
+  jshKill();
+  return time;
+}
+
+bool run_benchmark(const char *filename, BenchmarkResult *result) {
+  char *code = read_file(filename);
+  if (!code) return false;
+  double times[BENCHMARK_RUNS];
+  int i;
+  // benchmarks may print things - don't let them mess up our results
+  fflush(stdout);
+  int oldStdout = dup(1);
+  int devNull = open("/dev/null", O_WRONLY);
+  dup2(devNull, 1);
+  close(devNull);
+  for (i=0;i<BENCHMARK_RUNS;i++)
+    times[i] = run_benchmark_once(code, &result->stats);
+  fflush(stdout);
+  dup2(oldStdout, 1);
+  close(oldStdout);
+  free(code);
+
+  qsort(times, BENCHMARK_RUNS, sizeof(double), compare_doubles);
+  result->medianTime = times[BENCHMARK_RUNS/2];
+  // name is the filename without directory or '.js'
+  const char *name = strrchr(filename, '/');
+  name = name ? name+1 : filename;
+  strncpy(result->name, name, sizeof(result->name)-1);
+  result->name[sizeof(result->name)-1] = 0;
+  char *ext = strstr(result->name, ".js");
+  if (ext) *ext = 0;
+  return true;
+}
+
+/// Find the median time for the given benchmark in JSON output from --bench-json. Returns <0 if not found
+double get_baseline_time(const char *baseline, const char *name) {
+  char key[80];
+  snprintf(key, sizeof(key), "\"%s\": {\"median_ms\": ", name);
+  const char *p = strstr(baseline, key);
+  double time;
+  if (!p || sscanf(p+strlen(key), "%lf", &time)!=1) return -1;
+  return time;
+}
+
+/** Run all benchmarks in BENCHMARK_DIR. Output results as a table, or as
+ * JSON. If baselineFile is given, compare against the JSON in it and fail
+ * if any benchmark has got too much slower */
+bool run_all_benchmarks(bool outputJSON, const char *baselineFile) {
+  char *baseline = 0;
+  if (baselineFile) {
+    baseline = read_file(baselineFile);
+    if (!baseline) return false;
+  }
+
+  char *files[BENCHMARK_MAX];
+  int count = 0, i;
+  DIR *dir = opendir(BENCHMARK_DIR);
+  if (!dir) {
+    printf(BENCHMARK_DIR" directory not found\n");
+    return false;
+  }
+  struct dirent *pDir=NULL;
+  while((pDir = readdir(dir)) != NULL && count<BENCHMARK_MAX) {
+    char *fn = (*pDir).d_name;
+    size_t l = strlen(fn);
+    if (l>3 && fn[l-3]=='.' && fn[l-2]=='j' && fn[l-1]=='s') {
+      files[count] = (char *)malloc(1+l+strlen(BENCHMARK_DIR));
+      strcpy(files[count], BENCHMARK_DIR);
+      strcat(files[count], fn);
+      count++;
+    }
+  }
+  closedir(dir);
+  qsort(files, (size_t)count, sizeof(char*), compare_strings);
+
+  bool ok = true;
+  if (outputJSON)
+    printf("{\n  \"runs\": %d,\n  \"var_size\": %d,\n  \"benchmarks\": {", BENCHMARK_RUNS, (int)sizeof(JsVar));
+  else
+    printf("%-20s %10s %10s %10s %6s %10s%s\n", "Benchmark", "Median ms", "Allocs", "Scratch", "GCs", "Peak vars", baseline ? "  vs baseline":"");
+  for (i=0;i<count;i++) {
+    BenchmarkResult r;
+    if (!run_benchmark(files[i], &r)) {
+      ok = false;
+      continue;
+    }
+    if (outputJSON) {
+      printf("%s\n    \"%s\": {\"median_ms\": %.3f, \"allocations\": %u, \"scratch_allocations\": %u, \"gc_runs\": %u, \"peak_vars\": %u, \"peak_bytes\": %u}",
+          i ? "," : "", r.name, r.medianTime, r.stats.allocations, r.stats.scratchAllocations, r.stats.garbageCollects,
+          r.stats.peakMemoryUsage, r.stats.peakMemoryUsage*(unsigned int)sizeof(JsVar));
+    } else {
+      printf("%-20s %10.3f %10u %10u %6u %10u", r.name, r.medianTime, r.stats.allocations, r.stats.scratchAllocations, r.stats.garbageCollects, r.stats.peakMemoryUsage);
+      double baseTime = baseline ? get_baseline_time(baseline, r.name) : -1;
+      if (baseTime > 0) {
+        double change = (r.medianTime - baseTime) * 100 / baseTime;
+        bool regressed = change > BENCHMARK_REGRESSION_PERCENT;
+        if (regressed) ok = false;
+        printf("  %+.1f%%%s", change, regressed ? " REGRESSION" : "");
+      } else if (baseline)
+        printf("  (new)");
+      printf("\n");
+    }
+    fflush(stdout);
+  }
+  if (outputJSON)
+    printf("\n  }\n}\n");
+  for (i=0;i<count;i++)
+    free(files[i]);
+  free(baseline);
+  return ok;
+}
 
 void sig_handler(int sig)
 {
@@ -218,6 +449,11 @@ void show_help() {
     printf("   --test-mem-all          Run all Exhaustive Memory crash tests\n");
     printf("   --test-mem test.js      Run the supplied Exhaustive Memory crash test\n");
     printf("   --test-mem-n test.js #  Run the supplied Exhaustive Memory crash test with # vars\n");
+    printf("   --threads a.js b.js ... Run each script in its own interpreter, all at once on separate threads\n");
+    printf("   --test-threads a.js ... Run the supplied tests at once on separate threads\n");
+    printf("   --bench                 Run all benchmarks (in 'benchmark' directory) and show timings\n");
+    printf("   --bench-json            Run all benchmarks and output the results as JSON\n");
+    printf("   --bench-compare b.json  Run all benchmarks, and fail if any are slower than in b.json (from --bench-json)\n");
 }
 
 void die(const char *txt) {
@@ -267,6 +503,20 @@ int main(int argc, char **argv) {
         if (i+2>=argc) die("Expecting an extra 2 arguments\n");
         bool ok = run_memory_test(argv[i+1], atoi(argv[i+2]));
         exit(ok ? 0 : 1);
+      } else if (!strcmp(a,"--threads") || !strcmp(a,"--test-threads")) {
+        if (i+1>=argc) die("Expecting at least one extra argument\n");
+        bool ok = run_threads(argc-(i+1), &argv[i+1], !strcmp(a,"--test-threads"));
+        exit(ok ? 0 : 1);
+      } else if (!strcmp(a,"--bench")) {
+        bool ok = run_all_benchmarks(false, 0);
+        exit(ok ? 0 : 1);
+      } else if (!strcmp(a,"--bench-json")) {
+        bool ok = run_all_benchmarks(true, 0);
+        exit(ok ? 0 : 1);
+      } else if (!strcmp(a,"--bench-compare")) {
+        if (i+1>=argc) die("Expecting an extra argument\n");
+        bool ok = run_all_benchmarks(false, argv[i+1]);
+        exit(ok ? 0 : 1);
       } else {
         printf("Unknown Argument %s\n", a);
         show_help();
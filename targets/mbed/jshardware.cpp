@@ -224,16 +224,16 @@ void jshI2CRead(IOEventFlags device, unsigned char address, int nBytes, unsigned
 }
 
 
-void jshSaveToFlash() {
+void jshFlashErasePage(uint32_t addr) {
   
 }
 
-void jshLoadFromFlash() {
-  
+void jshFlashRead(void *buf, uint32_t addr, uint32_t len) {
+  memset(buf, 0xFF, len); // looks like erased flash
 }
 
-bool jshFlashContainsCode() {
-
+bool jshFlashWrite(void *buf, uint32_t addr, uint32_t len) {
+  return false;
 }
 
 /// Enter simple sleep mode (can be woken up by interrupts). Returns true on success
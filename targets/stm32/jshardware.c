@@ -2338,7 +2338,7 @@ void jshI2CRead(IOEventFlags device, unsigned char address, int nBytes, unsigned
 }
 
 
-void jshSaveToFlash() {
+static void jshFlashUnlock() {
 #ifdef STM32API2
   FLASH_Unlock();
 #else
@@ -2348,8 +2348,6 @@ void jshSaveToFlash() {
     FLASH_UnlockBank2();
   #endif
 #endif
-
-  unsigned int i;
   /* Clear All pending flags */
 #if defined(STM32F2) || defined(STM32F4) 
   FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | 
@@ -2359,41 +2357,9 @@ void jshSaveToFlash() {
 #else
   FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
 #endif
+}
 
-  jsiConsolePrint("Erasing Flash...");
-#if defined(STM32F2) || defined(STM32F4) 
-  for (i=0;i<FLASH_SAVED_CODE_PAGES;i++) {
-    FLASH_EraseSector(FLASH_Sector_0 + (FLASH_Sector_1-FLASH_Sector_0)*(FLASH_SAVED_CODE_SECTOR+i), VoltageRange_3); // a FLASH_Sector_## constant
-    jsiConsolePrint(".");
-  }
-#else
-  /* Erase the FLASH pages */
-  for(i=0;i<FLASH_SAVED_CODE_PAGES;i++) {
-    FLASH_ErasePage((uint32_t)(FLASH_SAVED_CODE_START + (FLASH_PAGE_SIZE * i)));
-    jsiConsolePrint(".");
-  }
-#endif
-  unsigned int dataSize = jsvGetMemoryTotal() * sizeof(JsVar);
-  jsiConsolePrintf("\nProgramming %d Bytes...", dataSize);
-
-  JsVar *firstData = jsvLock(1);
-  uint32_t *basePtr = (uint32_t *)firstData;
-  jsvUnLock(firstData);
-#if defined(STM32F2) || defined(STM32F4) 
-  for (i=0;i<dataSize;i+=4) {
-      while (FLASH_ProgramWord((uint32_t)(FLASH_SAVED_CODE_START+i), basePtr[i>>2]) != FLASH_COMPLETE);
-      if ((i&1023)==0) jsiConsolePrint(".");
-  }
-  while (FLASH_ProgramWord(FLASH_MAGIC_LOCATION, FLASH_MAGIC) != FLASH_COMPLETE);
-#else
-  /* Program Flash Bank */  
-  for (i=0;i<dataSize;i+=4) {
-      FLASH_ProgramWord((uint32_t)(FLASH_SAVED_CODE_START+i), basePtr[i>>2]);
-      if ((i&1023)==0) jsiConsolePrint(".");
-  }
-  FLASH_ProgramWord(FLASH_MAGIC_LOCATION, FLASH_MAGIC);
-  FLASH_WaitForLastOperation(0x2000);
-#endif
+static void jshFlashLock() {
 #ifdef STM32API2
   FLASH_Lock();
 #else
@@ -2403,84 +2369,41 @@ void jshSaveToFlash() {
     FLASH_LockBank2();
   #endif
 #endif
-  jsiConsolePrint("\nChecking...");
+}
 
-  int errors = 0;
-  for (i=0;i<dataSize;i+=4)
-    if ((*(uint32_t*)(FLASH_SAVED_CODE_START+i)) != basePtr[i>>2])
-      errors++;
+void jshFlashErasePage(uint32_t addr) {
+  jshFlashUnlock();
+#if defined(STM32F2) || defined(STM32F4) 
+  uint32_t page = (addr - FLASH_SAVED_CODE_START) / FLASH_PAGE_SIZE;
+  FLASH_EraseSector(FLASH_Sector_0 + (FLASH_Sector_1-FLASH_Sector_0)*(FLASH_SAVED_CODE_SECTOR+page), VoltageRange_3); // a FLASH_Sector_## constant
+#else
+  FLASH_ErasePage(addr & ~(uint32_t)(FLASH_PAGE_SIZE-1));
+  FLASH_WaitForLastOperation(0x2000);
+#endif
+  jshFlashLock();
+}
 
-  if (FLASH_MAGIC != *(unsigned int*)FLASH_MAGIC_LOCATION) {
-    jsiConsolePrint("\nFlash Magic Byte is wrong");
-    errors++;
-  }
+void jshFlashRead(void *buf, uint32_t addr, uint32_t len) {
+  memcpy(buf, (void*)addr, len);
+}
 
-  if (errors) {
-      jsiConsolePrintf("\nThere were %d errors!\n>", errors);
-  } else
-      jsiConsolePrint("\nDone!\n");
-
-//  This is nicer, but also broken!
-//  FLASH_UnlockBank1();
-//  /* Clear All pending flags */
-//  FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
-//
-//  size_t varDataSize = jsvGetVarDataSize();
-//  int *basePtr = jsvGetVarDataPointer();
-//
-//  int page;
-//  for(page=0;page<FLASH_SAVED_CODE_PAGES;page++) {
-//    jsPrint("Flashing Page ");jsPrintInt(page);jsPrint("...\n");
-//    size_t pageOffset = (FLASH_PAGE_SIZE * page);
-//    size_t pagePtr = FLASH_SAVED_CODE_START + pageOffset;
-//    size_t pageSize = varDataSize-pageOffset;
-//    if (pageSize>FLASH_PAGE_SIZE) pageSize = FLASH_PAGE_SIZE;
-//    jsPrint("Offset ");jsPrintInt(pageOffset);jsPrint(", Size ");jsPrintInt(pageSize);jsPrint(" bytes\n");
-//    bool first = true;
-//    int errors = 0;
-//    int i;
-//    for (i=pageOffset;i<pageOffset+pageSize;i+=4)
-//      if ((*(int*)(FLASH_SAVED_CODE_START+i)) != basePtr[i>>2])
-//        errors++;
-//    while (errors && !jspIsInterrupted()) {
-//      if (!first) { jsPrintInt(errors);jsPrint(" errors - retrying...\n"); }
-//      first = false;
-//      /* Erase the FLASH page */
-//      FLASH_ErasePage(pagePtr);
-//      /* Program Flash Bank1 */
-//      for (i=pageOffset;i<pageOffset+pageSize;i+=4)
-//          FLASH_ProgramWord(FLASH_SAVED_CODE_START+i, basePtr[i>>2]);
-//      FLASH_WaitForLastOperation(0x20000);
-//    }
-//  }
-//  // finally flash magic byte
-//  FLASH_ProgramWord(FLASH_MAGIC_LOCATION, FLASH_MAGIC);
-//  FLASH_WaitForLastOperation(0x20000);
-//  FLASH_LockBank1();
-//  if (*(int*)FLASH_MAGIC_LOCATION != FLASH_MAGIC)
-//    jsPrint("Flash magic word not flashed correctly!\n");
-//  jsPrint("Flashing Complete\n");
-
-}
-
-void jshLoadFromFlash() {
-  unsigned int dataSize = jsvGetMemoryTotal() * sizeof(JsVar);
-  jsiConsolePrintf("Loading from flash...\n");
-
-  JsVar *firstData = jsvLock(1);
-  uint32_t *basePtr = (uint32_t *)firstData;
-  jsvUnLock(firstData);
-
-  memcpy(basePtr, (int*)FLASH_SAVED_CODE_START, dataSize);
-}
-
-bool jshFlashContainsCode() {
-  /*jsPrint("Magic contains ");
-  jsPrintInt(*(int*)FLASH_MAGIC_LOCATION);
-  jsPrint("we want");
-  jsPrintInt(FLASH_MAGIC);
-  jsPrint("\n");*/
-  return (*(int*)FLASH_MAGIC_LOCATION) == (int)FLASH_MAGIC;
+bool jshFlashWrite(void *buf, uint32_t addr, uint32_t len) {
+  assert(!(addr&3) && !(len&3));
+  bool ok = true;
+  uint32_t i;
+  jshFlashUnlock();
+  for (i=0;i<len && ok;i+=4) {
+    // never read past the end of buf - any bytes after it are left erased
+    uint32_t word = 0xFFFFFFFF;
+    memcpy(&word, (unsigned char*)buf+i, (len-i<4) ? len-i : 4);
+    ok = FLASH_ProgramWord(addr+i, word) == FLASH_COMPLETE &&
+         *(uint32_t*)(addr+i) == word;
+  }
+#if !defined(STM32F2) && !defined(STM32F4)
+  FLASH_WaitForLastOperation(0x2000);
+#endif
+  jshFlashLock();
+  return ok;
 }
 
 #ifdef USB
@@ -0,0 +1,26 @@
+// Check that the allocation profiler records which lines allocate memory
+function make(n) {
+  var a=[];
+  for (var i=0;i<n;i++) a.push("item"+i);
+  return a;
+}
+E.setAllocationProfiler(true);
+var keep = make(10);
+var tmp = make(10); tmp = undefined;
+// sites in code that's been freed shouldn't be named after code that reuses its vars
+var fns = {};
+fns.a = function() { var k=[]; for (var i=0;i<5;i++) k.push("a"+i); return k; };
+var keepA = fns.a();
+delete fns.a;
+fns.b = function() { return [1,2,3]; };
+var keepB = fns.b();
+var sites = E.getAllocationSites();
+E.setAllocationProfiler(false);
+
+function site(name) { return sites.filter(function(s) { return s.site==name; })[0]; }
+var loop = site("make line 3");
+var freed = site("freed code line 1"), b = site("fns.b line 1");
+result = loop && loop.live>=20 && loop.allocs>=40 && loop.bytes>loop.live &&
+         sites[0].live >= sites[sites.length-1].live &&
+         freed && freed.live>=10 && b && b.allocs<freed.allocs &&
+         E.getAllocationSites()===undefined;
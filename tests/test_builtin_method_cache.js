@@ -0,0 +1,13 @@
+// Built-in methods should be the same var each time they're accessed
+var a = [1,2];
+var s = "Hello";
+
+var results = [
+  a.push === [].push && s.indexOf === "x".indexOf,
+  a.push !== a.pop && a.map === [3].map,
+  s.indexOf("l")==2 && a.push(3)==3 && a.length==3,
+  (function() { var p = a.push; p.call(a, 4); return a[3]==4; })(),
+];
+
+result = 1;
+for (var i in results) if (!results[i]) { result = 0; console.log("Failed "+i); }
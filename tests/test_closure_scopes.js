@@ -0,0 +1,15 @@
+// Closures nested deeper than the old limit of 8 scopes, and closures that outlive their scope
+
+var out;
+(function(){var a=1;(function(){var b=2;(function(){var c=3;(function(){var d=4;(function(){var e=5;
+(function(){var f=6;(function(){var g=7;(function(){var h=8;(function(){var i=9;(function(){var j=10;
+  out = a+b+c+d+e+f+g+h+i+j;
+})();})();})();})();})();})();})();})();})();})();
+
+function counter() { var n = 0; return function() { return ++n; }; }
+var c1 = counter(), c2 = counter();
+c1(); c1();
+
+function mk(d) { var v = "d"+d; return d ? function() { return v+","+mk(d-1)(); } : function() { return v; }; }
+
+result = out==55 && c1()==3 && c2()==1 && mk(12)().split(",").length==13;
@@ -0,0 +1,30 @@
+// Check that moving variables around with E.defrag() keeps everything intact
+
+var keep = [];
+var junk = [];
+for (var i=0;i<200;i++) {
+  junk.push({ a : "Some junk that takes up space "+i });
+  keep.push({ n : i, s : "A string long enough to need extra blocks #"+i, arr : [i,i*2,i*3] });
+}
+junk = undefined;
+var big = "";
+for (var i=0;i<50;i++) big += String.fromCharCode(65+(i%26));
+var ab = new Uint8Array([1,2,3,4,5]);
+function f(x) { return x+keep.length; }
+
+var usageBefore = process.memory().usage;
+E.defrag();
+
+var results = [];
+setTimeout(function() {
+  var ok = true;
+  for (var i=0;i<keep.length;i++)
+    if (keep[i].n!=i || keep[i].s!="A string long enough to need extra blocks #"+i || keep[i].arr[2]!=i*3)
+      ok = false;
+  results.push(ok);
+  results.push(big.length==50 && big[49]=="X");
+  results.push(ab[4]==5);
+  results.push(f(1)==201);
+  results.push(process.memory().usage<=usageBefore+20);
+  result = results.every(function(r) { return r; });
+}, 10);
@@ -0,0 +1,18 @@
+// Events are queued natively - check arguments, ordering, growth and that queued callbacks survive GC
+var o = {};
+var got = [];
+o.on('data', function(a,b,c,d) { got.push(a+b+c+d); });
+o.emit('data',1,2,3,4);
+for (var i=0;i<200;i++) o.emit('data',i,"",[],"");
+
+var p = {};
+var called = false;
+p.on('x', function(s) { called = s.v; });
+p.emit('x', {v:"ok"});
+delete p["#onx"]; // the callback is now only referenced from the queue
+process.memory(); // force a garbage collection
+
+setTimeout(function() {
+  result = got.length==201 && got[0]==10 && got[1]=="0" && got[200]=="199" &&
+           called=="ok" && E.getErrorFlags().indexOf("EVENT_QUEUE_FULL")<0;
+}, 10);
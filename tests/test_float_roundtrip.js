@@ -0,0 +1,26 @@
+// Floats should be written with the shortest digits that parse back to the same value
+
+var results = [
+  (0.1+0.2)+""=="0.30000000000000004" && 1/3+""=="0.3333333333333333",
+  1e21+""=="1e+21" && 1e20+""=="100000000000000000000" && 1e23+""=="1e+23",
+  1e-7+""=="1e-7" && 0.000001+""=="0.000001" && 1.5e-7+""=="1.5e-7",
+  5e-324+""=="5e-324" && 1.7976931348623157e308+""=="1.7976931348623157e+308",
+  Math.PI+""=="3.141592653589793" && -1.25+""=="-1.25" && 8.41e21+""=="8.41e+21",
+  parseFloat("2.2250738585072011e-308")==2.2250738585072011e-308 && 2.2250738585072011e-308+""=="2.225073858507201e-308",
+  parseFloat("6.2663561157260056873313985626112e+31")+""=="6.266356115726006e+31", // exactly halfway - round to even
+  // below the smallest denormal, round against half of it (2^-1075)
+  parseFloat("4e-324")==5e-324 && parseFloat("3e-324")==5e-324 && parseFloat("4.9406564584124654e-324")==5e-324,
+  parseFloat("2.4703282292062328e-324")==5e-324 && parseFloat("2.4703282292062327e-324")===0 && parseFloat("1e-324")===0,
+  JSON.stringify([0.1,1e-7,1234.5678])=="[0.1,1e-7,1234.5678]" && JSON.parse("[0.1,2.5e-3]")[1]==0.0025,
+];
+
+// everything written should parse back the same
+var ok = true;
+for (var i=1;i<200;i++) {
+  var v = Math.sin(i)*Math.pow(10,(i%40)-20);
+  if (parseFloat(v+"")!=v) ok = false;
+}
+results.push(ok);
+
+result = 1;
+for (var i in results) if (!results[i]) { result = 0; console.log("Failed "+i); }
@@ -0,0 +1,26 @@
+// Check the callback versions of the fs functions - on Linux these do their IO on worker threads
+var fs = require('fs');
+var file = './tests/FS_API_Async_Test.txt';
+var steps = [];
+var synchronous = true;
+
+fs.writeFile(file, "Hello", function(err) {
+  steps.push(!err && !synchronous);
+  fs.appendFile(file, new Uint8Array([32,87,111,114,108,100]), function(err) {
+    steps.push(!err);
+    fs.readFile(file, function(err, data) {
+      steps.push(!err && data=="Hello World");
+      fs.readdir('./tests', function(err, files) {
+        steps.push(!err && files.indexOf("FS_API_Async_Test.txt")>=0);
+        fs.unlink(file, function(err) {
+          steps.push(!err);
+          fs.readFile(file, function(err, data) {
+            steps.push(err!==undefined && err.msg=="Unable to read file" && data===undefined);
+            result = steps.length==6 && steps.every(function(s) { return s; });
+          });
+        });
+      });
+    });
+  });
+});
+synchronous = false;
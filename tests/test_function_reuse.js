@@ -0,0 +1,21 @@
+// Activation records are reused between calls - check nothing leaks from one call to the next
+
+function locals(set) {
+  if (set) var x = 42;
+  return x;
+}
+function sum(a,b) { return a+b; }
+function keep(v) { return function() { return v; }; }
+function fib(n) { return n<2 ? n : fib(n-1)+fib(n-2); }
+function args() { return arguments.length; }
+
+var first = locals(true);
+var second = locals(false);
+var total = 0;
+for (var i=0;i<100;i++) total = sum(total, i);
+var k1 = keep(1), k2 = keep(2);
+sum(3,4); // would reuse k2's record if it hadn't been kept
+
+result = first==42 && second===undefined && total==4950 &&
+         k1()==1 && k2()==2 && fib(15)==610 &&
+         args(1,2,3)==3 && args()==0 && sum(1)!=sum(1,1);
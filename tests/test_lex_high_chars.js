@@ -0,0 +1,4 @@
+// Characters >= 128 are only reserved words/operators in tokenised loop copies.
+// In normal code they're just single characters (so this is a syntax error, not '1 == 1')
+var r = eval("[1 \x80 1]");
+result = !(r && r[0]===true);
@@ -0,0 +1,11 @@
+// Identifiers that look like (or contain) reserved words shouldn't be treated as them
+var iff=1, doo=2, in1=3, typeofx=4, $if=5, _do=6, ne=7, voi=8, undefine=9, nulll=10, instanceofx=11, f0r=12;
+var results = [
+  iff+doo+in1+typeofx+$if+_do+ne+voi+undefine+nulll+instanceofx+f0r == 78,
+  typeof undefined == "undefined" && (void 0)===undefined && !("x" in {}) && null===null,
+  eval("var d=0; do { d++; } while (d<3); d") == 3,
+  eval("/* a comment with \"quotes\" and * stars **/ 'a\\'b\\x41\\101' // trailing") == "a'bAA",
+];
+
+result = 1;
+for (var i in results) if (!results[i]) { result = 0; console.log("Failed "+i); }
@@ -0,0 +1,16 @@
+// Loops that go round more than a few times are run from a tokenised copy - check it behaves the same
+var r=[];
+for (var i=0;i<12;i++) { if (i==1) continue; r.push(i); /* comment */ }
+var j=0; do { j++; } while (j<20);
+var k=0; while (k<40) { k+=3; if (k>30) break; }
+var s=0; for (var a=0;a<10;a++) for (var b=0;b<10;b++) s+=a*10+b;
+var fs=[]; for (var q=0;q<10;q++) fs.push(function() { return 42; }); // not tokenised
+function f(n) { var t=0; for (var x=0;x<n;x++) { if (x==10) return t; t+=x; } return t; }
+var str=""; for (var z=0;z<10;z++) { str += "a\"b'"+'c\n'; }
+var neg=0; for (var m=0;m<10;m++) neg = neg - -m;
+var inc=0; for (var n=0;n<10;n++) inc = inc + +n;
+var tc=0; for (var p=0;p<10;p++) { try { if (p==1) throw "x"; tc++; } catch (e) { tc+=10; } }
+
+result = r.toString()=="0,2,3,4,5,6,7,8,9,10,11" && j==20 && k==33 && s==4950 &&
+         fs[9]()==42 && f(20)==45 && f(3)==3 && str.length==60 && str.substr(54)=="a\"b'c\n" &&
+         neg==45 && inc==45 && tc==19;
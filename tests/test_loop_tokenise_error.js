@@ -0,0 +1,13 @@
+// Errors in loops that are run from a tokenised copy should still report where they are in the original code
+var hidden = this[">"];
+setTimeout(function() {
+  // the uncaught error's stack trace hasn't been printed (and cleared) yet
+  result = hidden.sTrace == " at line 12 col 36\n"+
+                            "  if (i==15) a += undefinedVariable.foo;\n"+
+                            "                                    ^\n";
+}, 0);
+
+var a = 0;
+for (var i=0;i<20;i++) { /* tokenised after 8 iterations */
+  if (i==15) a += undefinedVariable.foo;
+}
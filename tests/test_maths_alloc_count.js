@@ -0,0 +1,13 @@
+// Integer literals and the step of ++/-- are used directly, so a simple
+// counting loop only allocates for the results it can't store in a name
+// (the condition, i*2 and the old value of i++)
+function f() {
+  var x=0;for(var i=0;i<1000;i++) x+=i*2;
+  return x;
+}
+E.setAllocationProfiler(true);
+var x = f();
+var site = E.getAllocationSites().filter(function(s) { return s.site=="f line 2"; })[0];
+E.setAllocationProfiler(false);
+
+result = x==999000 && site && site.allocs<=3010;
@@ -0,0 +1,38 @@
+// Maths on numbers and booleans, where temporary values may be reused for results
+
+var a = 2147483647;
+var b = a + 1; // int overflow turns into a float
+var c = -(-2147483648);
+var d = 3;
+var e = d++; // e must keep the old value
+var f = ++d;
+var g = 10;
+g -= 4;
+g *= 2;
+var h = true + true + 1;
+var i = 0;
+for (var j=0;j<10;j++) i += j*2 - 1;
+var k = (1+2)*(3+4) - (5<<2);
+var l = [1 === 1.0, 1 === true, true === true, 2 !== 2, 1 == true];
+
+result = b == 2147483648 && c == 2147483648 &&
+         d == 5 && e == 3 && f == 5 &&
+         g == 12 && h == 3 && i == 80 && k == 1 &&
+         l.join() == "true,false,true,false,true";
+
+// literal operands that are used directly, and ++/-- done in place on names
+var m = 2147483647; m++;
+var n = -2147483648; n--;
+var o = { v : 5 }; o.v++; ++o.v;
+var p = [7]; p[0]--;
+var q = "5"; var q2 = q++;
+var r = 1.5; r++;
+var s = "a"; s += 1;
+var t = (m-1);
+var u = 3; u <<= 2; u = u<<1;
+var v = [1<2, 2<1, 1==true, 3%0];
+var w = 5; w = w-2147483648;
+
+result = result && m==2147483648 && n==-2147483649 && o.v==7 && p[0]==6 &&
+         q===6 && q2===5 && r==2.5 && s=="a1" && t==2147483647 && u==24 &&
+         v[0]===true && v[1]===false && v[2]===true && isNaN(v[3]) && w==-2147483643;
@@ -0,0 +1,30 @@
+// require() should create node_modules/NAME.min.js from NAME.js, and then use
+// it until the source changes - even if its size and time stay the same
+var fs = require("fs");
+var sourcePath = "node_modules/test_module_cache.js";
+var minPath = "node_modules/test_module_cache.min.js";
+if (fs.statSync(minPath)) fs.unlinkSync(minPath);
+
+fs.writeFileSync(sourcePath, "// A comment\nexports.value = 1;\n");
+var r1 = require("test_module_cache").value==1;
+var min = fs.readFileSync(minPath);
+var r2 = min.substr(0,15)=="//ESPRUINO_MIN ";
+
+// change the cached file's body but keep its header - it should be used as-is
+var header = min.substr(0, min.indexOf("\n")+1);
+fs.writeFileSync(minPath, header+"exports.value=2;");
+Modules.removeCached("test_module_cache");
+var r3 = require("test_module_cache").value==2;
+
+// now change the source - the cached file should be recreated
+fs.writeFileSync(sourcePath, "exports.value = 3;\n");
+Modules.removeCached("test_module_cache");
+var r4 = require("test_module_cache").value==3;
+var r5 = fs.readFileSync(minPath)!=header+"exports.value=2;";
+
+// change it again without changing its size, probably in the same second
+fs.writeFileSync(sourcePath, "exports.value = 4;\n");
+Modules.removeCached("test_module_cache");
+var r6 = require("test_module_cache").value==4;
+
+result = r1 && r2 && r3 && r4 && r5 && r6;
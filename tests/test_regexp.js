@@ -0,0 +1,24 @@
+// Regular expressions - literals, RegExp methods, and String methods that use them
+
+var r = /(\d+)-(\d+)/.exec("Range: 10-20");
+var a = 10, b = 2, c = 5;
+var g = /o/g;
+g.test("foo");
+
+var results = [
+  r[0]=="10-20" && r[1]=="10" && r[2]=="20" && r.index==7,
+  /ab+c/i.test("xxABBBCx") && !/^a/.test("ba") && /^a/m.test("b\na"),
+  /^a{2,3}$/.test("aaa") && !/^a{2,3}$/.test("aaaa"),
+  /\bfoo\b/.test("a foo b") && !/\bfoo\b/.test("afoob"),
+  "<a><b>".match(/<.+?>/)[0]=="<a>" && "<a><b>".match(/<.+>/)[0]=="<a><b>",
+  "a1b22c333".match(/\d+/g).join()=="1,22,333",
+  "John Smith".replace(/(\w+)\s(\w+)/, "$2, $1")=="Smith, John",
+  "aaa".replace(/a/g, function(m) { return m.toUpperCase(); })=="AAA",
+  "a, b,c".split(/, ?/).join("|")=="a|b|c" && "a1b2c".split(/(\d)/).length==5,
+  "hello world".search(/wor/)==6 && "x".search(/y/)==-1,
+  /[^a-c]+/.exec("abxyz")[0]=="xyz" && /[/]/.test("/"),
+  a/b/c==1, // still division
+  g.lastIndex==2 && new RegExp("x+","g").source=="x+",
+];
+
+result = results.every(function(r) { return r; });
@@ -0,0 +1,41 @@
+// setWatch using fake GPIO files. Pins can only be watched in a build made with SYSFS_GPIO_DIR=tests/gpio (see README.md)
+var fs = require("fs");
+function setPin(pin, value) { fs.writeFileSync("tests/gpio/gpio"+pin+"/value", value?"1":"0"); }
+setPin(1, 0);
+setPin(2, 0);
+
+if (setWatch(function(){}, D1) === undefined) {
+  result = true; // no GPIO in this build - setWatch just warns
+} else {
+  clearWatch();
+  var falling = 0, once = 0, selfClear = 0, many = 0;
+  var captured, debounced = [];
+  // these fit in the native watch table...
+  setWatch(function(e) { captured = e; }, D1, { capture : new Uint32Array(3) });
+  setWatch(function(e) { debounced.push(e.state); }, D1, { repeat:true, debounce:50 });
+  setWatch(function(e) { falling++; }, D2, { repeat:true, edge:"falling" });
+  setWatch(function(e) { once++; }, D2, { edge:"rising" });
+  var selfId = setWatch(function(e) { selfClear++; clearWatch(selfId); }, D2, { repeat:true });
+  // ...but more watches than that still work
+  for (var i=0;i<20;i++) setWatch(function(e) { many++; }, D2, { repeat:true, edge:"rising" });
+  var capturedLate;
+  setWatch(function(e) { capturedLate = e; }, D1, { capture : new Uint32Array(3) });
+  setWatch(function(e) { debounced.push(e.state); }, D1, { repeat:true, debounce:50 });
+
+  var steps = [[2,1],[2,0],[2,1],[2,0],[1,1],[1,0],[1,1]];
+  function step() {
+    var s = steps.shift();
+    setPin(s[0], s[1]);
+    if (steps.length) setTimeout(step, 20);
+    else setTimeout(check, 200);
+  }
+  function check() {
+    r = [falling, once, selfClear, many, debounced,
+         captured && captured.state, captured && captured.data[0], captured && captured.data[2]>captured.data[1],
+         capturedLate && capturedLate.state, capturedLate && capturedLate.data[2]>capturedLate.data[1]];
+    clearWatch();
+    result = JSON.stringify(r)==JSON.stringify([2, 1, 1, 40, [true, true], true, 0, true, true, true]);
+    if (!result) print(JSON.stringify(r));
+  }
+  setTimeout(step, 20);
+}
@@ -0,0 +1,23 @@
+// Reading a stream's buffer a few characters at a time, and by line
+var r = [];
+var lb = LoopbackB; // instantiate so received data gets buffered
+LoopbackA.write("Hello\r\nWorld\nabcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.");
+LoopbackA.write("x;y");
+
+setTimeout(function() {
+  r.push(LoopbackB.available());
+  r.push(LoopbackB.readLine());
+  r.push(LoopbackB.readLine());
+  r.push(LoopbackB.read(3));
+  r.push(LoopbackB.readUntil("."));
+  r.push(LoopbackB.readLine()); // no newline yet
+  r.push(LoopbackB.readUntil(";"));
+  r.push(LoopbackB.available());
+  r.push(LoopbackB.read());
+  r.push(LoopbackB.available());
+  r.push(LoopbackB.read());
+  result = JSON.stringify(r)==JSON.stringify([89,"Hello","World","abc",
+    "defghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.",
+    undefined,"x;",1,"y",0,""]);
+  if (!result) print(JSON.stringify(r));
+}, 10);
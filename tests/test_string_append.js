@@ -0,0 +1,29 @@
+// Long strings remember where their last block is - check that lengths and contents stay right however they grow
+
+var s = "";
+for (var i=0;i<500;i++) s += String.fromCharCode(65+(i%26));
+var a = s.length==500 && s[499]==String.fromCharCode(65+(499%26));
+
+var c = s; // copy, then grow both separately
+c += "!";
+s += "?";
+var b = s.length==501 && c.length==501 && s[500]=="?" && c[500]=="!";
+
+var o = {};
+o[s] = 42; // long string used as a name
+s += "more";
+var d = o[s.substr(0,501)]==42 && s.length==505;
+
+var arr = [];
+for (var i=0;i<200;i++) arr.push("item"+i);
+var j = arr.join(",");
+var e = j.length==arr.join(",").length && j.split(",").length==200;
+
+var js = JSON.stringify(arr);
+var f = JSON.parse(js).length==200;
+
+E.defrag();
+s += "X";
+var g = s.length==506 && s[505]=="X";
+
+result = a && b && d && e && f && g;
@@ -0,0 +1,29 @@
+// String searching - replace, replaceAll, and searching long strings / for long strings
+
+var long = "";
+for (var i=0;i<100;i++) long += "abcdefghij";
+long += "END\r\n\r\n";
+
+var n = "";
+for (var i=0;i<300;i++) n += String.fromCharCode(97+i%7); // longer than we'll make a search table for
+var h = "zz"+n+"q"+n+"y";
+
+var r = [
+ "aXbXc".replace("X","_")=="a_bXc",
+ "aXbXc".replaceAll("X","__")=="a__b__c",
+ "aaa".replaceAll("aa","b")=="ba",
+ "ab".replaceAll("","-")=="-a-b-",
+ "abc".replaceAll("x","y")=="abc",
+ "aaaa".lastIndexOf("aa")==2,
+ "hello world".lastIndexOf("o",6)==4,
+ "abcabd".indexOf("abd")==3,
+ "abc".indexOf("c",5)==-1,
+ long.indexOf("\r\n\r\n")==1003,
+ long.lastIndexOf("abc")==990,
+ long.split("j").length==101,
+ long.replaceAll("abcdefghij","").length==7,
+ h.indexOf(n)==2 && h.lastIndexOf(n)==303,
+ h.replaceAll(n,"N")=="zzNqNy",
+ h.split(n).length==3,
+];
+result = r.every(function(x) { return x; });
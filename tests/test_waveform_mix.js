@@ -0,0 +1,25 @@
+// Two Waveforms output on the same pin get mixed together (with their gains) - on Linux this goes to a WAV file
+var fs = require("fs");
+var file = "tests/test_waveform_mix.wav";
+var finished = 0;
+var a = new Waveform(32);
+var b = new Waveform(16);
+for (var i=0;i<32;i++) a.buffer[i] = 192; // +16384
+for (var i=0;i<16;i++) b.buffer[i] = 160; // +8192
+a.on("finish", function() { finished++; });
+b.on("finish", function() { finished++; });
+
+Waveform.setOutputFile(file, 1000);
+a.startOutput(D1, 1000);
+b.startOutput(D1, 1000, {gain:0.5});
+
+setTimeout(function() {
+  Waveform.setOutputFile();
+  var wav = fs.readFile(file);
+  fs.unlink(file); // don't leave it lying around in tests/
+  function int16(i) { var v = wav.charCodeAt(i) | (wav.charCodeAt(i+1)<<8); return (v<<16)>>16; }
+  var samples = (wav.length-44)/2;
+  r = [finished, samples, int16(44), int16(44+2*31), int16(40)];
+  result = JSON.stringify(r)==JSON.stringify([2, 32, 20480, 16384, 64]);
+  if (!result) print(JSON.stringify(r));
+}, 200);
@@ -0,0 +1,25 @@
+// A Waveform mixed into an output that's already running still waits until its 'time' before it starts
+var fs = require("fs");
+var file = "tests/test_waveform_mix_time.wav";
+var a = new Waveform(32);
+var b = new Waveform(8);
+for (var i=0;i<32;i++) a.buffer[i] = 192; // +16384
+for (var i=0;i<8;i++) b.buffer[i] = 160; // +8192
+
+Waveform.setOutputFile(file, 1000);
+a.startOutput(D1, 1000);
+b.startOutput(D1, 1000, {time:getTime()+0.01}); // 10 samples later
+
+setTimeout(function() {
+  Waveform.setOutputFile();
+  var wav = fs.readFile(file);
+  fs.unlink(file); // don't leave it lying around in tests/
+  function int16(i) { var v = wav.charCodeAt(i) | (wav.charCodeAt(i+1)<<8); return (v<<16)>>16; }
+  var samples = (wav.length-44)/2;
+  var start = 0, mixed = 0;
+  while (start<samples && int16(44+2*start)==16384) start++;
+  for (var i=0;i<samples;i++) if (int16(44+2*i)==24576) mixed++;
+  r = [samples, start, mixed, int16(44+2*31)];
+  result = samples==32 && start>=9 && start<=11 && mixed==8 && r[3]==16384;
+  if (!result) print(JSON.stringify(r));
+}, 200);
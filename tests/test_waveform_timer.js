@@ -0,0 +1,13 @@
+// Several Waveforms at once, run from the utility timer queue - they should finish in order of duration
+var order = [];
+var freqs = [100, 400, 50, 200];
+freqs.forEach(function(f) {
+  var w = new Waveform(8);
+  w.on("finish", function() { order.push(f); });
+  w.startInput(D1, f);
+});
+
+setTimeout(function() {
+  result = JSON.stringify(order)==JSON.stringify([400,200,100,50]);
+  if (!result) print(JSON.stringify(order));
+}, 400);